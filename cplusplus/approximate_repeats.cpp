@@ -0,0 +1,157 @@
+/**
+ * Approximate repeat matching and expansion
+ */
+
+#include "approximate_repeats.h"
+#include "packed_bases.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace ccc {
+
+namespace {
+
+constexpr unsigned kHashMinBits = 10;
+constexpr unsigned kHashMaxBits = 20;           // 4 MB of last occurrences, kept cache-resident
+
+inline uint32_t seed_slot(uint32_t key, unsigned bits) {
+    return (key * 2654435761u) >> (32 - bits);
+}
+
+} // namespace
+
+size_t extract_approximate_repeats(const uint8_t* symbols, size_t count, size_t min_bases, uint8_t* residual,
+                                   std::vector<ApproximateRepeat>& repeats) {
+    static_assert(kApproxSeedBases == 16, "seed keys are 16 bases of 2 bits");
+    static_assert(kApproxMinBases >= kApproxSeedBases + kApproxProbeStride - 1,
+                  "every copy of kApproxMinBases exact bases must hold a probe");
+    if (min_bases < kApproxMinBases) {
+        throw std::invalid_argument("Approximate repeats need at least " + std::to_string(kApproxMinBases) +
+                                    " bases, got " + std::to_string(min_bases));
+    }
+
+    // Positions are stored + 1 in 32 bits (0 = empty), so only that prefix is searched
+    const size_t searched = std::min<size_t>(count, std::numeric_limits<uint32_t>::max() - 1);
+    unsigned bits = kHashMinBits;
+    while (bits < kHashMaxBits && (size_t(1) << bits) < searched) {
+        ++bits;
+    }
+    std::vector<uint32_t> last(size_t(1) << bits, 0);
+
+    size_t out = 0;
+    size_t cursor = 0;                  // symbols before cursor are in the residual or a copy
+    uint32_t key = 0;
+    for (size_t j = 0; j + 1 < kApproxSeedBases && j < searched; ++j) {
+        key = key << 2 | symbols[j];
+    }
+    for (size_t j = 0; j + kApproxSeedBases <= searched; ++j) {
+        key = key << 2 | symbols[j + kApproxSeedBases - 1];
+        uint32_t& slot = last[seed_slot(key, bits)];
+        if (j >= cursor && j % kApproxProbeStride == 0 && slot != 0 &&
+            std::memcmp(symbols + (slot - 1), symbols + j, kApproxSeedBases) == 0) {
+            const size_t distance = j - (slot - 1);
+
+            // Exactly back to the residual, then forward through substitutions
+            size_t begin = j;
+            while (begin > cursor && begin > distance && symbols[begin - 1] == symbols[begin - 1 - distance]) {
+                --begin;
+            }
+            size_t end = j + kApproxSeedBases;
+            size_t best_end = end;
+            int score = 0;
+            int best_score = 0;
+            for (; end < count; ++end) {
+                if (symbols[end] == symbols[end - distance]) {
+                    if (++score > best_score) {
+                        best_score = score;
+                        best_end = end + 1;
+                    }
+                } else if ((score -= kApproxMismatchCost) < best_score - kApproxXDrop) {
+                    break;
+                }
+            }
+
+            if (best_end - begin >= min_bases) {
+                std::memcpy(residual + out, symbols + cursor, begin - cursor);
+                out += begin - cursor;
+                ApproximateRepeat repeat;
+                repeat.position = out;
+                repeat.distance = distance;
+                repeat.length = best_end - begin;
+                for (size_t p = j + kApproxSeedBases; p < best_end; ++p) {
+                    if (symbols[p] != symbols[p - distance]) {
+                        repeat.edits.push_back({p - begin, symbols[p]});
+                    }
+                }
+                repeats.push_back(std::move(repeat));
+                cursor = best_end;
+            }
+        }
+        // Every position stays a source, including those inside copies
+        slot = static_cast<uint32_t>(j + 1);
+    }
+    std::memcpy(residual + out, symbols + cursor, count - cursor);
+    return out + (count - cursor);
+}
+
+size_t approximate_repeat_bases(const std::vector<ApproximateRepeat>& repeats) {
+    size_t total = 0;
+    for (const ApproximateRepeat& repeat : repeats) {
+        bool edits_ok = true;
+        for (size_t e = 0; e < repeat.edits.size(); ++e) {
+            edits_ok = edits_ok && repeat.edits[e].offset < repeat.length && repeat.edits[e].base <= 3 &&
+                       (e == 0 || repeat.edits[e].offset > repeat.edits[e - 1].offset);
+        }
+        if (repeat.length == 0 || repeat.distance == 0 || !edits_ok ||
+            repeat.length > std::numeric_limits<size_t>::max() - total) {
+            throw std::invalid_argument("Malformed approximate repeat (distance " + std::to_string(repeat.distance) +
+                                        ", length " + std::to_string(repeat.length) + ", " +
+                                        std::to_string(repeat.edits.size()) + " edits)");
+        }
+        total += repeat.length;
+    }
+    return total;
+}
+
+void expand_approximate_repeats(const uint8_t* residual_packed, size_t residual_bases,
+                                const std::vector<ApproximateRepeat>& repeats, uint8_t* packed_out, size_t bases) {
+    if (residual_bases > bases || approximate_repeat_bases(repeats) != bases - residual_bases) {
+        throw std::invalid_argument("Approximate repeats do not add up to " + std::to_string(bases) + " bases");
+    }
+
+    size_t in = 0;
+    size_t out = 0;
+    for (const ApproximateRepeat& repeat : repeats) {
+        if (repeat.position < in || repeat.position > residual_bases) {
+            throw std::invalid_argument("Approximate repeat position " + std::to_string(repeat.position) +
+                                        " out of order or past the residual");
+        }
+        copy_bases(residual_packed, in, packed_out, out, repeat.position - in);
+        out += repeat.position - in;
+        in = repeat.position;
+        if (repeat.distance > out) {
+            throw std::invalid_argument("Approximate repeat source " + std::to_string(repeat.distance) +
+                                        " bases back at base " + std::to_string(out) + " precedes the stream");
+        }
+
+        // A source overlapping the copy is read as it is written, at most distance bases at a time,
+        // and each piece is edited before a later piece can read it
+        const size_t start = out;
+        auto edit = repeat.edits.begin();
+        for (size_t done = 0; done < repeat.length;) {
+            const size_t chunk = std::min(repeat.distance, repeat.length - done);
+            copy_bases(packed_out, out - repeat.distance, packed_out, out, chunk);
+            out += chunk;
+            done += chunk;
+            for (; edit != repeat.edits.end() && edit->offset < done; ++edit) {
+                set_base(packed_out, start + edit->offset, edit->base);
+            }
+        }
+    }
+    copy_bases(residual_packed, in, packed_out, out, residual_bases - in);
+}
+
+} // namespace ccc
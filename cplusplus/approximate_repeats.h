@@ -0,0 +1,92 @@
+/**
+ * Approximate Repeat Coding - C++ Implementation
+ *
+ * Optional pre-coding stage for diverged copies of earlier material
+ * (transposons, segmental duplications, paralogs). A point mutation splits
+ * the LZW phrases of an otherwise known copy, so every SNP costs several
+ * short codes on each side; here the copy is cut out of the base stream and
+ * kept as one (position, distance, length) token plus the substituted bases,
+ * next to the DVNP codes of the remainder.
+ *
+ * Matching is seed-and-extend on the 2-bit symbols: every position's
+ * kApproxSeedBases-base k-mer goes into a hash table of last occurrences,
+ * probes at a fixed stride look up earlier copies, and a verified seed is
+ * extended backwards exactly and forwards through mismatches until its score
+ * (+1 per match, -kApproxMismatchCost per substitution) falls kApproxXDrop
+ * below its best.
+ */
+
+#ifndef CCC_APPROXIMATE_REPEATS_H
+#define CCC_APPROXIMATE_REPEATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ccc {
+
+constexpr size_t kApproxSeedBases = 16;         // exact k-mer a match must contain (32-bit key)
+constexpr size_t kApproxProbeStride = 4;        // positions between probes
+constexpr size_t kApproxMinBases = 32;          // shortest copy the matcher can report
+constexpr size_t kApproxDefaultMinBases = 64;   // shorter copies cost more as tokens than as codes
+constexpr int kApproxMismatchCost = 8;          // score of a substitution; a match scores 1
+constexpr int kApproxXDrop = 24;                // extension stops this far below its best score
+
+/**
+ * One substituted base inside a copy
+ */
+struct RepeatEdit {
+    size_t offset = 0;                  // bases from the start of the copy
+    uint8_t base = 0;                   // base at that offset, 0-3
+};
+
+/**
+ * One copy of earlier material removed from a base stream
+ */
+struct ApproximateRepeat {
+    size_t position = 0;                // residual bases preceding the copy
+    size_t distance = 0;                // bases from the source's start to the copy's start (may be < length)
+    size_t length = 0;                  // bases covered by the copy
+    std::vector<RepeatEdit> edits;      // substitutions, ascending offsets
+};
+
+/**
+ * Cut approximate copies of earlier material out of a symbol stream
+ * Sources lie anywhere before the copy in the original stream, including
+ * inside earlier copies.
+ *
+ * @param symbols Symbols 0-3
+ * @param count Number of symbols
+ * @param min_bases Shortest copy to remove (at least kApproxMinBases)
+ * @param residual Output of at least count symbols: the stream without the copies;
+ *                 must not overlap symbols
+ * @param repeats Receives the copies, in stream order
+ * @return Number of residual symbols
+ * @throws std::invalid_argument if min_bases is below kApproxMinBases
+ */
+size_t extract_approximate_repeats(const uint8_t* symbols, size_t count, size_t min_bases, uint8_t* residual,
+                                   std::vector<ApproximateRepeat>& repeats);
+
+/**
+ * Total bases covered by a copy list
+ *
+ * @throws std::invalid_argument on a malformed copy (zero length or distance, edits out of order
+ *         or outside the copy, or an overflowing total)
+ */
+size_t approximate_repeat_bases(const std::vector<ApproximateRepeat>& repeats);
+
+/**
+ * Rebuild a base stream from its residual and copies (inverse of extract_approximate_repeats())
+ *
+ * @param residual_packed Residual bases, four per byte in binary_to_dna() order
+ * @param residual_bases Number of residual bases
+ * @param packed_out Zero-initialised output, four bases per byte
+ * @param bases residual_bases plus approximate_repeat_bases(repeats)
+ * @throws std::invalid_argument if the copies do not fit the residual or reach before the stream
+ */
+void expand_approximate_repeats(const uint8_t* residual_packed, size_t residual_bases,
+                                const std::vector<ApproximateRepeat>& repeats, uint8_t* packed_out, size_t bases);
+
+} // namespace ccc
+
+#endif // CCC_APPROXIMATE_REPEATS_H
@@ -0,0 +1,1165 @@
+/**
+ * CCC archive serialization
+ */
+
+#include "archive.h"
+#include "fast_hash.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#define CCC_HAVE_FSYNC 1
+#endif
+
+namespace ccc {
+
+namespace {
+
+constexpr char kArchiveMagic[4] = {'C', 'C', 'C', 'A'};
+constexpr char kMultiArchiveMagic[4] = {'C', 'C', 'C', 'M'};
+// Version 1 (one stream per member, no stream table) remains readable
+constexpr uint32_t kMultiArchiveVersion = 2;
+constexpr char kStripedIndexMagic[4] = {'C', 'C', 'C', 'S'};
+constexpr char kVolumeMagic[4] = {'C', 'C', 'C', 'V'};
+constexpr uint32_t kStripedArchiveVersion = 1;
+// Stripes span whole DVNP blocks of at least this many codes
+constexpr size_t kStripeCodes = 262144;
+
+class ByteWriter {
+public:
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            bytes_.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        bytes_.push_back(static_cast<uint8_t>(value));
+    }
+
+    void f64(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int i = 0; i < 8; ++i) {
+            bytes_.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+        }
+    }
+
+    void string(const std::string& value) {
+        varint(value.size());
+        bytes_.insert(bytes_.end(), value.begin(), value.end());
+    }
+
+    void raw(const void* data, size_t size) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        bytes_.insert(bytes_.end(), p, p + size);
+    }
+
+    std::vector<uint8_t>& bytes() { return bytes_; }
+
+private:
+    std::vector<uint8_t> bytes_;
+};
+
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size) : data_(data), size_(size), pos_(0) {}
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = take(1)[0];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::runtime_error("Invalid CCC archive: varint too long");
+    }
+
+    /**
+     * Varint that must fit a size_t and be at most limit
+     */
+    size_t count(uint64_t limit) {
+        uint64_t value = varint();
+        if (value > limit) {
+            throw std::runtime_error("Invalid CCC archive: count " + std::to_string(value) + " out of range");
+        }
+        return static_cast<size_t>(value);
+    }
+
+    double f64() {
+        const uint8_t* p = take(8);
+        uint64_t bits = 0;
+        for (int i = 0; i < 8; ++i) {
+            bits |= static_cast<uint64_t>(p[i]) << (8 * i);
+        }
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string string() {
+        size_t length = count(remaining());
+        const uint8_t* p = take(length);
+        return std::string(reinterpret_cast<const char*>(p), length);
+    }
+
+    const uint8_t* take(size_t size) {
+        if (size > remaining()) {
+            throw std::runtime_error("Invalid CCC archive: truncated data");
+        }
+        const uint8_t* p = data_ + pos_;
+        pos_ += size;
+        return p;
+    }
+
+    size_t remaining() const { return size_ - pos_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_;
+};
+
+unsigned code_width(const std::vector<int>& codes) {
+    uint32_t max_code = 0;
+    for (int code : codes) {
+        if (code < 0) {
+            throw std::invalid_argument("Cannot archive negative code " + std::to_string(code));
+        }
+        max_code = std::max(max_code, static_cast<uint32_t>(code));
+    }
+    unsigned width = 1;
+    while (width < 32 && (max_code >> width) != 0) {
+        ++width;
+    }
+    return width;
+}
+
+void pack_codes(const int* codes, size_t count, unsigned width, std::vector<uint8_t>& out) {
+    size_t start = out.size();
+    out.resize(start + (count * width + 7) / 8, 0);
+    uint8_t* p = out.data() + start;
+
+    uint64_t buffer = 0;
+    unsigned bits = 0;
+    for (size_t i = 0; i < count; ++i) {
+        buffer |= static_cast<uint64_t>(static_cast<uint32_t>(codes[i])) << bits;
+        bits += width;
+        while (bits >= 8) {
+            *p++ = static_cast<uint8_t>(buffer);
+            buffer >>= 8;
+            bits -= 8;
+        }
+    }
+    if (bits > 0) {
+        *p = static_cast<uint8_t>(buffer);
+    }
+}
+
+void unpack_codes(const uint8_t* p, size_t count, unsigned width, int* codes) {
+    const uint64_t mask = (1ULL << width) - 1;
+    uint64_t buffer = 0;
+    unsigned bits = 0;
+    for (size_t i = 0; i < count; ++i) {
+        while (bits < width) {
+            buffer |= static_cast<uint64_t>(*p++) << bits;
+            bits += 8;
+        }
+        codes[i] = static_cast<int>(buffer & mask);
+        buffer >>= width;
+        bits -= width;
+    }
+}
+
+void write_stats(ByteWriter& writer, const CompressionStats& stats) {
+    writer.varint(stats.original_size_bytes);
+    writer.varint(stats.compressed_size_bytes);
+    writer.f64(stats.compression_ratio);
+    writer.f64(stats.space_savings_percent);
+    writer.f64(stats.bits_per_base);
+    writer.varint(stats.bits_per_code);
+    writer.varint(stats.total_codes);
+    writer.varint(static_cast<uint32_t>(stats.max_code_value));
+    writer.f64(stats.original_entropy);
+    writer.f64(stats.compressed_entropy);
+    writer.f64(stats.entropy_reduction);
+    writer.f64(stats.theoretical_minimum_size);
+    writer.f64(stats.shannon_efficiency);
+    writer.f64(stats.compression_effectiveness);
+    writer.varint(stats.core_codes);
+    writer.varint(stats.reset_count);
+    writer.varint(stats.block_ratios.size());
+    for (double ratio : stats.block_ratios) {
+        writer.f64(ratio);
+    }
+}
+
+CompressionStats read_stats(ByteReader& reader) {
+    CompressionStats stats;
+    stats.original_size_bytes = reader.varint();
+    stats.compressed_size_bytes = reader.varint();
+    stats.compression_ratio = reader.f64();
+    stats.space_savings_percent = reader.f64();
+    stats.bits_per_base = reader.f64();
+    stats.bits_per_code = reader.varint();
+    stats.total_codes = reader.varint();
+    stats.max_code_value = static_cast<int>(reader.count(INT32_MAX));
+    stats.original_entropy = reader.f64();
+    stats.compressed_entropy = reader.f64();
+    stats.entropy_reduction = reader.f64();
+    stats.theoretical_minimum_size = reader.f64();
+    stats.shannon_efficiency = reader.f64();
+    stats.compression_effectiveness = reader.f64();
+    stats.core_codes = reader.varint();
+    stats.reset_count = reader.varint();
+    stats.block_ratios.resize(reader.count(reader.remaining() / 8));
+    for (double& ratio : stats.block_ratios) {
+        ratio = reader.f64();
+    }
+    return stats;
+}
+
+void write_layout(ByteWriter& writer, const NucleotideLayout& layout) {
+    writer.varint(layout.text_size);
+    writer.varint(layout.bases);
+    writer.varint(layout.lowercase.size());
+    size_t previous_end = 0;
+    for (const auto& [start, length] : layout.lowercase) {
+        writer.varint(start - previous_end);
+        writer.varint(length);
+        previous_end = start + length;
+    }
+    writer.varint(layout.literals.size());
+    previous_end = 0;
+    for (const TextRun& run : layout.literals) {
+        // Fill runs (N blocks) store one byte
+        writer.varint(run.position - previous_end);
+        writer.varint(run.length);
+        writer.string(run.bytes);
+        previous_end = run.position + run.length;
+    }
+    writer.varint(layout.wraps.size());
+    size_t previous_break = 0;
+    for (const LineWrap& wrap : layout.wraps) {
+        writer.varint(wrap.first - previous_break);
+        writer.varint(wrap.width);
+        writer.varint(wrap.count);
+        previous_break = wrap.first + (wrap.count - 1) * (wrap.width + 1);
+    }
+}
+
+NucleotideLayout read_layout(ByteReader& reader, uint64_t version) {
+    NucleotideLayout layout;
+    layout.text_size = reader.varint();
+    layout.bases = reader.varint();
+    layout.lowercase.resize(reader.count(reader.remaining() / 2));
+    size_t previous_end = 0;
+    for (auto& [start, length] : layout.lowercase) {
+        start = previous_end + reader.varint();
+        length = reader.varint();
+        previous_end = start + length;
+    }
+    // Gap, length and a byte string of at least one byte
+    layout.literals.resize(reader.count(reader.remaining() / 4));
+    previous_end = 0;
+    for (TextRun& run : layout.literals) {
+        run.position = previous_end + reader.varint();
+        run.length = reader.varint();
+        run.bytes = reader.string();
+        if (run.bytes.size() != run.length && run.bytes.size() != 1) {
+            throw std::runtime_error("Invalid CCC archive: malformed nucleotide literal run");
+        }
+        previous_end = run.position + run.length;
+    }
+    if (version >= 8) {
+        // unpack_nucleotide_text() checks the wraps against the text
+        layout.wraps.resize(reader.count(reader.remaining() / 3));
+        size_t previous_break = 0;
+        for (LineWrap& wrap : layout.wraps) {
+            wrap.first = previous_break + reader.varint();
+            wrap.width = reader.varint();
+            wrap.count = reader.varint();
+            if (wrap.count == 0) {
+                throw std::runtime_error("Invalid CCC archive: malformed nucleotide line wrap");
+            }
+            previous_break = wrap.first + (wrap.count - 1) * (wrap.width + 1);
+        }
+    }
+    return layout;
+}
+
+/**
+ * Check magic and version; returns the version
+ */
+uint64_t read_preamble(ByteReader& reader) {
+    if (std::memcmp(reader.take(sizeof(kArchiveMagic)), kArchiveMagic, sizeof(kArchiveMagic)) != 0) {
+        throw std::runtime_error("Not a CCC archive (bad magic)");
+    }
+    uint64_t version = reader.varint();
+    if (version == 0 || version > kArchiveVersion) {
+        throw std::runtime_error("Unsupported CCC archive version " + std::to_string(version));
+    }
+    return version;
+}
+
+} // namespace
+
+std::vector<uint8_t> serialize_archive(const std::vector<int>& codes, const CompressionMetadata& metadata) {
+    ByteWriter writer;
+    writer.raw(kArchiveMagic, sizeof(kArchiveMagic));
+    writer.varint(kArchiveVersion);
+
+    ByteWriter stats_writer;
+    write_stats(stats_writer, metadata.stats);
+    writer.varint(stats_writer.bytes().size());
+    writer.raw(stats_writer.bytes().data(), stats_writer.bytes().size());
+
+    const CoreMetadata& core = metadata.core;
+    writer.varint(core.dna_length);
+    writer.varint(core.original_size);
+    writer.varint(core.original_bits_length);
+    writer.varint(core.block_size);
+    writer.varint(core.max_dict_size);
+    writer.varint(core.seed_window);
+    writer.varint(core.lanes);
+    writer.varint(core.tandem_min_bases);
+    writer.varint(static_cast<uint8_t>(core.route));
+    if (core.route == CompressionRoute::Nucleotide) {
+        write_layout(writer, core.nucleotide);
+    }
+    writer.varint(core.filters.size());
+    for (const FilterStage& stage : core.filters) {
+        writer.varint(static_cast<uint8_t>(stage.kind));
+        writer.varint(stage.element_size);
+    }
+    writer.varint(core.approx_min_bases);
+    writer.varint(core.blocks.size());
+    for (const BlockMetadata& block : core.blocks) {
+        writer.varint(block.original_offset);
+        writer.varint(block.original_size);
+        writer.varint(block.code_offset);
+        writer.varint(block.code_count);
+        if (core.lanes > 1) {
+            for (size_t lane = 0; lane < core.lanes; ++lane) {
+                writer.varint(lane < block.lane_code_counts.size() ? block.lane_code_counts[lane] : 0);
+            }
+        }
+        if (core.tandem_min_bases > 0) {
+            writer.varint(block.tandem_repeats.size());
+            size_t previous_position = 0;
+            for (const TandemRepeat& repeat : block.tandem_repeats) {
+                writer.varint(repeat.position - previous_position);
+                writer.varint(static_cast<uint64_t>(repeat.unit) << 3 | repeat.period);
+                writer.varint(repeat.count);
+                previous_position = repeat.position;
+            }
+        }
+        if (core.approx_min_bases > 0) {
+            writer.varint(block.approximate_repeats.size());
+            size_t previous_position = 0;
+            for (const ApproximateRepeat& repeat : block.approximate_repeats) {
+                writer.varint(repeat.position - previous_position);
+                writer.varint(repeat.distance);
+                writer.varint(repeat.length);
+                writer.varint(repeat.edits.size());
+                size_t previous_offset = 0;
+                for (const RepeatEdit& edit : repeat.edits) {
+                    // Offsets ascend; the base rides in the low bits of the gap
+                    writer.varint(static_cast<uint64_t>(edit.offset - previous_offset) << 2 | edit.base);
+                    previous_offset = edit.offset;
+                }
+                previous_position = repeat.position;
+            }
+        }
+    }
+
+    const EncapsulationMetadata& encap = metadata.encapsulation;
+    const TransSplicingMetadata& ts = encap.trans_splicing;
+    writer.varint(encap.circular_length);
+    writer.varint(static_cast<uint32_t>(ts.sl_marker_code));
+    writer.varint(ts.chunk_size);
+    writer.varint(ts.original_length);
+    writer.varint(ts.original_compressed_length);
+    writer.varint(ts.marker_positions.size());
+    size_t previous = 0;
+    for (size_t position : ts.marker_positions) {
+        // Positions ascend, so deltas stay small
+        writer.varint(position - previous);
+        previous = position;
+    }
+    writer.string(ts.data_hash);
+    writer.f64(metadata.compression_ratio);
+
+    unsigned width = code_width(codes);
+    writer.varint(width);
+    writer.varint(codes.size());
+    pack_codes(codes.data(), codes.size(), width, writer.bytes());
+    return std::move(writer.bytes());
+}
+
+std::pair<std::vector<int>, CompressionMetadata> deserialize_archive(const uint8_t* data, size_t size) {
+    ByteReader reader(data, size);
+    uint64_t version = read_preamble(reader);
+
+    CompressionMetadata metadata;
+    if (version >= 2) {
+        size_t stats_size = reader.count(reader.remaining());
+        ByteReader stats_reader(reader.take(stats_size), stats_size);
+        metadata.stats = read_stats(stats_reader);
+    }
+    CoreMetadata& core = metadata.core;
+    core.dna_length = reader.varint();
+    core.original_size = reader.varint();
+    core.original_bits_length = reader.varint();
+    core.block_size = reader.varint();
+    core.max_dict_size = static_cast<uint32_t>(reader.count(kDvnpDictSizeLimit));
+    core.seed_window = reader.varint();
+    core.lanes = version >= 3 ? reader.count(kDvnpMaxLanes) : 1;
+    core.tandem_min_bases = version >= 4 ? reader.varint() : 0;
+    if (version >= 5) {
+        core.route = static_cast<CompressionRoute>(reader.count(static_cast<uint8_t>(CompressionRoute::Nucleotide)));
+        if (core.route == CompressionRoute::Nucleotide) {
+            core.nucleotide = read_layout(reader, version);
+        }
+    }
+    if (version >= 6) {
+        core.filters.resize(reader.count(reader.remaining() / 2));
+        for (FilterStage& stage : core.filters) {
+            stage.kind = static_cast<FilterKind>(reader.count(static_cast<uint8_t>(FilterKind::BitShuffle)));
+            stage.element_size = reader.varint();
+        }
+        try {
+            validate_filter_chain(core.filters);
+        } catch (const std::invalid_argument& e) {
+            throw std::runtime_error(std::string("Invalid CCC archive: ") + e.what());
+        }
+    }
+    core.approx_min_bases = version >= 7 ? reader.varint() : 0;
+    core.reset_count = metadata.stats.reset_count;
+    // Every block record takes at least four bytes, plus one per lane and one per repeat count
+    size_t record_bytes = 4 + (core.lanes > 1 ? core.lanes : 0) + (core.tandem_min_bases > 0 ? 1 : 0) +
+                          (core.approx_min_bases > 0 ? 1 : 0);
+    core.blocks.resize(reader.count(reader.remaining() / record_bytes));
+    for (BlockMetadata& block : core.blocks) {
+        block.original_offset = reader.varint();
+        block.original_size = reader.varint();
+        block.code_offset = reader.varint();
+        block.code_count = reader.varint();
+        if (core.lanes > 1) {
+            block.lane_code_counts.resize(core.lanes);
+            for (size_t& count : block.lane_code_counts) {
+                count = reader.varint();
+            }
+        }
+        if (core.tandem_min_bases > 0) {
+            // Three bytes at least per repeat
+            block.tandem_repeats.resize(reader.count(reader.remaining() / 3));
+            size_t position = 0;
+            for (TandemRepeat& repeat : block.tandem_repeats) {
+                position += reader.varint();
+                repeat.position = position;
+                uint64_t unit_period = reader.varint();
+                repeat.period = static_cast<uint32_t>(unit_period & 7);
+                repeat.unit = static_cast<uint32_t>(std::min<uint64_t>(unit_period >> 3, UINT32_MAX));
+                repeat.count = reader.varint();
+            }
+        }
+        if (core.approx_min_bases > 0) {
+            // Four bytes at least per copy, one per edit
+            block.approximate_repeats.resize(reader.count(reader.remaining() / 4));
+            size_t position = 0;
+            for (ApproximateRepeat& repeat : block.approximate_repeats) {
+                position += reader.varint();
+                repeat.position = position;
+                repeat.distance = reader.varint();
+                repeat.length = reader.varint();
+                repeat.edits.resize(reader.count(reader.remaining()));
+                size_t offset = 0;
+                for (RepeatEdit& edit : repeat.edits) {
+                    uint64_t gap_base = reader.varint();
+                    offset += gap_base >> 2;
+                    edit.offset = offset;
+                    edit.base = static_cast<uint8_t>(gap_base & 3);
+                }
+            }
+        }
+    }
+
+    EncapsulationMetadata& encap = metadata.encapsulation;
+    TransSplicingMetadata& ts = encap.trans_splicing;
+    encap.circular_length = reader.varint();
+    ts.sl_marker_code = static_cast<int>(reader.count(INT32_MAX));
+    ts.chunk_size = reader.varint();
+    ts.original_length = reader.varint();
+    ts.original_compressed_length = reader.varint();
+    ts.marker_positions.resize(reader.count(reader.remaining()));
+    size_t position = 0;
+    for (size_t& marker : ts.marker_positions) {
+        position += reader.varint();
+        marker = position;
+    }
+    ts.data_hash = reader.string();
+    metadata.compression_ratio = reader.f64();
+
+    unsigned width = static_cast<unsigned>(reader.count(32));
+    if (width == 0) {
+        throw std::runtime_error("Invalid CCC archive: zero code width");
+    }
+    size_t count = reader.count(UINT64_MAX / 32);
+    size_t packed_size = (count * width + 7) / 8;
+    const uint8_t* packed = reader.take(packed_size);   // bounds count before anything is allocated
+    std::vector<int> codes(count);
+    unpack_codes(packed, count, width, codes.data());
+    return {std::move(codes), std::move(metadata)};
+}
+
+namespace {
+
+void write_file_atomically(const std::string& path, const std::vector<uint8_t>& bytes) {
+    std::filesystem::path file_path(path);
+    if (file_path.has_parent_path()) {
+        std::error_code ec;
+        std::filesystem::create_directories(file_path.parent_path(), ec);
+    }
+
+    // Readers never observe a partially written archive; the random suffix keeps
+    // concurrent writers of the same path (e.g. shared cache entries) apart
+    std::string temp_path = path + ".tmp" + std::to_string(std::random_device()());
+    auto fail = [&](const std::string& message) {
+        std::error_code ec;
+        std::filesystem::remove(temp_path, ec);
+        throw std::runtime_error(message);
+    };
+#ifdef CCC_HAVE_FSYNC
+    // The bytes must be on disk before the rename makes them the archive
+    int fd = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot write CCC archive " + temp_path + ": " + std::strerror(errno));
+    }
+    size_t written = 0;
+    while (written < bytes.size()) {
+        ssize_t chunk = ::write(fd, bytes.data() + written, bytes.size() - written);
+        if (chunk < 0 && errno == EINTR) {
+            continue;
+        }
+        if (chunk <= 0) {
+            const std::string error = chunk < 0 ? std::strerror(errno) : "no progress";
+            ::close(fd);
+            fail("Failed writing CCC archive " + temp_path + ": " + error);
+        }
+        written += static_cast<size_t>(chunk);
+    }
+    if (::fsync(fd) != 0) {
+        const std::string error = std::strerror(errno);
+        ::close(fd);
+        fail("Failed syncing CCC archive " + temp_path + ": " + error);
+    }
+    if (::close(fd) != 0) {
+        fail("Failed closing CCC archive " + temp_path + ": " + std::strerror(errno));
+    }
+#else
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Cannot write CCC archive: " + temp_path);
+        }
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        file.close();
+        if (!file.good()) {
+            fail("Failed writing CCC archive: " + temp_path);
+        }
+    }
+#endif
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        throw std::runtime_error("Cannot install CCC archive " + path);
+    }
+}
+
+std::vector<uint8_t> read_file_range(std::ifstream& file, const std::string& path, uint64_t offset, uint64_t size) {
+    std::vector<uint8_t> bytes(static_cast<size_t>(size));
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(offset));
+    file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(size));
+    if (static_cast<uint64_t>(file.gcount()) != size) {
+        throw std::runtime_error("Invalid CCC archive: " + path + " is truncated");
+    }
+    return bytes;
+}
+
+void write_runs(ByteWriter& writer, const std::vector<BaseRun>& runs) {
+    writer.varint(runs.size());
+    size_t previous_end = 0;
+    for (const BaseRun& run : runs) {
+        // Runs are sorted and disjoint: store the gap from the previous run
+        writer.varint(run.start - previous_end);
+        writer.varint(run.length);
+        previous_end = run.start + run.length;
+    }
+}
+
+std::vector<BaseRun> read_runs(ByteReader& reader) {
+    std::vector<BaseRun> runs(reader.count(reader.remaining() / 2));
+    size_t previous_end = 0;
+    for (BaseRun& run : runs) {
+        run.start = previous_end + reader.varint();
+        run.length = reader.varint();
+        previous_end = run.start + run.length;
+    }
+    return runs;
+}
+
+std::vector<MemberIndexEntry> load_multi_index(std::ifstream& file, const std::string& path) {
+    // Magic, version and index length fit in the first 32 bytes
+    std::vector<uint8_t> prefix(32);
+    file.read(reinterpret_cast<char*>(prefix.data()), static_cast<std::streamsize>(prefix.size()));
+    prefix.resize(static_cast<size_t>(file.gcount()));
+
+    ByteReader reader(prefix.data(), prefix.size());
+    if (std::memcmp(reader.take(sizeof(kMultiArchiveMagic)), kMultiArchiveMagic, sizeof(kMultiArchiveMagic)) != 0) {
+        throw std::runtime_error("Not a multi-member CCC archive: " + path);
+    }
+    uint64_t version = reader.varint();
+    if (version < 1 || version > kMultiArchiveVersion) {
+        throw std::runtime_error("Unsupported multi-member CCC archive version " + std::to_string(version));
+    }
+    uint64_t index_size = reader.varint();
+    uint64_t index_offset = prefix.size() - reader.remaining();
+    std::vector<uint8_t> index_bytes = read_file_range(file, path, index_offset, index_size);
+
+    ByteReader index(index_bytes.data(), index_bytes.size());
+    std::vector<MemberIndexEntry> entries(index.count(index.remaining()));
+    uint64_t offset = index_offset + index_size;
+    if (version == 1) {
+        for (size_t i = 0; i < entries.size(); ++i) {
+            MemberIndexEntry& entry = entries[i];
+            entry.name = index.string();
+            entry.length = index.varint();
+            entry.n_blocks = read_runs(index);
+            entry.mask_blocks = read_runs(index);
+            entry.stream = i;
+            entry.size = index.varint();
+            entry.offset = offset;
+            offset += entry.size;
+        }
+        return entries;
+    }
+
+    for (MemberIndexEntry& entry : entries) {
+        entry.name = index.string();
+        entry.length = index.varint();
+        entry.n_blocks = read_runs(index);
+        entry.mask_blocks = read_runs(index);
+        entry.stream = index.varint();
+        entry.stream_offset = index.varint();
+    }
+    std::vector<uint64_t> stream_offsets(index.count(index.remaining()));
+    std::vector<uint64_t> stream_sizes(stream_offsets.size());
+    for (size_t s = 0; s < stream_offsets.size(); ++s) {
+        stream_sizes[s] = index.varint();
+        stream_offsets[s] = offset;
+        offset += stream_sizes[s];
+    }
+    for (MemberIndexEntry& entry : entries) {
+        if (entry.stream < stream_offsets.size()) {
+            entry.offset = stream_offsets[entry.stream];
+            entry.size = stream_sizes[entry.stream];
+        } else if (entry.length != 0) {
+            throw std::runtime_error("Invalid CCC archive: member " + entry.name + " refers to a missing stream");
+        }
+    }
+    return entries;
+}
+
+/**
+ * Write a version 2 multi-member archive
+ *
+ * @param placement Stream and stream byte offset of each member
+ * @param bodies serialize_archive() of each stream; released as they are copied
+ */
+void write_multi_file(const std::string& path, const std::vector<SequenceMember>& members,
+                      const std::vector<std::pair<size_t, uint64_t>>& placement,
+                      std::vector<std::vector<uint8_t>>& bodies) {
+    ByteWriter index;
+    index.varint(members.size());
+    for (size_t i = 0; i < members.size(); ++i) {
+        index.string(members[i].name);
+        index.varint(members[i].length);
+        write_runs(index, members[i].n_blocks);
+        write_runs(index, members[i].mask_blocks);
+        index.varint(placement[i].first);
+        index.varint(placement[i].second);
+    }
+    index.varint(bodies.size());
+    for (const std::vector<uint8_t>& body : bodies) {
+        index.varint(body.size());
+    }
+
+    ByteWriter writer;
+    writer.raw(kMultiArchiveMagic, sizeof(kMultiArchiveMagic));
+    writer.varint(kMultiArchiveVersion);
+    writer.varint(index.bytes().size());
+    writer.raw(index.bytes().data(), index.bytes().size());
+    for (std::vector<uint8_t>& body : bodies) {
+        writer.raw(body.data(), body.size());
+        std::vector<uint8_t>().swap(body);
+    }
+    write_file_atomically(path, writer.bytes());
+}
+
+/**
+ * Shared index of a striped archive
+ */
+struct StripedIndex {
+    uint64_t set_id = 0;                    // ties volumes to their index
+    std::vector<std::string> volume_paths;  // resolved against the index location
+    std::vector<uint64_t> volume_bytes;     // packed stripe bytes after the volume header
+    std::vector<uint64_t> volume_hashes;    // XXH64 of those bytes
+    unsigned width = 1;
+    size_t total_codes = 0;
+    std::vector<size_t> stripe_codes;       // stripe s lives on volume s % volumes
+    std::vector<uint8_t> body;              // serialize_archive() of the metadata, no codes
+};
+
+std::vector<uint8_t> read_whole_file(const std::string& path, const std::string& what) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot read " + what + ": " + path);
+    }
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+/**
+ * Cut the code stream into stripes of whole DVNP blocks
+ */
+std::vector<size_t> stripe_lengths(const std::vector<int>& codes, const CompressionMetadata& metadata) {
+    // Block boundaries are core code offsets; the stored stream has a marker before every chunk
+    const TransSplicingMetadata& ts = metadata.encapsulation.trans_splicing;
+    const bool marked = ts.sl_marker_code != 0 && ts.chunk_size > 0;
+    std::vector<size_t> cuts;
+    for (const BlockMetadata& block : metadata.core.blocks) {
+        size_t i = block.code_offset;
+        cuts.push_back(marked ? i + (i + ts.chunk_size - 1) / ts.chunk_size : i);
+    }
+    if (cuts.empty()) {
+        for (size_t cut = kStripeCodes; cut < codes.size(); cut += kStripeCodes) {
+            cuts.push_back(cut);
+        }
+    }
+
+    std::vector<size_t> lengths;
+    size_t start = 0;
+    for (size_t cut : cuts) {
+        if (cut >= codes.size()) {
+            break;
+        }
+        if (cut - start >= kStripeCodes) {
+            lengths.push_back(cut - start);
+            start = cut;
+        }
+    }
+    if (start < codes.size() || lengths.empty()) {
+        lengths.push_back(codes.size() - start);
+    }
+    return lengths;
+}
+
+StripedIndex load_striped_index(const std::string& path) {
+    std::vector<uint8_t> bytes = read_whole_file(path, "CCC archive");
+    ByteReader reader(bytes.data(), bytes.size());
+    if (reader.remaining() < sizeof(kStripedIndexMagic) ||
+        std::memcmp(reader.take(sizeof(kStripedIndexMagic)), kStripedIndexMagic, sizeof(kStripedIndexMagic)) != 0) {
+        throw std::runtime_error("Not a striped CCC archive: " + path);
+    }
+    uint64_t version = reader.varint();
+    if (version != kStripedArchiveVersion) {
+        throw std::runtime_error("Unsupported striped CCC archive version " + std::to_string(version));
+    }
+
+    StripedIndex index;
+    index.set_id = reader.varint();
+    size_t volumes = reader.count(reader.remaining() / 3);
+    if (volumes == 0) {
+        throw std::runtime_error("Invalid CCC archive: striped archive without volumes");
+    }
+    std::filesystem::path index_dir = std::filesystem::path(path).parent_path();
+    for (size_t v = 0; v < volumes; ++v) {
+        std::filesystem::path volume(reader.string());
+        index.volume_paths.push_back(volume.is_absolute() ? volume.string() : (index_dir / volume).string());
+        index.volume_bytes.push_back(reader.varint());
+        index.volume_hashes.push_back(reader.varint());
+    }
+    index.width = static_cast<unsigned>(reader.count(32));
+    if (index.width == 0) {
+        throw std::runtime_error("Invalid CCC archive: zero code width");
+    }
+    index.total_codes = reader.count(UINT64_MAX / 32);
+    index.stripe_codes.resize(reader.count(reader.remaining()));
+    size_t covered = 0;
+    for (size_t& count : index.stripe_codes) {
+        count = reader.count(index.total_codes - covered);
+        covered += count;
+    }
+    if (covered != index.total_codes) {
+        throw std::runtime_error("Invalid CCC archive: stripe table does not cover the code stream");
+    }
+    size_t body_size = reader.count(reader.remaining());
+    const uint8_t* body = reader.take(body_size);
+    index.body.assign(body, body + body_size);
+    return index;
+}
+
+} // namespace
+
+void write_archive(const std::string& path, const std::vector<int>& codes, const CompressionMetadata& metadata) {
+    write_file_atomically(path, serialize_archive(codes, metadata));
+}
+
+std::pair<std::vector<int>, CompressionMetadata> read_archive(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot read CCC archive: " + path);
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return deserialize_archive(bytes.data(), bytes.size());
+}
+
+bool is_archive(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(kArchiveMagic)] = {};
+    file.read(magic, sizeof(magic));
+    return file.gcount() == sizeof(magic) && std::memcmp(magic, kArchiveMagic, sizeof(magic)) == 0;
+}
+
+CompressionStats parse_archive_stats(const uint8_t* data, size_t size) {
+    ByteReader reader(data, size);
+    if (read_preamble(reader) < 2) {
+        throw std::runtime_error("CCC archive version 1 has no statistics section");
+    }
+    size_t stats_size = reader.count(reader.remaining());
+    ByteReader stats_reader(reader.take(stats_size), stats_size);
+    return read_stats(stats_reader);
+}
+
+CompressionStats read_archive_stats(const std::string& path) {
+    if (is_striped_archive(path)) {
+        StripedIndex index = load_striped_index(path);
+        return parse_archive_stats(index.body.data(), index.body.size());
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot read CCC archive: " + path);
+    }
+
+    // Magic, version and section length fit in the first 32 bytes
+    std::vector<uint8_t> header(32);
+    file.read(reinterpret_cast<char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    header.resize(static_cast<size_t>(file.gcount()));
+
+    ByteReader reader(header.data(), header.size());
+    if (read_preamble(reader) < 2) {
+        throw std::runtime_error("CCC archive version 1 has no statistics section");
+    }
+    uint64_t stats_size = reader.varint();
+    size_t section_end = header.size() - reader.remaining() + static_cast<size_t>(stats_size);
+    if (section_end > header.size()) {
+        size_t have = header.size();
+        header.resize(section_end);
+        file.read(reinterpret_cast<char*>(header.data() + have), static_cast<std::streamsize>(section_end - have));
+        header.resize(have + static_cast<size_t>(file.gcount()));
+    }
+    return parse_archive_stats(header.data(), header.size());
+}
+
+void write_multi_archive(const std::string& path, const std::vector<SequenceMember>& members) {
+    std::vector<std::vector<uint8_t>> bodies;
+    std::vector<std::pair<size_t, uint64_t>> placement;
+    bodies.reserve(members.size());
+    placement.reserve(members.size());
+    for (const SequenceMember& member : members) {
+        placement.emplace_back(bodies.size(), 0);
+        bodies.push_back(serialize_archive(member.codes, member.metadata));
+    }
+    write_multi_file(path, members, placement, bodies);
+}
+
+size_t write_solid_archive(const std::string& path, const std::vector<SequenceMember>& members,
+                           const std::vector<std::vector<uint8_t>>& packed,
+                           const CircularChromosomeCompressor& compressor, const SolidOptions& options,
+                           size_t num_threads) {
+    if (packed.size() != members.size()) {
+        throw std::invalid_argument("Solid archive needs the packed bases of every member");
+    }
+    std::vector<size_t> nonempty;
+    for (size_t i = 0; i < members.size(); ++i) {
+        if (packed[i].size() != (members[i].length + 3) / 4) {
+            throw std::invalid_argument("Packed bases of member " + members[i].name + " do not match its length");
+        }
+        if (members[i].length != 0) {
+            nonempty.push_back(i);
+        }
+    }
+
+    ThreadPool pool(std::max<size_t>(1, std::min(num_threads == 0 ? ThreadPool::default_thread_count() : num_threads,
+                                                 std::max<size_t>(nonempty.size(), 1))));
+    std::vector<MinHashSketch> sketches(nonempty.size());
+    std::vector<size_t> sizes(nonempty.size());
+    pool.parallel_for(nonempty.size(), [&](size_t i) {
+        const SequenceMember& member = members[nonempty[i]];
+        sketches[i] = minhash_sketch(packed[nonempty[i]].data(), member.length, options.kmer_length,
+                                     options.sketch_size);
+        sizes[i] = packed[nonempty[i]].size();
+    });
+    std::vector<std::vector<size_t>> groups = cluster_members(sketches, sizes, options);
+
+    // Empty members decode from no stream
+    std::vector<std::pair<size_t, uint64_t>> placement(members.size(), {0, 0});
+    for (size_t g = 0; g < groups.size(); ++g) {
+        uint64_t offset = 0;
+        for (size_t& member : groups[g]) {
+            member = nonempty[member];
+            placement[member] = {g, offset};
+            offset += packed[member].size();
+        }
+    }
+
+    std::vector<std::vector<uint8_t>> bodies(groups.size());
+    pool.parallel_for(groups.size(), [&](size_t g) {
+        std::vector<uint8_t> stream;
+        if (groups[g].size() == 1) {
+            stream = packed[groups[g].front()];
+        } else {
+            for (size_t member : groups[g]) {
+                stream.insert(stream.end(), packed[member].begin(), packed[member].end());
+            }
+        }
+
+        // Streams already run concurrently; keep each compression single-threaded
+        CircularChromosomeCompressor stream_compressor = compressor;
+        if (pool.size() > 1) {
+            stream_compressor.set_num_threads(1);
+        }
+        auto [codes, metadata] = stream_compressor.compress(stream);
+        bodies[g] = serialize_archive(codes, metadata);
+    });
+
+    write_multi_file(path, members, placement, bodies);
+    return groups.size();
+}
+
+std::vector<MemberIndexEntry> read_multi_archive_index(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot read CCC archive: " + path);
+    }
+    return load_multi_index(file, path);
+}
+
+SequenceMember read_multi_archive_member(const std::string& path, const MemberIndexEntry& entry) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot read CCC archive: " + path);
+    }
+    std::vector<uint8_t> body = read_file_range(file, path, entry.offset, entry.size);
+
+    SequenceMember member;
+    member.name = entry.name;
+    member.length = entry.length;
+    member.n_blocks = entry.n_blocks;
+    member.mask_blocks = entry.mask_blocks;
+    auto [codes, metadata] = deserialize_archive(body.data(), body.size());
+    member.codes = std::move(codes);
+    member.metadata = std::move(metadata);
+    return member;
+}
+
+SequenceMember read_multi_archive_member(const std::string& path, size_t index) {
+    std::vector<MemberIndexEntry> entries = read_multi_archive_index(path);
+    if (index >= entries.size()) {
+        throw std::out_of_range("Member " + std::to_string(index) + " out of range in " + path);
+    }
+    return read_multi_archive_member(path, entries[index]);
+}
+
+std::vector<uint8_t> extract_multi_archive_member(const std::string& path, const MemberIndexEntry& entry,
+                                                  size_t num_threads) {
+    const size_t bytes = (entry.length + 3) / 4;
+    if (bytes == 0) {
+        return {};
+    }
+    SequenceMember stream = read_multi_archive_member(path, entry);
+    CircularChromosomeCompressor decompressor(stream.metadata.encapsulation.trans_splicing.chunk_size, 4, true, false);
+    decompressor.set_num_threads(num_threads);
+    std::vector<uint8_t> decoded = decompressor.decompress(stream.codes, stream.metadata);
+    if (entry.stream_offset > decoded.size() || decoded.size() - entry.stream_offset < bytes) {
+        throw std::runtime_error("Member " + entry.name + " extends past its stream (" +
+                                 std::to_string(decoded.size()) + " bytes) in " + path);
+    }
+    if (entry.stream_offset == 0 && decoded.size() == bytes) {
+        return decoded;
+    }
+    auto first = decoded.begin() + static_cast<std::ptrdiff_t>(entry.stream_offset);
+    return std::vector<uint8_t>(first, first + static_cast<std::ptrdiff_t>(bytes));
+}
+
+void write_striped_archive(const std::string& index_path, const std::vector<std::string>& volume_paths,
+                           const std::vector<int>& codes, const CompressionMetadata& metadata,
+                           size_t num_threads) {
+    namespace fs = std::filesystem;
+    const size_t volumes = volume_paths.size();
+    if (volumes == 0) {
+        throw std::invalid_argument("A striped archive needs at least one volume");
+    }
+
+    // Relative volume paths are stored relative to the index, so the set can move as a whole
+    const fs::path index_file = fs::absolute(index_path).lexically_normal();
+    std::vector<std::string> stored(volumes);
+    std::vector<fs::path> seen{index_file};
+    for (size_t v = 0; v < volumes; ++v) {
+        fs::path volume = fs::absolute(volume_paths[v]).lexically_normal();
+        if (std::find(seen.begin(), seen.end(), volume) != seen.end()) {
+            throw std::invalid_argument("Duplicate striped archive volume: " + volume_paths[v]);
+        }
+        seen.push_back(volume);
+        fs::path relative = volume.lexically_relative(index_file.parent_path());
+        stored[v] = fs::path(volume_paths[v]).is_absolute() || relative.empty() ? volume.string() : relative.string();
+    }
+
+    const unsigned width = code_width(codes);
+    const std::vector<size_t> lengths = stripe_lengths(codes, metadata);
+    std::vector<size_t> offsets(lengths.size(), 0);
+    for (size_t s = 1; s < lengths.size(); ++s) {
+        offsets[s] = offsets[s - 1] + lengths[s - 1];
+    }
+    std::random_device random;
+    const uint64_t set_id = (static_cast<uint64_t>(random()) << 32) | random();
+
+    // Each volume is packed and written by its own worker, so the disks fill concurrently
+    std::vector<uint64_t> volume_bytes(volumes, 0);
+    std::vector<uint64_t> volume_hashes(volumes, 0);
+    ThreadPool pool(std::min(num_threads == 0 ? volumes : num_threads, volumes));
+    pool.parallel_for(volumes, [&](size_t v) {
+        ByteWriter writer;
+        writer.raw(kVolumeMagic, sizeof(kVolumeMagic));
+        writer.varint(kStripedArchiveVersion);
+        writer.varint(set_id);
+        writer.varint(v);
+        writer.varint(volumes);
+        const size_t header_size = writer.bytes().size();
+        for (size_t s = v; s < lengths.size(); s += volumes) {
+            pack_codes(codes.data() + offsets[s], lengths[s], width, writer.bytes());
+        }
+        volume_bytes[v] = writer.bytes().size() - header_size;
+        volume_hashes[v] = fast_hash64(writer.bytes().data() + header_size, volume_bytes[v]);
+        write_file_atomically(volume_paths[v], writer.bytes());
+    });
+
+    // The index goes last: a reader never finds an index whose volumes are incomplete
+    ByteWriter index;
+    index.raw(kStripedIndexMagic, sizeof(kStripedIndexMagic));
+    index.varint(kStripedArchiveVersion);
+    index.varint(set_id);
+    index.varint(volumes);
+    for (size_t v = 0; v < volumes; ++v) {
+        index.string(stored[v]);
+        index.varint(volume_bytes[v]);
+        index.varint(volume_hashes[v]);
+    }
+    index.varint(width);
+    index.varint(codes.size());
+    index.varint(lengths.size());
+    for (size_t length : lengths) {
+        index.varint(length);
+    }
+    std::vector<uint8_t> body = serialize_archive({}, metadata);
+    index.varint(body.size());
+    index.raw(body.data(), body.size());
+    write_file_atomically(index_path, index.bytes());
+}
+
+std::pair<std::vector<int>, CompressionMetadata> read_striped_archive(const std::string& index_path,
+                                                                      size_t num_threads) {
+    StripedIndex index = load_striped_index(index_path);
+    CompressionMetadata metadata = deserialize_archive(index.body.data(), index.body.size()).second;
+
+    const size_t volumes = index.volume_paths.size();
+    std::vector<size_t> offsets(index.stripe_codes.size(), 0);
+    for (size_t s = 1; s < offsets.size(); ++s) {
+        offsets[s] = offsets[s - 1] + index.stripe_codes[s - 1];
+    }
+    // Every volume must hold exactly its stripes' packed codes, so a hostile
+    // code count is rejected before the output is allocated
+    std::vector<size_t> expected_bytes(volumes, 0);
+    for (size_t s = 0; s < index.stripe_codes.size(); ++s) {
+        expected_bytes[s % volumes] += (index.stripe_codes[s] * index.width + 7) / 8;
+    }
+    for (size_t v = 0; v < volumes; ++v) {
+        if (expected_bytes[v] != index.volume_bytes[v]) {
+            throw std::runtime_error("Invalid CCC archive: volume " + index.volume_paths[v] + " is indexed with " +
+                                     std::to_string(index.volume_bytes[v]) + " bytes but its stripes need " +
+                                     std::to_string(expected_bytes[v]));
+        }
+    }
+
+    std::vector<int> codes(index.total_codes);
+    ThreadPool pool(std::min(num_threads == 0 ? volumes : num_threads, volumes));
+    pool.parallel_for(volumes, [&](size_t v) {
+        const std::string& path = index.volume_paths[v];
+        std::vector<uint8_t> bytes = read_whole_file(path, "CCC archive volume");
+        ByteReader reader(bytes.data(), bytes.size());
+        if (reader.remaining() < sizeof(kVolumeMagic) ||
+            std::memcmp(reader.take(sizeof(kVolumeMagic)), kVolumeMagic, sizeof(kVolumeMagic)) != 0) {
+            throw std::runtime_error("Not a CCC archive volume: " + path);
+        }
+        uint64_t version = reader.varint();
+        if (version != kStripedArchiveVersion) {
+            throw std::runtime_error("Unsupported CCC archive volume version " + std::to_string(version));
+        }
+        uint64_t set_id = reader.varint();
+        uint64_t position = reader.varint();
+        uint64_t count = reader.varint();
+        if (set_id != index.set_id || position != v || count != volumes) {
+            throw std::runtime_error("Volume " + path + " does not belong to striped archive " + index_path +
+                                     " at position " + std::to_string(v));
+        }
+        if (reader.remaining() != index.volume_bytes[v]) {
+            throw std::runtime_error("Invalid CCC archive: volume " + path + " has " +
+                                     std::to_string(reader.remaining()) + " data bytes, expected " +
+                                     std::to_string(index.volume_bytes[v]));
+        }
+        const uint8_t* data = bytes.data() + (bytes.size() - reader.remaining());
+        if (fast_hash64(data, reader.remaining()) != index.volume_hashes[v]) {
+            throw std::runtime_error("Invalid CCC archive: volume " + path + " is corrupt (hash mismatch)");
+        }
+        for (size_t s = v; s < index.stripe_codes.size(); s += volumes) {
+            size_t packed_size = (index.stripe_codes[s] * index.width + 7) / 8;
+            unpack_codes(reader.take(packed_size), index.stripe_codes[s], index.width, codes.data() + offsets[s]);
+        }
+    });
+    return {std::move(codes), std::move(metadata)};
+}
+
+std::vector<std::string> striped_archive_volumes(const std::string& index_path) {
+    return load_striped_index(index_path).volume_paths;
+}
+
+bool is_striped_archive(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(kStripedIndexMagic)] = {};
+    file.read(magic, sizeof(magic));
+    return file.gcount() == sizeof(magic) && std::memcmp(magic, kStripedIndexMagic, sizeof(magic)) == 0;
+}
+
+} // namespace ccc
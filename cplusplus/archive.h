@@ -0,0 +1,224 @@
+/**
+ * CCC Archive Format - C++ Implementation
+ *
+ * Binary container for a compressed code stream and its CompressionMetadata
+ * (.ccc files). Integers are LEB128 varints, doubles little-endian IEEE-754,
+ * and the codes are bit-packed at the width of the largest code.
+ *
+ * Layout: magic "CCCA", version, length-prefixed statistics section,
+ * metadata, codes. The statistics section comes first so inventory tools can
+ * read it without touching the rest of the file.
+ *
+ * Multi-member ("CCCM"), solid multi-member and striped multi-volume
+ * ("CCCS" + "CCCV") containers are built from the same pieces.
+ */
+
+#ifndef CCC_ARCHIVE_H
+#define CCC_ARCHIVE_H
+
+#include "circular_chromosome_compression.h"
+#include "member_clustering.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ccc {
+
+// Versions 1 (no statistics section), 2 (no lane counts), 3 (no tandem repeats), 4 (no input
+// route), 5 (no pre-filters), 6 (no approximate repeats) and 7 (no line wraps) remain readable
+constexpr uint32_t kArchiveVersion = 8;
+
+/**
+ * Serialize a compress() result
+ *
+ * @param codes Compressed code stream
+ * @param metadata Metadata returned with the codes
+ * @return Archive bytes
+ */
+std::vector<uint8_t> serialize_archive(const std::vector<int>& codes, const CompressionMetadata& metadata);
+
+/**
+ * Parse archive bytes produced by serialize_archive()
+ *
+ * @throws std::runtime_error if the data is truncated, corrupt or of an unknown version
+ */
+std::pair<std::vector<int>, CompressionMetadata> deserialize_archive(const uint8_t* data, size_t size);
+
+/**
+ * Write an archive file atomically (temporary file, then rename)
+ *
+ * @throws std::runtime_error if the file cannot be written
+ */
+void write_archive(const std::string& path, const std::vector<int>& codes, const CompressionMetadata& metadata);
+
+/**
+ * Read an archive file written by write_archive()
+ *
+ * @throws std::runtime_error if the file cannot be read or parsed
+ */
+std::pair<std::vector<int>, CompressionMetadata> read_archive(const std::string& path);
+
+/**
+ * Whether a file starts with the CCC archive magic
+ */
+bool is_archive(const std::string& path);
+
+/**
+ * Statistics recorded at compression time, parsed from the archive header only
+ *
+ * @param data Archive bytes; only the leading header needs to be present
+ * @param size Number of bytes available
+ * @throws std::runtime_error if the header is truncated or the archive predates statistics
+ */
+CompressionStats parse_archive_stats(const uint8_t* data, size_t size);
+
+/**
+ * Read the statistics of an archive file without reading its metadata or codes
+ * Striped archives are read from their index alone.
+ *
+ * @throws std::runtime_error if the file cannot be read or has no statistics section
+ */
+CompressionStats read_archive_stats(const std::string& path);
+
+/**
+ * Run of bases [start, start + length) within a sequence
+ */
+struct BaseRun {
+    size_t start = 0;
+    size_t length = 0;
+};
+
+/**
+ * One named sequence of a multi-member archive
+ * The compressed stream holds the bases 2-bit packed in binary_to_dna() order;
+ * N runs and soft-masked (lowercase) runs are kept alongside.
+ */
+struct SequenceMember {
+    std::string name;
+    size_t length = 0;                  // bases
+    std::vector<BaseRun> n_blocks;
+    std::vector<BaseRun> mask_blocks;
+    std::vector<int> codes;
+    CompressionMetadata metadata;
+};
+
+/**
+ * Everything about a member except its code stream, readable without decoding any member
+ */
+struct MemberIndexEntry {
+    std::string name;
+    size_t length = 0;
+    std::vector<BaseRun> n_blocks;
+    std::vector<BaseRun> mask_blocks;
+    size_t stream = 0;                  // code stream holding the member; shared in solid archives
+    uint64_t stream_offset = 0;         // byte offset of the member's packed bases in the decoded stream
+    uint64_t offset = 0;                // byte offset of the stream body in the file
+    uint64_t size = 0;                  // byte size of the stream body
+};
+
+/**
+ * Write a multi-member archive ("CCCM"): a member index followed by one
+ * serialize_archive() body per member, written atomically
+ *
+ * @throws std::runtime_error if the file cannot be written
+ */
+void write_multi_archive(const std::string& path, const std::vector<SequenceMember>& members);
+
+/**
+ * Compress members into a solid multi-member archive
+ * Members are grouped with cluster_members(); the packed bases of each group
+ * are concatenated, each member starting on a byte boundary, and compressed
+ * as one stream, so similar members share DVNP dictionary state. The index
+ * records each member's stream and offset; the file reads with the same
+ * functions as write_multi_archive() output.
+ *
+ * @param members Member names, lengths and runs; codes and metadata are ignored
+ * @param packed Packed bases of each member, (length + 3) / 4 bytes in binary_to_dna() order
+ * @param compressor Template whose settings every stream is compressed with
+ * @param num_threads Concurrent sketches and streams; 0 uses the hardware concurrency
+ * @return Number of code streams written
+ * @throws std::invalid_argument if packed does not match members
+ * @throws std::runtime_error if the file cannot be written
+ */
+size_t write_solid_archive(const std::string& path, const std::vector<SequenceMember>& members,
+                           const std::vector<std::vector<uint8_t>>& packed,
+                           const CircularChromosomeCompressor& compressor,
+                           const SolidOptions& options = SolidOptions(), size_t num_threads = 0);
+
+/**
+ * Read the member index of a multi-member archive
+ *
+ * @throws std::runtime_error if the file cannot be read or parsed
+ */
+std::vector<MemberIndexEntry> read_multi_archive_index(const std::string& path);
+
+/**
+ * Read one member, seeking directly to its stream body
+ * In a solid archive the codes decode to the member's whole stream, with
+ * the member's bases at entry.stream_offset; extract_multi_archive_member()
+ * returns the member alone.
+ *
+ * @param entry Entry from read_multi_archive_index() for the same file
+ * @throws std::runtime_error if the file cannot be read or parsed
+ */
+SequenceMember read_multi_archive_member(const std::string& path, const MemberIndexEntry& entry);
+
+/**
+ * Read one member by index position
+ *
+ * @throws std::out_of_range if there is no such member
+ */
+SequenceMember read_multi_archive_member(const std::string& path, size_t index);
+
+/**
+ * Decode one member's packed bases, reading and decoding only its stream
+ *
+ * @param entry Entry from read_multi_archive_index() for the same file
+ * @param num_threads Threads for the stream decode; 0 uses the compressor default
+ * @return (entry.length + 3) / 4 bytes in binary_to_dna() order
+ * @throws std::runtime_error if the file cannot be read or the stream is too short for the member
+ */
+std::vector<uint8_t> extract_multi_archive_member(const std::string& path, const MemberIndexEntry& entry,
+                                                  size_t num_threads = 0);
+
+/**
+ * Write an archive striped across several volume files, e.g. one per disk
+ * The code stream is cut at DVNP block boundaries into stripes that go
+ * round-robin to the volumes ("CCCV" files); index_path receives the shared
+ * index ("CCCS": metadata, stripe table, per-volume size and XXH64). Volumes
+ * are written concurrently, then the index, each atomically.
+ *
+ * @param volume_paths At least one path; relative paths are stored relative to the index
+ * @param num_threads Concurrent volume writers; 0 uses one per volume
+ * @throws std::invalid_argument if no volume or a duplicate volume is given
+ * @throws std::runtime_error if a file cannot be written
+ */
+void write_striped_archive(const std::string& index_path, const std::vector<std::string>& volume_paths,
+                           const std::vector<int>& codes, const CompressionMetadata& metadata,
+                           size_t num_threads = 0);
+
+/**
+ * Read a striped archive, reading all volumes concurrently
+ * The result decodes like read_archive(); decompress() then decodes its blocks in parallel.
+ *
+ * @param num_threads Concurrent volume readers; 0 uses one per volume
+ * @throws std::runtime_error if a volume is missing, truncated, corrupt or from another archive
+ */
+std::pair<std::vector<int>, CompressionMetadata> read_striped_archive(const std::string& index_path,
+                                                                      size_t num_threads = 0);
+
+/**
+ * Volume paths of a striped archive, resolved against the index location
+ *
+ * @throws std::runtime_error if the index cannot be read or parsed
+ */
+std::vector<std::string> striped_archive_volumes(const std::string& index_path);
+
+/**
+ * Whether a file starts with the striped archive index magic
+ */
+bool is_striped_archive(const std::string& path);
+
+} // namespace ccc
+
+#endif // CCC_ARCHIVE_H
@@ -0,0 +1,407 @@
+/**
+ * Asynchronous structured logging: per-thread rings and the writer thread
+ */
+
+#include "async_logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+namespace ccc {
+
+struct alignas(64) AsyncLogger::Record {
+    uint64_t timestamp_ns = 0;          // system clock, for wall-clock output
+    uint64_t bytes = 0;
+    uint64_t duration_ns = 0;
+    const char* stage = nullptr;
+    uint32_t thread = 0;
+    LogSeverity severity = LogSeverity::Debug;
+    bool truncated = false;
+    uint16_t length = 0;
+    char message[kLogMessageBytes];
+};
+
+/**
+ * Single-producer single-consumer ring: the owning thread advances head,
+ * the writer advances tail. Once its thread has exited and it is drained,
+ * a ring is handed to the next new thread, with head and tail carrying on.
+ */
+struct AsyncLogger::Ring {
+    Ring(size_t capacity, uint32_t thread_id) : records(capacity), mask(capacity - 1), thread(thread_id) {}
+
+    std::vector<Record> records;
+    const size_t mask;
+    uint32_t thread;                    // id of the thread currently owning the ring
+    alignas(64) std::atomic<uint64_t> head{0};
+    uint64_t cached_tail = 0;           // producer's last view of tail
+    alignas(64) std::atomic<uint64_t> tail{0};
+    std::atomic<bool> closed{false};    // producer thread has exited
+    std::atomic<bool> orphaned{false};  // logger has been destroyed
+};
+
+namespace {
+
+std::atomic<uint64_t> g_next_logger_id{1};
+
+/**
+ * Rings of the current thread, one per logger it has written to
+ */
+struct ThreadRings {
+    std::vector<std::pair<uint64_t, std::shared_ptr<AsyncLogger::Ring>>> rings;
+
+    ~ThreadRings() {
+        for (auto& entry : rings) {
+            entry.second->closed.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadRings t_rings;
+
+size_t round_up_pow2(size_t value) {
+    size_t result = 16;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+void append_timestamp(uint64_t timestamp_ns, std::string& out) {
+    std::time_t seconds = static_cast<std::time_t>(timestamp_ns / 1000000000ull);
+    std::tm utc{};
+    gmtime_r(&seconds, &utc);
+    char text[40];
+    int length = std::snprintf(text, sizeof(text), "%04d-%02d-%02dT%02d:%02d:%02d.%06uZ", utc.tm_year + 1900,
+                               utc.tm_mon + 1, utc.tm_mday, utc.tm_hour, utc.tm_min, utc.tm_sec,
+                               static_cast<unsigned>(timestamp_ns % 1000000000ull / 1000));
+    out.append(text, static_cast<size_t>(length));
+}
+
+void append_json_string(const char* text, size_t length, std::string& out) {
+    out += '"';
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char escape[8];
+            std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+            out += escape;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+    out += '"';
+}
+
+} // namespace
+
+const char* log_severity_name(LogSeverity severity) {
+    switch (severity) {
+        case LogSeverity::Debug: return "debug";
+        case LogSeverity::Info: return "info";
+        case LogSeverity::Warning: return "warning";
+        case LogSeverity::Error: return "error";
+    }
+    return "unknown";
+}
+
+AsyncLogger::AsyncLogger(std::ostream& sink, const LoggerOptions& options)
+    : sink_(sink), options_(options), id_(g_next_logger_id.fetch_add(1)),
+      ring_capacity_(round_up_pow2(options.ring_records)),
+      min_severity_(static_cast<uint8_t>(options.min_severity)) {
+    start();
+}
+
+AsyncLogger::AsyncLogger(const std::string& path, const LoggerOptions& options)
+    : file_(std::make_unique<std::ofstream>(path, std::ios::binary | std::ios::app)), sink_(*file_),
+      options_(options), id_(g_next_logger_id.fetch_add(1)), ring_capacity_(round_up_pow2(options.ring_records)),
+      min_severity_(static_cast<uint8_t>(options.min_severity)) {
+    if (!file_->is_open()) {
+        throw std::runtime_error("Cannot open log file " + path);
+    }
+    start();
+}
+
+AsyncLogger::~AsyncLogger() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    writer_.join();
+    // Threads that outlive the logger drop their ring on their next miss
+    for (auto& ring : rings_) {
+        ring->orphaned.store(true, std::memory_order_release);
+    }
+}
+
+void AsyncLogger::start() {
+    writer_ = std::thread([this]() { writer_loop(); });
+}
+
+AsyncLogger& AsyncLogger::standard() {
+    static AsyncLogger logger(std::cout);
+    return logger;
+}
+
+AsyncLogger::Ring& AsyncLogger::local_ring() {
+    auto& rings = t_rings.rings;
+    for (auto& entry : rings) {
+        if (entry.first == id_) {
+            return *entry.second;
+        }
+    }
+    // First record from this thread: register a ring (the only locked step)
+    rings.erase(std::remove_if(rings.begin(), rings.end(), [](const auto& entry) {
+        return entry.second->orphaned.load(std::memory_order_acquire);
+    }), rings.end());
+    std::shared_ptr<Ring> ring;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (spare_rings_.empty()) {
+            ring = std::make_shared<Ring>(ring_capacity_, next_thread_++);
+        } else {
+            ring = std::move(spare_rings_.back());
+            spare_rings_.pop_back();
+            ring->thread = next_thread_++;
+            ring->cached_tail = ring->tail.load(std::memory_order_relaxed);
+            ring->closed.store(false, std::memory_order_relaxed);
+        }
+        rings_.push_back(ring);
+    }
+    rings.emplace_back(id_, ring);
+    return *ring;
+}
+
+void AsyncLogger::log(LogSeverity severity, const char* stage, std::string_view message,
+                      uint64_t bytes, uint64_t duration_ns) {
+    if (!enabled(severity)) {
+        return;
+    }
+    Ring& ring = local_ring();
+    const uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.cached_tail > ring.mask) {
+        ring.cached_tail = ring.tail.load(std::memory_order_acquire);
+        while (head - ring.cached_tail > ring.mask) {
+            if (options_.drop_when_full) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            // The writer cannot be parked while this ring holds records, but may be in its batching delay
+            wake_.notify_one();
+            std::this_thread::yield();
+            ring.cached_tail = ring.tail.load(std::memory_order_acquire);
+        }
+    }
+
+    Record& record = ring.records[head & ring.mask];
+    record.timestamp_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    record.bytes = bytes;
+    record.duration_ns = duration_ns;
+    record.stage = stage;
+    record.thread = ring.thread;
+    record.severity = severity;
+    record.truncated = message.size() > kLogMessageBytes;
+    record.length = static_cast<uint16_t>(std::min(message.size(), kLogMessageBytes));
+    std::memcpy(record.message, message.data(), record.length);
+    if (record.truncated) {
+        truncated_.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Sequentially consistent like the writer's park: either it sees this record or this sees it parked
+    ring.head.store(head + 1, std::memory_order_seq_cst);
+    if (writer_parked_.load(std::memory_order_seq_cst)) {
+        wake_writer();
+    } else if (((head + 1) & (ring.mask >> 1)) == 0) {
+        // A half-full ring ends the writer's batching delay early
+        wake_.notify_one();
+    }
+}
+
+void AsyncLogger::wake_writer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writer_parked_.store(false, std::memory_order_relaxed);
+    }
+    wake_.notify_one();
+}
+
+void AsyncLogger::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const uint64_t target = ++flush_requests_;
+    wake_.notify_one();
+    flushed_cv_.wait(lock, [&]() { return flushes_done_ >= target; });
+}
+
+LoggerCounters AsyncLogger::counters() const {
+    LoggerCounters counters;
+    counters.written = written_.load(std::memory_order_relaxed);
+    counters.dropped = dropped_.load(std::memory_order_relaxed);
+    counters.truncated = truncated_.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters.threads = rings_.size();
+    counters.spare_rings = spare_rings_.size();
+    return counters;
+}
+
+size_t AsyncLogger::drain() {
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rings = rings_;
+    }
+
+    bool prune = false;
+    for (const auto& ring : rings) {
+        // Read closed before head: a closed ring that is empty afterwards stays empty
+        const bool closed = ring->closed.load(std::memory_order_acquire);
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+        const uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        for (uint64_t i = tail; i < head; ++i) {
+            batch_.push_back(ring->records[i & ring->mask]);
+        }
+        ring->tail.store(head, std::memory_order_release);
+        prune = prune || closed;
+    }
+    if (prune) {
+        // Drained rings of exited threads are kept for reuse rather than freed and reallocated
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto retired = std::stable_partition(rings_.begin(), rings_.end(), [](const std::shared_ptr<Ring>& ring) {
+            return !ring->closed.load(std::memory_order_acquire) ||
+                   ring->head.load(std::memory_order_acquire) != ring->tail.load(std::memory_order_relaxed);
+        });
+        std::move(retired, rings_.end(), std::back_inserter(spare_rings_));
+        rings_.erase(retired, rings_.end());
+    }
+
+    const size_t count = batch_.size();
+    if (count == 0) {
+        return 0;
+    }
+    // Each ring is already in order; merge threads by time
+    std::stable_sort(batch_.begin(), batch_.end(), [](const Record& a, const Record& b) {
+        return a.timestamp_ns < b.timestamp_ns;
+    });
+    buffer_.clear();
+    for (const Record& record : batch_) {
+        format_record(record, buffer_);
+    }
+    batch_.clear();
+    sink_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    sink_.flush();
+    written_.fetch_add(count, std::memory_order_relaxed);
+    return count;
+}
+
+void AsyncLogger::format_record(const Record& record, std::string& out) const {
+    const char* stage = record.stage ? record.stage : "";
+    if (options_.format == LogFormat::Json) {
+        out += "{\"time\":\"";
+        append_timestamp(record.timestamp_ns, out);
+        out += "\",\"severity\":\"";
+        out += log_severity_name(record.severity);
+        out += "\",\"thread\":";
+        out += std::to_string(record.thread);
+        out += ",\"stage\":";
+        append_json_string(stage, std::strlen(stage), out);
+        if (record.bytes) {
+            out += ",\"bytes\":";
+            out += std::to_string(record.bytes);
+        }
+        if (record.duration_ns) {
+            out += ",\"duration_ns\":";
+            out += std::to_string(record.duration_ns);
+        }
+        out += ",\"message\":";
+        append_json_string(record.message, record.length, out);
+        if (record.truncated) {
+            out += ",\"truncated\":true";
+        }
+        out += "}\n";
+        return;
+    }
+
+    static const char* const kSeverityLabels[] = {"DEBUG", "INFO ", "WARN ", "ERROR"};
+    out += "[CCC] ";
+    append_timestamp(record.timestamp_ns, out);
+    out += ' ';
+    out += kSeverityLabels[static_cast<uint8_t>(record.severity) & 3];
+    out += " [";
+    out += stage;
+    out += "] ";
+    if (record.bytes) {
+        out += "bytes=" + std::to_string(record.bytes) + ' ';
+    }
+    if (record.duration_ns) {
+        char duration[32];
+        std::snprintf(duration, sizeof(duration), "duration_us=%.1f ", record.duration_ns / 1000.0);
+        out += duration;
+    }
+    out += "tid=" + std::to_string(record.thread) + ' ';
+    out.append(record.message, record.length);
+    if (record.truncated) {
+        out += "...";
+    }
+    out += '\n';
+}
+
+void AsyncLogger::writer_loop() {
+    for (;;) {
+        uint64_t requests;
+        bool stopping;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            requests = flush_requests_;
+            stopping = stop_;
+        }
+        // Everything queued before the flush request was read is written by this drain
+        const size_t written = drain();
+        if (requests > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (requests > flushes_done_) {
+                flushes_done_ = requests;
+                flushed_cv_.notify_all();
+            }
+        }
+        if (written > 0) {
+            continue;
+        }
+        if (stopping) {
+            break;
+        }
+        // Park until a record, flush or stop arrives; no timed polling while idle
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stop_ || flush_requests_ != flushes_done_) {
+            continue;
+        }
+        writer_parked_.store(true, std::memory_order_seq_cst);
+        if (rings_empty()) {
+            wake_.wait(lock, [this]() {
+                return !writer_parked_.load(std::memory_order_relaxed) || stop_ || flush_requests_ != flushes_done_;
+            });
+            // Woken by a record: let more arrive so one write covers many (a flush or stop cuts this short)
+            if (!stop_ && flush_requests_ == flushes_done_) {
+                wake_.wait_for(lock, std::chrono::microseconds(options_.batch_delay_us));
+            }
+        }
+        writer_parked_.store(false, std::memory_order_relaxed);
+    }
+}
+
+bool AsyncLogger::rings_empty() {
+    for (const auto& ring : rings_) {
+        if (ring->head.load(std::memory_order_seq_cst) != ring->tail.load(std::memory_order_relaxed)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace ccc
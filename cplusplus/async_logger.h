@@ -0,0 +1,163 @@
+/**
+ * Asynchronous Structured Logging - C++ Implementation
+ *
+ * Verbose logging without the stream lock on the calling thread: each thread
+ * appends fixed-size records to its own single-producer ring, and one
+ * background writer drains all rings, orders the batch by timestamp and
+ * writes it with a single stream write. Records carry structured fields
+ * (severity, stage, bytes, duration) and are written as text lines or
+ * JSON lines.
+ *
+ * A call below the severity threshold returns after one atomic load; an
+ * enabled call copies the message into the ring without locks or
+ * allocations. The writer blocks while every ring is empty and is woken by
+ * the next record. The rings of exited threads are reused by new ones, so
+ * short-lived thread pools do not keep allocating rings.
+ */
+
+#ifndef CCC_ASYNC_LOGGER_H
+#define CCC_ASYNC_LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace ccc {
+
+enum class LogSeverity : uint8_t {
+    Debug = 0,
+    Info = 1,
+    Warning = 2,
+    Error = 3
+};
+
+/**
+ * Severity name used in log lines ("debug", "info", "warning", "error")
+ */
+const char* log_severity_name(LogSeverity severity);
+
+enum class LogFormat {
+    Text,                               // 2026-01-02T03:04:05.123456Z INFO  [stage] bytes=.. duration_us=.. tid=.. message
+    Json                                // one JSON object per line
+};
+
+struct LoggerOptions {
+    LogSeverity min_severity = LogSeverity::Debug;
+    LogFormat format = LogFormat::Text;
+    size_t ring_records = 4096;         // per thread, rounded up to a power of two
+    bool drop_when_full = false;        // false: a full ring waits for the writer, so no record is lost
+    uint32_t batch_delay_us = 1000;     // writer wait after being woken, to gather a batch; none while idle
+};
+
+struct LoggerCounters {
+    uint64_t written = 0;               // records written to the sink
+    uint64_t dropped = 0;               // records lost to full rings (drop_when_full only)
+    uint64_t truncated = 0;             // messages cut to kLogMessageBytes
+    size_t threads = 0;                 // producer rings currently registered
+    size_t spare_rings = 0;             // rings of exited threads, kept for the next new thread
+};
+
+// Message bytes kept per record; longer messages are truncated
+constexpr size_t kLogMessageBytes = 208;
+
+class AsyncLogger {
+public:
+    /**
+     * Log to a stream owned by the caller, which must outlive the logger
+     */
+    explicit AsyncLogger(std::ostream& sink, const LoggerOptions& options = LoggerOptions());
+
+    /**
+     * Log to a file, appending
+     *
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    explicit AsyncLogger(const std::string& path, const LoggerOptions& options = LoggerOptions());
+
+    /**
+     * Writes every pending record, then stops the writer thread
+     */
+    ~AsyncLogger();
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    /**
+     * Process-wide logger on std::cout, used by verbose compressors without their own logger
+     */
+    static AsyncLogger& standard();
+
+    bool enabled(LogSeverity severity) const {
+        return static_cast<uint8_t>(severity) >= min_severity_.load(std::memory_order_relaxed);
+    }
+    void set_min_severity(LogSeverity severity) {
+        min_severity_.store(static_cast<uint8_t>(severity), std::memory_order_relaxed);
+    }
+
+    /**
+     * Queue one record from the calling thread
+     *
+     * @param stage Pipeline stage; must be a string with static storage (a literal)
+     * @param bytes Bytes processed by the stage, 0 if not applicable
+     * @param duration_ns Stage duration, 0 if not applicable
+     */
+    void log(LogSeverity severity, const char* stage, std::string_view message,
+             uint64_t bytes = 0, uint64_t duration_ns = 0);
+
+    /**
+     * Block until every record queued before the call has reached the sink
+     */
+    void flush();
+
+    LoggerCounters counters() const;
+
+    // Defined in async_logger.cpp
+    struct Record;
+    struct Ring;
+
+private:
+    void start();
+    Ring& local_ring();
+    size_t drain();
+    void writer_loop();
+    bool rings_empty();                 // caller holds mutex_
+    void wake_writer();
+    void format_record(const Record& record, std::string& out) const;
+
+    std::unique_ptr<std::ofstream> file_;
+    std::ostream& sink_;
+    const LoggerOptions options_;
+    const uint64_t id_;
+    size_t ring_capacity_;
+    std::atomic<uint8_t> min_severity_;
+
+    mutable std::mutex mutex_;          // guards rings_ and the flush handshake
+    std::condition_variable wake_;
+    std::condition_variable flushed_cv_;
+    std::vector<std::shared_ptr<Ring>> rings_;
+    std::vector<std::shared_ptr<Ring>> spare_rings_;  // drained rings of exited threads
+    uint32_t next_thread_ = 1;
+    uint64_t flush_requests_ = 0;
+    uint64_t flushes_done_ = 0;
+    bool stop_ = false;
+    std::atomic<bool> writer_parked_{false};  // set under mutex_ while the writer blocks on an empty queue
+
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> truncated_{0};
+    std::vector<Record> batch_;         // writer thread only
+    std::string buffer_;                // writer thread only
+    std::thread writer_;
+};
+
+} // namespace ccc
+
+#endif // CCC_ASYNC_LOGGER_H
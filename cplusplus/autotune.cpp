@@ -0,0 +1,434 @@
+/**
+ * Startup Autotuner with Cached Machine Profile - C++ Implementation
+ */
+
+#include "autotune.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace ccc {
+
+namespace {
+
+constexpr int kProfileVersion = 1;
+
+double level_ratio_tolerance(int level) {
+    switch (level) {
+        case 1: return std::numeric_limits<double>::infinity();
+        case 2: return 0.05;
+        default: return 0.01;
+    }
+}
+
+size_t bits_for_value(uint32_t value) {
+    size_t bits = 1;
+    while (bits < 32 && (value >> bits) != 0) {
+        ++bits;
+    }
+    return bits;
+}
+
+/**
+ * Calibration corpus: text, genome-like ASCII, structured binary and noise
+ */
+std::vector<uint8_t> create_calibration_sample(size_t size) {
+    std::vector<uint8_t> data;
+    data.reserve(size);
+    std::mt19937 rng(20240611u);
+    const size_t quarter = size / 4;
+
+    const std::string words[] = {"circular ", "chromosome ", "compression ", "dinoflagellate ",
+                                 "nucleotide ", "sequence ", "block ", "the ", "of ", "and "};
+    while (data.size() < quarter) {
+        const std::string& word = words[rng() % 10];
+        data.insert(data.end(), word.begin(), word.end());
+    }
+    data.resize(quarter);
+
+    const char bases[] = {'A', 'C', 'G', 'T'};
+    while (data.size() < 2 * quarter) {
+        if (data.size() > quarter + 4096 && rng() % 3 == 0) {
+            // Copy an earlier segment with point mutations, like a repeat family
+            size_t length = 200 + rng() % 1800;
+            size_t source = quarter + rng() % (data.size() - quarter - length);
+            for (size_t i = 0; i < length && data.size() < 2 * quarter; ++i) {
+                data.push_back(rng() % 50 == 0 ? bases[rng() % 4] : data[source + i]);
+            }
+        } else {
+            for (size_t i = 0; i < 500 && data.size() < 2 * quarter; ++i) {
+                data.push_back(bases[rng() % 4]);
+            }
+        }
+    }
+
+    for (uint32_t counter = 0; data.size() < 3 * quarter; counter += 1 + rng() % 3) {
+        for (size_t b = 0; b < 4 && data.size() < 3 * quarter; ++b) {
+            data.push_back(static_cast<uint8_t>(counter >> (8 * b)));
+        }
+    }
+
+    while (data.size() < size) {
+        data.push_back(static_cast<uint8_t>(rng()));
+    }
+    return data;
+}
+
+double elapsed_seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string current_timestamp() {
+    std::time_t now = std::time(nullptr);
+    std::ostringstream oss;
+    oss << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S");
+    return oss.str();
+}
+
+} // namespace
+
+TunedConfig MachineProfile::config_for(int level) const {
+    if (levels.empty()) {
+        return TunedConfig();
+    }
+    auto best = levels.begin();
+    for (auto it = levels.begin(); it != levels.end(); ++it) {
+        if (std::abs(it->first - level) < std::abs(best->first - level)) {
+            best = it;
+        }
+    }
+    return best->second;
+}
+
+void MachineProfile::save(const std::string& path) const {
+    std::filesystem::path file_path(path);
+    if (file_path.has_parent_path()) {
+        std::error_code ec;
+        std::filesystem::create_directories(file_path.parent_path(), ec);
+    }
+
+    // Write to a temporary file and rename so concurrent readers never see a partial profile
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Cannot write machine profile: " + temp_path);
+        }
+        file << "# CCC machine profile (generated by Autotuner)\n";
+        file << "version=" << kProfileVersion << "\n";
+        file << "created=" << created << "\n";
+        file << "hardware_threads=" << hardware_threads << "\n";
+        for (const auto& [level, config] : levels) {
+            std::string prefix = "level." + std::to_string(level) + ".";
+            file << prefix << "block_size=" << config.block_size << "\n";
+            file << prefix << "num_threads=" << config.num_threads << "\n";
+            file << prefix << "max_dict_size=" << config.max_dict_size << "\n";
+            file << prefix << "symbol_kernel=" << symbol_kernel_name(config.symbol_kernel) << "\n";
+            file << prefix << "throughput_mb_s=" << std::fixed << std::setprecision(3)
+                 << config.throughput_mb_s << "\n";
+            file << prefix << "compressed_ratio=" << std::fixed << std::setprecision(6)
+                 << config.compressed_ratio << "\n";
+        }
+        // Buffered lines only reach the file on close, so its result decides success
+        file.close();
+        if (!file.good()) {
+            std::error_code ec;
+            std::filesystem::remove(temp_path, ec);
+            throw std::runtime_error("Failed writing machine profile: " + temp_path);
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        const std::string error = ec.message();
+        std::filesystem::remove(temp_path, ec);
+        throw std::runtime_error("Cannot install machine profile " + path + ": " + error);
+    }
+}
+
+MachineProfile MachineProfile::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot read machine profile: " + path);
+    }
+
+    MachineProfile profile;
+    int version = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            throw std::runtime_error("Malformed machine profile line: " + line);
+        }
+        std::string key = line.substr(0, eq);
+        std::string value = line.substr(eq + 1);
+
+        try {
+            if (key == "version") {
+                version = std::stoi(value);
+            } else if (key == "created") {
+                profile.created = value;
+            } else if (key == "hardware_threads") {
+                profile.hardware_threads = std::stoul(value);
+            } else if (key.compare(0, 6, "level.") == 0) {
+                size_t dot = key.find('.', 6);
+                if (dot == std::string::npos) {
+                    throw std::runtime_error("Malformed machine profile key: " + key);
+                }
+                TunedConfig& config = profile.levels[std::stoi(key.substr(6, dot - 6))];
+                std::string field = key.substr(dot + 1);
+                if (field == "block_size") {
+                    config.block_size = std::stoull(value);
+                } else if (field == "num_threads") {
+                    config.num_threads = std::stoull(value);
+                } else if (field == "max_dict_size") {
+                    // Out of range values become 0 and are rejected below
+                    unsigned long max_dict_size = std::stoul(value);
+                    config.max_dict_size =
+                        max_dict_size > kDvnpDictSizeLimit ? 0 : static_cast<uint32_t>(max_dict_size);
+                } else if (field == "symbol_kernel") {
+                    config.symbol_kernel = parse_symbol_kernel(value);
+                } else if (field == "throughput_mb_s") {
+                    config.throughput_mb_s = std::stod(value);
+                } else if (field == "compressed_ratio") {
+                    config.compressed_ratio = std::stod(value);
+                }
+            }
+        } catch (const std::logic_error&) {
+            throw std::runtime_error("Invalid value in machine profile line: " + line);
+        }
+    }
+
+    if (version != kProfileVersion) {
+        throw std::runtime_error("Unsupported machine profile version " + std::to_string(version) +
+                                 " in " + path);
+    }
+    // A level the compressor would reject makes the whole profile stale
+    for (const auto& [level, config] : profile.levels) {
+        if (config.max_dict_size < 16 || config.max_dict_size > kDvnpDictSizeLimit) {
+            throw std::runtime_error("Machine profile " + path + " level " + std::to_string(level) +
+                                     " has an out-of-range dictionary size");
+        }
+    }
+    return profile;
+}
+
+std::string MachineProfile::default_path() {
+    if (const char* explicit_path = std::getenv("CCC_PROFILE")) {
+        return explicit_path;
+    }
+    if (const char* cache_home = std::getenv("XDG_CACHE_HOME")) {
+        return std::string(cache_home) + "/ccc/machine_profile";
+    }
+    if (const char* home = std::getenv("HOME")) {
+        return std::string(home) + "/.cache/ccc/machine_profile";
+    }
+    return "ccc_machine_profile";
+}
+
+Autotuner::Autotuner(AutotuneOptions options) : options_(std::move(options)) {
+    if (options_.sample.empty()) {
+        options_.sample = create_calibration_sample(options_.sample_size);
+    }
+    if (options_.block_sizes.empty()) {
+        options_.block_sizes = {262144, 1048576, 4194304};
+    }
+    if (options_.dict_sizes.empty()) {
+        options_.dict_sizes = {4096, 16384, kDvnpMaxDictSize};
+    }
+    if (options_.thread_counts.empty()) {
+        size_t hardware = ThreadPool::default_thread_count();
+        for (size_t threads = 1; threads < hardware; threads *= 2) {
+            options_.thread_counts.push_back(threads);
+        }
+        options_.thread_counts.push_back(hardware);
+    }
+}
+
+void Autotuner::log(const std::string& message) {
+    if (options_.verbose) {
+        std::cout << "[CCC Autotune] " << message << std::endl;
+    }
+}
+
+SymbolKernel Autotuner::tune_symbol_kernel() {
+    const auto& sample = options_.sample;
+    std::vector<uint8_t> symbols(sample.size() * 4);
+
+    SymbolKernel best = SymbolKernel::Scalar;
+    double best_seconds = std::numeric_limits<double>::infinity();
+    for (SymbolKernel kernel : {SymbolKernel::Scalar, SymbolKernel::SSSE3}) {
+        if (!symbol_kernel_supported(kernel)) {
+            continue;
+        }
+        bytes_to_symbols(sample.data(), sample.size(), symbols.data(), kernel);  // warm-up
+        auto start = std::chrono::steady_clock::now();
+        for (int rep = 0; rep < 3; ++rep) {
+            bytes_to_symbols(sample.data(), sample.size(), symbols.data(), kernel);
+        }
+        double seconds = elapsed_seconds(start);
+        log(std::string("Kernel ") + symbol_kernel_name(kernel) + ": " + std::to_string(seconds) + " s");
+        if (seconds < best_seconds) {
+            best_seconds = seconds;
+            best = kernel;
+        }
+    }
+    return best;
+}
+
+Autotuner::Measurement Autotuner::measure_codec(size_t block_size, uint32_t max_dict_size, SymbolKernel kernel) {
+    const auto& sample = options_.sample;
+    Measurement measurement;
+    measurement.block_size = block_size;
+    measurement.max_dict_size = max_dict_size;
+
+    DvnpEncoder encoder(max_dict_size);
+    DvnpDecoder decoder(max_dict_size);
+    std::vector<uint8_t> symbols(std::min(block_size, sample.size()) * 4);
+    std::vector<uint8_t> decoded(std::min(block_size, sample.size()));
+    std::vector<int> codes;
+    size_t total_codes = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t offset = 0; offset < sample.size(); offset += block_size) {
+        size_t size = std::min(block_size, sample.size() - offset);
+        codes.clear();
+        bytes_to_symbols(sample.data() + offset, size, symbols.data(), kernel);
+        encoder.encode(symbols.data(), size * 4, codes);
+        std::fill(decoded.begin(), decoded.begin() + size, 0);
+        decoder.decode(codes.data(), codes.size(), decoded.data(), size * 4);
+        if (std::memcmp(decoded.data(), sample.data() + offset, size) != 0) {
+            throw std::logic_error("Autotune calibration round trip mismatch");
+        }
+        total_codes += codes.size();
+    }
+    measurement.seconds = elapsed_seconds(start);
+
+    // Codes (including the reset marker) are packed at a fixed width per dictionary size
+    double packed_bytes = total_codes * static_cast<double>(bits_for_value(max_dict_size)) / 8.0;
+    measurement.compressed_ratio = sample.empty() ? 0.0 : packed_bytes / sample.size();
+    return measurement;
+}
+
+double Autotuner::measure_parallel(const TunedConfig& config, size_t num_threads) {
+    const auto& sample = options_.sample;
+    const size_t num_blocks = (sample.size() + config.block_size - 1) / config.block_size;
+    ThreadPool pool(num_threads);
+
+    auto start = std::chrono::steady_clock::now();
+    pool.parallel_for(num_blocks, [&](size_t b) {
+        size_t offset = b * config.block_size;
+        size_t size = std::min(config.block_size, sample.size() - offset);
+        std::vector<uint8_t> symbols(size * 4);
+        std::vector<uint8_t> decoded(size, 0);
+        std::vector<int> codes;
+        bytes_to_symbols(sample.data() + offset, size, symbols.data(), config.symbol_kernel);
+        DvnpEncoder encoder(config.max_dict_size);
+        encoder.encode(symbols.data(), symbols.size(), codes);
+        DvnpDecoder decoder(config.max_dict_size);
+        decoder.decode(codes.data(), codes.size(), decoded.data(), size * 4);
+    });
+    return elapsed_seconds(start);
+}
+
+MachineProfile Autotuner::run() {
+    MachineProfile profile;
+    profile.hardware_threads = ThreadPool::default_thread_count();
+    profile.created = current_timestamp();
+
+    log("Calibrating on " + std::to_string(options_.sample.size()) + " bytes");
+
+    // Stage 1: symbol expansion kernel (independent of the other knobs)
+    SymbolKernel kernel = tune_symbol_kernel();
+
+    // Stage 2: single-thread DVNP cost and ratio per block/dictionary size
+    std::vector<Measurement> measurements;
+    double best_ratio = std::numeric_limits<double>::infinity();
+    for (size_t block_size : options_.block_sizes) {
+        for (uint32_t dict_size : options_.dict_sizes) {
+            Measurement m = measure_codec(block_size, dict_size, kernel);
+            log("block=" + std::to_string(block_size) + " dict=" + std::to_string(dict_size) +
+                ": " + std::to_string(m.seconds) + " s, ratio " + std::to_string(m.compressed_ratio));
+            best_ratio = std::min(best_ratio, m.compressed_ratio);
+            measurements.push_back(m);
+        }
+    }
+    if (measurements.empty()) {
+        return profile;
+    }
+
+    // Stage 3: per level, fastest candidate within the ratio budget, then thread scaling
+    const double sample_mb = options_.sample.size() / 1048576.0;
+    for (int level = kMinCompressionLevel; level <= kMaxCompressionLevel; ++level) {
+        const double ratio_limit = best_ratio * (1.0 + level_ratio_tolerance(level));
+        const Measurement* chosen = nullptr;
+        for (const auto& m : measurements) {
+            if (m.compressed_ratio <= ratio_limit && (!chosen || m.seconds < chosen->seconds)) {
+                chosen = &m;
+            }
+        }
+
+        TunedConfig config;
+        config.block_size = chosen->block_size;
+        config.max_dict_size = chosen->max_dict_size;
+        config.symbol_kernel = kernel;
+        config.compressed_ratio = chosen->compressed_ratio;
+
+        double best_seconds = std::numeric_limits<double>::infinity();
+        for (size_t threads : options_.thread_counts) {
+            double seconds = measure_parallel(config, threads);
+            if (seconds < best_seconds) {
+                best_seconds = seconds;
+                config.num_threads = threads;
+            }
+        }
+        config.throughput_mb_s = best_seconds > 0 ? sample_mb / best_seconds : 0.0;
+
+        log("Level " + std::to_string(level) + ": block=" + std::to_string(config.block_size) +
+            " dict=" + std::to_string(config.max_dict_size) + " threads=" +
+            std::to_string(config.num_threads) + " kernel=" + symbol_kernel_name(config.symbol_kernel));
+        profile.levels[level] = config;
+    }
+
+    return profile;
+}
+
+void apply_tuned_config(CircularChromosomeCompressor& compressor, const TunedConfig& config) {
+    compressor.set_block_size(config.block_size);
+    compressor.set_num_threads(config.num_threads);
+    compressor.set_max_dict_size(config.max_dict_size);
+    compressor.set_symbol_kernel(config.symbol_kernel);
+}
+
+bool apply_machine_profile(CircularChromosomeCompressor& compressor, int level) {
+    // Loaded once per process; a missing or stale profile leaves defaults in place
+    static const std::pair<bool, MachineProfile> cached = []() {
+        try {
+            return std::make_pair(true, MachineProfile::load(MachineProfile::default_path()));
+        } catch (const std::exception&) {
+            return std::make_pair(false, MachineProfile());
+        }
+    }();
+
+    if (!cached.first || cached.second.levels.empty()) {
+        return false;
+    }
+    apply_tuned_config(compressor, cached.second.config_for(level));
+    return true;
+}
+
+} // namespace ccc
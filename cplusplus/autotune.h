@@ -0,0 +1,134 @@
+/**
+ * Startup Autotuner with Cached Machine Profile - C++ Implementation
+ *
+ * Runs short calibration microbenchmarks of the block pipeline stages on the
+ * current machine and records the fastest configuration per compression
+ * level in a profile file that later processes load at startup.
+ */
+
+#ifndef CCC_AUTOTUNE_H
+#define CCC_AUTOTUNE_H
+
+#include "circular_chromosome_compression.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ccc {
+
+/**
+ * Compression levels trade throughput for ratio:
+ * 1 = fastest configuration regardless of ratio,
+ * 2 = fastest within 5% of the best measured ratio,
+ * 3 = fastest within 1% of the best measured ratio
+ */
+constexpr int kMinCompressionLevel = 1;
+constexpr int kDefaultCompressionLevel = 2;
+constexpr int kMaxCompressionLevel = 3;
+
+/**
+ * Block-parallel settings selected for one compression level
+ */
+struct TunedConfig {
+    size_t block_size = 1048576;
+    size_t num_threads = 0;
+    uint32_t max_dict_size = kDvnpMaxDictSize;
+    SymbolKernel symbol_kernel = SymbolKernel::Auto;
+    double throughput_mb_s = 0.0;   // measured round-trip throughput
+    double compressed_ratio = 0.0;  // measured packed size / original size
+};
+
+/**
+ * Per-machine tuning result, persisted as a key=value text file
+ */
+struct MachineProfile {
+    size_t hardware_threads = 0;
+    std::string created;
+    std::map<int, TunedConfig> levels;
+
+    /**
+     * Configuration for a level, falling back to the nearest tuned level
+     * and to TunedConfig defaults when the profile is empty
+     */
+    TunedConfig config_for(int level) const;
+
+    /**
+     * Write the profile, creating parent directories as needed
+     *
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * Read a profile written by save()
+     *
+     * @throws std::runtime_error if the file cannot be read or parsed, or a level holds
+     *         settings the compressor would reject
+     */
+    static MachineProfile load(const std::string& path);
+
+    /**
+     * $CCC_PROFILE if set, else $XDG_CACHE_HOME/ccc/machine_profile,
+     * else $HOME/.cache/ccc/machine_profile
+     */
+    static std::string default_path();
+};
+
+/**
+ * Calibration parameters; empty candidate lists select built-in defaults
+ */
+struct AutotuneOptions {
+    size_t sample_size = 8 * 1048576;
+    std::vector<uint8_t> sample;                // calibration data; synthetic if empty
+    std::vector<size_t> block_sizes;            // default: 256KB, 1MB, 4MB
+    std::vector<uint32_t> dict_sizes;           // default: 4096, 16384, 65536
+    std::vector<size_t> thread_counts;          // default: 1, 2, 4, ... hardware threads
+    bool verbose = false;
+};
+
+/**
+ * Calibration driver
+ */
+class Autotuner {
+public:
+    explicit Autotuner(AutotuneOptions options = AutotuneOptions());
+
+    /**
+     * Run all calibration microbenchmarks
+     *
+     * @return Profile with one entry per compression level
+     */
+    MachineProfile run();
+
+private:
+    struct Measurement {
+        size_t block_size = 0;
+        uint32_t max_dict_size = 0;
+        double seconds = 0.0;
+        double compressed_ratio = 0.0;
+    };
+
+    SymbolKernel tune_symbol_kernel();
+    Measurement measure_codec(size_t block_size, uint32_t max_dict_size, SymbolKernel kernel);
+    double measure_parallel(const TunedConfig& config, size_t num_threads);
+    void log(const std::string& message);
+
+    AutotuneOptions options_;
+};
+
+/**
+ * Apply a tuned configuration to a compressor
+ */
+void apply_tuned_config(CircularChromosomeCompressor& compressor, const TunedConfig& config);
+
+/**
+ * Apply the cached machine profile for a level
+ * The default profile is loaded once per process on first use.
+ *
+ * @return False if no profile is available (compressor left unchanged)
+ */
+bool apply_machine_profile(CircularChromosomeCompressor& compressor, int level = kDefaultCompressionLevel);
+
+} // namespace ccc
+
+#endif // CCC_AUTOTUNE_H
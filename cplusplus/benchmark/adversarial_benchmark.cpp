@@ -0,0 +1,374 @@
+/**
+ * Adversarial and worst-case performance benchmark for CCC C++ implementation
+ * Each generator is built to maximize the cost of one pipeline stage; every
+ * stage is run on every generator and the worst throughput and peak heap per
+ * stage are reported, bounding latency and memory for untrusted inputs.
+ *
+ * Usage:
+ *     adversarial_benchmark [--size KB] [--repeat N] [--dict-size N]
+ */
+
+#include "circular_chromosome_compression.h"
+#include "dvnp_codec.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#define CCC_HAVE_USABLE_SIZE 1
+#endif
+
+using namespace ccc;
+using namespace std::chrono;
+
+// Heap accounting for per-stage peak memory: every global allocation is counted
+namespace {
+std::atomic<size_t> g_heap_current{0};
+std::atomic<size_t> g_heap_peak{0};
+
+size_t allocation_size(void* ptr, size_t requested) {
+#ifdef CCC_HAVE_USABLE_SIZE
+    (void)requested;
+    return ::malloc_usable_size(ptr);
+#else
+    return requested;
+#endif
+}
+
+void* counted_alloc(size_t size) {
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    size_t current = g_heap_current.fetch_add(allocation_size(ptr, size)) + allocation_size(ptr, size);
+    size_t peak = g_heap_peak.load();
+    while (current > peak && !g_heap_peak.compare_exchange_weak(peak, current)) {
+    }
+    return ptr;
+}
+
+void counted_free(void* ptr) {
+    if (ptr != nullptr) {
+        g_heap_current.fetch_sub(allocation_size(ptr, 0));
+        std::free(ptr);
+    }
+}
+} // namespace
+
+void* operator new(size_t size) { return counted_alloc(size); }
+void* operator new[](size_t size) { return counted_alloc(size); }
+void operator delete(void* ptr) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { counted_free(ptr); }
+
+namespace {
+
+struct StageResult {
+    std::string stage;
+    std::string generator;
+    size_t input_bytes = 0;
+    double seconds = 0.0;
+    size_t peak_heap_bytes = 0;         // above the heap in use when the stage started
+    bool ok = true;
+    std::string error_message;
+
+    double throughput_mb_s() const { return seconds > 0 ? input_bytes / 1048576.0 / seconds : 0.0; }
+    double heap_per_input_byte() const {
+        return input_bytes > 0 ? static_cast<double>(peak_heap_bytes) / input_bytes : 0.0;
+    }
+};
+
+/**
+ * Inputs built to maximize the cost of a particular stage
+ */
+class AdversarialGenerator {
+public:
+    struct Generator {
+        std::string name;
+        std::string target;             // stage the generator attacks
+        std::function<std::vector<uint8_t>(size_t)> create;
+    };
+
+    static std::vector<Generator> all() {
+        return {
+            // All-A: LZW phrases grow by one base each, so dvnp_compress copies
+            // ever longer `current` strings and phrase length reaches ~sqrt(2n)
+            {"homopolymer", "dvnp_compress", [](size_t size) { return std::vector<uint8_t>(size, 0x00); }},
+            // Period-2 repeat: same unbounded phrase growth over two symbols
+            {"dinucleotide", "dvnp_compress", [](size_t size) { return std::vector<uint8_t>(size, 0x11); }},
+            // Fibonacci word: aperiodic, long repeated phrases with deep dictionary chains
+            {"fibonacci", "dvnp_decompress", create_fibonacci},
+            // Random bytes: shortest phrases, so the dictionary fills and resets as
+            // often as the code space allows, and the code stream is as long and as
+            // diverse as possible for encapsulation and the marker search
+            {"random", "resets/markers", create_random},
+            // Order-8 de Bruijn sequence: every 8-mer once per period, so phrases
+            // stay short and trie walks keep landing on fresh nodes
+            {"debruijn", "block_encode", create_de_bruijn},
+        };
+    }
+
+private:
+    static std::vector<uint8_t> create_random(size_t size) {
+        std::mt19937_64 rng(0xCCC);
+        std::vector<uint8_t> data(size);
+        for (uint8_t& byte : data) {
+            byte = static_cast<uint8_t>(rng());
+        }
+        return data;
+    }
+
+    static std::vector<uint8_t> create_fibonacci(size_t size) {
+        // Bases: 'a' -> A (00), 'b' -> T (11)
+        std::string a = "b";
+        std::string b = "ba";
+        while (b.size() < size * 4) {
+            std::string next = b + a;
+            a = std::move(b);
+            b = std::move(next);
+        }
+        std::vector<uint8_t> data(size, 0);
+        for (size_t i = 0; i < size * 4; ++i) {
+            if (b[i] == 'b') {
+                data[i / 4] |= static_cast<uint8_t>(3 << (6 - 2 * (i % 4)));
+            }
+        }
+        return data;
+    }
+
+    static std::vector<uint8_t> create_de_bruijn(size_t size) {
+        // Order-8 de Bruijn sequence over ACGT (Lyndon word concatenation), repeated
+        const int k = 4, n = 8;
+        std::vector<int> a(k * n, 0);
+        std::vector<uint8_t> bases;
+        std::function<void(int, int)> db = [&](int t, int p) {
+            if (t > n) {
+                if (n % p == 0) {
+                    bases.insert(bases.end(), a.begin() + 1, a.begin() + p + 1);
+                }
+                return;
+            }
+            a[t] = a[t - p];
+            db(t + 1, p);
+            for (int j = a[t - p] + 1; j < k; ++j) {
+                a[t] = j;
+                db(t + 1, t);
+            }
+        };
+        db(1, 1);
+        std::vector<uint8_t> data(size, 0);
+        for (size_t i = 0; i < size * 4; ++i) {
+            data[i / 4] |= static_cast<uint8_t>(bases[i % bases.size()] << (6 - 2 * (i % 4)));
+        }
+        return data;
+    }
+};
+
+class AdversarialBenchmark {
+public:
+    AdversarialBenchmark(size_t size, size_t repeat, uint32_t dict_size)
+        : size_(size), repeat_(repeat), dict_size_(dict_size) {}
+
+    void run_all() {
+        std::cout << "=== CCC C++ Adversarial Benchmark ===" << std::endl;
+        std::cout << "Input: " << size_ / 1024 << "KB per generator, best of " << repeat_
+                  << ", block dictionary " << dict_size_ << " codes" << std::endl;
+
+        std::vector<StageResult> results;
+        for (const auto& generator : AdversarialGenerator::all()) {
+            std::cout << "\nGenerator: " << generator.name << " (targets " << generator.target << ")" << std::endl;
+            std::vector<uint8_t> data = generator.create(size_);
+            run_generator(generator.name, data, results);
+        }
+
+        print_summary(results);
+        save_results(results);
+    }
+
+private:
+    /**
+     * Time a stage, keeping the fastest repeat and the largest heap high-water mark
+     */
+    void measure(const std::string& stage, const std::string& generator, size_t input_bytes,
+                 const std::function<void()>& body, std::vector<StageResult>& results) {
+        StageResult result;
+        result.stage = stage;
+        result.generator = generator;
+        result.input_bytes = input_bytes;
+        try {
+            for (size_t r = 0; r < repeat_; ++r) {
+                size_t baseline = g_heap_current.load();
+                g_heap_peak.store(baseline);
+                auto start = steady_clock::now();
+                body();
+                double seconds = duration<double>(steady_clock::now() - start).count();
+                result.seconds = r == 0 ? seconds : std::min(result.seconds, seconds);
+                result.peak_heap_bytes = std::max(result.peak_heap_bytes, g_heap_peak.load() - baseline);
+            }
+        } catch (const std::exception& e) {
+            result.ok = false;
+            result.error_message = e.what();
+        }
+        std::cout << "  " << std::left << std::setw(18) << stage << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(10) << result.throughput_mb_s() << " MB/s" << std::setw(12)
+                  << result.peak_heap_bytes / 1048576.0 << " MB peak" << std::setw(9) << std::setprecision(1)
+                  << result.heap_per_input_byte() << "x input" << (result.ok ? "" : "  ✗ " + result.error_message)
+                  << std::endl;
+        results.push_back(result);
+    }
+
+    void run_generator(const std::string& name, const std::vector<uint8_t>& data, std::vector<StageResult>& results) {
+        CircularChromosomeCompressor serial(1000, 4, true, false);
+        CircularChromosomeCompressor blocks(1000, 4, true, false);
+        blocks.set_block_size(std::max<size_t>(65536, data.size() / 4));
+        blocks.set_max_dict_size(dict_size_);
+
+        std::string dna;
+        std::vector<int> codes;
+        measure("binary_to_dna", name, data.size(), [&]() { dna = serial.binary_to_dna(data); }, results);
+        measure("dvnp_compress", name, data.size(), [&]() { codes = serial.dvnp_compress(dna); }, results);
+        measure("dvnp_decompress", name, data.size(), [&]() {
+            if (serial.dvnp_decompress(codes) != dna) throw std::runtime_error("round trip mismatch");
+        }, results);
+        std::string().swap(dna);
+
+        std::vector<uint8_t> symbols(data.size() * 4);
+        bytes_to_symbols(data.data(), data.size(), symbols.data());
+        std::vector<int> block_codes;
+        measure("block_encode", name, data.size(), [&]() {
+            DvnpEncoder encoder(dict_size_);
+            block_codes.clear();
+            encoder.encode(symbols.data(), symbols.size(), block_codes);
+        }, results);
+        measure("block_decode", name, data.size(), [&]() {
+            DvnpDecoder decoder(dict_size_);
+            std::vector<uint8_t> packed(data.size(), 0);
+            decoder.decode(block_codes.data(), block_codes.size(), packed.data(), symbols.size());
+            if (packed != data) throw std::runtime_error("round trip mismatch");
+        }, results);
+        std::vector<uint8_t>().swap(symbols);
+
+        // Full pipelines include circular encapsulation, marker search and hashing
+        std::pair<std::vector<int>, CompressionMetadata> compressed;
+        measure("compress_serial", name, data.size(), [&]() { compressed = serial.compress(data); }, results);
+        measure("decompress_serial", name, data.size(), [&]() {
+            if (serial.decompress(compressed.first, compressed.second) != data) {
+                throw std::runtime_error("round trip mismatch");
+            }
+        }, results);
+        measure("compress_blocks", name, data.size(), [&]() { compressed = blocks.compress(data); }, results);
+        measure("decompress_blocks", name, data.size(), [&]() {
+            if (blocks.decompress(compressed.first, compressed.second) != data) {
+                throw std::runtime_error("round trip mismatch");
+            }
+        }, results);
+    }
+
+    void print_summary(const std::vector<StageResult>& results) {
+        std::cout << "\n=== Worst Case per Stage ===" << std::endl;
+        std::cout << std::left << std::setw(18) << "Stage" << std::right << std::setw(12) << "Worst MB/s"
+                  << "  " << std::left << std::setw(14) << "(generator)" << std::right << std::setw(12)
+                  << "Peak MB" << "  " << std::left << std::setw(14) << "(generator)" << std::right
+                  << std::setw(10) << "x input" << std::endl;
+        std::cout << std::string(96, '-') << std::endl;
+
+        std::vector<std::string> stages;
+        for (const StageResult& result : results) {
+            if (std::find(stages.begin(), stages.end(), result.stage) == stages.end()) {
+                stages.push_back(result.stage);
+            }
+        }
+        for (const std::string& stage : stages) {
+            const StageResult* slowest = nullptr;
+            const StageResult* largest = nullptr;
+            for (const StageResult& result : results) {
+                if (result.stage != stage || !result.ok) continue;
+                if (!slowest || result.throughput_mb_s() < slowest->throughput_mb_s()) slowest = &result;
+                if (!largest || result.peak_heap_bytes > largest->peak_heap_bytes) largest = &result;
+            }
+            if (!slowest) {
+                std::cout << std::left << std::setw(18) << stage << "  ✗ failed on every generator" << std::endl;
+                continue;
+            }
+            std::cout << std::left << std::setw(18) << stage << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(12) << slowest->throughput_mb_s() << "  " << std::left << std::setw(14)
+                      << slowest->generator << std::right << std::setw(12) << largest->peak_heap_bytes / 1048576.0
+                      << "  " << std::left << std::setw(14) << largest->generator << std::right << std::setw(10)
+                      << std::setprecision(1) << largest->heap_per_input_byte() << std::endl;
+        }
+
+        size_t failures = std::count_if(results.begin(), results.end(), [](const StageResult& r) { return !r.ok; });
+        std::cout << "\nFailed stage runs: " << failures << " of " << results.size() << std::endl;
+    }
+
+    void save_results(const std::vector<StageResult>& results) {
+        std::ofstream file("adversarial_benchmark_results.json");
+        if (!file.is_open()) {
+            std::cout << "Warning: Could not save results to file" << std::endl;
+            return;
+        }
+        file << "{\n  \"input_bytes\": " << size_ << ",\n  \"dict_size\": " << dict_size_ << ",\n";
+        file << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const StageResult& result = results[i];
+            file << "    {\"stage\": \"" << result.stage << "\", \"generator\": \"" << result.generator
+                 << "\", \"seconds\": " << std::fixed << std::setprecision(6) << result.seconds
+                 << ", \"throughput_mb_s\": " << std::setprecision(2) << result.throughput_mb_s()
+                 << ", \"peak_heap_bytes\": " << result.peak_heap_bytes
+                 << ", \"ok\": " << (result.ok ? "true" : "false");
+            if (!result.ok) {
+                file << ", \"error\": \"" << result.error_message << "\"";
+            }
+            file << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        file << "  ]\n}\n";
+        std::cout << "Detailed results saved to: adversarial_benchmark_results.json" << std::endl;
+    }
+
+    size_t size_;
+    size_t repeat_;
+    uint32_t dict_size_;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t size_kb = 1024;
+    size_t repeat = 1;
+    uint32_t dict_size = kDvnpMaxDictSize;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--size" && i + 1 < argc) {
+            size_kb = std::stoul(argv[++i]);
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else if (arg == "--dict-size" && i + 1 < argc) {
+            dict_size = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--size KB] [--repeat N] [--dict-size N]" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        AdversarialBenchmark benchmark(size_kb * 1024, repeat, dict_size);
+        benchmark.run_all();
+        std::cout << "\n🎉 Adversarial benchmark completed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
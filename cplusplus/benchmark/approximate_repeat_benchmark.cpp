@@ -0,0 +1,255 @@
+/**
+ * Approximate repeat coding benchmark for CCC C++ implementation
+ * Compresses synthetic mutated-repeat corpora (random background plus copies
+ * of earlier stretches at 0-10% substitution divergence) with the approximate
+ * repeat stage off and at several minimum copy lengths, reporting archive
+ * size (codes plus copy tokens), ratio and its gain over the stage being off,
+ * and compress/decompress throughput.
+ *
+ * Usage:
+ *     approximate_repeat_benchmark [--size MB] [--repeat N] [--block-size N] [--threads N] [--min-bases N,...]
+ */
+
+#include "circular_chromosome_compression.h"
+#include "archive.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace ccc;
+using namespace std::chrono;
+
+namespace {
+
+/**
+ * Random background where a share of the bases are diverged copies of
+ * material up to reach bases back (so copies stay inside one block)
+ */
+std::vector<uint8_t> mutated_repeats(size_t bases, double copy_share, double divergence, size_t reach,
+                                     uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<uint8_t> symbols;
+    symbols.reserve(bases + 4096);
+    while (symbols.size() < bases) {
+        const size_t length = 150 + rng() % 1850;
+        if (symbols.size() > 4 * length && uniform(rng) < copy_share) {
+            const size_t back = length + rng() % std::min(reach, symbols.size() - length);
+            const size_t source = symbols.size() - back;
+            for (size_t i = 0; i < length; ++i) {
+                symbols.push_back(uniform(rng) < divergence ? static_cast<uint8_t>(rng() & 3) : symbols[source + i]);
+            }
+        } else {
+            for (size_t i = 0; i < length; ++i) {
+                symbols.push_back(static_cast<uint8_t>(rng() & 3));
+            }
+        }
+    }
+    symbols.resize(bases);
+    return symbols;
+}
+
+std::vector<uint8_t> pack_symbols(const std::vector<uint8_t>& symbols) {
+    std::vector<uint8_t> packed(symbols.size() / 4);
+    for (size_t i = 0; i < packed.size(); ++i) {
+        packed[i] = static_cast<uint8_t>(symbols[4 * i] << 6 | symbols[4 * i + 1] << 4 |
+                                         symbols[4 * i + 2] << 2 | symbols[4 * i + 3]);
+    }
+    return packed;
+}
+
+struct CopyResult {
+    std::string corpus;
+    size_t min_bases = 0;               // 0 = stage off
+    size_t input_bytes = 0;
+    size_t archive_bytes = 0;
+    size_t baseline_bytes = 0;          // archive bytes with the stage off
+    size_t copies = 0;
+    size_t copy_bases = 0;
+    size_t edits = 0;
+    double compress_seconds = 0.0;
+    double decompress_seconds = 0.0;
+
+    double ratio() const { return input_bytes ? static_cast<double>(archive_bytes) / input_bytes : 0.0; }
+    double gain() const { return archive_bytes ? static_cast<double>(baseline_bytes) / archive_bytes : 0.0; }
+    double compress_mb_s() const { return compress_seconds > 0 ? input_bytes / 1048576.0 / compress_seconds : 0.0; }
+    double decompress_mb_s() const {
+        return decompress_seconds > 0 ? input_bytes / 1048576.0 / decompress_seconds : 0.0;
+    }
+};
+
+class ApproximateRepeatBenchmark {
+public:
+    ApproximateRepeatBenchmark(size_t size, size_t repeat, size_t block_size, size_t num_threads,
+                               std::vector<size_t> min_bases)
+        : size_(size), repeat_(repeat), block_size_(block_size), num_threads_(num_threads),
+          min_bases_(std::move(min_bases)) {}
+
+    void run_all() {
+        std::cout << "=== CCC Approximate Repeat Coding Benchmark ===" << std::endl;
+        std::cout << "Corpus: " << size_ / 1048576.0 << " MB per corpus, " << block_size_ << " byte blocks, best of "
+                  << repeat_ << std::endl;
+
+        const size_t bases = size_ * 4;
+        const size_t reach = std::max<size_t>(block_size_, 4096) * 2;   // in bases: within about half a block
+        std::vector<std::pair<std::string, std::vector<uint8_t>>> corpus;
+        corpus.emplace_back("random", pack_symbols(mutated_repeats(bases, 0.0, 0.0, reach, 1)));
+        corpus.emplace_back("exact_copies", pack_symbols(mutated_repeats(bases, 0.5, 0.0, reach, 2)));
+        corpus.emplace_back("snp_1pct", pack_symbols(mutated_repeats(bases, 0.5, 0.01, reach, 3)));
+        corpus.emplace_back("snp_3pct", pack_symbols(mutated_repeats(bases, 0.5, 0.03, reach, 4)));
+        corpus.emplace_back("snp_5pct", pack_symbols(mutated_repeats(bases, 0.5, 0.05, reach, 5)));
+        corpus.emplace_back("snp_10pct", pack_symbols(mutated_repeats(bases, 0.5, 0.10, reach, 6)));
+
+        std::vector<CopyResult> results;
+        for (const auto& [name, data] : corpus) {
+            std::cout << "\n--- " << name << " ---" << std::endl;
+            size_t baseline = run_corpus(name, data, 0, 0, results);
+            for (size_t min_bases : min_bases_) {
+                run_corpus(name, data, min_bases, baseline, results);
+            }
+        }
+        save_results(results);
+    }
+
+private:
+    double time_best(const std::function<void()>& body) {
+        double best = 0.0;
+        for (size_t r = 0; r < repeat_; ++r) {
+            auto start = steady_clock::now();
+            body();
+            double seconds = duration<double>(steady_clock::now() - start).count();
+            best = r == 0 ? seconds : std::min(best, seconds);
+        }
+        return best;
+    }
+
+    size_t run_corpus(const std::string& name, const std::vector<uint8_t>& data, size_t min_bases, size_t baseline,
+                      std::vector<CopyResult>& results) {
+        CircularChromosomeCompressor compressor(1000, 4, true, false);
+        compressor.set_block_size(block_size_);
+        compressor.set_num_threads(num_threads_);
+        compressor.set_approximate_repeats(min_bases);
+
+        std::vector<int> codes;
+        CompressionMetadata metadata;
+        CopyResult result;
+        result.corpus = name;
+        result.min_bases = min_bases;
+        result.input_bytes = data.size();
+        result.compress_seconds = time_best([&]() { std::tie(codes, metadata) = compressor.compress(data); });
+
+        std::vector<uint8_t> restored;
+        result.decompress_seconds = time_best([&]() { restored = compressor.decompress(codes, metadata); });
+        if (restored != data) {
+            throw std::runtime_error("Round trip mismatch for " + name + " at min_bases " + std::to_string(min_bases));
+        }
+        // Archive bytes count the copy tokens as well as the codes
+        result.archive_bytes = serialize_archive(codes, metadata).size();
+        result.baseline_bytes = min_bases == 0 ? result.archive_bytes : baseline;
+        for (const BlockMetadata& block : metadata.core.blocks) {
+            result.copies += block.approximate_repeats.size();
+            result.copy_bases += approximate_repeat_bases(block.approximate_repeats);
+            for (const ApproximateRepeat& copy : block.approximate_repeats) {
+                result.edits += copy.edits.size();
+            }
+        }
+
+        std::cout << "  " << std::left << std::setw(10)
+                  << (min_bases == 0 ? std::string("off") : ">=" + std::to_string(min_bases)) << std::right
+                  << std::setw(10) << result.archive_bytes << " bytes  ratio " << std::fixed << std::setprecision(4)
+                  << result.ratio() << "  gain " << std::setprecision(2) << result.gain() << "x  "
+                  << std::setprecision(1) << std::setw(7) << result.compress_mb_s() << " MB/s in  " << std::setw(7)
+                  << result.decompress_mb_s() << " MB/s out  " << result.copies << " copies, " << result.edits
+                  << " edits, " << std::setprecision(2) << 100.0 * result.copy_bases / (data.size() * 4.0)
+                  << "% of bases" << std::endl;
+        results.push_back(result);
+        return result.archive_bytes;
+    }
+
+    void save_results(const std::vector<CopyResult>& results) {
+        std::ofstream file("approximate_repeat_benchmark_results.json");
+        if (!file.is_open()) {
+            std::cout << "Warning: Could not save results to file" << std::endl;
+            return;
+        }
+        file << "{\n  \"corpus_bytes\": " << size_ << ",\n  \"block_size\": " << block_size_ << ",\n";
+        file << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const CopyResult& result = results[i];
+            file << "    {\"corpus\": \"" << result.corpus << "\", \"min_bases\": " << result.min_bases
+                 << ", \"archive_bytes\": " << result.archive_bytes << ", \"ratio\": " << std::fixed
+                 << std::setprecision(6) << result.ratio() << ", \"gain\": " << std::setprecision(4) << result.gain()
+                 << ", \"copies\": " << result.copies << ", \"copy_bases\": " << result.copy_bases
+                 << ", \"edits\": " << result.edits << ", \"compress_mb_s\": " << std::setprecision(2)
+                 << result.compress_mb_s() << ", \"decompress_mb_s\": " << result.decompress_mb_s() << "}"
+                 << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        file << "  ]\n}\n";
+        std::cout << "\nDetailed results saved to: approximate_repeat_benchmark_results.json" << std::endl;
+    }
+
+    size_t size_;
+    size_t repeat_;
+    size_t block_size_;
+    size_t num_threads_;
+    std::vector<size_t> min_bases_;
+};
+
+std::vector<size_t> parse_list(const std::string& list) {
+    std::vector<size_t> values;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        values.push_back(std::stoul(item));
+    }
+    return values;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t size_mb = 16;
+    size_t repeat = 3;
+    size_t block_size = 1048576;
+    size_t num_threads = 0;
+    std::string min_bases = "32,48,64,96";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--size" && i + 1 < argc) {
+            size_mb = std::stoul(argv[++i]);
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else if (arg == "--block-size" && i + 1 < argc) {
+            block_size = std::stoul(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            num_threads = std::stoul(argv[++i]);
+        } else if (arg == "--min-bases" && i + 1 < argc) {
+            min_bases = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--size MB] [--repeat N] [--block-size N] [--threads N] [--min-bases N,...]" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        ApproximateRepeatBenchmark benchmark(size_mb * 1048576, repeat, block_size, num_threads,
+                                             parse_list(min_bases));
+        benchmark.run_all();
+        std::cout << "\n🎉 Approximate repeat benchmark completed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,153 @@
+/**
+ * Constrained coding benchmark for CCC C++ implementation
+ * Measures density (bits/base) and throughput of the synthesis-friendly
+ * transcoding stage, and compares constraint compliance with binary_to_dna.
+ */
+
+#include "circular_chromosome_compression.h"
+#include "constrained_coding.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <cstdint>
+
+using namespace ccc;
+using namespace std::chrono;
+
+struct CodingResult {
+    std::string pattern;
+    size_t input_bytes = 0;
+    size_t dna_bases = 0;
+    double bits_per_base = 0.0;
+    double encode_mb_s = 0.0;
+    double decode_mb_s = 0.0;
+    size_t max_run = 0;
+    size_t naive_max_run = 0;
+    bool constraints_ok = false;
+    bool roundtrip_ok = false;
+};
+
+static std::vector<uint8_t> create_pattern_data(size_t size, const std::string& pattern) {
+    std::vector<uint8_t> data(size);
+    if (pattern == "random") {
+        std::mt19937 rng(42);
+        for (auto& byte : data) {
+            byte = static_cast<uint8_t>(rng());
+        }
+    } else if (pattern == "zeros") {
+        std::fill(data.begin(), data.end(), 0);
+    } else { // text
+        const std::string text = "Lorem ipsum dolor sit amet, consectetur adipiscing elit. ";
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = static_cast<uint8_t>(text[i % text.length()]);
+        }
+    }
+    return data;
+}
+
+static CodingResult run_single_test(const ConstrainedCodec& codec, size_t size, const std::string& pattern) {
+    CodingResult result;
+    result.pattern = pattern;
+    result.input_bytes = size;
+
+    auto data = create_pattern_data(size, pattern);
+
+    const int iterations = 5;
+    std::string dna;
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        dna = codec.encode(data);
+    }
+    double encode_sec = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1e6;
+
+    std::vector<uint8_t> decoded;
+    start = high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        decoded = codec.decode(dna, data.size());
+    }
+    double decode_sec = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1e6;
+
+    double mb = static_cast<double>(size) * iterations / 1048576.0;
+    result.dna_bases = dna.length();
+    result.bits_per_base = dna.empty() ? 0.0 : (size * 8.0) / dna.length();
+    result.encode_mb_s = encode_sec > 0 ? mb / encode_sec : 0.0;
+    result.decode_mb_s = decode_sec > 0 ? mb / decode_sec : 0.0;
+    result.max_run = ConstrainedCodec::max_homopolymer_run(dna);
+    result.constraints_ok = ConstrainedCodec::satisfies_constraints(dna);
+    result.roundtrip_ok = (decoded == data);
+
+    // Reference: unconstrained 2-bit mapping of the same bytes
+    CircularChromosomeCompressor compressor(1000, 4, false, false);
+    std::vector<uint8_t> sample(data.begin(), data.begin() + std::min(data.size(), size_t(65536)));
+    result.naive_max_run = ConstrainedCodec::max_homopolymer_run(compressor.binary_to_dna(sample));
+
+    return result;
+}
+
+static void run_pipeline_test(const ConstrainedCodec& codec) {
+    std::cout << "\n=== Compression + Constrained Transcoding ===" << std::endl;
+
+    CircularChromosomeCompressor compressor(1000, 4, true, false);
+    auto data = create_pattern_data(262144, "text");
+    auto [compressed, metadata] = compressor.compress(data);
+
+    auto start = high_resolution_clock::now();
+    std::string dna = codec.encode_codes(compressed);
+    std::vector<int> restored = codec.decode_codes(dna);
+    double sec = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1e6;
+
+    std::vector<uint8_t> roundtrip = compressor.decompress(restored, metadata);
+
+    std::cout << "  Input: " << data.size() << " bytes, " << compressed.size() << " codes" << std::endl;
+    std::cout << "  Synthesis DNA: " << dna.length() << " bases ("
+              << std::fixed << std::setprecision(3) << (data.size() * 8.0) / dna.length()
+              << " input bits/base)" << std::endl;
+    std::cout << "  Transcode round trip: " << std::fixed << std::setprecision(2) << sec * 1000 << " ms" << std::endl;
+    std::cout << "  Max homopolymer run: " << ConstrainedCodec::max_homopolymer_run(dna) << std::endl;
+    std::cout << "  Integrity: " << (roundtrip == data ? "PASS" : "FAIL") << std::endl;
+}
+
+int main() {
+    std::cout << "=== CCC Constrained Coding Benchmark ===" << std::endl;
+    std::cout << "Code: " << ConstrainedCodec::kBitsPerWord << " bits -> "
+              << ConstrainedCodec::kWordBases << " bases, max run "
+              << ConstrainedCodec::kMaxRunLength << ", GC "
+              << ConstrainedCodec::kMinGcPerWord << "-" << ConstrainedCodec::kMaxGcPerWord
+              << " per " << ConstrainedCodec::kWordBases << " bases" << std::endl;
+
+    ConstrainedCodec codec;
+    std::vector<std::string> patterns = {"random", "zeros", "text"};
+    std::vector<CodingResult> results;
+    for (const auto& pattern : patterns) {
+        results.push_back(run_single_test(codec, 16 * 1048576, pattern));
+    }
+
+    std::cout << "\n" << std::left << std::setw(10) << "Pattern"
+              << std::setw(12) << "Bits/base"
+              << std::setw(12) << "Enc MB/s"
+              << std::setw(12) << "Dec MB/s"
+              << std::setw(10) << "MaxRun"
+              << std::setw(12) << "NaiveRun"
+              << "Status" << std::endl;
+    std::cout << std::string(76, '-') << std::endl;
+
+    bool all_ok = true;
+    for (const auto& r : results) {
+        bool ok = r.constraints_ok && r.roundtrip_ok;
+        all_ok = all_ok && ok;
+        std::cout << std::left << std::setw(10) << r.pattern
+                  << std::setw(12) << std::fixed << std::setprecision(3) << r.bits_per_base
+                  << std::setw(12) << std::fixed << std::setprecision(1) << r.encode_mb_s
+                  << std::setw(12) << std::fixed << std::setprecision(1) << r.decode_mb_s
+                  << std::setw(10) << r.max_run
+                  << std::setw(12) << r.naive_max_run
+                  << (ok ? "✓" : "✗") << std::endl;
+    }
+
+    run_pipeline_test(codec);
+
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+/**
+ * DVNP trie stepping benchmark for CCC C++ implementation
+ * Encodes synthetic base-symbol corpora (random, genome-like, periodic) with
+ * the single-step DvnpEncoder and with multi-base radix stepping, at several
+ * dictionary sizes, checking the code streams are identical and reporting
+ * encode throughput in megabases per second.
+ *
+ * Usage:
+ *     dvnp_stepping_benchmark [--size MB] [--repeat N]
+ */
+
+#include "dvnp_codec.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ccc;
+using namespace std::chrono;
+
+namespace {
+
+struct Corpus {
+    std::string name;
+    std::vector<uint8_t> symbols;
+};
+
+/**
+ * Symbol streams with short, medium and long typical phrases
+ */
+std::vector<Corpus> make_corpora(size_t count) {
+    std::mt19937_64 rng(124);
+    std::vector<Corpus> corpora;
+
+    Corpus random{"random", std::vector<uint8_t>(count)};
+    for (uint8_t& symbol : random.symbols) {
+        symbol = static_cast<uint8_t>(rng() & 3);
+    }
+    corpora.push_back(std::move(random));
+
+    // Copies of a few thousand source segments with point mutations
+    Corpus genome{"genome_like", {}};
+    std::vector<uint8_t> source(65536);
+    for (uint8_t& symbol : source) {
+        symbol = static_cast<uint8_t>(rng() & 3);
+    }
+    while (genome.symbols.size() < count) {
+        size_t start = rng() % (source.size() - 2000);
+        size_t length = 200 + rng() % 1800;
+        for (size_t i = 0; i < length; ++i) {
+            genome.symbols.push_back(rng() % 50 == 0 ? static_cast<uint8_t>(rng() & 3) : source[start + i]);
+        }
+    }
+    genome.symbols.resize(count);
+    corpora.push_back(std::move(genome));
+
+    Corpus periodic{"periodic", std::vector<uint8_t>(count)};
+    const uint8_t unit[] = {2, 0, 3, 3, 0, 1, 0, 3, 3, 0, 2, 2, 2};
+    for (size_t i = 0; i < count; ++i) {
+        periodic.symbols[i] = unit[i % sizeof(unit)];
+    }
+    corpora.push_back(std::move(periodic));
+    return corpora;
+}
+
+struct SteppingResult {
+    std::string corpus;
+    uint32_t dict_size = 0;
+    size_t codes = 0;
+    double single_mbases_s = 0.0;
+    double multi_mbases_s = 0.0;
+
+    double speedup() const { return single_mbases_s > 0 ? multi_mbases_s / single_mbases_s : 0.0; }
+};
+
+class SteppingBenchmark {
+public:
+    SteppingBenchmark(size_t count, size_t repeat) : count_(count), repeat_(repeat) {}
+
+    void run_all() {
+        std::cout << "=== CCC DVNP Trie Stepping Benchmark ===" << std::endl;
+        std::cout << "Corpus: " << count_ / 1e6 << " M bases, best of " << repeat_ << std::endl;
+
+        std::vector<SteppingResult> results;
+        for (const Corpus& corpus : make_corpora(count_)) {
+            std::cout << "\n--- " << corpus.name << " ---" << std::endl;
+            for (uint32_t dict_size : {4096u, 65536u, 1u << 20}) {
+                results.push_back(run_corpus(corpus, dict_size));
+            }
+        }
+        save_results(results);
+    }
+
+private:
+    double time_encode(const Corpus& corpus, DvnpEncoder& encoder, std::vector<int>& codes) {
+        double best = 0.0;
+        for (size_t r = 0; r < repeat_; ++r) {
+            codes.clear();
+            auto start = steady_clock::now();
+            encoder.encode(corpus.symbols.data(), corpus.symbols.size(), codes);
+            double seconds = duration<double>(steady_clock::now() - start).count();
+            best = r == 0 ? seconds : std::min(best, seconds);
+        }
+        return best > 0 ? corpus.symbols.size() / 1e6 / best : 0.0;
+    }
+
+    SteppingResult run_corpus(const Corpus& corpus, uint32_t dict_size) {
+        DvnpEncoder single(dict_size, false);
+        DvnpEncoder multi(dict_size, true);
+        std::vector<int> single_codes;
+        std::vector<int> multi_codes;
+
+        SteppingResult result;
+        result.corpus = corpus.name;
+        result.dict_size = dict_size;
+        result.single_mbases_s = time_encode(corpus, single, single_codes);
+        result.multi_mbases_s = time_encode(corpus, multi, multi_codes);
+        if (single_codes != multi_codes) {
+            throw std::runtime_error("Code mismatch for " + corpus.name + " at dictionary size " +
+                                     std::to_string(dict_size));
+        }
+        result.codes = multi_codes.size();
+
+        std::cout << "  dict " << std::setw(8) << dict_size << std::setw(10) << result.codes << " codes  "
+                  << std::fixed << std::setprecision(1) << std::setw(7) << result.single_mbases_s
+                  << " Mbase/s single  " << std::setw(7) << result.multi_mbases_s << " Mbase/s multi  "
+                  << std::setprecision(2) << result.speedup() << "x" << std::endl;
+        return result;
+    }
+
+    void save_results(const std::vector<SteppingResult>& results) {
+        std::ofstream file("dvnp_stepping_benchmark_results.json");
+        if (!file.is_open()) {
+            std::cout << "Warning: Could not save results to file" << std::endl;
+            return;
+        }
+        file << "{\n  \"bases\": " << count_ << ",\n  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const SteppingResult& result = results[i];
+            file << "    {\"corpus\": \"" << result.corpus << "\", \"dict_size\": " << result.dict_size
+                 << ", \"codes\": " << result.codes << ", \"single_mbases_s\": " << std::fixed
+                 << std::setprecision(2) << result.single_mbases_s << ", \"multi_mbases_s\": "
+                 << result.multi_mbases_s << ", \"speedup\": " << std::setprecision(3) << result.speedup() << "}"
+                 << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        file << "  ]\n}\n";
+        std::cout << "\nDetailed results saved to: dvnp_stepping_benchmark_results.json" << std::endl;
+    }
+
+    size_t count_;
+    size_t repeat_;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t size_mb = 16;
+    size_t repeat = 3;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--size" && i + 1 < argc) {
+            size_mb = std::stoul(argv[++i]);
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--size MB] [--repeat N]" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        // One megabyte of input is four million bases
+        SteppingBenchmark benchmark(size_mb * 1048576 * 4, repeat);
+        benchmark.run_all();
+        std::cout << "\n🎉 DVNP stepping benchmark completed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
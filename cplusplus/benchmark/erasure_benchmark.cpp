@@ -0,0 +1,265 @@
+/**
+ * Reed-Solomon erasure coding benchmark for CCC C++ implementation
+ * Measures parity encode and worst-case repair throughput (all lost shards
+ * are data shards, so every lost byte is solved for) per GF(2^8) kernel and
+ * code shape, plus the framed shard container end to end.
+ *
+ * Usage:
+ *     erasure_benchmark [--size MB] [--shard-size N] [--repeat N] [--threads N] [--codes K+M,...]
+ */
+
+#include "erasure_coding.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ccc;
+using namespace std::chrono;
+
+namespace {
+
+struct CodeShape {
+    size_t data_shards;
+    size_t parity_shards;
+
+    std::string name() const { return std::to_string(data_shards) + "+" + std::to_string(parity_shards); }
+};
+
+struct ErasureResult {
+    std::string stage;
+    std::string kernel;
+    std::string code;
+    size_t data_bytes = 0;
+    double seconds = 0.0;
+
+    double throughput_mb_s() const { return seconds > 0 ? data_bytes / 1048576.0 / seconds : 0.0; }
+};
+
+class ErasureBenchmark {
+public:
+    ErasureBenchmark(size_t size, size_t shard_size, size_t repeat, size_t num_threads, std::vector<CodeShape> codes)
+        : size_(size), shard_size_(shard_size), repeat_(repeat), num_threads_(num_threads), codes_(std::move(codes)) {}
+
+    void run_all() {
+        std::cout << "=== CCC Reed-Solomon Erasure Benchmark ===" << std::endl;
+        std::cout << "Data: " << size_ / 1048576.0 << " MB, shard payload " << shard_size_ << " bytes, best of "
+                  << repeat_ << std::endl;
+
+        std::vector<uint8_t> data(size_);
+        std::mt19937_64 rng(42);
+        for (auto& byte : data) {
+            byte = static_cast<uint8_t>(rng());
+        }
+
+        std::vector<ErasureResult> results;
+        for (const CodeShape& code : codes_) {
+            std::cout << "\n--- RS(" << code.name() << "), "
+                      << std::fixed << std::setprecision(1)
+                      << 100.0 * code.parity_shards / code.data_shards << "% overhead ---" << std::endl;
+            for (GfKernel kernel : {GfKernel::Scalar, GfKernel::SSSE3, GfKernel::AVX2}) {
+                if (!gf_kernel_supported(kernel)) {
+                    std::cout << "  " << gf_kernel_name(kernel) << ": not supported on this CPU" << std::endl;
+                    continue;
+                }
+                run_codec(data, code, kernel, results);
+            }
+            run_container(data, code, results);
+        }
+        save_results(results);
+    }
+
+private:
+    /**
+     * Best-of-repeat wall time of body
+     */
+    double time_best(const std::function<void()>& body) {
+        double best = 0.0;
+        for (size_t r = 0; r < repeat_; ++r) {
+            auto start = steady_clock::now();
+            body();
+            double seconds = duration<double>(steady_clock::now() - start).count();
+            best = r == 0 ? seconds : std::min(best, seconds);
+        }
+        return best;
+    }
+
+    void report(const std::string& stage, const std::string& kernel, const CodeShape& code, double seconds,
+                std::vector<ErasureResult>& results) {
+        ErasureResult result;
+        result.stage = stage;
+        result.kernel = kernel;
+        result.code = code.name();
+        result.data_bytes = size_;
+        result.seconds = seconds;
+        std::cout << "  " << std::left << std::setw(8) << kernel << std::setw(18) << stage << std::right
+                  << std::fixed << std::setprecision(1) << std::setw(10) << result.throughput_mb_s() << " MB/s"
+                  << std::endl;
+        results.push_back(result);
+    }
+
+    /**
+     * Single-threaded ReedSolomon over in-memory groups
+     */
+    void run_codec(const std::vector<uint8_t>& data, const CodeShape& code, GfKernel kernel,
+                   std::vector<ErasureResult>& results) {
+        const size_t k = code.data_shards;
+        const size_t total = k + code.parity_shards;
+        const size_t groups = (data.size() + k * shard_size_ - 1) / (k * shard_size_);
+        ReedSolomon codec(k, code.parity_shards, kernel);
+
+        std::vector<uint8_t> stripes(groups * total * shard_size_, 0);
+        for (size_t g = 0; g < groups; ++g) {
+            size_t offset = g * k * shard_size_;
+            std::copy(data.begin() + offset, data.begin() + std::min(data.size(), offset + k * shard_size_),
+                      stripes.begin() + g * total * shard_size_);
+        }
+        auto group_pointers = [&](size_t g) {
+            std::vector<uint8_t*> pointers(total);
+            for (size_t i = 0; i < total; ++i) {
+                pointers[i] = stripes.data() + (g * total + i) * shard_size_;
+            }
+            return pointers;
+        };
+
+        double encode_seconds = time_best([&]() {
+            for (size_t g = 0; g < groups; ++g) {
+                std::vector<uint8_t*> pointers = group_pointers(g);
+                codec.encode(pointers.data(), pointers.data() + k, shard_size_);
+            }
+        });
+        report("encode", gf_kernel_name(kernel), code, encode_seconds, results);
+
+        // Worst case: the lost shards are all data shards
+        const std::vector<uint8_t> reference = stripes;
+        std::vector<bool> present(total, true);
+        for (size_t i = 0; i < code.parity_shards && i < k; ++i) {
+            present[i] = false;
+        }
+        double repair_seconds = time_best([&]() {
+            for (size_t g = 0; g < groups; ++g) {
+                std::vector<uint8_t*> pointers = group_pointers(g);
+                codec.reconstruct(pointers.data(), present, shard_size_, true);
+            }
+        });
+        if (stripes != reference) {
+            throw std::runtime_error("Repair mismatch for RS(" + code.name() + ") with " + gf_kernel_name(kernel));
+        }
+        report("repair_" + std::to_string(code.parity_shards) + "_lost", gf_kernel_name(kernel), code,
+               repair_seconds, results);
+    }
+
+    /**
+     * Framed shards with hashing, grouping and the thread pool
+     */
+    void run_container(const std::vector<uint8_t>& data, const CodeShape& code, std::vector<ErasureResult>& results) {
+        ErasureOptions options;
+        options.data_shards = code.data_shards;
+        options.parity_shards = code.parity_shards;
+        options.shard_size = shard_size_;
+        options.num_threads = num_threads_;
+
+        std::vector<std::vector<uint8_t>> shards;
+        double encode_seconds = time_best([&]() { shards = erasure_encode(data.data(), data.size(), options); });
+        report("container_encode", "auto", code, encode_seconds, results);
+
+        // Drop the first parity_shards data shards of every group
+        const size_t total = code.data_shards + code.parity_shards;
+        std::vector<std::vector<uint8_t>> survivors;
+        for (size_t i = 0; i < shards.size(); ++i) {
+            if (i % total >= std::min(code.parity_shards, code.data_shards)) {
+                survivors.push_back(std::move(shards[i]));
+            }
+        }
+        std::vector<uint8_t> recovered;
+        double repair_seconds = time_best([&]() { recovered = erasure_decode(survivors, nullptr, num_threads_); });
+        if (recovered != data) {
+            throw std::runtime_error("Container repair mismatch for RS(" + code.name() + ")");
+        }
+        report("container_repair", "auto", code, repair_seconds, results);
+    }
+
+    void save_results(const std::vector<ErasureResult>& results) {
+        std::ofstream file("erasure_benchmark_results.json");
+        if (!file.is_open()) {
+            std::cout << "Warning: Could not save results to file" << std::endl;
+            return;
+        }
+        file << "{\n  \"data_bytes\": " << size_ << ",\n  \"shard_size\": " << shard_size_ << ",\n";
+        file << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const ErasureResult& result = results[i];
+            file << "    {\"stage\": \"" << result.stage << "\", \"kernel\": \"" << result.kernel
+                 << "\", \"code\": \"" << result.code << "\", \"seconds\": " << std::fixed << std::setprecision(6)
+                 << result.seconds << ", \"throughput_mb_s\": " << std::setprecision(2) << result.throughput_mb_s()
+                 << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        file << "  ]\n}\n";
+        std::cout << "\nDetailed results saved to: erasure_benchmark_results.json" << std::endl;
+    }
+
+    size_t size_;
+    size_t shard_size_;
+    size_t repeat_;
+    size_t num_threads_;
+    std::vector<CodeShape> codes_;
+};
+
+std::vector<CodeShape> parse_codes(const std::string& list) {
+    std::vector<CodeShape> codes;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        size_t plus = item.find('+');
+        if (plus == std::string::npos) {
+            throw std::invalid_argument("Code shapes are written K+M, got '" + item + "'");
+        }
+        codes.push_back({std::stoul(item.substr(0, plus)), std::stoul(item.substr(plus + 1))});
+    }
+    return codes;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t size_mb = 64;
+    size_t shard_size = 65536;
+    size_t repeat = 3;
+    size_t num_threads = 0;
+    std::string codes = "10+4,16+4,8+8,32+8";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--size" && i + 1 < argc) {
+            size_mb = std::stoul(argv[++i]);
+        } else if (arg == "--shard-size" && i + 1 < argc) {
+            shard_size = std::stoul(argv[++i]);
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else if (arg == "--threads" && i + 1 < argc) {
+            num_threads = std::stoul(argv[++i]);
+        } else if (arg == "--codes" && i + 1 < argc) {
+            codes = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--size MB] [--shard-size N] [--repeat N] [--threads N] [--codes K+M,...]" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        ErasureBenchmark benchmark(size_mb * 1048576, shard_size, repeat, num_threads, parse_codes(codes));
+        benchmark.run_all();
+        std::cout << "\n🎉 Erasure benchmark completed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,823 @@
+/**
+ * File-level end-to-end benchmark for CCC C++ implementation
+ * Measures read → compress → write and read → decompress → write on real
+ * files, comparing buffered, mmap, O_DIRECT and io_uring I/O, with per-phase
+ * time, total throughput and CPU utilization.
+ *
+ * Usage:
+ *     file_io_benchmark [file ...] [--size MB] [--modes buffered,mmap,direct,io_uring]
+ *                       [--repeat N] [--threads N] [--dir DIR] [--keep-cache] [--no-sync]
+ *
+ * Without input files a synthetic 2-bit packed sequence file of --size MB is generated.
+ * Page cache is dropped for the input before every run unless --keep-cache is given,
+ * and the write phase includes fdatasync() unless --no-sync is given.
+ */
+
+#include "circular_chromosome_compression.h"
+#include "archive.h"
+#include "autotune.h"
+#include "fast_hash.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#if defined(SYS_io_uring_setup) && defined(SYS_io_uring_enter)
+#define CCC_HAVE_IO_URING 1
+#endif
+#endif
+
+using namespace ccc;
+using namespace std::chrono;
+
+namespace {
+
+constexpr size_t kDirectAlignment = 4096;
+constexpr size_t kChunkSize = 1048576;
+constexpr unsigned kQueueDepth = 8;
+
+enum class IoMode { Buffered, Mmap, Direct, IoUring };
+
+const char* mode_name(IoMode mode) {
+    switch (mode) {
+        case IoMode::Buffered: return "buffered";
+        case IoMode::Mmap: return "mmap";
+        case IoMode::Direct: return "direct";
+        case IoMode::IoUring: return "io_uring";
+    }
+    return "unknown";
+}
+
+struct BenchmarkOptions {
+    std::vector<std::string> inputs;
+    std::vector<IoMode> modes = {IoMode::Buffered, IoMode::Mmap, IoMode::Direct, IoMode::IoUring};
+    size_t size_mb = 64;
+    size_t repeat = 3;
+    size_t num_threads = 0;
+    std::string dir = ".";
+    bool drop_cache = true;
+    bool sync_writes = true;
+};
+
+struct PhaseTimes {
+    double read_sec = 0.0;
+    double codec_sec = 0.0;
+    double write_sec = 0.0;
+    double cpu_sec = 0.0;               // user + system over all phases
+
+    double total_sec() const { return read_sec + codec_sec + write_sec; }
+};
+
+struct FileResult {
+    std::string input;
+    std::string mode;
+    std::string operation;              // "compress" or "decompress"
+    size_t input_bytes = 0;
+    size_t output_bytes = 0;
+    size_t original_bytes = 0;          // uncompressed size, the throughput basis
+    PhaseTimes best;                    // fastest total of the repeats
+    bool verified = false;
+    std::string error_message;
+
+    double throughput_mb_s() const {
+        return best.total_sec() > 0 ? original_bytes / 1048576.0 / best.total_sec() : 0.0;
+    }
+    double cpu_percent() const { return best.total_sec() > 0 ? 100.0 * best.cpu_sec / best.total_sec() : 0.0; }
+};
+
+double cpu_seconds() {
+    struct rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+[[noreturn]] void throw_errno(const std::string& what) {
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+/**
+ * File descriptor closed on scope exit
+ */
+class FileHandle {
+public:
+    FileHandle(const std::string& path, int flags, mode_t mode = 0644) : fd_(::open(path.c_str(), flags, mode)) {
+        if (fd_ < 0) {
+            throw_errno("Cannot open " + path);
+        }
+    }
+    ~FileHandle() { ::close(fd_); }
+    FileHandle(const FileHandle&) = delete;
+    FileHandle& operator=(const FileHandle&) = delete;
+    int get() const { return fd_; }
+
+private:
+    int fd_;
+};
+
+/**
+ * Bytes of an input file: an owned vector, an aligned O_DIRECT buffer or a mapping
+ */
+class InputBuffer {
+public:
+    InputBuffer() = default;
+    ~InputBuffer() { release(); }
+    InputBuffer(const InputBuffer&) = delete;
+    InputBuffer& operator=(const InputBuffer&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    void own(std::vector<uint8_t> bytes) {
+        release();
+        owned_ = std::move(bytes);
+        data_ = owned_.data();
+        size_ = owned_.size();
+    }
+    void own_aligned(uint8_t* buffer, size_t size) {
+        release();
+        aligned_ = buffer;
+        data_ = buffer;
+        size_ = size;
+    }
+    void own_mapping(void* mapping, size_t size) {
+        release();
+        mapping_ = mapping;
+        data_ = static_cast<const uint8_t*>(mapping);
+        size_ = size;
+    }
+
+    /**
+     * Contents as a vector for compress(); moves when the bytes are already a vector
+     */
+    std::vector<uint8_t> take_vector() {
+        if (!owned_.empty() || size_ == 0) {
+            return std::move(owned_);
+        }
+        return std::vector<uint8_t>(data_, data_ + size_);
+    }
+
+private:
+    void release() {
+        if (mapping_ != nullptr) {
+            ::munmap(mapping_, size_);
+        }
+        std::free(aligned_);
+        mapping_ = nullptr;
+        aligned_ = nullptr;
+        owned_.clear();
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    std::vector<uint8_t> owned_;
+    uint8_t* aligned_ = nullptr;
+    void* mapping_ = nullptr;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+uint8_t* aligned_alloc_or_throw(size_t size) {
+    void* buffer = nullptr;
+    if (::posix_memalign(&buffer, kDirectAlignment, std::max(size, kDirectAlignment)) != 0) {
+        throw std::bad_alloc();
+    }
+    return static_cast<uint8_t*>(buffer);
+}
+
+size_t align_up(size_t value) {
+    return (value + kDirectAlignment - 1) / kDirectAlignment * kDirectAlignment;
+}
+
+void read_fully(int fd, uint8_t* buffer, size_t size, const std::string& path) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = ::pread(fd, buffer + done, size - done, static_cast<off_t>(done));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw_errno("Read failed on " + path);
+        }
+        if (n == 0) break;
+        done += static_cast<size_t>(n);
+    }
+}
+
+void write_fully(int fd, const uint8_t* buffer, size_t size, const std::string& path) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = ::pwrite(fd, buffer + done, size - done, static_cast<off_t>(done));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw_errno("Write failed on " + path);
+        }
+        done += static_cast<size_t>(n);
+    }
+}
+
+size_t file_size(int fd, const std::string& path) {
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        throw_errno("Cannot stat " + path);
+    }
+    return static_cast<size_t>(st.st_size);
+}
+
+#ifdef CCC_HAVE_IO_URING
+/**
+ * Minimal io_uring driven through the raw system calls (no liburing needed)
+ * Keeps up to kQueueDepth chunk transfers in flight over one file.
+ */
+class IoUring {
+public:
+    IoUring() {
+        std::memset(&params_, 0, sizeof(params_));
+        fd_ = static_cast<int>(::syscall(SYS_io_uring_setup, kQueueDepth, &params_));
+        if (fd_ < 0) {
+            throw_errno("io_uring_setup");
+        }
+        sq_size_ = params_.sq_off.array + params_.sq_entries * sizeof(unsigned);
+        cq_size_ = params_.cq_off.cqes + params_.cq_entries * sizeof(io_uring_cqe);
+        if (params_.features & IORING_FEAT_SINGLE_MMAP) {
+            sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+        }
+        sq_ring_ = ::mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        cq_ring_ = (params_.features & IORING_FEAT_SINGLE_MMAP)
+                       ? sq_ring_
+                       : ::mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                                IORING_OFF_CQ_RING);
+        sqes_size_ = params_.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(
+            ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES));
+        if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+            int saved = errno;
+            unmap();
+            ::close(fd_);
+            errno = saved;
+            throw_errno("io_uring mmap");
+        }
+    }
+
+    ~IoUring() {
+        unmap();
+        ::close(fd_);
+    }
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    /**
+     * Read or write [0, size) of a file in kChunkSize pieces; short transfers are resubmitted
+     */
+    void transfer(int file_fd, uint8_t* buffer, size_t size, bool write) {
+        struct Pending {
+            size_t offset;
+            size_t length;
+        };
+        std::vector<Pending> slots(kQueueDepth);
+        std::vector<unsigned> free_slots;
+        for (unsigned i = 0; i < kQueueDepth; ++i) {
+            free_slots.push_back(i);
+        }
+
+        size_t next = 0;
+        size_t in_flight = 0;
+        while (next < size || in_flight > 0) {
+            unsigned to_submit = 0;
+            while (next < size && !free_slots.empty()) {
+                unsigned slot = free_slots.back();
+                free_slots.pop_back();
+                slots[slot] = {next, std::min(kChunkSize, size - next)};
+                queue(file_fd, buffer, slots[slot].offset, slots[slot].length, write, slot);
+                next += slots[slot].length;
+                ++to_submit;
+            }
+            if (::syscall(SYS_io_uring_enter, fd_, to_submit, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+                errno != EINTR) {
+                throw_errno("io_uring_enter");
+            }
+            in_flight += to_submit;
+
+            unsigned* cq_head = cq_field(params_.cq_off.head);
+            unsigned head = *cq_head;
+            unsigned tail = __atomic_load_n(cq_field(params_.cq_off.tail), __ATOMIC_ACQUIRE);
+            unsigned mask = *cq_field(params_.cq_off.ring_mask);
+            auto* cqes = reinterpret_cast<io_uring_cqe*>(static_cast<uint8_t*>(cq_ring_) + params_.cq_off.cqes);
+            std::vector<unsigned> resubmit;
+            for (; head != tail; ++head) {
+                const io_uring_cqe& cqe = cqes[head & mask];
+                unsigned slot = static_cast<unsigned>(cqe.user_data);
+                --in_flight;
+                if (cqe.res < 0) {
+                    errno = -cqe.res;
+                    throw_errno(write ? "io_uring write" : "io_uring read");
+                }
+                Pending& pending = slots[slot];
+                size_t done = static_cast<size_t>(cqe.res);
+                if (done == 0 && !write) {
+                    throw std::runtime_error("io_uring read hit end of file early");
+                }
+                if (done < pending.length) {
+                    pending = {pending.offset + done, pending.length - done};
+                    resubmit.push_back(slot);
+                } else {
+                    free_slots.push_back(slot);
+                }
+            }
+            __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+
+            for (unsigned slot : resubmit) {
+                queue(file_fd, buffer, slots[slot].offset, slots[slot].length, write, slot);
+            }
+            if (!resubmit.empty()) {
+                if (::syscall(SYS_io_uring_enter, fd_, resubmit.size(), 0, 0, nullptr, 0) < 0) {
+                    throw_errno("io_uring_enter");
+                }
+                in_flight += resubmit.size();
+            }
+        }
+    }
+
+private:
+    unsigned* sq_field(unsigned offset) {
+        return reinterpret_cast<unsigned*>(static_cast<uint8_t*>(sq_ring_) + offset);
+    }
+    unsigned* cq_field(unsigned offset) {
+        return reinterpret_cast<unsigned*>(static_cast<uint8_t*>(cq_ring_) + offset);
+    }
+
+    void queue(int file_fd, uint8_t* buffer, size_t offset, size_t length, bool write, unsigned slot) {
+        unsigned tail = *sq_field(params_.sq_off.tail);
+        unsigned index = tail & *sq_field(params_.sq_off.ring_mask);
+        io_uring_sqe& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = write ? IORING_OP_WRITE : IORING_OP_READ;
+        sqe.fd = file_fd;
+        sqe.addr = reinterpret_cast<uint64_t>(buffer + offset);
+        sqe.len = static_cast<uint32_t>(length);
+        sqe.off = offset;
+        sqe.user_data = slot;
+        sq_field(params_.sq_off.array)[index] = index;
+        __atomic_store_n(sq_field(params_.sq_off.tail), tail + 1, __ATOMIC_RELEASE);
+    }
+
+    void unmap() {
+        if (sqes_ != nullptr && sqes_ != MAP_FAILED) ::munmap(sqes_, sqes_size_);
+        if (cq_ring_ != nullptr && cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) ::munmap(cq_ring_, cq_size_);
+        if (sq_ring_ != nullptr && sq_ring_ != MAP_FAILED) ::munmap(sq_ring_, sq_size_);
+    }
+
+    int fd_ = -1;
+    io_uring_params params_;
+    void* sq_ring_ = nullptr;
+    void* cq_ring_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sq_size_ = 0;
+    size_t cq_size_ = 0;
+    size_t sqes_size_ = 0;
+};
+#endif
+
+void read_input(IoMode mode, const std::string& path, InputBuffer& input) {
+    switch (mode) {
+        case IoMode::Buffered: {
+            FileHandle file(path, O_RDONLY);
+            std::vector<uint8_t> bytes(file_size(file.get(), path));
+            read_fully(file.get(), bytes.data(), bytes.size(), path);
+            input.own(std::move(bytes));
+            return;
+        }
+        case IoMode::Mmap: {
+            FileHandle file(path, O_RDONLY);
+            size_t size = file_size(file.get(), path);
+            if (size == 0) {
+                input.own({});
+                return;
+            }
+            void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file.get(), 0);
+            if (mapping == MAP_FAILED) {
+                throw_errno("Cannot map " + path);
+            }
+            ::madvise(mapping, size, MADV_SEQUENTIAL);
+            input.own_mapping(mapping, size);
+            return;
+        }
+        case IoMode::Direct: {
+            FileHandle file(path, O_RDONLY | O_DIRECT);
+            size_t size = file_size(file.get(), path);
+            uint8_t* buffer = aligned_alloc_or_throw(align_up(size));
+            input.own_aligned(buffer, size);
+            read_fully(file.get(), buffer, align_up(size), path);
+            return;
+        }
+        case IoMode::IoUring: {
+#ifdef CCC_HAVE_IO_URING
+            FileHandle file(path, O_RDONLY);
+            std::vector<uint8_t> bytes(file_size(file.get(), path));
+            IoUring ring;
+            ring.transfer(file.get(), bytes.data(), bytes.size(), false);
+            input.own(std::move(bytes));
+            return;
+#else
+            throw std::runtime_error("io_uring is not available on this platform");
+#endif
+        }
+    }
+}
+
+void write_output(IoMode mode, const std::string& path, const uint8_t* data, size_t size, bool sync) {
+    switch (mode) {
+        case IoMode::Buffered: {
+            FileHandle file(path, O_WRONLY | O_CREAT | O_TRUNC);
+            write_fully(file.get(), data, size, path);
+            if (sync) ::fdatasync(file.get());
+            return;
+        }
+        case IoMode::Mmap: {
+            FileHandle file(path, O_RDWR | O_CREAT | O_TRUNC);
+            if (size == 0) return;
+            if (::ftruncate(file.get(), static_cast<off_t>(size)) != 0) {
+                throw_errno("Cannot size " + path);
+            }
+            void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file.get(), 0);
+            if (mapping == MAP_FAILED) {
+                throw_errno("Cannot map " + path);
+            }
+            std::memcpy(mapping, data, size);
+            if (sync) ::msync(mapping, size, MS_SYNC);
+            ::munmap(mapping, size);
+            return;
+        }
+        case IoMode::Direct: {
+            // O_DIRECT needs aligned buffers and lengths: write padded, then trim
+            FileHandle file(path, O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT);
+            std::unique_ptr<uint8_t, decltype(&std::free)> buffer(aligned_alloc_or_throw(align_up(size)), &std::free);
+            std::memcpy(buffer.get(), data, size);
+            std::memset(buffer.get() + size, 0, align_up(size) - size);
+            write_fully(file.get(), buffer.get(), align_up(size), path);
+            if (::ftruncate(file.get(), static_cast<off_t>(size)) != 0) {
+                throw_errno("Cannot trim " + path);
+            }
+            if (sync) ::fdatasync(file.get());
+            return;
+        }
+        case IoMode::IoUring: {
+#ifdef CCC_HAVE_IO_URING
+            FileHandle file(path, O_WRONLY | O_CREAT | O_TRUNC);
+            IoUring ring;
+            ring.transfer(file.get(), const_cast<uint8_t*>(data), size, true);
+            if (sync) ::fdatasync(file.get());
+            return;
+#else
+            throw std::runtime_error("io_uring is not available on this platform");
+#endif
+        }
+    }
+}
+
+/**
+ * Write back and evict a file from the page cache so the next read hits storage
+ */
+void drop_page_cache(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::fdatasync(fd);
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+}
+
+/**
+ * Whether a mode works on the benchmark directory (O_DIRECT is refused by
+ * tmpfs and some overlay filesystems; io_uring may be disabled by seccomp)
+ */
+bool mode_available(IoMode mode, const std::string& dir, std::string& reason) {
+    const std::string probe = dir + "/.ccc_io_probe";
+    try {
+        std::vector<uint8_t> bytes(kDirectAlignment, 0x5A);
+        write_output(mode, probe, bytes.data(), bytes.size(), false);
+        InputBuffer input;
+        read_input(mode, probe, input);
+        std::remove(probe.c_str());
+        return input.size() == bytes.size();
+    } catch (const std::exception& e) {
+        std::remove(probe.c_str());
+        reason = e.what();
+        return false;
+    }
+}
+
+/**
+ * Synthetic input: repeated motifs with point mutations, as 2-bit packed bases
+ */
+std::vector<uint8_t> create_sequence_data(size_t size) {
+    std::vector<std::vector<uint8_t>> motifs;
+    uint32_t state = 12345;
+    auto next = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return state;
+    };
+    for (int m = 0; m < 256; ++m) {
+        std::vector<uint8_t> motif(16 + next() % 240);
+        for (uint8_t& byte : motif) {
+            byte = static_cast<uint8_t>(next() >> 24);
+        }
+        motifs.push_back(std::move(motif));
+    }
+    std::vector<uint8_t> data;
+    data.reserve(size);
+    while (data.size() < size) {
+        std::vector<uint8_t> motif = motifs[next() % motifs.size()];
+        if (next() % 4 == 0) {
+            motif[next() % motif.size()] ^= static_cast<uint8_t>(1 << (next() % 8));
+        }
+        data.insert(data.end(), motif.begin(), motif.begin() + std::min(motif.size(), size - data.size()));
+    }
+    return data;
+}
+
+class FileIoBenchmark {
+public:
+    explicit FileIoBenchmark(const BenchmarkOptions& options)
+        : options_(options), compressor_(1000, 4, true, false) {
+        if (!apply_machine_profile(compressor_)) {
+            compressor_.set_block_size(4 * 1048576);
+        }
+        if (options_.num_threads != 0) {
+            compressor_.set_num_threads(options_.num_threads);
+        }
+    }
+
+    void run_all() {
+        std::cout << "=== CCC C++ File I/O Benchmark ===" << std::endl;
+        std::cout << "Directory: " << options_.dir << ", repeats: " << options_.repeat
+                  << ", page cache " << (options_.drop_cache ? "dropped" : "kept")
+                  << ", writes " << (options_.sync_writes ? "synced" : "unsynced") << std::endl;
+
+        std::vector<std::string> inputs = options_.inputs;
+        std::string generated;
+        if (inputs.empty()) {
+            generated = options_.dir + "/ccc_io_benchmark_input.bin";
+            std::cout << "Generating " << options_.size_mb << "MB sequence input..." << std::flush;
+            std::vector<uint8_t> data = create_sequence_data(options_.size_mb * 1048576);
+            write_output(IoMode::Buffered, generated, data.data(), data.size(), true);
+            std::cout << " Done." << std::endl;
+            inputs.push_back(generated);
+        }
+
+        std::vector<IoMode> modes;
+        for (IoMode mode : options_.modes) {
+            std::string reason;
+            if (mode_available(mode, options_.dir, reason)) {
+                modes.push_back(mode);
+            } else {
+                std::cout << "Skipping " << mode_name(mode) << ": " << reason << std::endl;
+            }
+        }
+
+        std::vector<FileResult> results;
+        for (const std::string& input : inputs) {
+            for (IoMode mode : modes) {
+                std::cout << "\n" << input << " [" << mode_name(mode) << "]" << std::endl;
+                run_file(input, mode, results);
+            }
+        }
+        if (!generated.empty()) {
+            std::remove(generated.c_str());
+        }
+
+        print_summary(results);
+        save_results(results);
+    }
+
+private:
+    void run_file(const std::string& input, IoMode mode, std::vector<FileResult>& results) {
+        const std::string archive_path = options_.dir + "/ccc_io_benchmark." + mode_name(mode) + ".ccc";
+        const std::string restored_path = options_.dir + "/ccc_io_benchmark." + mode_name(mode) + ".out";
+
+        FileResult compress_result;
+        compress_result.input = input;
+        compress_result.mode = mode_name(mode);
+        compress_result.operation = "compress";
+        FileResult decompress_result = compress_result;
+        decompress_result.operation = "decompress";
+
+        uint64_t input_hash = 0;
+        try {
+            for (size_t r = 0; r < options_.repeat; ++r) {
+                PhaseTimes times = compress_file(input, archive_path, mode, compress_result, input_hash);
+                keep_best(compress_result, times);
+            }
+            compress_result.verified = true;
+            report(compress_result);
+
+            for (size_t r = 0; r < options_.repeat; ++r) {
+                uint64_t output_hash = 0;
+                PhaseTimes times = decompress_file(archive_path, restored_path, mode, decompress_result, output_hash);
+                keep_best(decompress_result, times);
+                decompress_result.verified = output_hash == input_hash;
+            }
+            report(decompress_result);
+        } catch (const std::exception& e) {
+            compress_result.error_message = decompress_result.error_message = e.what();
+            std::cout << "  ✗ Error: " << e.what() << std::endl;
+        }
+        std::remove(archive_path.c_str());
+        std::remove(restored_path.c_str());
+        results.push_back(compress_result);
+        results.push_back(decompress_result);
+    }
+
+    PhaseTimes compress_file(const std::string& input_path, const std::string& output_path, IoMode mode,
+                             FileResult& result, uint64_t& input_hash) {
+        if (options_.drop_cache) {
+            drop_page_cache(input_path);
+        }
+        PhaseTimes times;
+        double cpu_start = cpu_seconds();
+
+        auto start = steady_clock::now();
+        InputBuffer input;
+        read_input(mode, input_path, input);
+        std::vector<uint8_t> data = input.take_vector();
+        auto read_done = steady_clock::now();
+
+        auto [codes, metadata] = compressor_.compress(data);
+        std::vector<uint8_t> archive = serialize_archive(codes, metadata);
+        auto codec_done = steady_clock::now();
+
+        write_output(mode, output_path, archive.data(), archive.size(), options_.sync_writes);
+        auto write_done = steady_clock::now();
+
+        times.cpu_sec = cpu_seconds() - cpu_start;
+        times.read_sec = duration<double>(read_done - start).count();
+        times.codec_sec = duration<double>(codec_done - read_done).count();
+        times.write_sec = duration<double>(write_done - codec_done).count();
+
+        result.input_bytes = result.original_bytes = data.size();
+        result.output_bytes = archive.size();
+        input_hash = fast_hash64(data.data(), data.size());
+        return times;
+    }
+
+    PhaseTimes decompress_file(const std::string& input_path, const std::string& output_path, IoMode mode,
+                               FileResult& result, uint64_t& output_hash) {
+        if (options_.drop_cache) {
+            drop_page_cache(input_path);
+        }
+        PhaseTimes times;
+        double cpu_start = cpu_seconds();
+
+        auto start = steady_clock::now();
+        InputBuffer input;
+        read_input(mode, input_path, input);
+        auto read_done = steady_clock::now();
+
+        // The archive parser reads mapped and aligned buffers in place
+        auto [codes, metadata] = deserialize_archive(input.data(), input.size());
+        std::vector<uint8_t> data = compressor_.decompress(codes, metadata);
+        auto codec_done = steady_clock::now();
+
+        write_output(mode, output_path, data.data(), data.size(), options_.sync_writes);
+        auto write_done = steady_clock::now();
+
+        times.cpu_sec = cpu_seconds() - cpu_start;
+        times.read_sec = duration<double>(read_done - start).count();
+        times.codec_sec = duration<double>(codec_done - read_done).count();
+        times.write_sec = duration<double>(write_done - codec_done).count();
+
+        result.input_bytes = input.size();
+        result.output_bytes = result.original_bytes = data.size();
+        output_hash = fast_hash64(data.data(), data.size());
+        return times;
+    }
+
+    static void keep_best(FileResult& result, const PhaseTimes& times) {
+        if (result.best.total_sec() == 0.0 || times.total_sec() < result.best.total_sec()) {
+            result.best = times;
+        }
+    }
+
+    static void report(const FileResult& result) {
+        std::cout << "  " << std::left << std::setw(11) << result.operation << std::right << std::fixed
+                  << std::setprecision(2) << "read " << std::setw(8) << result.best.read_sec * 1000 << " ms, codec "
+                  << std::setw(8) << result.best.codec_sec * 1000 << " ms, write " << std::setw(8)
+                  << result.best.write_sec * 1000 << " ms → " << std::setw(7) << result.throughput_mb_s()
+                  << " MB/s, CPU " << std::setprecision(1) << result.cpu_percent() << "%"
+                  << (result.verified ? "" : "  ✗ output mismatch") << std::endl;
+    }
+
+    void print_summary(const std::vector<FileResult>& results) {
+        std::cout << "\n=== File I/O Summary ===" << std::endl;
+        std::cout << std::left << std::setw(10) << "Mode" << std::setw(12) << "Operation" << std::right
+                  << std::setw(10) << "Read ms" << std::setw(11) << "Codec ms" << std::setw(10) << "Write ms"
+                  << std::setw(10) << "MB/s" << std::setw(8) << "CPU%" << "  Status" << std::endl;
+        std::cout << std::string(80, '-') << std::endl;
+        for (const FileResult& result : results) {
+            std::cout << std::left << std::setw(10) << result.mode << std::setw(12) << result.operation << std::right
+                      << std::fixed << std::setprecision(2) << std::setw(10) << result.best.read_sec * 1000
+                      << std::setw(11) << result.best.codec_sec * 1000 << std::setw(10)
+                      << result.best.write_sec * 1000 << std::setw(10) << result.throughput_mb_s() << std::setw(8)
+                      << std::setprecision(1) << result.cpu_percent() << "  "
+                      << (result.error_message.empty() && result.verified ? "✓" : "✗") << std::endl;
+        }
+    }
+
+    void save_results(const std::vector<FileResult>& results) {
+        std::ofstream file("file_io_benchmark_results.json");
+        if (!file.is_open()) {
+            std::cout << "Warning: Could not save results to file" << std::endl;
+            return;
+        }
+        file << "{\n  \"repeat\": " << options_.repeat << ",\n";
+        file << "  \"page_cache_dropped\": " << (options_.drop_cache ? "true" : "false") << ",\n";
+        file << "  \"synced_writes\": " << (options_.sync_writes ? "true" : "false") << ",\n";
+        file << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const FileResult& result = results[i];
+            file << "    {\"input\": \"" << result.input << "\", \"mode\": \"" << result.mode
+                 << "\", \"operation\": \"" << result.operation << "\", \"input_bytes\": " << result.input_bytes
+                 << ", \"output_bytes\": " << result.output_bytes << std::fixed << std::setprecision(6)
+                 << ", \"read_sec\": " << result.best.read_sec << ", \"codec_sec\": " << result.best.codec_sec
+                 << ", \"write_sec\": " << result.best.write_sec << ", \"cpu_sec\": " << result.best.cpu_sec
+                 << std::setprecision(2) << ", \"throughput_mb_s\": " << result.throughput_mb_s()
+                 << ", \"cpu_percent\": " << result.cpu_percent()
+                 << ", \"verified\": " << (result.verified ? "true" : "false");
+            if (!result.error_message.empty()) {
+                file << ", \"error\": \"" << result.error_message << "\"";
+            }
+            file << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        file << "  ]\n}\n";
+        std::cout << "\nDetailed results saved to: file_io_benchmark_results.json" << std::endl;
+    }
+
+    BenchmarkOptions options_;
+    CircularChromosomeCompressor compressor_;
+};
+
+std::vector<IoMode> parse_modes(const std::string& list) {
+    std::vector<IoMode> modes;
+    std::stringstream stream(list);
+    std::string name;
+    while (std::getline(stream, name, ',')) {
+        if (name == "buffered") modes.push_back(IoMode::Buffered);
+        else if (name == "mmap") modes.push_back(IoMode::Mmap);
+        else if (name == "direct") modes.push_back(IoMode::Direct);
+        else if (name == "io_uring") modes.push_back(IoMode::IoUring);
+        else throw std::invalid_argument("Unknown I/O mode: " + name);
+    }
+    return modes;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        BenchmarkOptions options;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--size" && i + 1 < argc) {
+                options.size_mb = std::stoul(argv[++i]);
+            } else if (arg == "--modes" && i + 1 < argc) {
+                options.modes = parse_modes(argv[++i]);
+            } else if (arg == "--repeat" && i + 1 < argc) {
+                options.repeat = std::max<size_t>(1, std::stoul(argv[++i]));
+            } else if (arg == "--threads" && i + 1 < argc) {
+                options.num_threads = std::stoul(argv[++i]);
+            } else if (arg == "--dir" && i + 1 < argc) {
+                options.dir = argv[++i];
+            } else if (arg == "--keep-cache") {
+                options.drop_cache = false;
+            } else if (arg == "--no-sync") {
+                options.sync_writes = false;
+            } else {
+                options.inputs.push_back(arg);
+            }
+        }
+
+        FileIoBenchmark benchmark(options);
+        benchmark.run_all();
+        std::cout << "\n🎉 File I/O benchmark completed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,313 @@
+/**
+ * Typed pre-filter benchmark for CCC C++ implementation
+ * Compresses synthetic numeric corpora (coverage counts, float signal,
+ * sorted positions, sensor readings) without filters and with delta, XOR,
+ * byte-shuffle and bit-shuffle chains at the corpus element width, reporting
+ * archive size, compression ratio and compress/decompress throughput. Also
+ * times every filter kernel alone, SSE2 against scalar.
+ *
+ * Usage:
+ *     prefilter_benchmark [--size MB] [--repeat N] [--block-size N] [--threads N]
+ */
+
+#include "circular_chromosome_compression.h"
+#include "archive.h"
+#include "prefilter.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ccc;
+using namespace std::chrono;
+
+namespace {
+
+struct Corpus {
+    std::string name;
+    size_t element_size = 0;
+    std::vector<uint8_t> data;
+};
+
+template <typename T>
+void append_value(std::vector<uint8_t>& data, T value) {
+    uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+/**
+ * Numeric arrays shaped like the non-sequence data we store
+ */
+std::vector<Corpus> make_corpora(size_t size) {
+    std::mt19937_64 rng(2024);
+    std::vector<Corpus> corpora;
+
+    // Read depth along a genome: a random walk with occasional jumps at repeats and gaps
+    Corpus coverage{"coverage_u32", 4, {}};
+    int64_t depth = 30;
+    while (coverage.data.size() < size) {
+        depth += static_cast<int64_t>(rng() % 5) - 2;
+        if (rng() % 4096 == 0) {
+            depth = static_cast<int64_t>(rng() % 200);
+        }
+        depth = std::max<int64_t>(0, depth);
+        append_value(coverage.data, static_cast<uint32_t>(depth));
+    }
+    corpora.push_back(std::move(coverage));
+
+    // Nanopore-like current signal: drifting levels plus noise, as float32
+    Corpus signal{"signal_f32", 4, {}};
+    double level = 90.0;
+    std::normal_distribution<double> noise(0.0, 1.5);
+    while (signal.data.size() < size) {
+        if (rng() % 10 == 0) {
+            level = 70.0 + static_cast<double>(rng() % 4000) / 100.0;
+        }
+        append_value(signal.data, static_cast<float>(level + noise(rng)));
+    }
+    corpora.push_back(std::move(signal));
+
+    // Sorted variant positions: small gaps between 64-bit coordinates
+    Corpus positions{"positions_u64", 8, {}};
+    uint64_t position = 10000;
+    while (positions.data.size() < size) {
+        position += 1 + rng() % 1000;
+        append_value(positions.data, position);
+    }
+    corpora.push_back(std::move(positions));
+
+    // 16-bit sensor readings: a slow sine with quantisation noise
+    Corpus sensor{"sensor_i16", 2, {}};
+    for (size_t i = 0; sensor.data.size() < size; ++i) {
+        double value = 8000.0 * std::sin(static_cast<double>(i) * 0.0005) + static_cast<double>(rng() % 32);
+        append_value(sensor.data, static_cast<int16_t>(value));
+    }
+    corpora.push_back(std::move(sensor));
+
+    for (Corpus& corpus : corpora) {
+        corpus.data.resize(size);
+    }
+    return corpora;
+}
+
+/**
+ * Chains tried on every corpus, at the corpus element width
+ */
+std::vector<FilterChain> candidate_chains(size_t width) {
+    std::vector<FilterChain> chains = {
+        {},
+        {{FilterKind::Delta, width}},
+        {{FilterKind::XorDelta, width}},
+        {{FilterKind::ByteShuffle, width}},
+        {{FilterKind::BitShuffle, width}},
+        {{FilterKind::Delta, width}, {FilterKind::ByteShuffle, width}},
+        {{FilterKind::Delta, width}, {FilterKind::BitShuffle, width}},
+        {{FilterKind::XorDelta, width}, {FilterKind::ByteShuffle, width}},
+    };
+    return chains;
+}
+
+struct FilterResult {
+    std::string corpus;
+    std::string chain;
+    size_t input_bytes = 0;
+    size_t archive_bytes = 0;
+    double compress_seconds = 0.0;
+    double decompress_seconds = 0.0;
+
+    double ratio() const { return input_bytes ? static_cast<double>(archive_bytes) / input_bytes : 0.0; }
+    double compress_mb_s() const { return compress_seconds > 0 ? input_bytes / 1048576.0 / compress_seconds : 0.0; }
+    double decompress_mb_s() const {
+        return decompress_seconds > 0 ? input_bytes / 1048576.0 / decompress_seconds : 0.0;
+    }
+};
+
+struct KernelResult {
+    std::string stage;
+    double apply_sse2_gb_s = 0.0;
+    double apply_scalar_gb_s = 0.0;
+    double invert_sse2_gb_s = 0.0;
+    double invert_scalar_gb_s = 0.0;
+};
+
+class PrefilterBenchmark {
+public:
+    PrefilterBenchmark(size_t size, size_t repeat, size_t block_size, size_t num_threads)
+        : size_(size), repeat_(repeat), block_size_(block_size), num_threads_(num_threads) {}
+
+    void run_all() {
+        std::cout << "=== CCC Typed Pre-Filter Benchmark ===" << std::endl;
+        std::cout << "Corpus: " << size_ / 1048576.0 << " MB per array, " << block_size_ << " byte blocks, best of "
+                  << repeat_ << std::endl;
+
+        std::vector<Corpus> corpora = make_corpora(size_);
+        std::vector<FilterResult> results;
+        for (const Corpus& corpus : corpora) {
+            std::cout << "\n--- " << corpus.name << " ---" << std::endl;
+            for (const FilterChain& chain : candidate_chains(corpus.element_size)) {
+                run_corpus(corpus, chain, results);
+            }
+        }
+
+        std::cout << "\n--- Kernels (GB/s, SSE2 / scalar) ---" << std::endl;
+        std::vector<KernelResult> kernels;
+        const std::vector<uint8_t>& sample = corpora.front().data;
+        for (FilterKind kind : {FilterKind::Delta, FilterKind::XorDelta, FilterKind::ByteShuffle, FilterKind::BitShuffle}) {
+            for (size_t width : {1, 2, 4, 8}) {
+                if (kind == FilterKind::ByteShuffle && width == 1) {
+                    continue;
+                }
+                kernels.push_back(run_kernel(sample, {kind, width}));
+            }
+        }
+        save_results(results, kernels);
+    }
+
+private:
+    double time_best(const std::function<void()>& body) {
+        double best = 0.0;
+        for (size_t r = 0; r < repeat_; ++r) {
+            auto start = steady_clock::now();
+            body();
+            double seconds = duration<double>(steady_clock::now() - start).count();
+            best = r == 0 ? seconds : std::min(best, seconds);
+        }
+        return best;
+    }
+
+    void run_corpus(const Corpus& corpus, const FilterChain& chain, std::vector<FilterResult>& results) {
+        CircularChromosomeCompressor compressor(1000, 4, true, false);
+        compressor.set_block_size(block_size_);
+        compressor.set_num_threads(num_threads_);
+        compressor.set_prefilters(chain);
+
+        std::vector<int> codes;
+        CompressionMetadata metadata;
+        FilterResult result;
+        result.corpus = corpus.name;
+        result.chain = filter_chain_name(chain);
+        result.input_bytes = corpus.data.size();
+        result.compress_seconds = time_best([&]() { std::tie(codes, metadata) = compressor.compress(corpus.data); });
+
+        std::vector<uint8_t> restored;
+        result.decompress_seconds = time_best([&]() { restored = compressor.decompress(codes, metadata); });
+        if (restored != corpus.data) {
+            throw std::runtime_error("Round trip mismatch for " + corpus.name + " with " + result.chain);
+        }
+        result.archive_bytes = serialize_archive(codes, metadata).size();
+
+        std::cout << "  " << std::left << std::setw(20) << result.chain << std::right << std::setw(10)
+                  << result.archive_bytes << " bytes  ratio " << std::fixed << std::setprecision(4) << result.ratio()
+                  << "  " << std::setprecision(1) << std::setw(7) << result.compress_mb_s() << " MB/s in  "
+                  << std::setw(7) << result.decompress_mb_s() << " MB/s out" << std::endl;
+        results.push_back(result);
+    }
+
+    KernelResult run_kernel(const std::vector<uint8_t>& data, const FilterStage& stage) {
+        std::vector<uint8_t> filtered(data.size());
+        std::vector<uint8_t> restored(data.size());
+        auto gb_s = [&](double seconds) { return seconds > 0 ? data.size() / 1e9 / seconds : 0.0; };
+
+        KernelResult result;
+        result.stage = filter_chain_name({stage});
+        result.apply_scalar_gb_s = gb_s(time_best([&]() {
+            apply_filter(data.data(), filtered.data(), data.size(), stage, false);
+        }));
+        result.apply_sse2_gb_s = gb_s(time_best([&]() {
+            apply_filter(data.data(), filtered.data(), data.size(), stage, true);
+        }));
+        result.invert_scalar_gb_s = gb_s(time_best([&]() {
+            invert_filter(filtered.data(), restored.data(), data.size(), stage, false);
+        }));
+        result.invert_sse2_gb_s = gb_s(time_best([&]() {
+            invert_filter(filtered.data(), restored.data(), data.size(), stage, true);
+        }));
+        if (restored != data) {
+            throw std::runtime_error("Kernel round trip mismatch for " + result.stage);
+        }
+
+        std::cout << "  " << std::left << std::setw(14) << result.stage << std::right << std::fixed
+                  << std::setprecision(2) << " apply " << std::setw(6) << result.apply_sse2_gb_s << " / "
+                  << std::setw(6) << result.apply_scalar_gb_s << "   invert " << std::setw(6)
+                  << result.invert_sse2_gb_s << " / " << std::setw(6) << result.invert_scalar_gb_s << std::endl;
+        return result;
+    }
+
+    void save_results(const std::vector<FilterResult>& results, const std::vector<KernelResult>& kernels) {
+        std::ofstream file("prefilter_benchmark_results.json");
+        if (!file.is_open()) {
+            std::cout << "Warning: Could not save results to file" << std::endl;
+            return;
+        }
+        file << "{\n  \"array_bytes\": " << size_ << ",\n  \"block_size\": " << block_size_ << ",\n";
+        file << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const FilterResult& result = results[i];
+            file << "    {\"corpus\": \"" << result.corpus << "\", \"filters\": \"" << result.chain
+                 << "\", \"archive_bytes\": " << result.archive_bytes << ", \"ratio\": " << std::fixed
+                 << std::setprecision(6) << result.ratio() << ", \"compress_mb_s\": " << std::setprecision(2)
+                 << result.compress_mb_s() << ", \"decompress_mb_s\": " << result.decompress_mb_s() << "}"
+                 << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        file << "  ],\n  \"kernels\": [\n";
+        for (size_t i = 0; i < kernels.size(); ++i) {
+            const KernelResult& kernel = kernels[i];
+            file << "    {\"stage\": \"" << kernel.stage << "\", \"apply_sse2_gb_s\": " << std::fixed
+                 << std::setprecision(3) << kernel.apply_sse2_gb_s << ", \"apply_scalar_gb_s\": "
+                 << kernel.apply_scalar_gb_s << ", \"invert_sse2_gb_s\": " << kernel.invert_sse2_gb_s
+                 << ", \"invert_scalar_gb_s\": " << kernel.invert_scalar_gb_s << "}"
+                 << (i + 1 < kernels.size() ? "," : "") << "\n";
+        }
+        file << "  ]\n}\n";
+        std::cout << "\nDetailed results saved to: prefilter_benchmark_results.json" << std::endl;
+    }
+
+    size_t size_;
+    size_t repeat_;
+    size_t block_size_;
+    size_t num_threads_;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t size_mb = 8;
+    size_t repeat = 3;
+    size_t block_size = 1048576;
+    size_t num_threads = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--size" && i + 1 < argc) {
+            size_mb = std::stoul(argv[++i]);
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else if (arg == "--block-size" && i + 1 < argc) {
+            block_size = std::stoul(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            num_threads = std::stoul(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--size MB] [--repeat N] [--block-size N] [--threads N]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        PrefilterBenchmark benchmark(size_mb * 1048576, repeat, block_size, num_threads);
+        benchmark.run_all();
+        std::cout << "\n🎉 Pre-filter benchmark completed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,285 @@
+/**
+ * Tandem repeat coding benchmark for CCC C++ implementation
+ * Compresses a synthetic genome corpus with the tandem repeat stage off and
+ * at several minimum repeat lengths, reporting archive size (codes plus
+ * repeat tokens), compression ratio and compress/decompress throughput.
+ *
+ * Usage:
+ *     tandem_repeat_benchmark [--size MB] [--repeat N] [--block-size N] [--threads N] [--min-bases N,...]
+ */
+
+#include "circular_chromosome_compression.h"
+#include "archive.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ccc;
+using namespace std::chrono;
+
+namespace {
+
+/**
+ * Synthetic genome generator: bases as 2-bit symbols
+ */
+class GenomeGenerator {
+public:
+    explicit GenomeGenerator(uint64_t seed) : rng_(seed) {}
+
+    /**
+     * Random background only; the stage should find nothing and cost nothing
+     */
+    std::vector<uint8_t> random_background(size_t bases) {
+        std::vector<uint8_t> symbols;
+        append_random(symbols, bases);
+        return symbols;
+    }
+
+    /**
+     * Human-like: random background, interspersed copies of a few repeat
+     * families with 10% divergence, and microsatellites; each inserted element
+     * is a microsatellite with probability microsatellite_share
+     */
+    std::vector<uint8_t> genome(size_t bases, double microsatellite_share) {
+        std::vector<std::vector<uint8_t>> families(4);
+        for (auto& family : families) {
+            append_random(family, 150 + rng_() % 250);
+        }
+        std::vector<uint8_t> symbols;
+        symbols.reserve(bases + 1024);
+        while (symbols.size() < bases) {
+            double pick = uniform_(rng_);
+            if (pick < microsatellite_share) {
+                append_microsatellite(symbols);
+            } else if (pick < microsatellite_share + 0.4) {
+                const std::vector<uint8_t>& family = families[rng_() % families.size()];
+                for (uint8_t base : family) {
+                    symbols.push_back(uniform_(rng_) < 0.10 ? static_cast<uint8_t>(rng_() & 3) : base);
+                }
+            } else {
+                append_random(symbols, 100 + rng_() % 400);
+            }
+        }
+        symbols.resize(bases);
+        return symbols;
+    }
+
+private:
+    void append_random(std::vector<uint8_t>& symbols, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            symbols.push_back(static_cast<uint8_t>(rng_() & 3));
+        }
+    }
+
+    /**
+     * (unit)n with a 1-6 base unit, 8-60 copies and occasional point mutations
+     */
+    void append_microsatellite(std::vector<uint8_t>& symbols) {
+        static const uint32_t kPeriodWeights[] = {15, 40, 10, 20, 8, 7};   // dinucleotides dominate
+        std::discrete_distribution<uint32_t> period_pick(std::begin(kPeriodWeights), std::end(kPeriodWeights));
+        uint32_t period = period_pick(rng_) + 1;
+        uint8_t unit[6];
+        for (uint32_t k = 0; k < period; ++k) {
+            unit[k] = static_cast<uint8_t>(rng_() & 3);
+        }
+        size_t copies = 8 + rng_() % 53;
+        for (size_t c = 0; c < copies; ++c) {
+            for (uint32_t k = 0; k < period; ++k) {
+                symbols.push_back(uniform_(rng_) < 0.01 ? static_cast<uint8_t>(rng_() & 3) : unit[k]);
+            }
+        }
+    }
+
+    std::mt19937_64 rng_;
+    std::uniform_real_distribution<double> uniform_{0.0, 1.0};
+};
+
+std::vector<uint8_t> pack_symbols(const std::vector<uint8_t>& symbols) {
+    std::vector<uint8_t> packed(symbols.size() / 4);
+    for (size_t i = 0; i < packed.size(); ++i) {
+        packed[i] = static_cast<uint8_t>(symbols[4 * i] << 6 | symbols[4 * i + 1] << 4 |
+                                         symbols[4 * i + 2] << 2 | symbols[4 * i + 3]);
+    }
+    return packed;
+}
+
+struct TandemResult {
+    std::string corpus;
+    size_t min_bases = 0;               // 0 = stage off
+    size_t input_bytes = 0;
+    size_t archive_bytes = 0;
+    size_t repeats = 0;
+    size_t repeat_bases = 0;
+    double compress_seconds = 0.0;
+    double decompress_seconds = 0.0;
+
+    double ratio() const { return input_bytes ? static_cast<double>(archive_bytes) / input_bytes : 0.0; }
+    double compress_mb_s() const { return compress_seconds > 0 ? input_bytes / 1048576.0 / compress_seconds : 0.0; }
+    double decompress_mb_s() const {
+        return decompress_seconds > 0 ? input_bytes / 1048576.0 / decompress_seconds : 0.0;
+    }
+};
+
+class TandemRepeatBenchmark {
+public:
+    TandemRepeatBenchmark(size_t size, size_t repeat, size_t block_size, size_t num_threads,
+                          std::vector<size_t> min_bases)
+        : size_(size), repeat_(repeat), block_size_(block_size), num_threads_(num_threads),
+          min_bases_(std::move(min_bases)) {}
+
+    void run_all() {
+        std::cout << "=== CCC Tandem Repeat Coding Benchmark ===" << std::endl;
+        std::cout << "Corpus: " << size_ / 1048576.0 << " MB per genome, " << block_size_ << " byte blocks, best of "
+                  << repeat_ << std::endl;
+
+        GenomeGenerator generator(2024);
+        const size_t bases = size_ * 4;
+        std::vector<std::pair<std::string, std::vector<uint8_t>>> corpus;
+        corpus.emplace_back("random", pack_symbols(generator.random_background(bases)));
+        corpus.emplace_back("genome_sparse_str", pack_symbols(generator.genome(bases, 0.05)));
+        corpus.emplace_back("genome_dense_str", pack_symbols(generator.genome(bases, 0.15)));
+        corpus.emplace_back("str_rich_region", pack_symbols(generator.genome(bases, 0.50)));
+
+        std::vector<TandemResult> results;
+        for (const auto& [name, data] : corpus) {
+            std::cout << "\n--- " << name << " ---" << std::endl;
+            run_corpus(name, data, 0, results);
+            for (size_t min_bases : min_bases_) {
+                run_corpus(name, data, min_bases, results);
+            }
+        }
+        save_results(results);
+    }
+
+private:
+    double time_best(const std::function<void()>& body) {
+        double best = 0.0;
+        for (size_t r = 0; r < repeat_; ++r) {
+            auto start = steady_clock::now();
+            body();
+            double seconds = duration<double>(steady_clock::now() - start).count();
+            best = r == 0 ? seconds : std::min(best, seconds);
+        }
+        return best;
+    }
+
+    void run_corpus(const std::string& name, const std::vector<uint8_t>& data, size_t min_bases,
+                    std::vector<TandemResult>& results) {
+        CircularChromosomeCompressor compressor(1000, 4, true, false);
+        compressor.set_block_size(block_size_);
+        compressor.set_num_threads(num_threads_);
+        compressor.set_tandem_repeats(min_bases);
+
+        std::vector<int> codes;
+        CompressionMetadata metadata;
+        TandemResult result;
+        result.corpus = name;
+        result.min_bases = min_bases;
+        result.input_bytes = data.size();
+        result.compress_seconds = time_best([&]() { std::tie(codes, metadata) = compressor.compress(data); });
+
+        std::vector<uint8_t> restored;
+        result.decompress_seconds = time_best([&]() { restored = compressor.decompress(codes, metadata); });
+        if (restored != data) {
+            throw std::runtime_error("Round trip mismatch for " + name + " at min_bases " + std::to_string(min_bases));
+        }
+        // Archive bytes count the repeat tokens as well as the codes
+        result.archive_bytes = serialize_archive(codes, metadata).size();
+        for (const BlockMetadata& block : metadata.core.blocks) {
+            result.repeats += block.tandem_repeats.size();
+            result.repeat_bases += tandem_repeat_bases(block.tandem_repeats);
+        }
+
+        std::cout << "  " << std::left << std::setw(10)
+                  << (min_bases == 0 ? std::string("off") : ">=" + std::to_string(min_bases)) << std::right
+                  << std::setw(10) << result.archive_bytes << " bytes  ratio " << std::fixed << std::setprecision(4)
+                  << result.ratio() << "  " << std::setprecision(1) << std::setw(7) << result.compress_mb_s()
+                  << " MB/s in  " << std::setw(7) << result.decompress_mb_s() << " MB/s out  " << result.repeats
+                  << " repeats, " << std::setprecision(2) << 100.0 * result.repeat_bases / (data.size() * 4.0)
+                  << "% of bases" << std::endl;
+        results.push_back(result);
+    }
+
+    void save_results(const std::vector<TandemResult>& results) {
+        std::ofstream file("tandem_repeat_benchmark_results.json");
+        if (!file.is_open()) {
+            std::cout << "Warning: Could not save results to file" << std::endl;
+            return;
+        }
+        file << "{\n  \"genome_bytes\": " << size_ << ",\n  \"block_size\": " << block_size_ << ",\n";
+        file << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const TandemResult& result = results[i];
+            file << "    {\"corpus\": \"" << result.corpus << "\", \"min_bases\": " << result.min_bases
+                 << ", \"archive_bytes\": " << result.archive_bytes << ", \"ratio\": " << std::fixed
+                 << std::setprecision(6) << result.ratio() << ", \"repeats\": " << result.repeats
+                 << ", \"repeat_bases\": " << result.repeat_bases << ", \"compress_mb_s\": " << std::setprecision(2)
+                 << result.compress_mb_s() << ", \"decompress_mb_s\": " << result.decompress_mb_s() << "}"
+                 << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        file << "  ]\n}\n";
+        std::cout << "\nDetailed results saved to: tandem_repeat_benchmark_results.json" << std::endl;
+    }
+
+    size_t size_;
+    size_t repeat_;
+    size_t block_size_;
+    size_t num_threads_;
+    std::vector<size_t> min_bases_;
+};
+
+std::vector<size_t> parse_list(const std::string& list) {
+    std::vector<size_t> values;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        values.push_back(std::stoul(item));
+    }
+    return values;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t size_mb = 16;
+    size_t repeat = 3;
+    size_t block_size = 1048576;
+    size_t num_threads = 0;
+    std::string min_bases = "12,16,24,32";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--size" && i + 1 < argc) {
+            size_mb = std::stoul(argv[++i]);
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else if (arg == "--block-size" && i + 1 < argc) {
+            block_size = std::stoul(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            num_threads = std::stoul(argv[++i]);
+        } else if (arg == "--min-bases" && i + 1 < argc) {
+            min_bases = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--size MB] [--repeat N] [--block-size N] [--threads N] [--min-bases N,...]" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        TandemRepeatBenchmark benchmark(size_mb * 1048576, repeat, block_size, num_threads, parse_list(min_bases));
+        benchmark.run_all();
+        std::cout << "\n🎉 Tandem repeat benchmark completed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,22 @@
+/**
+ * USDT probe semaphores
+ * Tracers increment a probe's semaphore while attached; the .probes section
+ * is where they look for it.
+ */
+
+#include "ccc_trace.h"
+
+#ifdef CCC_TRACING
+
+#define CCC_TRACE_DEFINE_STAGE(stage) \
+    __attribute__((section(".probes"))) volatile unsigned short ccc_##stage##_entry_semaphore = 0; \
+    __attribute__((section(".probes"))) volatile unsigned short ccc_##stage##_return_semaphore = 0;
+#define CCC_TRACE_DEFINE_EVENT(event) \
+    __attribute__((section(".probes"))) volatile unsigned short ccc_##event##_semaphore = 0;
+
+extern "C" {
+CCC_TRACE_STAGES(CCC_TRACE_DEFINE_STAGE)
+CCC_TRACE_EVENTS(CCC_TRACE_DEFINE_EVENT)
+}
+
+#endif // CCC_TRACING
@@ -0,0 +1,109 @@
+/**
+ * CCC Tracepoints - C++ Implementation
+ *
+ * USDT probes (provider "ccc") at the entry and return of each pipeline
+ * stage, for perf, bpftrace or SystemTap on unmodified production binaries.
+ * They are built in when <sys/sdt.h> is available (systemtap-sdt-dev) and
+ * CCC_DISABLE_TRACING is not defined; otherwise every macro expands to nothing.
+ *
+ * A probe site is a single nop. Its arguments and the clock reads behind the
+ * durations sit behind the probe's semaphore, which the tracer raises only
+ * while attached, so an unattached stage costs one load and a not-taken branch.
+ *
+ * Stage probes, sizes in bytes, bases or codes:
+ *   <stage>_entry(input_size)
+ *   <stage>_return(input_size, output_size, duration_ns)
+ * Stages: compress, decompress, binary_to_dna, dna_to_binary, dvnp_compress,
+ * dvnp_decompress, encapsulate, decapsulate, hash, verify. Block-parallel
+ * mode fires binary_to_dna, dvnp_compress and dvnp_decompress once per block,
+ * on the worker thread; a stage that fails fires no return probe.
+ *
+ * Event probes:
+ *   dvnp_reset(position_bases, codes_written)         encoder dictionary full
+ *   dvnp_decode_reset(position_bases, codes_read)     decoder meets a reset marker
+ * Positions count from the start of the stream, block or lane being coded.
+ */
+
+#ifndef CCC_TRACE_H
+#define CCC_TRACE_H
+
+#if !defined(CCC_DISABLE_TRACING) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define CCC_TRACING 1
+#endif
+#endif
+
+#ifdef CCC_TRACING
+
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+#include <chrono>
+#include <cstdint>
+
+#define CCC_TRACE_STAGES(X) \
+    X(compress) X(decompress) X(binary_to_dna) X(dna_to_binary) X(dvnp_compress) \
+    X(dvnp_decompress) X(encapsulate) X(decapsulate) X(hash) X(verify)
+
+#define CCC_TRACE_EVENTS(X) X(dvnp_reset) X(dvnp_decode_reset)
+
+// Semaphores are defined in ccc_trace.cpp; sdt.h refers to them by these names
+#define CCC_TRACE_DECLARE_STAGE(stage) \
+    extern "C" volatile unsigned short ccc_##stage##_entry_semaphore; \
+    extern "C" volatile unsigned short ccc_##stage##_return_semaphore;
+#define CCC_TRACE_DECLARE_EVENT(event) \
+    extern "C" volatile unsigned short ccc_##event##_semaphore;
+
+CCC_TRACE_STAGES(CCC_TRACE_DECLARE_STAGE)
+CCC_TRACE_EVENTS(CCC_TRACE_DECLARE_EVENT)
+
+namespace ccc {
+namespace trace {
+
+inline uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace trace
+} // namespace ccc
+
+#define CCC_TRACE_ATTACHED(stage) \
+    __builtin_expect((ccc_##stage##_entry_semaphore | ccc_##stage##_return_semaphore) != 0, 0)
+
+/**
+ * Fire <stage>_entry and start the stage clock; pair with CCC_TRACE_END in the same scope
+ */
+#define CCC_TRACE_BEGIN(stage, input_size) \
+    const uint64_t ccc_trace_##stage##_start = CCC_TRACE_ATTACHED(stage) ? ::ccc::trace::now_ns() : 0; \
+    if (__builtin_expect(ccc_##stage##_entry_semaphore != 0, 0)) { \
+        DTRACE_PROBE1(ccc, stage##_entry, static_cast<uint64_t>(input_size)); \
+    }
+
+/**
+ * Fire <stage>_return; the duration is 0 if the tracer attached mid-stage
+ */
+#define CCC_TRACE_END(stage, input_size, output_size) \
+    do { \
+        if (__builtin_expect(ccc_##stage##_return_semaphore != 0, 0)) { \
+            DTRACE_PROBE3(ccc, stage##_return, static_cast<uint64_t>(input_size), \
+                          static_cast<uint64_t>(output_size), \
+                          ccc_trace_##stage##_start ? ::ccc::trace::now_ns() - ccc_trace_##stage##_start : 0); \
+        } \
+    } while (0)
+
+#define CCC_TRACE_EVENT(event, a, b) \
+    do { \
+        if (__builtin_expect(ccc_##event##_semaphore != 0, 0)) { \
+            DTRACE_PROBE2(ccc, event, static_cast<uint64_t>(a), static_cast<uint64_t>(b)); \
+        } \
+    } while (0)
+
+#else
+
+#define CCC_TRACE_BEGIN(stage, input_size) ((void)0)
+#define CCC_TRACE_END(stage, input_size, output_size) ((void)0)
+#define CCC_TRACE_EVENT(event, a, b) ((void)0)
+
+#endif // CCC_TRACING
+
+#endif // CCC_TRACE_H
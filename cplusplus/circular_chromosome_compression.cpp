@@ -3,16 +3,180 @@
  */
 
 #include "circular_chromosome_compression.h"
-#include <iostream>
+#include "dvnp_codec.h"
+#include "packed_bases.h"
+#include "thread_pool.h"
+#include "result_cache.h"
+#include "ccc_trace.h"
+#include "async_logger.h"
 #include <sstream>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <iomanip>
+#include <limits>
 #include <map>
+#include <numeric>
 #include <functional>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#define CCC_HAVE_MMAP 1
+#endif
 
 namespace ccc {
 
+namespace {
+
+// Shannon entropy: H = -Σ(p * log2(p))
+double histogram_entropy(const std::array<size_t, 256>& freq, size_t total) {
+    double entropy = 0.0;
+    for (size_t count : freq) {
+        double probability = static_cast<double>(count) / total;
+        if (probability > 0) {
+            entropy -= probability * std::log2(probability);
+        }
+    }
+    return entropy;
+}
+
+// Decoding runs about twice as fast as encoding, so half as many workers keep up
+size_t verify_threads(size_t encode_threads) {
+    return std::max<size_t>(1, encode_threads / 2);
+}
+
+// Verify-on-write for a single-stream core: decode one reset-delimited segment (an
+// independent LZW stream) and compare it with the input bases it was encoded from
+void verify_stream_segment(const std::vector<int>& codes, const uint8_t* input, size_t first_base, size_t bases) {
+    std::vector<uint8_t> decoded((bases + 3) / 4);
+    size_t written = 0;
+    try {
+        written = DvnpDecoder(kDvnpMaxDictSize).decode(codes.data(), codes.size(), decoded.data(), bases);
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Verify-on-write: core segment at base " + std::to_string(first_base) +
+                                 " does not decode: " + e.what());
+    }
+    std::vector<uint8_t> expected(decoded.size());
+    copy_bases(input, first_base, expected.data(), 0, bases);
+    if (written != bases || decoded != expected) {
+        throw std::runtime_error("Verify-on-write: core segment at base " + std::to_string(first_base) +
+                                 " does not round-trip");
+    }
+}
+
+// Decompressed outputs are written beside their destination and renamed into place, so a failed
+// decode or write never leaves a partial file or clobbers an existing one
+std::string staging_path(const std::string& path) {
+    return path + ".tmp" + std::to_string(std::random_device()());
+}
+
+void install_output_file(const std::string& temp_path, const std::string& path) {
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        throw std::runtime_error("Cannot install output file " + path);
+    }
+}
+
+// Write a whole decompressed output, failing loudly on a short write (e.g. a full disk)
+void write_output_file(const std::string& path, const std::vector<uint8_t>& data) {
+    const std::string temp_path = staging_path(path);
+    std::ofstream outfile(temp_path, std::ios::binary | std::ios::trunc);
+    if (!outfile.is_open()) {
+        throw std::runtime_error("Cannot open output file " + temp_path);
+    }
+    outfile.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    outfile.close();
+    if (!outfile.good()) {
+        std::error_code ec;
+        std::filesystem::remove(temp_path, ec);
+        throw std::runtime_error("Failed writing output file " + temp_path);
+    }
+    install_output_file(temp_path, path);
+}
+
+} // namespace
+
+/**
+ * Decodes finished blocks on workers of its own while later blocks are
+ * still being encoded (verify-on-write)
+ * Checks reference the caller's block buffers, so wait() must return before
+ * those are moved or freed; the destructor drains queued checks either way.
+ */
+class CircularChromosomeCompressor::BlockVerifier {
+public:
+    explicit BlockVerifier(size_t num_threads) : pool_(num_threads) {}
+
+    /**
+     * Queue a check; once any check has failed, further checks are skipped
+     */
+    void submit(std::function<void()> check) {
+        if (failed()) {
+            return;
+        }
+        std::future<void> future = pool_.submit([this, check = std::move(check)]() {
+            if (failed()) {
+                return;
+            }
+            try {
+                check();
+            } catch (...) {
+                failed_.store(true, std::memory_order_relaxed);
+                throw;
+            }
+        });
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(std::move(future));
+    }
+
+    bool failed() const { return failed_.load(std::memory_order_relaxed); }
+
+    /**
+     * Wait for every queued check and rethrow the first failure
+     *
+     * @return Number of checks completed by this call
+     */
+    size_t wait() {
+        std::vector<std::future<void>> pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending.swap(pending_);
+        }
+        std::exception_ptr first_error;
+        for (auto& future : pending) {
+            try {
+                future.get();
+            } catch (...) {
+                if (!first_error) {
+                    first_error = std::current_exception();
+                }
+            }
+        }
+        if (first_error) {
+            std::rethrow_exception(first_error);
+        }
+        return pending.size();
+    }
+
+private:
+    ThreadPool pool_;
+    std::mutex mutex_;
+    std::vector<std::future<void>> pending_;
+    std::atomic<bool> failed_{false};
+};
+
 CircularChromosomeCompressor::CircularChromosomeCompressor(
     size_t chunk_size, 
     size_t min_pattern_length,
@@ -22,7 +186,18 @@ CircularChromosomeCompressor::CircularChromosomeCompressor(
     min_pattern_length_(min_pattern_length),
     strict_mode_(strict_mode),
     verbose_(verbose),
-    original_bits_length_(0) {
+    original_bits_length_(0),
+    block_size_(0),
+    num_threads_(0),
+    max_dict_size_(kDvnpMaxDictSize),
+    seed_window_(0),
+    lanes_(1),
+    multi_base_(false),
+    tandem_min_bases_(0),
+    approx_min_bases_(0),
+    auto_route_(false),
+    verify_on_write_(false),
+    symbol_kernel_(SymbolKernel::Auto) {
     
     // Initialize base mapping for DNA conversion
     base_mapping_["00"] = 'A';
@@ -42,12 +217,98 @@ CircularChromosomeCompressor::CircularChromosomeCompressor(
     base_dict_[3] = 'T';
 }
 
+const char* compression_route_name(CompressionRoute route) {
+    switch (route) {
+        case CompressionRoute::Dvnp: return "dvnp";
+        case CompressionRoute::Stored: return "stored";
+        case CompressionRoute::Nucleotide: return "nucleotide";
+    }
+    return "unknown";
+}
+
+CompressionRoute CircularChromosomeCompressor::route_for(const InputProfile& profile) {
+    switch (profile.kind) {
+        case InputKind::Compressed: return CompressionRoute::Stored;
+        case InputKind::Nucleotide: return CompressionRoute::Nucleotide;
+        // Quality lines are not bases; FASTQ and text gain nothing from a packed path
+        case InputKind::Fastq:
+        case InputKind::Text:
+        case InputKind::Binary: return CompressionRoute::Dvnp;
+    }
+    return CompressionRoute::Dvnp;
+}
+
+void CircularChromosomeCompressor::set_max_dict_size(uint32_t max_dict_size) {
+    if (max_dict_size < 16 || max_dict_size > kDvnpDictSizeLimit) {
+        throw std::invalid_argument("Dictionary size must be 16 to " + std::to_string(kDvnpDictSizeLimit) + 
+                                    " codes, got " + std::to_string(max_dict_size));
+    }
+    max_dict_size_ = max_dict_size;
+}
+
+void CircularChromosomeCompressor::set_lanes(size_t lanes) {
+    if (lanes == 0 || lanes > kDvnpMaxLanes) {
+        throw std::invalid_argument("Lane count must be between 1 and " + std::to_string(kDvnpMaxLanes) + 
+                                    ", got " + std::to_string(lanes));
+    }
+    lanes_ = lanes;
+}
+
+void CircularChromosomeCompressor::set_prefilters(FilterChain chain) {
+    validate_filter_chain(chain);
+    prefilters_ = std::move(chain);
+}
+
+void CircularChromosomeCompressor::set_tandem_repeats(size_t min_bases) {
+    if (min_bases != 0 && min_bases < kTandemMinBases) {
+        throw std::invalid_argument("Tandem repeats need at least " + std::to_string(kTandemMinBases) + 
+                                    " bases, got " + std::to_string(min_bases));
+    }
+    tandem_min_bases_ = min_bases;
+}
+
+void CircularChromosomeCompressor::set_approximate_repeats(size_t min_bases) {
+    if (min_bases != 0 && min_bases < kApproxMinBases) {
+        throw std::invalid_argument("Approximate repeats need at least " + std::to_string(kApproxMinBases) + 
+                                    " bases, got " + std::to_string(min_bases));
+    }
+    approx_min_bases_ = min_bases;
+}
+
+size_t CircularChromosomeCompressor::effective_lanes() const {
+    // Lanes split the raw base stream, so neither warm starts nor repeat tokens combine with them
+    return seed_window_ > 0 || tandem_min_bases_ > 0 || approx_min_bases_ > 0 ? 1 : lanes_;
+}
+
 void CircularChromosomeCompressor::log(const std::string& message) {
     if (verbose_) {
-        std::cout << "[CCC] " << message << std::endl;
+        // Free-form messages are progress detail unless they announce themselves otherwise
+        LogSeverity severity = LogSeverity::Debug;
+        if (message.rfind("Warning", 0) == 0 || message.rfind("[CCC Warning]", 0) == 0) {
+            severity = LogSeverity::Warning;
+        } else if (message.rfind("[CCC Info]", 0) == 0) {
+            severity = LogSeverity::Info;
+        }
+        log(severity, "ccc", message);
+    }
+}
+
+void CircularChromosomeCompressor::log(LogSeverity severity, const char* stage, const std::string& message,
+                                       uint64_t bytes, uint64_t duration_ns) {
+    if (verbose_) {
+        (logger_ ? *logger_ : AsyncLogger::standard()).log(severity, stage, message, bytes, duration_ns);
     }
 }
 
+uint64_t CircularChromosomeCompressor::log_clock() const {
+    // Stage durations are only measured when they will be logged
+    if (!verbose_) {
+        return 0;
+    }
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
 bool CircularChromosomeCompressor::validate_input(const void* data, const std::string& data_name) {
     if (!data) {
         if (strict_mode_) {
@@ -66,21 +327,12 @@ double CircularChromosomeCompressor::calculate_entropy(const std::vector<uint8_t
     }
     
     // Count frequency of each byte value
-    std::unordered_map<uint8_t, size_t> freq;
+    std::array<size_t, 256> freq{};
     for (uint8_t byte : data) {
         freq[byte]++;
     }
     
-    size_t total = data.size();
-    double entropy = 0.0;
-    
-    // Calculate Shannon entropy: H = -Σ(p * log2(p))
-    for (const auto& pair : freq) {
-        double probability = static_cast<double>(pair.second) / total;
-        if (probability > 0) {
-            entropy -= probability * std::log2(probability);
-        }
-    }
+    double entropy = histogram_entropy(freq, data.size());
     
     log("Shannon entropy calculated: " + std::to_string(entropy) + " bits/byte");
     return entropy;
@@ -91,6 +343,7 @@ std::string CircularChromosomeCompressor::compute_data_hash(const std::vector<in
         return "";
     }
     
+    CCC_TRACE_BEGIN(hash, data.size());
     std::ostringstream oss;
     for (size_t i = 0; i < data.size(); ++i) {
         if (i > 0) oss << ",";
@@ -107,6 +360,7 @@ std::string CircularChromosomeCompressor::compute_data_hash(const std::vector<in
     std::ostringstream hex_stream;
     hex_stream << std::hex << std::setfill('0') << std::setw(8) << (hash_value & 0xFFFFFFFF);
     
+    CCC_TRACE_END(hash, data.size(), hash_value & 0xFFFFFFFF);
     return hex_stream.str();
 }
 
@@ -116,26 +370,26 @@ bool CircularChromosomeCompressor::verify_data_integrity(
     const std::string& operation
 ) {
     if (expected_hash.empty()) {
-        log("[CCC Warning] No hash available for " + operation + " integrity verification");
+        log(LogSeverity::Warning, "integrity", "No hash available for " + operation + " integrity verification");
         return false;
     }
     
+    CCC_TRACE_BEGIN(verify, data.size());
     std::string computed_hash = compute_data_hash(data);
     
     if (computed_hash == expected_hash) {
-        log("[CCC Info] Data integrity verified successfully for " + operation);
+        CCC_TRACE_END(verify, data.size(), 1);
+        log(LogSeverity::Info, "integrity", "Data integrity verified successfully for " + operation);
         return true;
     } else {
+        CCC_TRACE_END(verify, data.size(), 0);
         std::string error_msg = "Data integrity check failed during " + operation + 
                                ": hash mismatch (expected " + expected_hash + 
                                ", got " + computed_hash + ")";
         if (strict_mode_) {
             throw std::runtime_error(error_msg);
         } else {
-            log("[CCC Warning] " + error_msg);
-            if (verbose_) {
-                std::cout << "[CCC Warning] " << error_msg << std::endl;
-            }
+            log(LogSeverity::Warning, "integrity", error_msg);
             return false;
         }
     }
@@ -148,6 +402,7 @@ std::string CircularChromosomeCompressor::binary_to_dna(const std::vector<uint8_
         }
     }
     
+    CCC_TRACE_BEGIN(binary_to_dna, binary_data.size());
     log("Converting " + std::to_string(binary_data.size()) + " bytes to DNA sequence");
     
     // Convert bytes to binary string
@@ -174,6 +429,7 @@ std::string CircularChromosomeCompressor::binary_to_dna(const std::vector<uint8_
     }
     
     log("Generated DNA sequence of length " + std::to_string(dna_sequence.length()));
+    CCC_TRACE_END(binary_to_dna, binary_data.size(), dna_sequence.length());
     return dna_sequence;
 }
 
@@ -184,6 +440,7 @@ std::vector<uint8_t> CircularChromosomeCompressor::dna_to_binary(const std::stri
         }
     }
     
+    CCC_TRACE_BEGIN(dna_to_binary, dna_seq.length());
     log("Converting DNA sequence of length " + std::to_string(dna_seq.length()) + " back to binary");
     
     // Validate DNA sequence contains only valid bases
@@ -233,36 +490,47 @@ std::vector<uint8_t> CircularChromosomeCompressor::dna_to_binary(const std::stri
         }
     }
     
+    CCC_TRACE_END(dna_to_binary, dna_seq.length(), byte_array.size());
     return byte_array;
 }
 
-bool CircularChromosomeCompressor::is_prime(int n) {
+bool CircularChromosomeCompressor::is_prime(uint64_t n) {
     if (n < 2) return false;
     if (n == 2) return true;
     if (n % 2 == 0) return false;
     
-    for (int i = 3; i <= std::sqrt(n); i += 2) {
+    // i <= n / i cannot overflow, unlike i * i <= n
+    for (uint64_t i = 3; i <= n / i; i += 2) {
         if (n % i == 0) return false;
     }
     return true;
 }
 
-int CircularChromosomeCompressor::next_prime(int n) {
+uint64_t CircularChromosomeCompressor::next_prime(uint64_t n) {
     if (n < 2) return 2;
     
     while (!is_prime(n)) {
+        if (n == UINT64_MAX) {
+            throw std::overflow_error("No 64-bit prime at or above the requested ring length");
+        }
         n++;
     }
     return n;
 }
 
 std::vector<int> CircularChromosomeCompressor::dvnp_compress(const std::string& dna_seq) {
+    return dvnp_compress_segments(dna_seq, nullptr);
+}
+
+std::vector<int> CircularChromosomeCompressor::dvnp_compress_segments(const std::string& dna_seq,
+                                                                      const StreamSegmentHandler& on_segment) {
     if (dna_seq.empty()) {
         if (!validate_input(nullptr, "dna_seq")) {
             return {};
         }
     }
     
+    CCC_TRACE_BEGIN(dvnp_compress, dna_seq.length());
     log("Starting DVNP compression on sequence of length " + std::to_string(dna_seq.length()));
     
     // Initialize compression parameters with uint32_t for safer code space
@@ -284,7 +552,11 @@ std::vector<int> CircularChromosomeCompressor::dvnp_compress(const std::string&
     log("Dynamic dictionary reset enabled for sequences >1M bases");
     
     // Main compression loop with dynamic dictionary reset
+    size_t position = 0;
+    size_t segment_code = 0;   // first code and first base of the current segment
+    size_t segment_base = 0;
     for (char ch : dna_seq) {
+        ++position;
         std::string combined = current + ch;
         
         if (dictionary.find(combined) != dictionary.end()) {
@@ -300,8 +572,16 @@ std::vector<int> CircularChromosomeCompressor::dvnp_compress(const std::string&
                 next_code++;
             } else {
                 // Dictionary is full - implement dynamic reset
+                // The segment ends before the marker and before ch, which starts the next one
+                if (on_segment) {
+                    on_segment(result.data() + segment_code, result.size() - segment_code, segment_base,
+                               position - 1 - segment_base);
+                }
                 result.push_back(RESET_MARKER);
+                segment_code = result.size();
+                segment_base = position - 1;
                 reset_count++;
+                CCC_TRACE_EVENT(dvnp_reset, position - 1, result.size());
                 
                 // Reset dictionary to initial state
                 dictionary.clear();
@@ -322,6 +602,10 @@ std::vector<int> CircularChromosomeCompressor::dvnp_compress(const std::string&
     if (!current.empty()) {
         result.push_back(dictionary[current]);
     }
+    if (on_segment && result.size() > segment_code) {
+        on_segment(result.data() + segment_code, result.size() - segment_code, segment_base,
+                   dna_seq.length() - segment_base);
+    }
     
     double compression_ratio = static_cast<double>(result.size()) / dna_seq.length();
     log("DVNP compression completed: " + std::to_string(dna_seq.length()) + 
@@ -336,6 +620,7 @@ std::vector<int> CircularChromosomeCompressor::dvnp_compress(const std::string&
         int_result.push_back(static_cast<int>(code));
     }
     
+    CCC_TRACE_END(dvnp_compress, dna_seq.length(), int_result.size());
     return int_result;
 }
 
@@ -346,6 +631,7 @@ std::string CircularChromosomeCompressor::dvnp_decompress(const std::vector<int>
         }
     }
     
+    CCC_TRACE_BEGIN(dvnp_decompress, compressed.size());
     log("Starting DVNP decompression on " + std::to_string(compressed.size()) + " codes");
     
     // Initialize decompression parameters with uint32_t for safer code space
@@ -386,6 +672,7 @@ std::string CircularChromosomeCompressor::dvnp_decompress(const std::vector<int>
         // Check for dictionary reset marker
         if (code == RESET_MARKER) {
             reset_count++;
+            CCC_TRACE_EVENT(dvnp_decode_reset, result.length(), i);
             log("Processing dictionary reset #" + std::to_string(reset_count));
             
             // Reset dictionary to initial state
@@ -470,6 +757,7 @@ std::string CircularChromosomeCompressor::dvnp_decompress(const std::vector<int>
         " codes → " + std::to_string(result.length()) + " chars");
     log("Dictionary resets processed: " + std::to_string(reset_count));
     
+    CCC_TRACE_END(dvnp_decompress, compressed.size(), result.length());
     return result;
 }
 
@@ -482,25 +770,24 @@ std::vector<int> CircularChromosomeCompressor::circular_encapsulate(const std::v
     log("Starting circular encapsulation for " + std::to_string(length) + " codes");
     
     // Find next prime for optimal ring size to avoid periodic artifacts
-    int prime_length = next_prime(static_cast<int>(length));
+    const size_t prime_length = static_cast<size_t>(next_prime(length));
     size_t padding_size = prime_length - length;
     
     log("Circular padding size = " + std::to_string(padding_size) + 
         " (prime length: " + std::to_string(prime_length) + ")");
     
-    // Pad with zeros if needed
-    std::vector<int> padded = compressed;
-    padded.resize(prime_length, 0);
-    
     // Create bridge for circular continuity
-    size_t bridge_length = std::min(static_cast<size_t>(std::sqrt(prime_length)), size_t(10));
+    size_t bridge_length = std::min(static_cast<size_t>(std::sqrt(static_cast<double>(prime_length))), size_t(10));
     
     log("Bridge length = " + std::to_string(bridge_length));
     
-    // Create circular structure
-    std::vector<int> circular_ring = padded;
+    // Create circular structure in one allocation: codes, zero padding, bridge
+    std::vector<int> circular_ring;
+    circular_ring.reserve(prime_length + bridge_length);
+    circular_ring.assign(compressed.begin(), compressed.end());
+    circular_ring.resize(prime_length, 0);
     for (size_t i = 0; i < bridge_length; ++i) {
-        circular_ring.push_back(padded[i]);
+        circular_ring.push_back(circular_ring[i]);
     }
     
     log("Circular encapsulation completed: " + std::to_string(length) + 
@@ -525,20 +812,18 @@ CircularChromosomeCompressor::add_trans_splicing_markers(
     // Generate spliced leader marker that doesn't conflict with data
     std::string data_hash = compute_data_hash(circular_data);
     
-    // Find a marker code that doesn't exist in the data
+    // One above the largest code cannot occur in the data
     int max_value = *std::max_element(circular_data.begin(), circular_data.end());
-    std::unordered_set<int> data_set(circular_data.begin(), circular_data.end());
-    
-    // Start with a value guaranteed to be outside the data range
-    int sl_marker_code = max_value + 1;
-    
-    // Double-check it doesn't conflict
-    while (data_set.find(sl_marker_code) != data_set.end()) {
-        sl_marker_code++;
+    if (max_value == std::numeric_limits<int>::max()) {
+        throw std::overflow_error("No trans-splicing marker code above " + std::to_string(max_value));
     }
+    int sl_marker_code = max_value + 1;
     
+    const size_t chunk_count = (circular_data.size() + chunk_size_ - 1) / chunk_size_;
     std::vector<int> marked_data;
     std::vector<size_t> marker_positions;
+    marked_data.reserve(circular_data.size() + chunk_count);
+    marker_positions.reserve(chunk_count);
     
     // Insert markers at regular intervals
     for (size_t i = 0; i < circular_data.size(); i += chunk_size_) {
@@ -580,17 +865,37 @@ CircularChromosomeCompressor::compress_core(const std::vector<uint8_t>& binary_d
     
     log("Starting core compression for " + std::to_string(binary_data.size()) + " bytes");
     
+    if (block_size_ > 0) {
+        return compress_blocks(binary_data);
+    }
+    
     // Step 1: Convert binary to DNA
     std::string dna_seq = binary_to_dna(binary_data);
     
     // Step 2: DVNP compression
-    std::vector<int> compressed = dvnp_compress(dna_seq);
+    // Verify-on-write decodes each finished reset segment on a worker while encoding continues
+    std::vector<int> compressed;
+    if (verify_on_write_) {
+        BlockVerifier verifier(verify_threads(num_threads_ == 0 ? ThreadPool::default_thread_count() : num_threads_));
+        compressed = dvnp_compress_segments(dna_seq, [&](const uint32_t* codes, size_t count, size_t first_base,
+                                                         size_t bases) {
+            verifier.submit([&binary_data, segment = std::vector<int>(codes, codes + count), first_base, bases]() {
+                verify_stream_segment(segment, binary_data.data(), first_base, bases);
+            });
+        });
+        const size_t verified = verifier.wait();
+        log("Verified " + std::to_string(verified) + " stream segments against the input");
+    } else {
+        compressed = dvnp_compress(dna_seq);
+    }
     
     // Core layer metadata
     CoreMetadata core_metadata;
     core_metadata.dna_length = dna_seq.length();
     core_metadata.original_size = binary_data.size();
     core_metadata.original_bits_length = original_bits_length_;
+    core_metadata.reset_count = static_cast<size_t>(
+        std::count(compressed.begin(), compressed.end(), static_cast<int>(kDvnpMaxDictSize)));
     
     return {compressed, core_metadata};
 }
@@ -605,6 +910,8 @@ CircularChromosomeCompressor::encapsulate(const std::vector<int>& compressed) {
         }
     }
     
+    CCC_TRACE_BEGIN(encapsulate, compressed.size());
+    
     // Step 1: Circular encapsulation
     std::vector<int> circular_data = circular_encapsulate(compressed);
     
@@ -616,6 +923,7 @@ CircularChromosomeCompressor::encapsulate(const std::vector<int>& compressed) {
     encap_metadata.circular_length = circular_data.size();
     encap_metadata.trans_splicing = ts_metadata;
     
+    CCC_TRACE_END(encapsulate, compressed.size(), marked_data.size());
     return {marked_data, encap_metadata};
 }
 
@@ -633,19 +941,112 @@ CircularChromosomeCompressor::compress(const std::vector<uint8_t>& binary_data)
         }
     }
     
-    // Layer 1: Core compression
-    auto [compressed, core_metadata] = compress_core(binary_data);
+    CCC_TRACE_BEGIN(compress, binary_data.size());
+    const uint64_t log_start = log_clock();
+    std::string cache_key;
+    if (result_cache_ && !binary_data.empty()) {
+        cache_key = ResultCache::make_key(binary_data.data(), binary_data.size(), cache_parameters());
+        std::vector<int> cached_data;
+        CompressionMetadata cached_metadata;
+        if (result_cache_->lookup(cache_key, cached_data, cached_metadata)) {
+            log("Result cache hit: " + cache_key);
+            CCC_TRACE_END(compress, binary_data.size(), cached_data.size());
+            return {cached_data, cached_metadata};
+        }
+    }
     
-    // Layer 2: Encapsulation
-    auto [final_data, encap_metadata] = encapsulate(compressed);
+    // Layer 0: Routing by content (auto-route mode)
+    CompressionRoute route = CompressionRoute::Dvnp;
+    std::vector<uint8_t> packed;
+    NucleotideLayout layout;
+    if (auto_route_ && !binary_data.empty()) {
+        const uint64_t classify_start = log_clock();
+        InputProfile profile = classify_input(binary_data);
+        route = route_for(profile);
+        if (route == CompressionRoute::Nucleotide) {
+            layout = pack_nucleotide_text(binary_data.data(), binary_data.size(), packed);
+            if (layout.bases == 0) {
+                route = CompressionRoute::Stored;
+            }
+        }
+        log(LogSeverity::Info, "classify", std::string("Input classified as ") + input_kind_name(profile.kind) +
+            (profile.format.empty() ? std::string() : " (" + profile.format + ")") + ", routed to " +
+            compression_route_name(route), binary_data.size(), log_clock() - classify_start);
+    }
     
-    // Combine metadata from all layers
     CompressionMetadata metadata;
-    metadata.core = core_metadata;
-    metadata.encapsulation = encap_metadata;
+    std::vector<int> final_data;
+    size_t core_codes = 0;
+    if (route == CompressionRoute::Stored) {
+        // Another pass cannot shrink it; keep the bytes, still hash-verified on decompression
+        final_data.assign(binary_data.begin(), binary_data.end());
+        core_codes = final_data.size();
+        metadata.core.route = route;
+        metadata.core.original_size = binary_data.size();
+        metadata.core.original_bits_length = binary_data.size() * 8;
+        TransSplicingMetadata& ts = metadata.encapsulation.trans_splicing;
+        ts.chunk_size = chunk_size_;
+        ts.original_length = final_data.size();
+        ts.original_compressed_length = final_data.size();
+        ts.data_hash = compute_data_hash(final_data);
+    } else {
+        // Layer 0b: Typed pre-filters (binary path only)
+        std::vector<uint8_t> filtered;
+        const bool filter = route == CompressionRoute::Dvnp && !prefilters_.empty() && !binary_data.empty();
+        if (filter) {
+            const uint64_t filter_start = log_clock();
+            filtered = apply_filters(binary_data, prefilters_);
+            log(LogSeverity::Debug, "prefilter", "Applied pre-filters " + filter_chain_name(prefilters_),
+                binary_data.size(), log_clock() - filter_start);
+        }
+        if (verify_on_write_) {
+            // The transforms in front of the core are checked whole, the core itself block by block
+            if (route == CompressionRoute::Nucleotide && unpack_nucleotide_text(packed, layout) != binary_data) {
+                throw std::runtime_error("Verify-on-write: nucleotide packing does not round-trip");
+            }
+            if (filter) {
+                std::vector<uint8_t> restored = filtered;
+                invert_filters(restored, prefilters_);
+                if (restored != binary_data) {
+                    throw std::runtime_error("Verify-on-write: pre-filters do not round-trip");
+                }
+            }
+        }
+        
+        // Layer 1: Core compression
+        auto [compressed, core_metadata] = compress_core(route == CompressionRoute::Nucleotide ? packed :
+                                                         filter ? filtered : binary_data);
+        core_metadata.route = route;
+        core_metadata.nucleotide = std::move(layout);
+        if (filter) {
+            core_metadata.filters = prefilters_;
+        }
+        std::vector<uint8_t>().swap(packed);
+        std::vector<uint8_t>().swap(filtered);
+        
+        // Layer 2: Encapsulation
+        auto [encapsulated, encap_metadata] = encapsulate(compressed);
+        final_data = std::move(encapsulated);
+        if (verify_on_write_ && decapsulate(final_data, encap_metadata) != compressed) {
+            throw std::runtime_error("Verify-on-write: encapsulation does not round-trip");
+        }
+        core_codes = compressed.size();
+        metadata.core = std::move(core_metadata);
+        metadata.encapsulation = std::move(encap_metadata);
+    }
     metadata.compression_ratio = binary_data.empty() ? 0.0 : 
                                static_cast<double>(final_data.size()) / binary_data.size();
     
+    // Statistics travel with the archive so later inspection needs neither input nor decoding
+    attach_stats(metadata, calculate_entropy(binary_data), final_data, core_codes);
+    
+    if (!cache_key.empty()) {
+        result_cache_->store(cache_key, final_data, metadata);
+    }
+    
+    CCC_TRACE_END(compress, binary_data.size(), final_data.size());
+    log(LogSeverity::Info, "compress", "Compressed to " + std::to_string(final_data.size()) + " codes",
+        binary_data.size(), log_clock() - log_start);
     return {final_data, metadata};
 }
 
@@ -657,12 +1058,15 @@ std::vector<int> CircularChromosomeCompressor::decapsulate(
         return {};
     }
     
+    CCC_TRACE_BEGIN(decapsulate, marked_data.size());
+    
     // Step 1: Remove trans-splicing markers
     const TransSplicingMetadata& ts_metadata = encap_metadata.trans_splicing;
     int marker_code = ts_metadata.sl_marker_code;
     
     // Filter out markers
     std::vector<int> filtered_data;
+    filtered_data.reserve(marked_data.size());
     for (int x : marked_data) {
         if (x != marker_code) {
             filtered_data.push_back(x);
@@ -673,26 +1077,25 @@ std::vector<int> CircularChromosomeCompressor::decapsulate(
     size_t original_length = ts_metadata.original_length;
     size_t original_compressed_length = ts_metadata.original_compressed_length;
     
-    std::vector<int> core_data;
-    if (original_length <= filtered_data.size()) {
-        // Get the encapsulated data (without trans-splicing markers)
-        std::vector<int> encapsulated_data(filtered_data.begin(), 
-                                         filtered_data.begin() + original_length);
+    // Trimmed in place: the code stream is the largest buffer of the pipeline
+    std::vector<int> core_data = std::move(filtered_data);
+    if (original_length <= core_data.size()) {
+        // Keep the encapsulated data (without trans-splicing markers)
+        core_data.resize(original_length);
         
         // Step 3: Hash verification for data integrity
         std::string stored_hash = ts_metadata.data_hash;
-        verify_data_integrity(encapsulated_data, stored_hash, "decapsulation");
+        verify_data_integrity(core_data, stored_hash, "decapsulation");
         
         // Extract only the original compressed data, excluding zero padding and bridge elements
-        size_t core_size = std::min(original_compressed_length, encapsulated_data.size());
-        core_data.assign(encapsulated_data.begin(), encapsulated_data.begin() + core_size);
+        core_data.resize(std::min(original_compressed_length, core_data.size()));
     } else {
         // Fallback - shouldn't happen in normal cases
-        size_t core_size = std::min(original_compressed_length, filtered_data.size());
-        core_data.assign(filtered_data.begin(), filtered_data.begin() + core_size);
+        core_data.resize(std::min(original_compressed_length, core_data.size()));
         log("[CCC Warning] Data length inconsistency detected during decapsulation");
     }
     
+    CCC_TRACE_END(decapsulate, marked_data.size(), core_data.size());
     return core_data;
 }
 
@@ -709,6 +1112,20 @@ std::vector<uint8_t> CircularChromosomeCompressor::decompress_core(
     
     log("Starting core decompression for " + std::to_string(compressed.size()) + " codes");
     
+    if (!core_metadata.blocks.empty()) {
+        std::vector<uint8_t> binary_data(core_metadata.original_size, 0);
+        try {
+            decompress_blocks_into(compressed, core_metadata, binary_data.data());
+        } catch (const std::invalid_argument& e) {
+            if (strict_mode_) {
+                throw;
+            }
+            log("Warning: " + std::string(e.what()));
+            return {};
+        }
+        return binary_data;
+    }
+    
     // Step 1: DVNP decompression
     std::string dna_sequence = dvnp_decompress(compressed);
     
@@ -739,30 +1156,677 @@ std::vector<uint8_t> CircularChromosomeCompressor::decompress(
         }
     }
     
+    CCC_TRACE_BEGIN(decompress, compressed_data.size());
+    const uint64_t log_start = log_clock();
     log("Starting decompression for " + std::to_string(compressed_data.size()) + " codes");
     
-    // Layer 1: Decapsulation
+    std::vector<uint8_t> binary_data;
+    if (metadata.core.route == CompressionRoute::Stored) {
+        binary_data = restore_stored(compressed_data, metadata);
+    } else {
+        // Layer 1: Decapsulation
+        std::vector<int> core_data = decapsulate(compressed_data, metadata.encapsulation);
+        
+        // Layer 2: Core decompression
+        binary_data = decompress_core(core_data, metadata.core);
+        if (metadata.core.route == CompressionRoute::Nucleotide) {
+            binary_data = unpack_nucleotide_text(binary_data, metadata.core.nucleotide);
+        }
+        invert_filters(binary_data, metadata.core.filters);
+    }
+    
+    CCC_TRACE_END(decompress, compressed_data.size(), binary_data.size());
+    log(LogSeverity::Info, "decompress", "Decompressed " + std::to_string(compressed_data.size()) + " codes",
+        binary_data.size(), log_clock() - log_start);
+    return binary_data;
+}
+
+std::vector<uint8_t> CircularChromosomeCompressor::restore_stored(
+    const std::vector<int>& stored,
+    const CompressionMetadata& metadata
+) {
+    verify_data_integrity(stored, metadata.encapsulation.trans_splicing.data_hash, "stored data");
+    if (stored.size() != metadata.core.original_size) {
+        throw std::runtime_error("Stored data holds " + std::to_string(stored.size()) + " bytes, expected " + 
+                                 std::to_string(metadata.core.original_size));
+    }
+    std::vector<uint8_t> binary_data(stored.size());
+    for (size_t i = 0; i < stored.size(); ++i) {
+        if (stored[i] < 0 || stored[i] > 255) {
+            throw std::runtime_error("Stored data code " + std::to_string(stored[i]) + " at " + 
+                                     std::to_string(i) + " is not a byte");
+        }
+        binary_data[i] = static_cast<uint8_t>(stored[i]);
+    }
+    return binary_data;
+}
+
+std::string CircularChromosomeCompressor::cache_parameters() const {
+    // Only settings that change the compressed output; threads and kernels do not
+    std::ostringstream oss;
+    oss << "chunk=" << chunk_size_ << ";pattern=" << min_pattern_length_
+        << ";block=" << block_size_ << ";dict=" << max_dict_size_ << ";seed=" << seed_window_
+        << ";lanes=" << effective_lanes() << ";tandem=" << tandem_min_bases_ << ";approx=" << approx_min_bases_
+        << (auto_route_ ? ";route=auto" : "")
+        << (prefilters_.empty() ? "" : ";filters=" + filter_chain_name(prefilters_));
+    return oss.str();
+}
+
+std::pair<std::vector<int>, CoreMetadata> 
+CircularChromosomeCompressor::compress_blocks(const std::vector<uint8_t>& binary_data) {
+    const size_t num_blocks = (binary_data.size() + block_size_ - 1) / block_size_;
+    
+    log("Block-parallel compression: " + std::to_string(num_blocks) + " blocks of " + 
+        std::to_string(block_size_) + " bytes" + 
+        (seed_window_ > 0 ? ", " + std::to_string(seed_window_) + " byte seed window" : std::string()) + 
+        (effective_lanes() > 1 ? ", " + std::to_string(lanes_) + " lanes" : std::string()) + 
+        (tandem_min_bases_ > 0 ? ", tandem repeats >= " + std::to_string(tandem_min_bases_) + " bases" :
+                                 std::string()) + 
+        (approx_min_bases_ > 0 ? ", approximate repeats >= " + std::to_string(approx_min_bases_) + " bases" :
+                                 std::string()));
+    
+    // Each block is its own DVNP stream; with a seed window its dictionary starts
+    // from the phrases of the preceding input, which is all available up front
+    std::vector<std::vector<int>> block_codes(num_blocks);
+    std::vector<size_t> block_resets(num_blocks, 0);
+    std::vector<std::vector<size_t>> block_lanes(num_blocks);
+    std::vector<std::vector<TandemRepeat>> block_repeats(num_blocks);
+    std::vector<std::vector<ApproximateRepeat>> block_copies(num_blocks);
+    
+    const size_t num_threads = std::min(num_threads_ == 0 ? ThreadPool::default_thread_count() : num_threads_,
+                                        num_blocks);
+    std::unique_ptr<BlockVerifier> verifier;
+    if (verify_on_write_) {
+        verifier = std::make_unique<BlockVerifier>(verify_threads(num_threads));
+    }
+    ThreadPool pool(num_threads);
+    pool.parallel_for(num_blocks, [&](size_t b) {
+        if (verifier && verifier->failed()) {
+            return;                         // compress() fails anyway; stop spending time on it
+        }
+        size_t offset = b * block_size_;
+        size_t size = std::min(block_size_, binary_data.size() - offset);
+        size_t seed_size = std::min(seed_window_, offset);
+        const uint64_t log_start = log_clock();
+        block_resets[b] = encode_block(binary_data.data() + offset, size, seed_size,
+                                       block_codes[b], block_lanes[b], block_repeats[b], block_copies[b]);
+        if (verbose_) {
+            log(LogSeverity::Debug, "block_encode", "Block " + std::to_string(b) + ": " + 
+                std::to_string(block_codes[b].size()) + " codes", size, log_clock() - log_start);
+        }
+        if (verifier) {
+            verifier->submit([&, b, offset, size, seed_size]() {
+                verify_block(binary_data.data() + offset, size, seed_size, block_codes[b], block_lanes[b],
+                             block_repeats[b], block_copies[b], b);
+            });
+        }
+    });
+    if (verifier) {
+        const size_t verified = verifier->wait();
+        log("Verified " + std::to_string(verified) + " blocks against the input");
+    }
+    
+    CoreMetadata core_metadata;
+    core_metadata.dna_length = binary_data.size() * 4;
+    core_metadata.original_size = binary_data.size();
+    core_metadata.original_bits_length = binary_data.size() * 8;
+    core_metadata.block_size = block_size_;
+    core_metadata.max_dict_size = max_dict_size_;
+    core_metadata.seed_window = seed_window_;
+    core_metadata.lanes = effective_lanes();
+    core_metadata.tandem_min_bases = tandem_min_bases_;
+    core_metadata.approx_min_bases = approx_min_bases_;
+    core_metadata.blocks.resize(num_blocks);
+    
+    size_t total_codes = 0;
+    size_t total_resets = 0;
+    for (size_t b = 0; b < num_blocks; ++b) {
+        BlockMetadata& block = core_metadata.blocks[b];
+        block.original_offset = b * block_size_;
+        block.original_size = std::min(block_size_, binary_data.size() - block.original_offset);
+        block.code_offset = total_codes;
+        block.code_count = block_codes[b].size();
+        block.lane_code_counts = std::move(block_lanes[b]);
+        block.tandem_repeats = std::move(block_repeats[b]);
+        block.approximate_repeats = std::move(block_copies[b]);
+        total_codes += block.code_count;
+        total_resets += block_resets[b];
+    }
+    core_metadata.reset_count = total_resets;
+    
+    std::vector<int> compressed;
+    compressed.reserve(total_codes);
+    for (auto& codes : block_codes) {
+        compressed.insert(compressed.end(), codes.begin(), codes.end());
+        std::vector<int>().swap(codes);
+    }
+    
+    log("Block-parallel compression completed: " + std::to_string(core_metadata.dna_length) + 
+        " bases → " + std::to_string(compressed.size()) + " codes, " + 
+        std::to_string(total_resets) + " dictionary resets");
+    
+    return {compressed, core_metadata};
+}
+
+size_t CircularChromosomeCompressor::encode_block(
+    const uint8_t* block,
+    size_t size,
+    size_t seed_size,
+    std::vector<int>& codes,
+    std::vector<size_t>& lane_counts,
+    std::vector<TandemRepeat>& repeats,
+    std::vector<ApproximateRepeat>& copies
+) {
+    // Seed symbols directly precede the block symbols in one buffer
+    CCC_TRACE_BEGIN(binary_to_dna, size);
+    std::vector<uint8_t> symbols((seed_size + size) * 4);
+    bytes_to_symbols(block - seed_size, seed_size + size, symbols.data(), symbol_kernel_);
+    CCC_TRACE_END(binary_to_dna, size, size * 4);
+    
+    CCC_TRACE_BEGIN(dvnp_compress, size * 4);
+    if (effective_lanes() > 1) {
+        DvnpLaneEncoder encoder(lanes_, max_dict_size_);
+        size_t resets = encoder.encode(symbols.data(), size * 4, codes, lane_counts);
+        CCC_TRACE_END(dvnp_compress, size * 4, codes.size());
+        return resets;
+    }
+    size_t block_symbols = size * 4;
+    uint8_t* block_start = symbols.data() + seed_size * 4;
+    if (tandem_min_bases_ > 0) {
+        // The residual overwrites the block symbols in place; it never runs ahead of the scan
+        block_symbols = extract_tandem_repeats(block_start, block_symbols, tandem_min_bases_, block_start, repeats);
+    }
+    std::vector<uint8_t> copy_residual;
+    if (approx_min_bases_ > 0) {
+        // Copies read sources behind the scan, so this residual needs its own buffer
+        copy_residual.resize(block_symbols);
+        block_symbols = extract_approximate_repeats(block_start, block_symbols, approx_min_bases_,
+                                                    copy_residual.data(), copies);
+        block_start = copy_residual.data();
+    }
+    DvnpEncoder encoder(max_dict_size_, multi_base_);
+    size_t resets = encoder.encode(block_start, block_symbols, codes, symbols.data(), seed_size * 4);
+    CCC_TRACE_END(dvnp_compress, size * 4, codes.size());
+    return resets;
+}
+
+void CircularChromosomeCompressor::verify_block(
+    const uint8_t* block,
+    size_t size,
+    size_t seed_size,
+    const std::vector<int>& codes,
+    const std::vector<size_t>& lane_counts,
+    const std::vector<TandemRepeat>& repeats,
+    const std::vector<ApproximateRepeat>& copies,
+    size_t index
+) {
+    // A one-block core; its seed is the input before the block, which earlier checks vouch for
+    CoreMetadata check;
+    check.max_dict_size = max_dict_size_;
+    check.seed_window = seed_size;
+    check.lanes = effective_lanes();
+    check.blocks.resize(1);
+    check.blocks[0].original_size = size;
+    check.blocks[0].code_count = codes.size();
+    check.blocks[0].lane_code_counts = lane_counts;
+    check.blocks[0].tandem_repeats = repeats;
+    check.blocks[0].approximate_repeats = copies;
+    
+    std::vector<uint8_t> decoded(seed_size + size);
+    std::copy(block - seed_size, block, decoded.begin());
+    try {
+        decode_block(codes, check, 0, decoded.data() + seed_size, seed_size);
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Verify-on-write: block " + std::to_string(index) + " does not decode: " + e.what());
+    }
+    if (!std::equal(decoded.begin() + seed_size, decoded.end(), block)) {
+        throw std::runtime_error("Verify-on-write: block " + std::to_string(index) + " does not round-trip");
+    }
+}
+
+void CircularChromosomeCompressor::validate_blocks(const std::vector<int>& compressed, const CoreMetadata& core_metadata) {
+    if (core_metadata.max_dict_size < 16) {
+        throw std::invalid_argument("Invalid dictionary size in core metadata: " + 
+                                    std::to_string(core_metadata.max_dict_size));
+    }
+    if (core_metadata.lanes == 0 || core_metadata.lanes > kDvnpMaxLanes ||
+        (core_metadata.lanes > 1 && core_metadata.seed_window > 0)) {
+        throw std::invalid_argument("Invalid lane count in core metadata: " + 
+                                    std::to_string(core_metadata.lanes));
+    }
+    for (const auto& block : core_metadata.blocks) {
+        if (block.code_offset + block.code_count > compressed.size() ||
+            block.original_offset + block.original_size > core_metadata.original_size) {
+            throw std::invalid_argument("Block metadata out of range of compressed data");
+        }
+        if (core_metadata.lanes > 1 &&
+            (block.lane_code_counts.size() != core_metadata.lanes ||
+             std::accumulate(block.lane_code_counts.begin(), block.lane_code_counts.end(), size_t(0)) != block.code_count)) {
+            throw std::invalid_argument("Block lane counts do not match its code count");
+        }
+        if (!block.tandem_repeats.empty() &&
+            (core_metadata.lanes > 1 || tandem_repeat_bases(block.tandem_repeats) > block.original_size * 4)) {
+            throw std::invalid_argument("Block tandem repeats exceed the block");
+        }
+        if (!block.approximate_repeats.empty() &&
+            (core_metadata.lanes > 1 || approximate_repeat_bases(block.approximate_repeats) >
+                                            block.original_size * 4 - tandem_repeat_bases(block.tandem_repeats))) {
+            throw std::invalid_argument("Block approximate repeats exceed the block");
+        }
+    }
+}
+
+void CircularChromosomeCompressor::decode_block(
+    const std::vector<int>& compressed,
+    const CoreMetadata& core_metadata,
+    size_t b,
+    uint8_t* output,
+    size_t seed_size
+) {
+    const BlockMetadata& block = core_metadata.blocks[b];
+    CCC_TRACE_BEGIN(dvnp_decompress, block.code_count);
+    
+    if (core_metadata.lanes > 1) {
+        DvnpLaneDecoder decoder(core_metadata.lanes, core_metadata.max_dict_size);
+        decoder.decode(compressed.data() + block.code_offset, block.lane_code_counts.data(),
+                       output, block.original_size);
+        CCC_TRACE_END(dvnp_decompress, block.code_count, block.original_size * 4);
+        return;
+    }
+    
+    std::vector<uint8_t> seed(seed_size * 4);
+    bytes_to_symbols(output - seed_size, seed_size, seed.data());
+    
+    DvnpDecoder decoder(core_metadata.max_dict_size);
+    if (block.tandem_repeats.empty() && block.approximate_repeats.empty()) {
+        size_t bases = decoder.decode(compressed.data() + block.code_offset, block.code_count,
+                                      output, block.original_size * 4, seed.data(), seed.size());
+        if (bases != block.original_size * 4) {
+            throw std::invalid_argument("Block " + std::to_string(b) + " decoded to " + 
+                                        std::to_string(bases) + " bases, expected " + 
+                                        std::to_string(block.original_size * 4));
+        }
+        CCC_TRACE_END(dvnp_decompress, block.code_count, bases);
+        return;
+    }
+    
+    // The codes hold the residual; copies, then tandem repeats, are spliced back in while repacking
+    const size_t tandem_residual_bases = block.original_size * 4 - tandem_repeat_bases(block.tandem_repeats);
+    const size_t residual_bases = tandem_residual_bases - approximate_repeat_bases(block.approximate_repeats);
+    std::vector<uint8_t> residual((residual_bases + 3) / 4, 0);
+    size_t bases = decoder.decode(compressed.data() + block.code_offset, block.code_count,
+                                  residual.data(), residual_bases, seed.data(), seed.size());
+    if (bases != residual_bases) {
+        throw std::invalid_argument("Block " + std::to_string(b) + " decoded to " + 
+                                    std::to_string(bases) + " residual bases, expected " + 
+                                    std::to_string(residual_bases));
+    }
+    if (!block.approximate_repeats.empty()) {
+        // Copies rebuild the tandem residual, which is the output itself without tandem repeats
+        std::vector<uint8_t> tandem_residual;
+        if (!block.tandem_repeats.empty()) {
+            tandem_residual.assign((tandem_residual_bases + 3) / 4, 0);
+        }
+        expand_approximate_repeats(residual.data(), residual_bases, block.approximate_repeats,
+                                   block.tandem_repeats.empty() ? output : tandem_residual.data(), tandem_residual_bases);
+        residual.swap(tandem_residual);
+    }
+    if (!block.tandem_repeats.empty()) {
+        expand_tandem_repeats(residual.data(), tandem_residual_bases, block.tandem_repeats, output,
+                              block.original_size * 4);
+    }
+    CCC_TRACE_END(dvnp_decompress, block.code_count, block.original_size * 4);
+}
+
+void CircularChromosomeCompressor::decompress_blocks_into(
+    const std::vector<int>& compressed,
+    const CoreMetadata& core_metadata,
+    uint8_t* output
+) {
+    const auto& blocks = core_metadata.blocks;
+    validate_blocks(compressed, core_metadata);
+    
+    if (core_metadata.seed_window > 0) {
+        // Each dictionary is rebuilt from the already decoded tail before the block
+        for (size_t b = 0; b < blocks.size(); ++b) {
+            size_t seed_size = std::min(core_metadata.seed_window, blocks[b].original_offset);
+            decode_block(compressed, core_metadata, b, output + blocks[b].original_offset, seed_size);
+        }
+        return;
+    }
+    
+    // Blocks cover disjoint byte ranges, so decoders can write concurrently
+    ThreadPool pool(std::min(num_threads_ == 0 ? ThreadPool::default_thread_count() : num_threads_, blocks.size()));
+    pool.parallel_for(blocks.size(), [&](size_t b) {
+        const uint64_t log_start = log_clock();
+        decode_block(compressed, core_metadata, b, output + blocks[b].original_offset, 0);
+        if (verbose_) {
+            log(LogSeverity::Debug, "block_decode", "Block " + std::to_string(b) + ": " + 
+                std::to_string(blocks[b].code_count) + " codes", blocks[b].original_size, log_clock() - log_start);
+        }
+    });
+}
+
+std::pair<std::vector<int>, CompressionMetadata> CircularChromosomeCompressor::recompress(
+    const std::vector<int>& compressed_data,
+    const CompressionMetadata& metadata
+) {
+    if (block_size_ == 0) {
+        throw std::invalid_argument("Recompression requires block-parallel mode (set_block_size)");
+    }
+    
+    const CoreMetadata& source = metadata.core;
+    if (source.original_size == 0 || source.route == CompressionRoute::Stored) {
+        return {compressed_data, metadata};
+    }
     std::vector<int> core_data = decapsulate(compressed_data, metadata.encapsulation);
     
-    // Layer 2: Core decompression
-    std::vector<uint8_t> binary_data = decompress_core(core_data, metadata.core);
+    log("Recompressing " + std::to_string(source.original_size) + " bytes: " + 
+        std::to_string(source.blocks.size()) + " source blocks → " + std::to_string(block_size_) + 
+        " byte blocks, dictionary " + std::to_string(max_dict_size_));
+    
+    const size_t num_threads = num_threads_ == 0 ? ThreadPool::default_thread_count() : num_threads_;
+    // Bytes before the next block that either side's seed window can reach
+    const size_t context = std::max(seed_window_, source.seed_window);
+    
+    std::vector<uint8_t> window;     // decoded input starting at window_offset
+    size_t window_offset = 0;
+    size_t decoded = 0;              // whole input bytes decoded; the window may hold part of the next
+    size_t encoded = 0;              // input bytes already re-encoded
+    std::array<size_t, 256> freq{};
+    
+    CompressionMetadata result;
+    CoreMetadata& core_metadata = result.core;
+    core_metadata.block_size = block_size_;
+    core_metadata.max_dict_size = max_dict_size_;
+    core_metadata.seed_window = seed_window_;
+    core_metadata.lanes = effective_lanes();
+    core_metadata.tandem_min_bases = tandem_min_bases_;
+    core_metadata.approx_min_bases = approx_min_bases_;
+    std::vector<int> core_codes;
+    
+    ThreadPool pool(num_threads);
+    auto encode_ready = [&](bool final) {
+        size_t pending = decoded - encoded;
+        size_t count = final ? (pending + block_size_ - 1) / block_size_ : pending / block_size_;
+        if (count == 0 || (!final && count < num_threads)) {
+            return;
+        }
+        
+        std::vector<std::vector<int>> block_codes(count);
+        std::vector<size_t> block_resets(count, 0);
+        std::vector<std::vector<size_t>> block_lanes(count);
+        std::vector<std::vector<TandemRepeat>> block_repeats(count);
+        std::vector<std::vector<ApproximateRepeat>> block_copies(count);
+        // Declared after the buffers its checks read, so it is drained before they go away
+        std::unique_ptr<BlockVerifier> verifier;
+        if (verify_on_write_) {
+            verifier = std::make_unique<BlockVerifier>(verify_threads(num_threads));
+        }
+        pool.parallel_for(count, [&](size_t k) {
+            size_t offset = encoded + k * block_size_;
+            size_t size = std::min(block_size_, decoded - offset);
+            size_t seed_size = std::min(seed_window_, offset);
+            const uint8_t* input = window.data() + (offset - window_offset);
+            block_resets[k] = encode_block(input, size, seed_size, block_codes[k], block_lanes[k], block_repeats[k],
+                                           block_copies[k]);
+            if (verifier) {
+                verifier->submit([&, k, input, size, seed_size]() {
+                    verify_block(input, size, seed_size, block_codes[k], block_lanes[k], block_repeats[k],
+                                 block_copies[k], core_metadata.blocks.size() + k);
+                });
+            }
+        });
+        if (verifier) {
+            verifier->wait();
+        }
+        
+        for (size_t k = 0; k < count; ++k) {
+            BlockMetadata block;
+            block.original_offset = encoded;
+            block.original_size = std::min(block_size_, decoded - encoded);
+            block.code_offset = core_codes.size();
+            block.code_count = block_codes[k].size();
+            block.lane_code_counts = std::move(block_lanes[k]);
+            block.tandem_repeats = std::move(block_repeats[k]);
+            block.approximate_repeats = std::move(block_copies[k]);
+            core_metadata.blocks.push_back(block);
+            core_metadata.reset_count += block_resets[k];
+            core_codes.insert(core_codes.end(), block_codes[k].begin(), block_codes[k].end());
+            encoded += block.original_size;
+        }
+        
+        // Drop input no later seed can reach
+        size_t keep_from = encoded - std::min(encoded, context);
+        if (keep_from > window_offset) {
+            window.erase(window.begin(), window.begin() + (keep_from - window_offset));
+            window_offset = keep_from;
+        }
+    };
+    
+    if (source.blocks.empty()) {
+        // Reset markers split one stream into independent dictionary segments; each is
+        // measured, decoded on its own and spliced in at its (unaligned) base position
+        const int marker = static_cast<int>(kDvnpMaxDictSize);
+        const size_t total_bases = source.original_size * 4;
+        DvnpDecoder decoder;
+        std::vector<uint8_t> segment;
+        size_t bases = 0;
+        size_t begin = 0;
+        while (begin < core_data.size()) {
+            // A leading marker stays in the segment for the decoder to reject
+            size_t end = std::find(core_data.begin() + begin + 1, core_data.end(), marker) - core_data.begin();
+            size_t segment_bases = decoder.decoded_bases(core_data.data() + begin, end - begin);
+            if (segment_bases > total_bases - bases) {
+                throw std::invalid_argument("Source stream decodes past its " + std::to_string(total_bases) +
+                                            " bases");
+            }
+            segment.assign((segment_bases + 3) / 4, 0);
+            decoder.decode(core_data.data() + begin, end - begin, segment.data(), segment_bases);
+            window.resize((bases + segment_bases + 3) / 4 - window_offset, 0);
+            copy_bases(segment.data(), 0, window.data(), bases - window_offset * 4, segment_bases);
+            bases += segment_bases;
+            for (; decoded < bases / 4; ++decoded) {
+                freq[window[decoded - window_offset]]++;
+            }
+            encode_ready(false);
+            begin = end;
+            while (begin < core_data.size() && core_data[begin] == marker) {
+                ++begin;
+            }
+        }
+        if (bases != total_bases) {
+            throw std::invalid_argument("Source stream decodes to " + std::to_string(bases) + " bases, expected " +
+                                        std::to_string(total_bases));
+        }
+    } else {
+        validate_blocks(core_data, source);
+        for (size_t b = 0; b < source.blocks.size(); ++b) {
+            const BlockMetadata& block = source.blocks[b];
+            if (block.original_offset != decoded) {
+                throw std::invalid_argument("Source block " + std::to_string(b) + " is not contiguous");
+            }
+            window.resize(window.size() + block.original_size, 0);
+            uint8_t* output = window.data() + (decoded - window_offset);
+            decode_block(core_data, source, b, output,
+                         std::min(source.seed_window, block.original_offset));
+            for (size_t i = 0; i < block.original_size; ++i) {
+                freq[output[i]]++;
+            }
+            decoded += block.original_size;
+            encode_ready(false);
+        }
+    }
+    encode_ready(true);
     
-    return binary_data;
+    if (encoded != source.original_size) {
+        throw std::invalid_argument("Recompressed " + std::to_string(encoded) + " bytes, expected " + 
+                                    std::to_string(source.original_size));
+    }
+    core_metadata.dna_length = encoded * 4;
+    core_metadata.original_size = encoded;
+    core_metadata.original_bits_length = encoded * 8;
+    // A nucleotide source re-encodes its packed bases; the text layout carries over
+    core_metadata.route = source.route;
+    core_metadata.nucleotide = source.nucleotide;
+    // Blocks are re-encoded in the filtered domain; the chain carries over too
+    core_metadata.filters = source.filters;
+    const size_t input_size = source.route == CompressionRoute::Nucleotide ? source.nucleotide.text_size : encoded;
+    
+    auto [final_data, encap_metadata] = encapsulate(core_codes);
+    result.encapsulation = encap_metadata;
+    result.compression_ratio = input_size == 0 ? 0.0 : static_cast<double>(final_data.size()) / input_size;
+    attach_stats(result, encoded == 0 ? 0.0 : histogram_entropy(freq, encoded), final_data, core_codes.size());
+    
+    log("Recompression completed: " + std::to_string(compressed_data.size()) + " → " + 
+        std::to_string(final_data.size()) + " codes");
+    
+    return {final_data, result};
+}
+
+size_t CircularChromosomeCompressor::decompress_to_file(
+    const std::vector<int>& compressed_data,
+    const CompressionMetadata& metadata,
+    const std::string& output_path
+) {
+    log("Starting decompression to file " + output_path);
+    
+    if (metadata.core.route != CompressionRoute::Dvnp || !metadata.core.filters.empty()) {
+        // Output size is only known after unpacking, and filters span the whole output; go through memory
+        std::vector<uint8_t> binary_data = decompress(compressed_data, metadata);
+        write_output_file(output_path, binary_data);
+        log("Decompressed " + std::to_string(binary_data.size()) + " bytes to " + output_path);
+        return binary_data.size();
+    }
+    
+    // Layer 1: Decapsulation (compressed-size working set only)
+    std::vector<int> core_data = decapsulate(compressed_data, metadata.encapsulation);
+    const size_t output_size = metadata.core.original_size;
+    
+#ifdef CCC_HAVE_MMAP
+    const std::string temp_path = staging_path(output_path);
+    int fd = ::open(temp_path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open output file " + temp_path + ": " + std::strerror(errno));
+    }
+    void* mapping = MAP_FAILED;
+    try {
+        if (output_size > 0) {
+            // Reserve the blocks up front: a store to an unbacked page of a sparse shared
+            // mapping raises SIGBUS on a full disk instead of failing a call
+            int error = ::posix_fallocate(fd, 0, static_cast<off_t>(output_size));
+            if (error != 0) {
+                throw std::runtime_error("Cannot allocate " + std::to_string(output_size) + " bytes for output file " +
+                                         temp_path + ": " + std::strerror(error));
+            }
+            mapping = ::mmap(nullptr, output_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (mapping == MAP_FAILED) {
+                throw std::runtime_error("Cannot map output file " + temp_path + ": " + std::strerror(errno));
+            }
+            
+            // Layer 2: Core decompression straight into the (zero-filled) mapping
+            uint8_t* output = static_cast<uint8_t*>(mapping);
+            if (!metadata.core.blocks.empty()) {
+                decompress_blocks_into(core_data, metadata.core, output);
+            } else {
+                DvnpDecoder decoder;
+                size_t bases = decoder.decode(core_data.data(), core_data.size(), output, output_size * 4);
+                if (bases != output_size * 4) {
+                    throw std::invalid_argument("Code stream decoded to " + std::to_string(bases) +
+                                                " bases, expected " + std::to_string(output_size * 4));
+                }
+            }
+            
+            // Writeback errors surface here, not after the file has been reported complete
+            if (::msync(mapping, output_size, MS_SYNC) != 0) {
+                throw std::runtime_error("Failed writing output file " + temp_path + ": " + std::strerror(errno));
+            }
+            ::munmap(mapping, output_size);
+            mapping = MAP_FAILED;
+        }
+        const int closed = ::close(fd);
+        fd = -1;
+        if (closed != 0) {
+            throw std::runtime_error("Failed closing output file " + temp_path + ": " + std::strerror(errno));
+        }
+    } catch (...) {
+        if (mapping != MAP_FAILED) {
+            ::munmap(mapping, output_size);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        ::unlink(temp_path.c_str());
+        throw;
+    }
+    install_output_file(temp_path, output_path);
+#else
+    write_output_file(output_path, decompress_core(core_data, metadata.core));
+#endif
+    
+    log("Decompressed " + std::to_string(output_size) + " bytes to " + output_path);
+    return output_size;
 }
 
 CompressionStats CircularChromosomeCompressor::get_compression_stats(
     const std::vector<uint8_t>& original_data,
     const std::vector<int>& compressed_data,
-    const CompressionMetadata& /* metadata */
+    const CompressionMetadata& metadata
 ) {
-    size_t original_size = original_data.size();
+    CompressionStats stats = build_stats(original_data.size(), calculate_entropy(original_data), compressed_data);
+    stats.core_codes = metadata.stats.core_codes;
+    stats.reset_count = metadata.core.reset_count;
+    stats.block_ratios = metadata.stats.block_ratios;
+    return stats;
+}
+
+double CircularChromosomeCompressor::code_entropy(const std::vector<int>& codes) {
+    if (codes.empty()) {
+        return 0.0;
+    }
     
+    // Byte histogram of each code in minimal little-endian form, without materialising the bytes
+    std::array<size_t, 256> freq{};
+    size_t total = 0;
+    for (int code : codes) {
+        size_t num_bytes = (code > 0 ? (static_cast<size_t>(std::log2(code)) + 1 + 7) / 8 : 1);
+        for (size_t i = 0; i < num_bytes; ++i) {
+            freq[(code >> (i * 8)) & 0xFF]++;
+        }
+        total += num_bytes;
+    }
+    return histogram_entropy(freq, total);
+}
+
+void CircularChromosomeCompressor::attach_stats(
+    CompressionMetadata& metadata,
+    double original_entropy,
+    const std::vector<int>& final_data,
+    size_t core_codes
+) {
+    const size_t original_size = metadata.core.route == CompressionRoute::Nucleotide ?
+        metadata.core.nucleotide.text_size : metadata.core.original_size;
+    metadata.stats = build_stats(original_size, original_entropy, final_data);
+    metadata.stats.core_codes = core_codes;
+    metadata.stats.reset_count = metadata.core.reset_count;
+    for (const BlockMetadata& block : metadata.core.blocks) {
+        metadata.stats.block_ratios.push_back(block.original_size == 0 ? 0.0 :
+            block.code_count * metadata.stats.bits_per_code / 8.0 / block.original_size);
+    }
+}
+
+CompressionStats CircularChromosomeCompressor::build_stats(
+    size_t original_size,
+    double original_entropy,
+    const std::vector<int>& compressed_data
+) {
     // More accurate size calculation: determine bits needed per code
     size_t compressed_size = 0;
     size_t bits_per_code = 16; // minimum 16-bit
+    int max_code = 0;
     
     if (!compressed_data.empty()) {
-        int max_code = *std::max_element(compressed_data.begin(), compressed_data.end());
+        max_code = *std::max_element(compressed_data.begin(), compressed_data.end());
         bits_per_code = std::max(static_cast<size_t>(16), static_cast<size_t>((max_code > 0 ? 
                                  static_cast<int>(std::log2(max_code)) + 1 : 1) + 7) / 8 * 8);
         size_t compressed_size_bits = compressed_data.size() * bits_per_code;
@@ -772,23 +1836,8 @@ CompressionStats CircularChromosomeCompressor::get_compression_stats(
     // Calculate DNA sequence length for bits per base calculation
     size_t dna_length = original_size * 4; // 2 bits per base -> 4 bases per byte
     
-    // Calculate Shannon entropy and efficiency metrics
-    double original_entropy = calculate_entropy(original_data);
-    
     // For compressed entropy, handle integer codes properly
-    double compressed_entropy = 0.0;
-    if (!compressed_data.empty()) {
-        // Convert integer codes to bytes representation for entropy calculation
-        std::vector<uint8_t> compressed_bytes;
-        for (int code : compressed_data) {
-            // Convert each code to bytes (using little-endian encoding)
-            size_t num_bytes = (code > 0 ? (static_cast<size_t>(std::log2(code)) + 1 + 7) / 8 : 1);
-            for (size_t i = 0; i < num_bytes; ++i) {
-                compressed_bytes.push_back(static_cast<uint8_t>((code >> (i * 8)) & 0xFF));
-            }
-        }
-        compressed_entropy = calculate_entropy(compressed_bytes);
-    }
+    double compressed_entropy = code_entropy(compressed_data);
     
     double entropy_reduction = original_entropy - compressed_entropy;
     double theoretical_min_size = (original_size > 0) ? (original_entropy * original_size) / 8 : 0;
@@ -816,8 +1865,7 @@ CompressionStats CircularChromosomeCompressor::get_compression_stats(
     stats.bits_per_base = (dna_length > 0) ? (compressed_size * 8.0) / dna_length : 0;
     stats.bits_per_code = bits_per_code;
     stats.total_codes = compressed_data.size();
-    stats.max_code_value = compressed_data.empty() ? 0 : 
-                          *std::max_element(compressed_data.begin(), compressed_data.end());
+    stats.max_code_value = max_code;
     stats.original_entropy = original_entropy;
     stats.compressed_entropy = compressed_entropy;
     stats.entropy_reduction = entropy_reduction;
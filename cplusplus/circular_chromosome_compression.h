@@ -14,10 +14,47 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include "approximate_repeats.h"
+#include "dvnp_codec.h"
+#include "input_classifier.h"
+#include "prefilter.h"
+#include "tandem_repeats.h"
 
 namespace ccc {
 
+class ResultCache;
+class AsyncLogger;
+enum class LogSeverity : uint8_t;
+
+/**
+ * Location of one independently coded block (block-parallel mode)
+ */
+struct BlockMetadata {
+    size_t original_offset = 0;
+    size_t original_size = 0;
+    size_t code_offset = 0;
+    size_t code_count = 0;
+    std::vector<size_t> lane_code_counts;   // codes per lane, empty for a single-lane block
+    std::vector<TandemRepeat> tandem_repeats;  // repeats cut out before DVNP coding
+    std::vector<ApproximateRepeat> approximate_repeats;  // copies cut out of the tandem residual
+};
+
+/**
+ * Path an input took through compress()
+ */
+enum class CompressionRoute : uint8_t {
+    Dvnp = 0,                           // binary_to_dna() and DVNP coding
+    Stored = 1,                         // bytes kept as codes (already compressed input)
+    Nucleotide = 2                      // ASCII bases packed 2-bit, then DVNP coding
+};
+
+/**
+ * Lowercase name of a route ("dvnp", "stored", "nucleotide")
+ */
+const char* compression_route_name(CompressionRoute route);
+
 /**
  * Metadata structure for compression layers
  */
@@ -25,6 +62,17 @@ struct CoreMetadata {
     size_t dna_length = 0;
     size_t original_size = 0;
     size_t original_bits_length = 0;
+    size_t block_size = 0;              // 0 for a single DVNP stream
+    uint32_t max_dict_size = kDvnpMaxDictSize;
+    size_t seed_window = 0;             // bytes of preceding input priming each block's dictionary
+    size_t lanes = 1;                   // interleaved DVNP streams per block
+    size_t tandem_min_bases = 0;        // shortest tandem repeat coded as a token; 0 = stage off
+    size_t approx_min_bases = 0;        // shortest approximate repeat coded as a copy token; 0 = stage off
+    size_t reset_count = 0;             // dictionary resets across all streams
+    std::vector<BlockMetadata> blocks;  // empty for a single DVNP stream
+    CompressionRoute route = CompressionRoute::Dvnp;
+    NucleotideLayout nucleotide;        // Nucleotide route: original_size etc. describe the packed bases
+    FilterChain filters;                // Dvnp route: applied before coding, inverted after decoding
 };
 
 struct TransSplicingMetadata {
@@ -41,12 +89,6 @@ struct EncapsulationMetadata {
     TransSplicingMetadata trans_splicing;
 };
 
-struct CompressionMetadata {
-    CoreMetadata core;
-    EncapsulationMetadata encapsulation;
-    double compression_ratio = 0.0;
-};
-
 struct CompressionStats {
     size_t original_size_bytes = 0;
     size_t compressed_size_bytes = 0;
@@ -62,6 +104,16 @@ struct CompressionStats {
     double theoretical_minimum_size = 0.0;
     double shannon_efficiency = 0.0;
     double compression_effectiveness = 0.0;
+    size_t core_codes = 0;              // DVNP codes before encapsulation
+    size_t reset_count = 0;             // dictionary resets across all streams
+    std::vector<double> block_ratios;   // per-block packed code size / block size
+};
+
+struct CompressionMetadata {
+    CoreMetadata core;
+    EncapsulationMetadata encapsulation;
+    double compression_ratio = 0.0;
+    CompressionStats stats;             // computed by compress(), stored in archive headers
 };
 
 /**
@@ -85,6 +137,18 @@ public:
         bool verbose = false
     );
 
+    /**
+     * Primality test by trial division; 64-bit so ring lengths of multi-GB inputs fit
+     */
+    static bool is_prime(uint64_t n);
+
+    /**
+     * Smallest prime >= n: the ring length used by circular encapsulation
+     *
+     * @throws std::overflow_error if no such prime fits in 64 bits
+     */
+    static uint64_t next_prime(uint64_t n);
+
     /**
      * Convert binary data to DNA sequence using 2-bit to base mapping
      * Inspired by balanced nucleotide distribution in dinoflagellates
@@ -137,6 +201,207 @@ public:
      */
     std::vector<uint8_t> decompress(const std::vector<int>& compressed_data, const CompressionMetadata& metadata);
 
+    /**
+     * Decompress directly into a memory-mapped output file
+     * The file's blocks are reserved from the core metadata and each block is
+     * decoded in parallel straight into the mapping, so peak memory stays at the
+     * dictionary size rather than the output size.
+     * 
+     * @param compressed_data Compressed data from compress()
+     * @param metadata Metadata from compress()
+     * @param output_path Destination file; the output is written to a temporary
+     *        file beside it and renamed into place only once complete, so a
+     *        failure leaves any existing file untouched
+     * @return Number of bytes written
+     * @throws std::runtime_error if the output cannot be allocated, written or installed
+     */
+    size_t decompress_to_file(
+        const std::vector<int>& compressed_data,
+        const CompressionMetadata& metadata,
+        const std::string& output_path
+    );
+
+    /**
+     * Re-encode an existing compress() result with this compressor's block settings
+     * Source blocks are decoded one at a time and re-encoded in parallel batches,
+     * so memory stays bounded by the code streams plus a few blocks rather than
+     * the original size. Single-stream sources are decoded one reset-delimited
+     * dictionary segment at a time.
+     * 
+     * @param compressed_data Compressed data from compress()
+     * @param metadata Metadata from compress()
+     * @return Data and metadata as compress() would produce for the original input
+     * @throws std::invalid_argument if block-parallel mode is disabled or the source is malformed
+     */
+    std::pair<std::vector<int>, CompressionMetadata> recompress(
+        const std::vector<int>& compressed_data,
+        const CompressionMetadata& metadata
+    );
+
+    /**
+     * Enable block-parallel compression
+     * Input is split into independently coded blocks of this many bytes;
+     * 0 keeps the single-stream layout.
+     * 
+     * @param block_size Block size in bytes
+     */
+    void set_block_size(size_t block_size) { block_size_ = block_size; }
+    size_t block_size() const { return block_size_; }
+
+    /**
+     * Worker threads for block-parallel compression and decompression
+     * 
+     * @param num_threads Thread count; 0 uses the hardware concurrency
+     */
+    void set_num_threads(size_t num_threads) { num_threads_ = num_threads; }
+    size_t num_threads() const { return num_threads_; }
+
+    /**
+     * DVNP dictionary capacity for block-parallel mode
+     * Smaller dictionaries reset more often but stay cache resident.
+     * 
+     * @param max_dict_size Number of codes before a reset (16 to kDvnpDictSizeLimit)
+     * @throws std::invalid_argument if max_dict_size is out of range
+     */
+    void set_max_dict_size(uint32_t max_dict_size);
+    uint32_t max_dict_size() const { return max_dict_size_; }
+
+    /**
+     * Warm-start each block's dictionary from the tail of the preceding input
+     * Encoding stays parallel; decoding becomes sequential because each block
+     * needs the decoded tail of the one before it.
+     * 
+     * @param seed_window Bytes of preceding input to prime with; 0 starts every block empty
+     */
+    void set_seed_window(size_t seed_window) { seed_window_ = seed_window; }
+    size_t seed_window() const { return seed_window_; }
+
+    /**
+     * Split every block into interleaved DVNP lanes
+     * The lanes are coded independently in one loop, so their dictionary
+     * lookups overlap on a single core. Each lane has its own dictionary,
+     * which costs some ratio and cache footprint; small dictionaries benefit
+     * most. Ignored when a seed window is set.
+     * 
+     * @param lanes Lanes per block, 1 to kDvnpMaxLanes
+     */
+    void set_lanes(size_t lanes);
+    size_t lanes() const { return lanes_; }
+
+    /**
+     * Walk long DVNP phrases 2-4 bases per trie lookup (see DvnpEncoder)
+     * The codes are identical either way. Only worth enabling for highly
+     * repetitive input; on random and genome-like data it is no faster and
+     * adds up to 16 MB of tables per encoder. Applies to single-lane blocks.
+     * Off by default.
+     * 
+     * @param enabled Whether block encoders use the multi-base tables
+     */
+    void set_multi_base(bool enabled) { multi_base_ = enabled; }
+    bool multi_base() const { return multi_base_; }
+
+    /**
+     * Code tandem repeats (microsatellites) as (unit, count) tokens
+     * Before DVNP coding, every block is scanned for runs of a 1-6 base unit
+     * of at least min_bases bases; these are removed from the base stream and
+     * stored as tokens in the block metadata. Ignores the lane setting.
+     * 
+     * @param min_bases Shortest repeat to tokenize (kTandemDefaultMinBases is a good start); 0 disables
+     * @throws std::invalid_argument if min_bases is below kTandemMinBases but not 0
+     */
+    void set_tandem_repeats(size_t min_bases);
+    size_t tandem_repeats() const { return tandem_min_bases_; }
+
+    /**
+     * Code approximate repeats as (distance, length, substitutions) copy tokens
+     * Before DVNP coding (and after the tandem repeat stage), every block is
+     * searched for copies of earlier material in the same block, allowing
+     * point substitutions; copies of at least min_bases bases are removed from
+     * the base stream and stored as tokens in the block metadata. Ignores the
+     * lane setting.
+     * 
+     * @param min_bases Shortest copy to tokenize (kApproxDefaultMinBases is a good start); 0 disables
+     * @throws std::invalid_argument if min_bases is below kApproxMinBases but not 0
+     */
+    void set_approximate_repeats(size_t min_bases);
+    size_t approximate_repeats() const { return approx_min_bases_; }
+
+    /**
+     * Route each input by its content
+     * compress() classifies the input from a prefix and sampled blocks
+     * (classify_input()) and picks a route: compressed or near-random data is
+     * stored as byte codes, ASCII nucleotide text is packed 2 bits per base
+     * before DVNP coding, and everything else takes the binary path.
+     * Off by default, so every input takes the binary path.
+     * 
+     * @param enabled Whether to classify and route inputs
+     */
+    void set_auto_route(bool enabled) { auto_route_ = enabled; }
+    bool auto_route() const { return auto_route_; }
+
+    /**
+     * Route compress() picks for a classified input in auto-route mode
+     */
+    static CompressionRoute route_for(const InputProfile& profile);
+
+    /**
+     * Typed pre-filters for arrays of fixed-width numbers
+     * Inputs taking the binary path are filtered (delta, XOR-delta, byte or
+     * bit shuffle per element width) before core compression; the chain is
+     * recorded in the metadata and inverted by decompress(). Empty by default.
+     * 
+     * @param chain Filters in application order
+     * @throws std::invalid_argument for an unsupported filter or element width
+     */
+    void set_prefilters(FilterChain chain);
+    const FilterChain& prefilters() const { return prefilters_; }
+
+    /**
+     * Verify every archive while it is written
+     * Finished pieces of the core are decoded on separate workers while
+     * later ones are still compressing, and compared against the input: each
+     * block in block-parallel mode, each dictionary-reset segment (about
+     * 65536 codes) of a single-stream core. Pre-filters, nucleotide packing
+     * and encapsulation are inverted and compared whole afterwards. Applies
+     * to compress() and recompress(). Off by default.
+     * Cost: the single-stream decode is far cheaper than its encode, so
+     * verification adds about 5% there. In block mode decoding costs over
+     * half as much CPU as encoding; it hides behind encoding on spare cores,
+     * but wall time grows about 1.5-1.8x when every core is already encoding.
+     * 
+     * @param enabled Whether to verify; a mismatch makes compression throw std::runtime_error
+     */
+    void set_verify_on_write(bool enabled) { verify_on_write_ = enabled; }
+    bool verify_on_write() const { return verify_on_write_; }
+
+    /**
+     * Reuse archives of previously compressed identical inputs
+     * compress() looks the input up by content hash and compression
+     * parameters, and stores new results in the cache.
+     * 
+     * @param cache Shared cache; nullptr disables caching
+     */
+    void set_result_cache(std::shared_ptr<ResultCache> cache) { result_cache_ = std::move(cache); }
+    const std::shared_ptr<ResultCache>& result_cache() const { return result_cache_; }
+
+    /**
+     * Destination of verbose-mode log records
+     * Records are queued on a per-thread ring and written by the logger's
+     * background thread, so logging does not serialize the pipeline.
+     * 
+     * @param logger Shared logger; nullptr uses AsyncLogger::standard() (std::cout)
+     */
+    void set_logger(std::shared_ptr<AsyncLogger> logger) { logger_ = std::move(logger); }
+    const std::shared_ptr<AsyncLogger>& logger() const { return logger_; }
+
+    /**
+     * Byte -> base expansion kernel for block-parallel mode
+     * 
+     * @param kernel Kernel; unsupported kernels fall back to Scalar
+     */
+    void set_symbol_kernel(SymbolKernel kernel) { symbol_kernel_ = kernel; }
+    SymbolKernel symbol_kernel() const { return symbol_kernel_; }
+
     /**
      * Calculate compression statistics and efficiency metrics
      * 
@@ -166,6 +431,20 @@ private:
     bool strict_mode_;
     bool verbose_;
     size_t original_bits_length_;
+    size_t block_size_;
+    size_t num_threads_;
+    uint32_t max_dict_size_;
+    size_t seed_window_;
+    size_t lanes_;
+    bool multi_base_;
+    size_t tandem_min_bases_;
+    size_t approx_min_bases_;
+    bool auto_route_;
+    bool verify_on_write_;
+    FilterChain prefilters_;
+    SymbolKernel symbol_kernel_;
+    std::shared_ptr<ResultCache> result_cache_;
+    std::shared_ptr<AsyncLogger> logger_;
 
     // Base mapping for DNA conversion
     std::unordered_map<std::string, char> base_mapping_;
@@ -174,14 +453,18 @@ private:
 
     // Private helper methods
     void log(const std::string& message);
+    void log(LogSeverity severity, const char* stage, const std::string& message,
+             uint64_t bytes = 0, uint64_t duration_ns = 0);
+    uint64_t log_clock() const;
     bool validate_input(const void* data, const std::string& data_name);
     
     std::string compute_data_hash(const std::vector<int>& data);
+    double code_entropy(const std::vector<int>& codes);
+    CompressionStats build_stats(size_t original_size, double original_entropy, const std::vector<int>& compressed_data);
+    void attach_stats(CompressionMetadata& metadata, double original_entropy, 
+                      const std::vector<int>& final_data, size_t core_codes);
     bool verify_data_integrity(const std::vector<int>& data, const std::string& expected_hash, const std::string& operation = "decompression");
     
-    bool is_prime(int n);
-    int next_prime(int n);
-    
     std::vector<int> circular_encapsulate(const std::vector<int>& compressed);
     std::pair<std::vector<int>, TransSplicingMetadata> add_trans_splicing_markers(
         const std::vector<int>& circular_data, 
@@ -189,10 +472,32 @@ private:
     );
     
     std::pair<std::vector<int>, CoreMetadata> compress_core(const std::vector<uint8_t>& binary_data);
+    // dvnp_compress() body; on_segment (if set) sees each reset-delimited segment as soon as it is finished
+    using StreamSegmentHandler = std::function<void(const uint32_t* codes, size_t count, size_t first_base,
+                                                    size_t bases)>;
+    std::vector<int> dvnp_compress_segments(const std::string& dna_seq, const StreamSegmentHandler& on_segment);
     std::pair<std::vector<int>, EncapsulationMetadata> encapsulate(const std::vector<int>& compressed);
     
     std::vector<int> decapsulate(const std::vector<int>& marked_data, const EncapsulationMetadata& encap_metadata);
     std::vector<uint8_t> decompress_core(const std::vector<int>& compressed, const CoreMetadata& core_metadata);
+    std::vector<uint8_t> restore_stored(const std::vector<int>& stored, const CompressionMetadata& metadata);
+    
+    std::string cache_parameters() const;
+    std::pair<std::vector<int>, CoreMetadata> compress_blocks(const std::vector<uint8_t>& binary_data);
+    void decompress_blocks_into(const std::vector<int>& compressed, const CoreMetadata& core_metadata, uint8_t* output);
+    size_t effective_lanes() const;
+    size_t encode_block(const uint8_t* block, size_t size, size_t seed_size, std::vector<int>& codes,
+                        std::vector<size_t>& lane_counts, std::vector<TandemRepeat>& repeats,
+                        std::vector<ApproximateRepeat>& copies);
+    void decode_block(const std::vector<int>& compressed, const CoreMetadata& core_metadata, size_t b,
+                      uint8_t* output, size_t seed_size);
+    void validate_blocks(const std::vector<int>& compressed, const CoreMetadata& core_metadata);
+    
+    // Verify-on-write: decode one freshly encoded block and compare it with its input
+    class BlockVerifier;
+    void verify_block(const uint8_t* block, size_t size, size_t seed_size, const std::vector<int>& codes,
+                      const std::vector<size_t>& lane_counts, const std::vector<TandemRepeat>& repeats,
+                      const std::vector<ApproximateRepeat>& copies, size_t index);
 };
 
 } // namespace ccc
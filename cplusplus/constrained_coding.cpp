@@ -0,0 +1,275 @@
+/**
+ * Constrained Coding for Synthesis-Friendly DNA - C++ Implementation
+ */
+
+#include "constrained_coding.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace ccc {
+
+namespace {
+
+constexpr uint16_t kInvalidWord = 0xFFFF;
+constexpr uint8_t kInvalidBase = 0xFF;
+constexpr char kBases[4] = {'A', 'C', 'G', 'T'};
+constexpr size_t kCodeHeaderBytes = 9;  // 1 byte code width + 8 bytes code count
+
+bool is_gc(uint32_t base) {
+    return base == 1 || base == 2;
+}
+
+/**
+ * Check a packed 8-base word (base 0 in the two most significant bits)
+ */
+bool is_codeword(uint32_t word) {
+    uint32_t bases[ConstrainedCodec::kWordBases];
+    size_t gc = 0;
+    for (size_t i = 0; i < ConstrainedCodec::kWordBases; ++i) {
+        bases[i] = (word >> (2 * (ConstrainedCodec::kWordBases - 1 - i))) & 3u;
+        gc += is_gc(bases[i]) ? 1 : 0;
+    }
+    if (gc < ConstrainedCodec::kMinGcPerWord || gc > ConstrainedCodec::kMaxGcPerWord) {
+        return false;
+    }
+
+    // Leading run of 1 and trailing run <= 2 keep boundary runs <= 3
+    if (bases[0] == bases[1]) {
+        return false;
+    }
+    size_t run = 1;
+    for (size_t i = 1; i < ConstrainedCodec::kWordBases; ++i) {
+        run = (bases[i] == bases[i - 1]) ? run + 1 : 1;
+        if (run > ConstrainedCodec::kMaxRunLength) {
+            return false;
+        }
+    }
+    return run <= ConstrainedCodec::kMaxRunLength - 1;
+}
+
+std::array<uint8_t, 256> make_base_lut() {
+    std::array<uint8_t, 256> lut;
+    lut.fill(kInvalidBase);
+    for (uint8_t i = 0; i < 4; ++i) {
+        lut[static_cast<uint8_t>(kBases[i])] = i;
+        lut[static_cast<uint8_t>(kBases[i] - 'A' + 'a')] = i;
+    }
+    return lut;
+}
+
+size_t bits_for_value(uint32_t value) {
+    size_t bits = 1;
+    while (bits < 32 && (value >> bits) != 0) {
+        ++bits;
+    }
+    return bits;
+}
+
+} // namespace
+
+struct ConstrainedCodec::Tables {
+    std::vector<char> word_chars;        // value -> 8 ASCII bases
+    std::vector<uint16_t> decode_table;  // packed word -> value or kInvalidWord
+    std::array<uint8_t, 256> base_lut;   // ASCII -> 2-bit base or kInvalidBase
+
+    Tables() : word_chars((size_t(1) << kBitsPerWord) * kWordBases),
+               decode_table(size_t(1) << (2 * kWordBases), kInvalidWord),
+               base_lut(make_base_lut()) {
+        const uint32_t num_values = 1u << kBitsPerWord;
+        uint32_t value = 0;
+        for (uint32_t word = 0; word < decode_table.size() && value < num_values; ++word) {
+            if (!is_codeword(word)) {
+                continue;
+            }
+            decode_table[word] = static_cast<uint16_t>(value);
+            for (size_t i = 0; i < kWordBases; ++i) {
+                word_chars[value * kWordBases + i] = kBases[(word >> (2 * (kWordBases - 1 - i))) & 3u];
+            }
+            ++value;
+        }
+        if (value != num_values) {
+            throw std::logic_error("Constrained code has fewer codewords than data symbols");
+        }
+    }
+};
+
+const ConstrainedCodec::Tables& ConstrainedCodec::shared_tables() {
+    static const Tables tables;
+    return tables;
+}
+
+ConstrainedCodec::ConstrainedCodec() : tables_(shared_tables()) {
+}
+
+std::string ConstrainedCodec::encode(const std::vector<uint8_t>& data) const {
+    const size_t total_bits = data.size() * 8;
+    const size_t num_words = (total_bits + kBitsPerWord - 1) / kBitsPerWord;
+    const uint32_t value_mask = (1u << kBitsPerWord) - 1;
+
+    std::string dna_seq(num_words * kWordBases, 'A');
+    char* out = &dna_seq[0];
+
+    uint64_t acc = 0;
+    size_t acc_bits = 0;
+    for (uint8_t byte : data) {
+        acc = (acc << 8) | byte;
+        acc_bits += 8;
+        if (acc_bits >= kBitsPerWord) {
+            acc_bits -= kBitsPerWord;
+            uint32_t value = static_cast<uint32_t>(acc >> acc_bits) & value_mask;
+            std::memcpy(out, &tables_.word_chars[value * kWordBases], kWordBases);
+            out += kWordBases;
+        }
+    }
+    if (acc_bits > 0) {
+        uint32_t value = static_cast<uint32_t>(acc << (kBitsPerWord - acc_bits)) & value_mask;
+        std::memcpy(out, &tables_.word_chars[value * kWordBases], kWordBases);
+    }
+
+    return dna_seq;
+}
+
+std::vector<uint8_t> ConstrainedCodec::decode(const std::string& dna_seq, size_t original_size) const {
+    const size_t needed_words = (original_size * 8 + kBitsPerWord - 1) / kBitsPerWord;
+    if (dna_seq.length() < needed_words * kWordBases) {
+        throw std::invalid_argument("Constrained DNA sequence too short: expected " +
+                                    std::to_string(needed_words * kWordBases) + " bases, got " +
+                                    std::to_string(dna_seq.length()));
+    }
+
+    std::vector<uint8_t> data(original_size);
+    size_t out = 0;
+    uint64_t acc = 0;
+    size_t acc_bits = 0;
+
+    for (size_t w = 0; w < needed_words; ++w) {
+        const char* chars = dna_seq.data() + w * kWordBases;
+        uint32_t word = 0;
+        uint8_t invalid = 0;
+        for (size_t i = 0; i < kWordBases; ++i) {
+            uint8_t base = tables_.base_lut[static_cast<uint8_t>(chars[i])];
+            invalid |= (base == kInvalidBase) ? 1 : 0;
+            word = (word << 2) | (base & 3u);
+        }
+        uint16_t value = tables_.decode_table[word];
+        if (invalid || value == kInvalidWord) {
+            throw std::invalid_argument("Invalid constrained codeword at base " +
+                                        std::to_string(w * kWordBases));
+        }
+
+        acc = (acc << kBitsPerWord) | value;
+        acc_bits += kBitsPerWord;
+        while (acc_bits >= 8 && out < original_size) {
+            acc_bits -= 8;
+            data[out++] = static_cast<uint8_t>(acc >> acc_bits);
+        }
+    }
+
+    return data;
+}
+
+std::string ConstrainedCodec::encode_codes(const std::vector<int>& codes) const {
+    uint32_t max_code = 0;
+    for (int code : codes) {
+        if (code < 0) {
+            throw std::invalid_argument("Negative code cannot be transcoded: " + std::to_string(code));
+        }
+        max_code = std::max(max_code, static_cast<uint32_t>(code));
+    }
+    const size_t width = bits_for_value(max_code);
+
+    std::vector<uint8_t> packed;
+    packed.reserve(kCodeHeaderBytes + (codes.size() * width + 7) / 8);
+    packed.push_back(static_cast<uint8_t>(width));
+    uint64_t count = codes.size();
+    for (size_t i = 0; i < 8; ++i) {
+        packed.push_back(static_cast<uint8_t>(count >> (8 * i)));
+    }
+
+    uint64_t acc = 0;
+    size_t acc_bits = 0;
+    for (int code : codes) {
+        acc = (acc << width) | static_cast<uint32_t>(code);
+        acc_bits += width;
+        while (acc_bits >= 8) {
+            acc_bits -= 8;
+            packed.push_back(static_cast<uint8_t>(acc >> acc_bits));
+        }
+    }
+    if (acc_bits > 0) {
+        packed.push_back(static_cast<uint8_t>(acc << (8 - acc_bits)));
+    }
+
+    return encode(packed);
+}
+
+std::vector<int> ConstrainedCodec::decode_codes(const std::string& dna_seq) const {
+    const size_t header_bases = ((kCodeHeaderBytes * 8 + kBitsPerWord - 1) / kBitsPerWord) * kWordBases;
+    if (dna_seq.length() < header_bases) {
+        throw std::invalid_argument("Constrained DNA sequence too short for code header");
+    }
+
+    std::vector<uint8_t> header = decode(dna_seq.substr(0, header_bases), kCodeHeaderBytes);
+    const size_t width = header[0];
+    uint64_t count = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        count |= static_cast<uint64_t>(header[1 + i]) << (8 * i);
+    }
+    // encode_codes() never writes more than 31 bits: wider codes would not fit an int
+    if (width == 0 || width > 31) {
+        throw std::invalid_argument("Invalid code width in constrained header: " + std::to_string(width));
+    }
+    // The count is untrusted; bound it by the payload bits before it sizes anything
+    const uint64_t payload_bits = dna_seq.length() / kWordBases * kBitsPerWord - kCodeHeaderBytes * 8;
+    if (count > payload_bits / width) {
+        throw std::invalid_argument("Constrained header claims " + std::to_string(count) +
+                                    " codes, sequence holds at most " + std::to_string(payload_bits / width));
+    }
+
+    const size_t packed_size = kCodeHeaderBytes + (count * width + 7) / 8;
+    std::vector<uint8_t> packed = decode(dna_seq, packed_size);
+
+    std::vector<int> codes;
+    codes.reserve(count);
+    uint64_t acc = 0;
+    size_t acc_bits = 0;
+    const uint64_t code_mask = (uint64_t(1) << width) - 1;
+    for (size_t i = kCodeHeaderBytes; i < packed.size() && codes.size() < count; ++i) {
+        acc = (acc << 8) | packed[i];
+        acc_bits += 8;
+        while (acc_bits >= width && codes.size() < count) {
+            acc_bits -= width;
+            codes.push_back(static_cast<int>((acc >> acc_bits) & code_mask));
+        }
+    }
+
+    return codes;
+}
+
+size_t ConstrainedCodec::max_homopolymer_run(const std::string& dna_seq) {
+    size_t longest = dna_seq.empty() ? 0 : 1;
+    size_t run = 1;
+    for (size_t i = 1; i < dna_seq.length(); ++i) {
+        run = (dna_seq[i] == dna_seq[i - 1]) ? run + 1 : 1;
+        longest = std::max(longest, run);
+    }
+    return longest;
+}
+
+bool ConstrainedCodec::satisfies_constraints(const std::string& dna_seq, size_t max_run) {
+    if (max_homopolymer_run(dna_seq) > max_run) {
+        return false;
+    }
+    for (size_t w = 0; w + kWordBases <= dna_seq.length(); w += kWordBases) {
+        size_t gc = std::count_if(dna_seq.begin() + w, dna_seq.begin() + w + kWordBases,
+                                  [](char base) { return base == 'G' || base == 'C'; });
+        if (gc < kMinGcPerWord || gc > kMaxGcPerWord) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace ccc
@@ -0,0 +1,107 @@
+/**
+ * Constrained Coding for Synthesis-Friendly DNA - C++ Implementation
+ *
+ * Table-driven block code that transcodes compressed output into DNA which
+ * respects common synthesis constraints: bounded homopolymer runs and
+ * balanced GC content. Runs after compression as an optional final stage.
+ */
+
+#ifndef CONSTRAINED_CODING_H
+#define CONSTRAINED_CODING_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace ccc {
+
+/**
+ * Constrained block code mapping 15 data bits to one 8-base codeword
+ *
+ * Every codeword has an internal homopolymer run of at most 3, a leading run
+ * of 1 and a trailing run of at most 2, so any concatenation of codewords keeps
+ * runs <= 3. Each codeword carries 3 to 5 G/C bases, bounding the GC content of
+ * every aligned 8-base window to 37.5%-62.5%. The rate is 15/8 = 1.875 bits per
+ * base, close to the ~1.93 bits/base capacity of this constraint set.
+ *
+ * Encoding and decoding are single table lookups per codeword; the tables are
+ * built once per process and shared by all instances.
+ */
+class ConstrainedCodec {
+public:
+    static constexpr size_t kWordBases = 8;
+    static constexpr size_t kBitsPerWord = 15;
+    static constexpr size_t kMaxRunLength = 3;
+    static constexpr size_t kMinGcPerWord = 3;
+    static constexpr size_t kMaxGcPerWord = 5;
+
+    ConstrainedCodec();
+
+    /**
+     * Transcode arbitrary bytes into constrained DNA
+     *
+     * @param data Input bytes (typically serialized compressed output)
+     * @return DNA sequence whose length is a multiple of kWordBases
+     */
+    std::string encode(const std::vector<uint8_t>& data) const;
+
+    /**
+     * Transcode constrained DNA back into bytes
+     *
+     * @param dna_seq DNA sequence produced by encode()
+     * @param original_size Number of bytes passed to encode()
+     * @return Original bytes
+     * @throws std::invalid_argument if the sequence contains non-codewords
+     */
+    std::vector<uint8_t> decode(const std::string& dna_seq, size_t original_size) const;
+
+    /**
+     * Transcode DVNP/encapsulated codes into constrained DNA
+     * Codes are bit-packed at the minimal fixed width behind a small header,
+     * so the result is self-describing.
+     *
+     * @param codes Compressed codes from CircularChromosomeCompressor::compress()
+     * @return Constrained DNA sequence
+     */
+    std::string encode_codes(const std::vector<int>& codes) const;
+
+    /**
+     * Inverse of encode_codes()
+     *
+     * @param dna_seq DNA sequence produced by encode_codes()
+     * @return Compressed codes
+     * @throws std::invalid_argument on invalid codewords or a header whose code
+     *         width or count the sequence cannot hold
+     */
+    std::vector<int> decode_codes(const std::string& dna_seq) const;
+
+    /**
+     * Check a DNA sequence against the synthesis constraints of this code
+     *
+     * @param dna_seq DNA sequence
+     * @param max_run Maximum allowed homopolymer run
+     * @return True if no run exceeds max_run and every aligned codeword window
+     *         has between kMinGcPerWord and kMaxGcPerWord G/C bases
+     */
+    static bool satisfies_constraints(const std::string& dna_seq, size_t max_run = kMaxRunLength);
+
+    /**
+     * Longest homopolymer run in a DNA sequence
+     */
+    static size_t max_homopolymer_run(const std::string& dna_seq);
+
+    /**
+     * Data bits carried per base (kBitsPerWord / kWordBases)
+     */
+    static double bits_per_base() { return static_cast<double>(kBitsPerWord) / kWordBases; }
+
+private:
+    struct Tables;
+    const Tables& tables_;
+
+    static const Tables& shared_tables();
+};
+
+} // namespace ccc
+
+#endif // CONSTRAINED_CODING_H
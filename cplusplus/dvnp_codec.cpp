@@ -0,0 +1,917 @@
+/**
+ * Flat-table DVNP codec used by the block-parallel CCC pipeline
+ */
+
+#include "dvnp_codec.h"
+#include "ccc_trace.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CCC_HAVE_X86_KERNELS 1
+#endif
+
+namespace ccc {
+
+namespace {
+
+std::array<uint32_t, 256> make_symbol_lut() {
+    std::array<uint32_t, 256> lut{};
+    for (uint32_t byte = 0; byte < 256; ++byte) {
+        // Little-endian layout so memcpy yields symbols in stream order
+        lut[byte] = ((byte >> 6) & 3u) | (((byte >> 4) & 3u) << 8) |
+                    (((byte >> 2) & 3u) << 16) | ((byte & 3u) << 24);
+    }
+    return lut;
+}
+
+void bytes_to_symbols_scalar(const uint8_t* data, size_t size, uint8_t* symbols) {
+    static const std::array<uint32_t, 256> lut = make_symbol_lut();
+    for (size_t i = 0; i < size; ++i) {
+        uint32_t four = lut[data[i]];
+        symbols[4 * i + 0] = static_cast<uint8_t>(four);
+        symbols[4 * i + 1] = static_cast<uint8_t>(four >> 8);
+        symbols[4 * i + 2] = static_cast<uint8_t>(four >> 16);
+        symbols[4 * i + 3] = static_cast<uint8_t>(four >> 24);
+    }
+}
+
+#ifdef CCC_HAVE_X86_KERNELS
+__attribute__((target("ssse3")))
+void bytes_to_symbols_ssse3(const uint8_t* data, size_t size, uint8_t* symbols) {
+    // Each nibble holds two symbols: high pair = nibble >> 2, low pair = nibble & 3
+    const __m128i high_pair = _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+    const __m128i low_pair = _mm_setr_epi8(0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3);
+    const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble_mask);
+        __m128i lo = _mm_and_si128(bytes, nibble_mask);
+
+        __m128i s0 = _mm_shuffle_epi8(high_pair, hi);
+        __m128i s1 = _mm_shuffle_epi8(low_pair, hi);
+        __m128i s2 = _mm_shuffle_epi8(high_pair, lo);
+        __m128i s3 = _mm_shuffle_epi8(low_pair, lo);
+
+        __m128i s01_lo = _mm_unpacklo_epi8(s0, s1);
+        __m128i s01_hi = _mm_unpackhi_epi8(s0, s1);
+        __m128i s23_lo = _mm_unpacklo_epi8(s2, s3);
+        __m128i s23_hi = _mm_unpackhi_epi8(s2, s3);
+
+        __m128i* out = reinterpret_cast<__m128i*>(symbols + 4 * i);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(s01_lo, s23_lo));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(s01_lo, s23_lo));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(s01_hi, s23_hi));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(s01_hi, s23_hi));
+    }
+    bytes_to_symbols_scalar(data + i, size - i, symbols + 4 * i);
+}
+#endif
+
+/**
+ * Insert the phrases an encoder would create while coding the seed,
+ * stopping once the dictionary is full. Encoder and decoder both call this,
+ * so they agree on every code assigned during priming.
+ */
+template <typename AddEntry>
+uint32_t prime_dictionary(const uint8_t* seed, size_t seed_count, uint32_t max_dict_size,
+                          std::vector<uint32_t>& children, uint32_t no_child, AddEntry add_entry) {
+    uint32_t next_code = kDvnpBaseCodes;
+    if (seed_count == 0) {
+        return next_code;
+    }
+
+    uint32_t current = seed[0];
+    for (size_t i = 1; i < seed_count && next_code < max_dict_size; ++i) {
+        const uint32_t symbol = seed[i];
+        uint32_t& child = children[static_cast<size_t>(current) * 4 + symbol];
+        if (child != no_child) {
+            current = child;
+            continue;
+        }
+        child = next_code;
+        add_entry(next_code, current, symbol);
+        ++next_code;
+        current = symbol;
+    }
+    return next_code;
+}
+
+/**
+ * Dictionary entries a stream over symbols bases (seed included) can reach
+ * Every entry past the base codes is created by one code or one seed step, so
+ * tables sized to this never overflow, however large max_dict_size is.
+ */
+inline size_t table_codes(uint32_t max_dict_size, size_t symbols) {
+    return std::min<size_t>(max_dict_size, kDvnpBaseCodes + symbols);
+}
+
+} // namespace
+
+bool symbol_kernel_supported(SymbolKernel kernel) {
+    switch (kernel) {
+        case SymbolKernel::Auto:
+        case SymbolKernel::Scalar:
+            return true;
+        case SymbolKernel::SSSE3:
+#ifdef CCC_HAVE_X86_KERNELS
+            return __builtin_cpu_supports("ssse3");
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+const char* symbol_kernel_name(SymbolKernel kernel) {
+    switch (kernel) {
+        case SymbolKernel::Scalar: return "scalar";
+        case SymbolKernel::SSSE3: return "ssse3";
+        case SymbolKernel::Auto: break;
+    }
+    return "auto";
+}
+
+SymbolKernel parse_symbol_kernel(const std::string& name) {
+    if (name == "scalar") return SymbolKernel::Scalar;
+    if (name == "ssse3") return SymbolKernel::SSSE3;
+    return SymbolKernel::Auto;
+}
+
+void bytes_to_symbols(const uint8_t* data, size_t size, uint8_t* symbols, SymbolKernel kernel) {
+    if (kernel == SymbolKernel::Auto) {
+        kernel = symbol_kernel_supported(SymbolKernel::SSSE3) ? SymbolKernel::SSSE3 : SymbolKernel::Scalar;
+    }
+#ifdef CCC_HAVE_X86_KERNELS
+    if (kernel == SymbolKernel::SSSE3 && symbol_kernel_supported(SymbolKernel::SSSE3)) {
+        bytes_to_symbols_ssse3(data, size, symbols);
+        return;
+    }
+#endif
+    bytes_to_symbols_scalar(data, size, symbols);
+}
+
+DvnpEncoder::DvnpEncoder(uint32_t max_dict_size, bool multi_base)
+    : max_dict_size_(max_dict_size),
+      next_code_(kDvnpBaseCodes),
+      multi_base_(multi_base),
+      children_(kDvnpBaseCodes * 4, kNoChild),
+      pair_codes_(std::min(max_dict_size, kDvnpPairTableCodes)),
+      radix_end_(kNoChild) {
+    if (multi_base_) {
+        pairs_.assign(std::min(kDvnpBaseCodes, pair_codes_) * 16, kNoChild);
+        quads_.assign(kDvnpBaseCodes * 256, kNoChild);
+        depth_.assign(kDvnpBaseCodes, 1);
+        parent_.assign(kDvnpBaseCodes, 0);
+        symbol_.resize(kDvnpBaseCodes);
+        for (uint32_t code = 0; code < kDvnpBaseCodes; ++code) {
+            symbol_[code] = static_cast<uint8_t>(code);
+        }
+    }
+}
+
+void DvnpEncoder::reset() {
+    // Only codes below next_code_ can have children
+    std::fill(children_.begin(), children_.begin() + static_cast<size_t>(next_code_) * 4, kNoChild);
+    if (multi_base_) {
+        const size_t rows = std::min(next_code_, radix_end_);
+        std::fill(pairs_.begin(), pairs_.begin() + std::min(pairs_.size(), rows * 16), kNoChild);
+        std::fill(quads_.begin(), quads_.end(), kNoChild);
+        radix_end_ = kNoChild;
+    }
+    next_code_ = kDvnpBaseCodes;
+}
+
+void DvnpEncoder::prime(const uint8_t* seed, size_t seed_count) {
+    if (multi_base_) {
+        next_code_ = prime_dictionary(seed, seed_count, max_dict_size_, children_, kNoChild,
+                                      [this](uint32_t code, uint32_t parent, uint32_t symbol) {
+                                          add_transitions(code, parent, symbol);
+                                      });
+        return;
+    }
+    next_code_ = prime_dictionary(seed, seed_count, max_dict_size_, children_, kNoChild,
+                                  [](uint32_t, uint32_t, uint32_t) {});
+}
+
+void DvnpEncoder::add_transitions(uint32_t code, uint32_t parent, uint32_t symbol) {
+    if (code >= parent_.size()) {
+        // Rows are created with their code; nothing can point below a row before then
+        size_t grown = std::min<size_t>(max_dict_size_, std::max<size_t>(4096, parent_.size() * 2));
+        parent_.resize(grown);
+        symbol_.resize(grown);
+        depth_.resize(grown);
+        pairs_.resize(std::min<size_t>(grown, pair_codes_) * 16, kNoChild);
+    }
+    parent_[code] = parent;
+    symbol_[code] = static_cast<uint8_t>(symbol);
+    depth_[code] = static_cast<uint8_t>(std::min(255, depth_[parent] + 1));
+
+    // The new entry is the grandchild of its parent's parent along (parent's base, symbol)
+    if (parent >= kDvnpBaseCodes) {
+        const uint32_t grandparent = parent_[parent];
+        if (grandparent < pair_codes_) {
+            pairs_[static_cast<size_t>(grandparent) * 16 + (static_cast<uint32_t>(symbol_[parent]) << 2 | symbol)] = code;
+        }
+    }
+    // A depth-5 entry is four bases below a base code
+    if (depth_[code] == 5) {
+        uint32_t index = 0;
+        uint32_t node = code;
+        for (uint32_t k = 0; k < 4; ++k) {
+            index |= static_cast<uint32_t>(symbol_[node]) << (2 * k);
+            node = parent_[node];
+        }
+        quads_[static_cast<size_t>(node) * 256 + index] = code;
+    }
+}
+
+size_t DvnpEncoder::encode(const uint8_t* symbols, size_t count, std::vector<int>& out,
+                           const uint8_t* seed, size_t seed_count) {
+    reset();
+    if (count == 0) {
+        return 0;
+    }
+    // Grow the trie to what this stream can use, never to the full dictionary up front
+    const size_t slots = table_codes(max_dict_size_, seed_count + count) * 4;
+    if (children_.size() < slots) {
+        children_.resize(slots, kNoChild);
+    }
+    prime(seed, seed_count);
+    return multi_base_ ? encode_multi(symbols, count, out) : encode_single(symbols, count, out);
+}
+
+size_t DvnpEncoder::encode_single(const uint8_t* symbols, size_t count, std::vector<int>& out) {
+    size_t position = 1;
+    uint32_t current = symbols[0];
+    size_t reset_count = single_steps(symbols, count, position, current, out, false);
+    out.push_back(static_cast<int>(current));
+    return reset_count;
+}
+
+size_t DvnpEncoder::single_steps(const uint8_t* symbols, size_t count, size_t& position, uint32_t& current,
+                                 std::vector<int>& out, bool until_reset) {
+    size_t reset_count = 0;
+    uint32_t phrase = current;
+
+    for (size_t i = position; i < count; ++i) {
+        const uint32_t symbol = symbols[i];
+        const uint32_t child = children_[static_cast<size_t>(phrase) * 4 + symbol];
+        if (child != kNoChild) {
+            phrase = child;
+            continue;
+        }
+
+        out.push_back(static_cast<int>(phrase));
+        if (next_code_ < max_dict_size_) {
+            children_[static_cast<size_t>(phrase) * 4 + symbol] = next_code_++;
+            phrase = symbol;
+            continue;
+        }
+        out.push_back(static_cast<int>(reset_marker()));
+        ++reset_count;
+        CCC_TRACE_EVENT(dvnp_reset, i, out.size());
+        reset();
+        phrase = symbol;
+        if (until_reset) {
+            position = i + 1;
+            current = phrase;
+            return reset_count;
+        }
+    }
+
+    position = count;
+    current = phrase;
+    return reset_count;
+}
+
+size_t DvnpEncoder::encode_multi(const uint8_t* symbols, size_t count, std::vector<int>& out) {
+    size_t reset_count = 0;
+    uint32_t current = symbols[0];
+    size_t i = 1;
+    size_t generation_codes = 0;
+    size_t window_start = 0;
+
+    // Four bases below a phrase's first base in one lookup
+    auto enter_phrase = [&]() {
+        if (i + 4 <= count) {
+            const uint32_t index = static_cast<uint32_t>(symbols[i]) << 6 | static_cast<uint32_t>(symbols[i + 1]) << 4 |
+                                   static_cast<uint32_t>(symbols[i + 2]) << 2 | symbols[i + 3];
+            const uint32_t entry = quads_[static_cast<size_t>(current) * 256 + index];
+            if (entry != kNoChild) {
+                current = entry;
+                i += 4;
+            }
+        }
+    };
+    enter_phrase();
+
+    while (i < count) {
+        if (current < pair_codes_ && i + 2 <= count) {
+            const uint32_t entry =
+                pairs_[static_cast<size_t>(current) * 16 + (static_cast<uint32_t>(symbols[i]) << 2 | symbols[i + 1])];
+            if (entry != kNoChild) {
+                current = entry;
+                i += 2;
+                continue;
+            }
+        }
+
+        // Single step: the phrase ends within the next two bases, or current has no pair row
+        const uint32_t symbol = symbols[i];
+        const uint32_t child = children_[static_cast<size_t>(current) * 4 + symbol];
+        if (child != kNoChild) {
+            current = child;
+            ++i;
+            continue;
+        }
+
+        out.push_back(static_cast<int>(current));
+        bool drop_radix = false;
+        if (next_code_ < max_dict_size_) {
+            children_[static_cast<size_t>(current) * 4 + symbol] = next_code_;
+            add_transitions(next_code_++, current, symbol);
+            if (++generation_codes == kDvnpRadixProbeCodes) {
+                window_start = i;
+            } else if (generation_codes == 2 * kDvnpRadixProbeCodes) {
+                drop_radix = i - window_start < kDvnpRadixProbeCodes * kDvnpRadixMinPhrase;
+            }
+        } else {
+            out.push_back(static_cast<int>(reset_marker()));
+            ++reset_count;
+            CCC_TRACE_EVENT(dvnp_reset, i, out.size());
+            reset();
+            generation_codes = 0;
+        }
+        current = symbol;
+        ++i;
+
+        if (drop_radix) {
+            // Short phrases: single-step to the next reset, which clears the stale tables
+            radix_end_ = next_code_;
+            reset_count += single_steps(symbols, count, i, current, out, true);
+            generation_codes = 0;
+        }
+        enter_phrase();
+    }
+
+    out.push_back(static_cast<int>(current));
+    return reset_count;
+}
+
+DvnpDecoder::DvnpDecoder(uint32_t max_dict_size)
+    : max_dict_size_(max_dict_size),
+      next_code_(kDvnpBaseCodes),
+      prefix_(kDvnpBaseCodes),
+      length_(kDvnpBaseCodes),
+      last_(kDvnpBaseCodes),
+      first_(kDvnpBaseCodes) {
+    for (uint32_t code = 0; code < kDvnpBaseCodes; ++code) {
+        prefix_[code] = 0;
+        length_[code] = 1;
+        last_[code] = static_cast<uint8_t>(code);
+        first_[code] = static_cast<uint8_t>(code);
+    }
+}
+
+void DvnpDecoder::reset() {
+    next_code_ = kDvnpBaseCodes;
+}
+
+void DvnpDecoder::reserve(size_t symbols) {
+    const size_t entries = table_codes(max_dict_size_, symbols);
+    if (prefix_.size() < entries) {
+        prefix_.resize(entries);
+        length_.resize(entries);
+        last_.resize(entries);
+        first_.resize(entries);
+    }
+}
+
+void DvnpDecoder::emit(uint32_t code, uint8_t* packed_out, size_t position) {
+    // Walk the prefix chain backwards, filling the entry from its last base
+    size_t p = position + length_[code];
+    while (p > position) {
+        --p;
+        packed_out[p >> 2] |= static_cast<uint8_t>(last_[code] << (6 - 2 * (p & 3)));
+        code = prefix_[code];
+    }
+}
+
+void DvnpDecoder::prime(const uint8_t* seed, size_t seed_count) {
+    if (seed_count == 0) {
+        return;
+    }
+    seed_children_.assign(table_codes(max_dict_size_, seed_count) * 4, 0xFFFFFFFFu);
+    next_code_ = prime_dictionary(seed, seed_count, max_dict_size_, seed_children_, 0xFFFFFFFFu,
+                                  [this](uint32_t code, uint32_t prefix, uint32_t symbol) {
+        prefix_[code] = prefix;
+        length_[code] = length_[prefix] + 1;
+        last_[code] = static_cast<uint8_t>(symbol);
+        first_[code] = first_[prefix];
+    });
+}
+
+size_t DvnpDecoder::decode(const int* codes, size_t count, uint8_t* packed_out, size_t capacity_bases,
+                           const uint8_t* seed, size_t seed_count) {
+    reset();
+    if (count == 0) {
+        return 0;
+    }
+    // Each code adds at most one entry
+    reserve(seed_count + count);
+    prime(seed, seed_count);
+
+    const uint32_t reset_marker = max_dict_size_;
+    size_t position = 0;
+
+    auto write_entry = [&](uint32_t code) {
+        if (length_[code] > capacity_bases - position) {
+            throw std::invalid_argument("DVNP stream decodes past output capacity of " +
+                                        std::to_string(capacity_bases) + " bases");
+        }
+        emit(code, packed_out, position);
+        position += length_[code];
+    };
+
+    uint32_t prev = static_cast<uint32_t>(codes[0]);
+    if (prev == reset_marker) {
+        throw std::invalid_argument("First code cannot be a reset marker");
+    }
+    if (prev >= next_code_) {
+        throw std::invalid_argument("Invalid first code " + std::to_string(prev) + " in DVNP stream");
+    }
+    write_entry(prev);
+
+    for (size_t i = 1; i < count; ++i) {
+        uint32_t code = static_cast<uint32_t>(codes[i]);
+
+        if (code == reset_marker) {
+            // Skip consecutive markers; the next code starts a fresh phrase
+            CCC_TRACE_EVENT(dvnp_decode_reset, position, i);
+            reset();
+            while (i < count && static_cast<uint32_t>(codes[i]) == reset_marker) {
+                ++i;
+            }
+            if (i >= count) {
+                break;
+            }
+            code = static_cast<uint32_t>(codes[i]);
+            if (code >= next_code_) {
+                throw std::invalid_argument("Invalid code after reset: " + std::to_string(code));
+            }
+            write_entry(code);
+            prev = code;
+            continue;
+        }
+
+        if (code < next_code_) {
+            if (next_code_ < max_dict_size_) {
+                uint32_t added = next_code_++;
+                prefix_[added] = prev;
+                length_[added] = length_[prev] + 1;
+                last_[added] = first_[code];
+                first_[added] = first_[prev];
+            }
+        } else if (code == next_code_) {
+            // Special case: entry is prev followed by its own first base
+            uint32_t added = next_code_++;
+            prefix_[added] = prev;
+            length_[added] = length_[prev] + 1;
+            last_[added] = first_[prev];
+            first_[added] = first_[prev];
+        } else {
+            throw std::invalid_argument("Invalid code " + std::to_string(code) +
+                                        " in DVNP decompression (next_code: " +
+                                        std::to_string(next_code_) + ")");
+        }
+
+        write_entry(code);
+        prev = code;
+    }
+
+    return position;
+}
+
+size_t DvnpDecoder::decoded_bases(const int* codes, size_t count) {
+    reset();
+    reserve(count);
+    const uint32_t reset_marker = max_dict_size_;
+    size_t bases = 0;
+    bool fresh = true;                  // the next code starts a phrase without adding an entry
+    uint32_t prev = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t code = static_cast<uint32_t>(codes[i]);
+        if (code == reset_marker) {
+            if (i == 0) {
+                throw std::invalid_argument("First code cannot be a reset marker");
+            }
+            reset();
+            fresh = true;
+            continue;
+        }
+        if (code > next_code_ || (fresh && code == next_code_)) {
+            throw std::invalid_argument("Invalid code " + std::to_string(code) + " in DVNP stream (next_code: " +
+                                        std::to_string(next_code_) + ")");
+        }
+        if (!fresh && next_code_ < max_dict_size_) {
+            length_[next_code_++] = length_[prev] + 1;
+        }
+        bases += length_[code];
+        prev = code;
+        fresh = false;
+    }
+    return bases;
+}
+
+namespace {
+
+// Empty lane-trie slots hold this flag plus the slot's own symbol, so a
+// lookup yields the next current code with one mask whether it hits or not
+constexpr uint32_t kLaneEmpty = 0x80000000u;
+
+/**
+ * Mark trie slots [0, slots) empty
+ */
+inline void clear_lane_trie(uint32_t* children, size_t slots) {
+    for (size_t i = 0; i < slots; ++i) {
+        children[i] = kLaneEmpty | static_cast<uint32_t>(i & 3);
+    }
+}
+
+/**
+ * State of one lane of the interleaved encoder
+ */
+struct EncodeLane {
+    const uint8_t* symbols = nullptr;
+    size_t position = 0;
+    size_t end = 0;
+    uint32_t current = 0;
+    uint32_t next_code = kDvnpBaseCodes;
+    uint32_t* children = nullptr;
+    std::vector<int>* out = nullptr;
+    size_t written = 0;                 // codes stored in *out
+    size_t resets = 0;
+};
+
+/**
+ * Dictionary full: emit the reset marker and empty the trie (rare path)
+ * Takes and returns values so no lane state has its address taken.
+ *
+ * @return Codes written after the marker
+ */
+__attribute__((noinline)) size_t reset_lane(uint32_t* children, uint32_t next_code, int* out, size_t written,
+                                            uint32_t max_dict_size) {
+    out[written] = static_cast<int>(max_dict_size);
+    clear_lane_trie(children, static_cast<size_t>(next_code) * 4);
+    return written + 1;
+}
+
+/**
+ * Run `steps` symbols of every lane, producing the same codes as DvnpEncoder::encode()
+ * Lane state lives in local arrays so it stays in registers across the
+ * unrolled lane loop. The hit/miss outcome of a lookup is data dependent and
+ * mispredicts often, which would flush the other lanes' in-flight lookups,
+ * so the common path is branch-free: the current code is always stored and
+ * only counted on a miss, and the slot is always rewritten. With kLaneEmpty
+ * slots the dependent chain per symbol is just load + mask + address.
+ * Only the rare dictionary-full case branches.
+ */
+template <size_t Lanes>
+void encode_steps(EncodeLane* lanes, size_t steps, uint32_t max_dict_size) {
+    const uint8_t* __restrict symbols[Lanes];
+    uint32_t* __restrict children[Lanes];
+    int* __restrict out[Lanes];
+    uint32_t current[Lanes];
+    uint32_t next_code[Lanes];
+    size_t written[Lanes];
+    for (size_t l = 0; l < Lanes; ++l) {
+        symbols[l] = lanes[l].symbols + lanes[l].position;
+        children[l] = lanes[l].children;
+        out[l] = lanes[l].out->data();
+        current[l] = lanes[l].current;
+        next_code[l] = lanes[l].next_code;
+        written[l] = lanes[l].written;
+    }
+
+    for (size_t s = 0; s < steps; ++s) {
+        for (size_t l = 0; l < Lanes; ++l) {
+            const uint32_t symbol = symbols[l][s];
+            uint32_t* slot = children[l] + static_cast<size_t>(current[l]) * 4 + symbol;
+            const uint32_t entry = *slot;
+            const uint32_t miss = entry >> 31;
+            out[l][written[l]] = static_cast<int>(current[l]);
+            written[l] += miss;
+            if (__builtin_expect(miss & (next_code[l] >= max_dict_size), 0)) {
+                written[l] = reset_lane(children[l], next_code[l], out[l], written[l], max_dict_size);
+                CCC_TRACE_EVENT(dvnp_reset, lanes[l].position + s, written[l]);
+                next_code[l] = kDvnpBaseCodes;
+                ++lanes[l].resets;
+                current[l] = symbol;
+                continue;
+            }
+            const uint32_t mask = 0u - miss;
+            *slot = entry ^ ((entry ^ next_code[l]) & mask);
+            next_code[l] += miss;
+            current[l] = entry & ~kLaneEmpty;
+        }
+    }
+
+    for (size_t l = 0; l < Lanes; ++l) {
+        lanes[l].position += steps;
+        lanes[l].current = current[l];
+        lanes[l].next_code = next_code[l];
+        lanes[l].written = written[l];
+    }
+}
+
+/**
+ * Make room for `steps` more symbols (at most two codes each) in every lane
+ */
+inline void reserve_lane_output(EncodeLane* lanes, size_t count, size_t steps) {
+    for (size_t l = 0; l < count; ++l) {
+        if (lanes[l].out->size() < lanes[l].written + 2 * steps) {
+            lanes[l].out->resize(std::max(lanes[l].out->size() * 2, lanes[l].written + 2 * steps));
+        }
+    }
+}
+
+/**
+ * Advance all lanes together while every lane has input, then finish the
+ * (at most a few symbols long) tails one lane at a time
+ */
+template <size_t Lanes>
+void encode_interleaved(EncodeLane* lanes, uint32_t max_dict_size) {
+    constexpr size_t kChunkSteps = 16384;
+    size_t steps = lanes[0].end - lanes[0].position;
+    for (size_t l = 1; l < Lanes; ++l) {
+        steps = std::min(steps, lanes[l].end - lanes[l].position);
+    }
+    while (steps > 0) {
+        size_t chunk = std::min(steps, kChunkSteps);
+        reserve_lane_output(lanes, Lanes, chunk);
+        encode_steps<Lanes>(lanes, chunk, max_dict_size);
+        steps -= chunk;
+    }
+    for (size_t l = 0; l < Lanes; ++l) {
+        size_t tail = lanes[l].end - lanes[l].position;
+        reserve_lane_output(lanes + l, 1, tail);
+        encode_steps<1>(lanes + l, tail, max_dict_size);
+    }
+}
+
+/**
+ * State of one lane of the interleaved decoder
+ */
+struct DecodeLane {
+    const int* codes = nullptr;
+    size_t index = 0;
+    size_t count = 0;
+    uint8_t* packed_out = nullptr;      // block output; positions are block-relative
+    size_t position = 0;                // next base to write
+    size_t end = 0;                     // one past the lane's last base
+    uint32_t prev = 0;
+    uint32_t next_code = kDvnpBaseCodes;
+    bool fresh = true;                  // next code starts a phrase (stream start or after a reset)
+    uint32_t* prefix = nullptr;
+    uint32_t* length = nullptr;
+    uint8_t* last = nullptr;
+    uint8_t* first = nullptr;
+};
+
+inline void write_lane_entry(DecodeLane& lane, uint32_t code) {
+    if (lane.length[code] > lane.end - lane.position) {
+        throw std::invalid_argument("DVNP lane decodes past its " + std::to_string(lane.end) + " base boundary");
+    }
+    const size_t start = lane.position;
+    size_t p = start + lane.length[code];
+    lane.position = p;
+    while (p > start) {
+        --p;
+        lane.packed_out[p >> 2] |= static_cast<uint8_t>(lane.last[code] << (6 - 2 * (p & 3)));
+        code = lane.prefix[code];
+    }
+}
+
+/**
+ * Consume one code; the same transitions as DvnpDecoder::decode()
+ */
+inline void decode_lane_step(DecodeLane& lane, uint32_t max_dict_size) {
+    const uint32_t code = static_cast<uint32_t>(lane.codes[lane.index++]);
+    if (code == max_dict_size) {
+        CCC_TRACE_EVENT(dvnp_decode_reset, lane.position, lane.index);
+        lane.next_code = kDvnpBaseCodes;
+        lane.fresh = true;
+        return;
+    }
+    if (lane.fresh) {
+        if (code >= lane.next_code) {
+            throw std::invalid_argument("Invalid code after reset: " + std::to_string(code));
+        }
+        lane.fresh = false;
+    } else if (code < lane.next_code) {
+        if (lane.next_code < max_dict_size) {
+            uint32_t added = lane.next_code++;
+            lane.prefix[added] = lane.prev;
+            lane.length[added] = lane.length[lane.prev] + 1;
+            lane.last[added] = lane.first[code];
+            lane.first[added] = lane.first[lane.prev];
+        }
+    } else if (code == lane.next_code) {
+        uint32_t added = lane.next_code++;
+        lane.prefix[added] = lane.prev;
+        lane.length[added] = lane.length[lane.prev] + 1;
+        lane.last[added] = lane.first[lane.prev];
+        lane.first[added] = lane.first[lane.prev];
+    } else {
+        throw std::invalid_argument("Invalid code " + std::to_string(code) +
+                                    " in DVNP decompression (next_code: " + std::to_string(lane.next_code) + ")");
+    }
+    write_lane_entry(lane, code);
+    lane.prev = code;
+}
+
+template <size_t Lanes>
+void decode_interleaved(DecodeLane* lanes, uint32_t max_dict_size) {
+    size_t steps = lanes[0].count - lanes[0].index;
+    for (size_t l = 1; l < Lanes; ++l) {
+        steps = std::min(steps, lanes[l].count - lanes[l].index);
+    }
+    for (size_t s = 0; s < steps; ++s) {
+        for (size_t l = 0; l < Lanes; ++l) {
+            decode_lane_step(lanes[l], max_dict_size);
+        }
+    }
+    for (size_t l = 0; l < Lanes; ++l) {
+        while (lanes[l].index < lanes[l].count) {
+            decode_lane_step(lanes[l], max_dict_size);
+        }
+    }
+}
+
+/**
+ * Run an interleaved loop with the lane count fixed at compile time, so the
+ * per-step lane loop fully unrolls
+ */
+template <typename Lane, template <size_t> class Loop>
+void dispatch_lanes(size_t lanes, Lane* state, uint32_t max_dict_size) {
+    switch (lanes) {
+        case 1: Loop<1>::run(state, max_dict_size); break;
+        case 2: Loop<2>::run(state, max_dict_size); break;
+        case 3: Loop<3>::run(state, max_dict_size); break;
+        case 4: Loop<4>::run(state, max_dict_size); break;
+        case 5: Loop<5>::run(state, max_dict_size); break;
+        case 6: Loop<6>::run(state, max_dict_size); break;
+        case 7: Loop<7>::run(state, max_dict_size); break;
+        default: Loop<8>::run(state, max_dict_size); break;
+    }
+}
+
+template <size_t Lanes>
+struct EncodeLoop {
+    static void run(EncodeLane* lanes, uint32_t max_dict_size) { encode_interleaved<Lanes>(lanes, max_dict_size); }
+};
+
+template <size_t Lanes>
+struct DecodeLoop {
+    static void run(DecodeLane* lanes, uint32_t max_dict_size) { decode_interleaved<Lanes>(lanes, max_dict_size); }
+};
+
+void check_lane_count(size_t lanes) {
+    if (lanes == 0 || lanes > kDvnpMaxLanes) {
+        throw std::invalid_argument("DVNP lane count must be between 1 and " + std::to_string(kDvnpMaxLanes) +
+                                    ", got " + std::to_string(lanes));
+    }
+}
+
+} // namespace
+
+DvnpLaneEncoder::DvnpLaneEncoder(size_t lanes, uint32_t max_dict_size)
+    : lanes_(lanes), max_dict_size_(max_dict_size) {
+    check_lane_count(lanes);
+    lane_codes_.resize(lanes_);
+}
+
+size_t DvnpLaneEncoder::encode(const uint8_t* symbols, size_t count, std::vector<int>& out,
+                               std::vector<size_t>& lane_counts) {
+    const size_t block_bytes = count / 4;
+    size_t longest = 0;
+    for (size_t l = 0; l < lanes_; ++l) {
+        longest = std::max(longest, (dvnp_lane_offset(block_bytes, lanes_, l + 1) -
+                                     dvnp_lane_offset(block_bytes, lanes_, l)) * 4);
+    }
+    const size_t table_size = table_codes(max_dict_size_, longest) * 4;
+    if (table_size > table_size_) {
+        // The tries are empty between blocks, so a wider stride only needs the new slots cleared
+        const size_t old_size = children_.size();
+        children_.resize(lanes_ * table_size);
+        clear_lane_trie(children_.data() + old_size, children_.size() - old_size);
+        table_size_ = table_size;
+    }
+
+    EncodeLane lanes[kDvnpMaxLanes];
+    size_t active = 0;
+    for (size_t l = 0; l < lanes_; ++l) {
+        size_t begin = dvnp_lane_offset(block_bytes, lanes_, l) * 4;
+        size_t end = dvnp_lane_offset(block_bytes, lanes_, l + 1) * 4;
+        lane_codes_[l].clear();
+        if (begin == end) {
+            continue;
+        }
+        EncodeLane& lane = lanes[active++];
+        lane.symbols = symbols + begin;
+        lane.position = 1;
+        lane.end = end - begin;
+        lane.current = symbols[begin];
+        lane.children = children_.data() + l * table_size_;
+        lane.out = &lane_codes_[l];
+    }
+    if (active > 0) {
+        dispatch_lanes<EncodeLane, EncodeLoop>(active, lanes, max_dict_size_);
+    }
+
+    size_t resets = 0;
+    for (size_t l = 0; l < active; ++l) {
+        lanes[l].out->resize(lanes[l].written);
+        lanes[l].out->push_back(static_cast<int>(lanes[l].current));
+        resets += lanes[l].resets;
+        // Leave the trie empty for the next block; only used codes have children
+        clear_lane_trie(lanes[l].children, static_cast<size_t>(lanes[l].next_code) * 4);
+    }
+    lane_counts.resize(lanes_);
+    for (size_t l = 0; l < lanes_; ++l) {
+        lane_counts[l] = lane_codes_[l].size();
+        out.insert(out.end(), lane_codes_[l].begin(), lane_codes_[l].end());
+    }
+    return resets;
+}
+
+DvnpLaneDecoder::DvnpLaneDecoder(size_t lanes, uint32_t max_dict_size)
+    : lanes_(lanes), max_dict_size_(max_dict_size) {
+    check_lane_count(lanes);
+}
+
+void DvnpLaneDecoder::decode(const int* codes, const size_t* lane_counts, uint8_t* packed_out, size_t block_bytes) {
+    // Each code adds at most one entry, so the longest lane stream bounds every table
+    const size_t entries = table_codes(max_dict_size_, *std::max_element(lane_counts, lane_counts + lanes_));
+    if (entries > table_codes_) {
+        table_codes_ = entries;
+        prefix_.assign(lanes_ * table_codes_, 0);
+        length_.assign(lanes_ * table_codes_, 0);
+        last_.assign(lanes_ * table_codes_, 0);
+        first_.assign(lanes_ * table_codes_, 0);
+        for (size_t l = 0; l < lanes_; ++l) {
+            for (uint32_t code = 0; code < kDvnpBaseCodes; ++code) {
+                size_t at = l * table_codes_ + code;
+                length_[at] = 1;
+                last_[at] = first_[at] = static_cast<uint8_t>(code);
+            }
+        }
+    }
+
+    DecodeLane lanes[kDvnpMaxLanes];
+    size_t active = 0;
+    size_t code_offset = 0;
+    for (size_t l = 0; l < lanes_; ++l) {
+        size_t begin = dvnp_lane_offset(block_bytes, lanes_, l) * 4;
+        size_t end = dvnp_lane_offset(block_bytes, lanes_, l + 1) * 4;
+        size_t count = lane_counts[l];
+        if (count == 0 || begin == end) {
+            if (count != 0 || begin != end) {
+                throw std::invalid_argument("DVNP lane " + std::to_string(l) + " has " + std::to_string(count) +
+                                            " codes for " + std::to_string(end - begin) + " bases");
+            }
+            continue;
+        }
+        if (static_cast<uint32_t>(codes[code_offset]) == max_dict_size_) {
+            throw std::invalid_argument("First code cannot be a reset marker");
+        }
+        DecodeLane& lane = lanes[active++];
+        lane.codes = codes + code_offset;
+        lane.count = count;
+        lane.packed_out = packed_out;
+        lane.position = begin;
+        lane.end = end;
+        lane.prefix = prefix_.data() + l * table_codes_;
+        lane.length = length_.data() + l * table_codes_;
+        lane.last = last_.data() + l * table_codes_;
+        lane.first = first_.data() + l * table_codes_;
+        code_offset += count;
+    }
+    dispatch_lanes<DecodeLane, DecodeLoop>(active, lanes, max_dict_size_);
+
+    for (size_t l = 0; l < active; ++l) {
+        if (lanes[l].position != lanes[l].end) {
+            throw std::invalid_argument("DVNP lane decoded " + std::to_string(lanes[l].position) +
+                                        " bases, expected " + std::to_string(lanes[l].end));
+        }
+    }
+}
+
+} // namespace ccc
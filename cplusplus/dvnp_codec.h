@@ -0,0 +1,276 @@
+/**
+ * Flat-table DVNP codec used by the block-parallel CCC pipeline
+ *
+ * Produces exactly the same code stream as
+ * CircularChromosomeCompressor::dvnp_compress(), but works on 2-bit base
+ * symbols with array-backed dictionaries instead of string maps, and decodes
+ * straight into packed bytes so block outputs can be written in place.
+ */
+
+#ifndef CCC_DVNP_CODEC_H
+#define CCC_DVNP_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ccc {
+
+// Allowed codes are 0 .. kDvnpMaxDictSize-1; the reset marker sits just outside
+constexpr uint32_t kDvnpMaxDictSize = 65536u;
+// Largest configurable dictionary: codes travel as int, and both the reset
+// marker (max_dict_size) and the trans-splicing marker one above it must fit
+constexpr uint32_t kDvnpDictSizeLimit = 0x7FFFFFFEu;
+constexpr uint32_t kDvnpBaseCodes = 4u;
+
+// Independently coded lanes per block: 1 codes the block as a single stream
+constexpr size_t kDvnpMaxLanes = 8;
+
+/**
+ * Byte offset at which a lane starts within a block; lanes split the block
+ * into near-equal contiguous byte ranges
+ */
+inline size_t dvnp_lane_offset(size_t block_bytes, size_t lanes, size_t lane) {
+    return block_bytes * lane / lanes;
+}
+
+/**
+ * Implementations of the byte -> base symbol expansion kernel
+ */
+enum class SymbolKernel {
+    Auto = 0,    // best kernel supported by the running CPU
+    Scalar = 1,  // 256-entry lookup table
+    SSSE3 = 2    // nibble shuffles, 16 bytes per iteration
+};
+
+/**
+ * Expand bytes into 2-bit base symbols (A=0, C=1, G=2, T=3), four per byte,
+ * most significant bit pair first - the same order as binary_to_dna()
+ *
+ * @param data Input bytes
+ * @param size Number of input bytes
+ * @param symbols Output buffer of at least size * 4 symbols
+ * @param kernel Kernel to use; unsupported kernels fall back to Scalar
+ */
+void bytes_to_symbols(const uint8_t* data, size_t size, uint8_t* symbols,
+                      SymbolKernel kernel = SymbolKernel::Auto);
+
+/**
+ * Whether a kernel can run on this CPU (Auto and Scalar always can)
+ */
+bool symbol_kernel_supported(SymbolKernel kernel);
+
+/**
+ * Kernel name used in logs and machine profiles ("auto", "scalar", "ssse3")
+ */
+const char* symbol_kernel_name(SymbolKernel kernel);
+
+/**
+ * Parse a kernel name produced by symbol_kernel_name(); unknown names map to Auto
+ */
+SymbolKernel parse_symbol_kernel(const std::string& name);
+
+/**
+ * Trie nodes with a radix-16 pair table: codes below this get one, which
+ * bounds the table at 16 MB for very large dictionaries
+ */
+constexpr uint32_t kDvnpPairTableCodes = 1u << 18;
+
+/**
+ * Multi-base stepping probes each dictionary generation over its second
+ * window of this many codes (the first is dictionary warm-up) and keeps the
+ * radix tables only if those phrases average at least kDvnpRadixMinPhrase
+ * bases; otherwise the rest of the generation is single-stepped
+ */
+constexpr size_t kDvnpRadixProbeCodes = 256;
+constexpr size_t kDvnpRadixMinPhrase = 12;
+
+/**
+ * LZW encoder over base symbols with an array trie
+ * Besides the one-base child table, the trie keeps precomputed multi-base
+ * transitions: a radix-16 table per node (the grandchild reached by the next
+ * two bases) and a radix-256 table under each base code (the depth-5 entry
+ * reached by the four bases after a phrase start). The greedy parse takes
+ * four or two bases per lookup while such a path exists and falls back to
+ * single steps near phrase ends, so the codes are identical to single
+ * stepping with half to a quarter of the dependent loads. On high-entropy
+ * input phrases are too short for that to repay the table upkeep, so a
+ * dictionary generation whose probe finds short phrases drops the tables
+ * until the next reset. Off by default: on random and genome-like input it
+ * measured 0.91-1.01x single stepping (about 0.9x at 4K dictionaries), and
+ * the pair tables take up to 16 MB per encoder; it pays on long-phrase,
+ * highly repetitive input.
+ */
+class DvnpEncoder {
+public:
+    /**
+     * @param max_dict_size Dictionary capacity
+     * @param multi_base Use the multi-base transition tables (false: one lookup per base)
+     */
+    explicit DvnpEncoder(uint32_t max_dict_size = kDvnpMaxDictSize, bool multi_base = false);
+
+    /**
+     * Encode a symbol buffer from an empty or warm-started dictionary
+     *
+     * @param symbols Base symbols (0-3)
+     * @param count Number of symbols
+     * @param out Codes are appended here, with reset markers on dictionary exhaustion
+     * @param seed Symbols preceding the buffer whose phrases pre-populate the
+     *             dictionary (nullptr for an empty dictionary); resets return to empty
+     * @param seed_count Number of seed symbols
+     * @return Number of dictionary resets
+     */
+    size_t encode(const uint8_t* symbols, size_t count, std::vector<int>& out,
+                  const uint8_t* seed = nullptr, size_t seed_count = 0);
+
+    uint32_t reset_marker() const { return max_dict_size_; }
+    bool multi_base() const { return multi_base_; }
+
+private:
+    static constexpr uint32_t kNoChild = 0xFFFFFFFFu;
+
+    void reset();
+    void prime(const uint8_t* seed, size_t seed_count);
+    size_t encode_single(const uint8_t* symbols, size_t count, std::vector<int>& out);
+    size_t single_steps(const uint8_t* symbols, size_t count, size_t& position, uint32_t& current,
+                        std::vector<int>& out, bool until_reset);
+    size_t encode_multi(const uint8_t* symbols, size_t count, std::vector<int>& out);
+    void add_transitions(uint32_t code, uint32_t parent, uint32_t symbol);
+
+    uint32_t max_dict_size_;
+    uint32_t next_code_;
+    bool multi_base_;
+    std::vector<uint32_t> children_;  // children_[code * 4 + symbol] -> code, grown per stream up to max_dict_size
+    // Multi-base tables, grown with the dictionary
+    uint32_t pair_codes_;             // codes with a pair row: min(max_dict_size, kDvnpPairTableCodes)
+    uint32_t radix_end_;              // tables hold no entries at or above this code (dropped generation)
+    std::vector<uint32_t> pairs_;     // pairs_[code * 16 + (a << 2 | b)] -> grandchild via a, b
+    std::vector<uint32_t> quads_;     // quads_[base * 256 + a b c d] -> depth-5 entry via a, b, c, d
+    std::vector<uint32_t> parent_;    // entry without its last base
+    std::vector<uint8_t> symbol_;     // last base of the entry
+    std::vector<uint8_t> depth_;      // entry length in bases, saturating at 255
+};
+
+/**
+ * LZW decoder writing 2-bit bases directly into zero-initialised packed bytes
+ */
+class DvnpDecoder {
+public:
+    explicit DvnpDecoder(uint32_t max_dict_size = kDvnpMaxDictSize);
+
+    /**
+     * Decode a code stream from an empty or warm-started dictionary
+     *
+     * @param codes Code stream produced by DvnpEncoder or dvnp_compress()
+     * @param count Number of codes
+     * @param packed_out Zero-initialised output, four bases per byte
+     * @param capacity_bases Maximum number of bases that fit in packed_out
+     * @param seed The seed symbols the stream was encoded with (nullptr if none)
+     * @param seed_count Number of seed symbols
+     * @return Number of bases written
+     * @throws std::invalid_argument on malformed streams or output overflow
+     */
+    size_t decode(const int* codes, size_t count, uint8_t* packed_out, size_t capacity_bases,
+                  const uint8_t* seed = nullptr, size_t seed_count = 0);
+
+    /**
+     * Number of bases an unseeded code stream decodes to, tracking entry lengths only
+     *
+     * @param codes Code stream produced by DvnpEncoder or dvnp_compress()
+     * @param count Number of codes
+     * @return Number of bases decode() would write
+     * @throws std::invalid_argument on malformed streams
+     */
+    size_t decoded_bases(const int* codes, size_t count);
+
+private:
+    void reset();
+    void reserve(size_t symbols);
+    void prime(const uint8_t* seed, size_t seed_count);
+    void emit(uint32_t code, uint8_t* packed_out, size_t position);
+
+    uint32_t max_dict_size_;
+    uint32_t next_code_;
+    // Entry tables, grown per stream up to max_dict_size
+    std::vector<uint32_t> prefix_;   // code of the entry without its last base
+    std::vector<uint32_t> length_;   // entry length in bases
+    std::vector<uint8_t> last_;      // last base of the entry
+    std::vector<uint8_t> first_;     // first base of the entry
+    std::vector<uint32_t> seed_children_;  // trie used only while priming
+};
+
+/**
+ * Multi-lane DVNP encoder
+ * A block is split into 2-8 contiguous lanes, each an ordinary DVNP stream
+ * with its own dictionary, and all lanes advance one symbol per step of a
+ * single interleaved loop. The lanes' dictionary lookups are independent, so
+ * the CPU overlaps their memory latency instead of waiting on one chain.
+ * Each lane's codes are exactly what DvnpEncoder produces for that lane alone.
+ */
+class DvnpLaneEncoder {
+public:
+    /**
+     * @param lanes Lane count, 1 to kDvnpMaxLanes
+     * @param max_dict_size Dictionary capacity of every lane
+     * @throws std::invalid_argument if the lane count is out of range
+     */
+    explicit DvnpLaneEncoder(size_t lanes, uint32_t max_dict_size = kDvnpMaxDictSize);
+
+    /**
+     * Encode the symbols of a whole block
+     *
+     * @param symbols Base symbols (0-3), four per block byte
+     * @param count Number of symbols (a multiple of 4)
+     * @param out Lane code streams are appended here one after another
+     * @param lane_counts Receives the number of codes of each lane
+     * @return Number of dictionary resets across all lanes
+     */
+    size_t encode(const uint8_t* symbols, size_t count, std::vector<int>& out, std::vector<size_t>& lane_counts);
+
+    size_t lanes() const { return lanes_; }
+
+private:
+    size_t lanes_;
+    uint32_t max_dict_size_;
+    size_t table_size_ = 0;           // trie slots per lane, grown with the longest lane
+    std::vector<uint32_t> children_;  // lanes_ tries of table_size_ entries
+    std::vector<std::vector<int>> lane_codes_;
+};
+
+/**
+ * Multi-lane DVNP decoder, interleaving the lanes of a DvnpLaneEncoder block
+ */
+class DvnpLaneDecoder {
+public:
+    /**
+     * @throws std::invalid_argument if the lane count is out of range
+     */
+    explicit DvnpLaneDecoder(size_t lanes, uint32_t max_dict_size = kDvnpMaxDictSize);
+
+    /**
+     * Decode a block into zero-initialised packed bytes
+     *
+     * @param codes Lane code streams, one after another
+     * @param lane_counts Number of codes of each lane (lanes() entries)
+     * @param packed_out Zero-initialised output of block_bytes bytes
+     * @param block_bytes Block size; every lane must decode to exactly its byte range
+     * @throws std::invalid_argument on malformed streams or lane size mismatches
+     */
+    void decode(const int* codes, const size_t* lane_counts, uint8_t* packed_out, size_t block_bytes);
+
+    size_t lanes() const { return lanes_; }
+
+private:
+    size_t lanes_;
+    uint32_t max_dict_size_;
+    size_t table_codes_ = 0;          // entries per lane table, grown with the longest lane stream
+    std::vector<uint32_t> prefix_;    // lanes_ tables of table_codes_ entries each
+    std::vector<uint32_t> length_;
+    std::vector<uint8_t> last_;
+    std::vector<uint8_t> first_;
+};
+
+} // namespace ccc
+
+#endif // CCC_DVNP_CODEC_H
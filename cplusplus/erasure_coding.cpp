@@ -0,0 +1,714 @@
+/**
+ * Reed-Solomon erasure coding over GF(2^8)
+ */
+
+#include "erasure_coding.h"
+#include "fast_hash.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CCC_HAVE_X86_KERNELS 1
+#endif
+
+namespace ccc {
+
+namespace {
+
+constexpr char kShardMagic[4] = {'C', 'C', 'C', 'E'};
+constexpr uint8_t kShardVersion = 1;
+
+// Columns coded per pass: one source stripe plus every output stripe stays in L1
+constexpr size_t kStripeBytes = 4096;
+
+struct GfTables {
+    std::array<uint8_t, 512> exp{};   // doubled so exp[log a + log b] needs no modulo
+    std::array<uint8_t, 256> log{};
+
+    GfTables() {
+        unsigned x = 1;
+        for (size_t i = 0; i < 255; ++i) {
+            exp[i] = static_cast<uint8_t>(x);
+            log[x] = static_cast<uint8_t>(i);
+            x <<= 1;
+            if (x & 0x100) {
+                x ^= 0x11D;
+            }
+        }
+        for (size_t i = 255; i < exp.size(); ++i) {
+            exp[i] = exp[i - 255];
+        }
+    }
+};
+
+const GfTables& gf_tables() {
+    static const GfTables tables;
+    return tables;
+}
+
+/**
+ * Products of one coefficient with every low nibble and every high nibble;
+ * coeff * x = low[x & 15] ^ high[x >> 4]
+ */
+struct alignas(16) SplitTable {
+    uint8_t low[16];
+    uint8_t high[16];
+};
+
+SplitTable make_split_table(uint8_t coeff) {
+    SplitTable table;
+    for (unsigned i = 0; i < 16; ++i) {
+        table.low[i] = gf_mul(coeff, static_cast<uint8_t>(i));
+        table.high[i] = gf_mul(coeff, static_cast<uint8_t>(i << 4));
+    }
+    return table;
+}
+
+/**
+ * outputs[r][offset + i] = (or ^=) tables[r] * src[i] for every row r
+ * The SIMD kernels split each source vector into nibbles once and reuse it
+ * for all rows, so parity rows cost two shuffles and an XOR each.
+ */
+template <bool Accumulate>
+void mul_rows_scalar(const uint8_t* src, uint8_t* const* outputs, size_t offset, size_t size,
+                     const SplitTable* tables, size_t rows) {
+    for (size_t r = 0; r < rows; ++r) {
+        const SplitTable& table = tables[r];
+        uint8_t* dst = outputs[r] + offset;
+        if (size < 256) {
+            // SIMD tails: too short to amortize a full product row
+            for (size_t i = 0; i < size; ++i) {
+                uint8_t product = table.low[src[i] & 15] ^ table.high[src[i] >> 4];
+                dst[i] = Accumulate ? dst[i] ^ product : product;
+            }
+            continue;
+        }
+        std::array<uint8_t, 256> row;
+        for (unsigned x = 0; x < 256; ++x) {
+            row[x] = table.low[x & 15] ^ table.high[x >> 4];
+        }
+        for (size_t i = 0; i < size; ++i) {
+            dst[i] = Accumulate ? dst[i] ^ row[src[i]] : row[src[i]];
+        }
+    }
+}
+
+#ifdef CCC_HAVE_X86_KERNELS
+template <bool Accumulate>
+__attribute__((target("ssse3")))
+void mul_rows_ssse3(const uint8_t* src, uint8_t* const* outputs, size_t offset, size_t size,
+                    const SplitTable* tables, size_t rows) {
+    const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i lo = _mm_and_si128(x, nibble_mask);
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), nibble_mask);
+        for (size_t r = 0; r < rows; ++r) {
+            __m128i low_table = _mm_load_si128(reinterpret_cast<const __m128i*>(tables[r].low));
+            __m128i high_table = _mm_load_si128(reinterpret_cast<const __m128i*>(tables[r].high));
+            __m128i product = _mm_xor_si128(_mm_shuffle_epi8(low_table, lo), _mm_shuffle_epi8(high_table, hi));
+            __m128i* dst = reinterpret_cast<__m128i*>(outputs[r] + offset + i);
+            if (Accumulate) {
+                product = _mm_xor_si128(product, _mm_loadu_si128(dst));
+            }
+            _mm_storeu_si128(dst, product);
+        }
+    }
+    mul_rows_scalar<Accumulate>(src + i, outputs, offset + i, size - i, tables, rows);
+}
+
+template <bool Accumulate>
+__attribute__((target("avx2")))
+void mul_rows_avx2(const uint8_t* src, uint8_t* const* outputs, size_t offset, size_t size,
+                   const SplitTable* tables, size_t rows) {
+    const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i lo = _mm256_and_si256(x, nibble_mask);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble_mask);
+        for (size_t r = 0; r < rows; ++r) {
+            // vpshufb looks up within each 128-bit lane, so both lanes carry the table
+            __m256i low_table = _mm256_broadcastsi128_si256(
+                _mm_load_si128(reinterpret_cast<const __m128i*>(tables[r].low)));
+            __m256i high_table = _mm256_broadcastsi128_si256(
+                _mm_load_si128(reinterpret_cast<const __m128i*>(tables[r].high)));
+            __m256i product = _mm256_xor_si256(_mm256_shuffle_epi8(low_table, lo),
+                                               _mm256_shuffle_epi8(high_table, hi));
+            __m256i* dst = reinterpret_cast<__m256i*>(outputs[r] + offset + i);
+            if (Accumulate) {
+                product = _mm256_xor_si256(product, _mm256_loadu_si256(dst));
+            }
+            _mm256_storeu_si256(dst, product);
+        }
+    }
+    mul_rows_scalar<Accumulate>(src + i, outputs, offset + i, size - i, tables, rows);
+}
+#endif
+
+/**
+ * Dispatch to a resolved kernel
+ */
+void mul_rows(GfKernel kernel, bool accumulate, const uint8_t* src, uint8_t* const* outputs, size_t offset,
+              size_t size, const SplitTable* tables, size_t rows) {
+    switch (kernel) {
+#ifdef CCC_HAVE_X86_KERNELS
+        case GfKernel::AVX2:
+            accumulate ? mul_rows_avx2<true>(src, outputs, offset, size, tables, rows)
+                       : mul_rows_avx2<false>(src, outputs, offset, size, tables, rows);
+            return;
+        case GfKernel::SSSE3:
+            accumulate ? mul_rows_ssse3<true>(src, outputs, offset, size, tables, rows)
+                       : mul_rows_ssse3<false>(src, outputs, offset, size, tables, rows);
+            return;
+#endif
+        default:
+            accumulate ? mul_rows_scalar<true>(src, outputs, offset, size, tables, rows)
+                       : mul_rows_scalar<false>(src, outputs, offset, size, tables, rows);
+            return;
+    }
+}
+
+GfKernel resolve_gf_kernel(GfKernel kernel) {
+    if (kernel == GfKernel::Auto) {
+        if (gf_kernel_supported(GfKernel::AVX2)) {
+            return GfKernel::AVX2;
+        }
+        return gf_kernel_supported(GfKernel::SSSE3) ? GfKernel::SSSE3 : GfKernel::Scalar;
+    }
+    return gf_kernel_supported(kernel) ? kernel : GfKernel::Scalar;
+}
+
+/**
+ * Invert a square matrix in place by Gauss-Jordan elimination
+ *
+ * @return false if the matrix is singular
+ */
+bool invert_matrix(std::vector<uint8_t>& matrix, size_t n) {
+    std::vector<uint8_t> inverse(n * n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        inverse[i * n + i] = 1;
+    }
+    for (size_t col = 0; col < n; ++col) {
+        size_t pivot = col;
+        while (pivot < n && matrix[pivot * n + col] == 0) {
+            ++pivot;
+        }
+        if (pivot == n) {
+            return false;
+        }
+        if (pivot != col) {
+            std::swap_ranges(matrix.begin() + pivot * n, matrix.begin() + (pivot + 1) * n, matrix.begin() + col * n);
+            std::swap_ranges(inverse.begin() + pivot * n, inverse.begin() + (pivot + 1) * n, inverse.begin() + col * n);
+        }
+        uint8_t scale = gf_inverse(matrix[col * n + col]);
+        for (size_t j = 0; j < n; ++j) {
+            matrix[col * n + j] = gf_mul(matrix[col * n + j], scale);
+            inverse[col * n + j] = gf_mul(inverse[col * n + j], scale);
+        }
+        for (size_t row = 0; row < n; ++row) {
+            uint8_t factor = matrix[row * n + col];
+            if (row == col || factor == 0) {
+                continue;
+            }
+            for (size_t j = 0; j < n; ++j) {
+                matrix[row * n + j] ^= gf_mul(factor, matrix[col * n + j]);
+                inverse[row * n + j] ^= gf_mul(factor, inverse[col * n + j]);
+            }
+        }
+    }
+    matrix.swap(inverse);
+    return true;
+}
+
+void put_u32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+void put_u64(uint8_t* out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint32_t get_u32(const uint8_t* in) {
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; --i) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+uint64_t get_u64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+/**
+ * Parsed shard header
+ * Layout (little-endian): magic "CCCE", version, data shards, parity shards,
+ * reserved byte, group (low 32 bits), position in group, payload size,
+ * group (high 32 bits, zero in streams under 2^32 groups), stream size,
+ * XXH64 of the whole stream.
+ */
+struct ShardHeader {
+    size_t data_shards = 0;
+    size_t parity_shards = 0;
+    size_t group = 0;
+    size_t position = 0;
+    size_t shard_size = 0;
+    uint64_t total_size = 0;
+    uint64_t stream_hash = 0;
+
+    bool same_stream(const ShardHeader& other) const {
+        return data_shards == other.data_shards && parity_shards == other.parity_shards &&
+               shard_size == other.shard_size && total_size == other.total_size && stream_hash == other.stream_hash;
+    }
+};
+
+void write_shard_header(uint8_t* out, const ShardHeader& header) {
+    std::memcpy(out, kShardMagic, sizeof(kShardMagic));
+    out[4] = kShardVersion;
+    out[5] = static_cast<uint8_t>(header.data_shards);
+    out[6] = static_cast<uint8_t>(header.parity_shards);
+    out[7] = 0;
+    put_u32(out + 8, static_cast<uint32_t>(header.group));
+    put_u32(out + 12, static_cast<uint32_t>(header.position));
+    put_u32(out + 16, static_cast<uint32_t>(header.shard_size));
+    put_u32(out + 20, static_cast<uint32_t>(static_cast<uint64_t>(header.group) >> 32));
+    put_u64(out + 24, header.total_size);
+    put_u64(out + 32, header.stream_hash);
+}
+
+/**
+ * Parse and verify a shard; false for anything that is not an intact shard
+ */
+bool parse_shard(const std::vector<uint8_t>& shard, ShardHeader& header) {
+    const size_t framing = kErasureShardHeaderSize + kErasureShardTrailerSize;
+    if (shard.size() < framing || std::memcmp(shard.data(), kShardMagic, sizeof(kShardMagic)) != 0 ||
+        shard[4] != kShardVersion) {
+        return false;
+    }
+    header.data_shards = shard[5];
+    header.parity_shards = shard[6];
+    header.group = static_cast<size_t>(static_cast<uint64_t>(get_u32(shard.data() + 20)) << 32 | get_u32(shard.data() + 8));
+    header.position = get_u32(shard.data() + 12);
+    header.shard_size = get_u32(shard.data() + 16);
+    header.total_size = get_u64(shard.data() + 24);
+    header.stream_hash = get_u64(shard.data() + 32);
+    if (header.shard_size != shard.size() - framing || header.data_shards == 0 || header.parity_shards == 0 ||
+        header.data_shards + header.parity_shards > ReedSolomon::kMaxShards ||
+        header.position >= header.data_shards + header.parity_shards) {
+        return false;
+    }
+    size_t body = kErasureShardHeaderSize + header.shard_size;
+    return fast_hash64(shard.data(), body) == get_u64(shard.data() + body);
+}
+
+void validate_options(const ErasureOptions& options) {
+    if (options.data_shards == 0 || options.parity_shards == 0 ||
+        options.data_shards + options.parity_shards > ReedSolomon::kMaxShards) {
+        throw std::invalid_argument("Erasure code needs 1+ data and 1+ parity shards, at most " +
+                                    std::to_string(ReedSolomon::kMaxShards) + " in total");
+    }
+    if (options.shard_size == 0 || options.shard_size > UINT32_MAX) {
+        throw std::invalid_argument("Invalid erasure shard size: " + std::to_string(options.shard_size));
+    }
+}
+
+size_t worker_count(size_t num_threads, size_t jobs) {
+    size_t threads = num_threads == 0 ? ThreadPool::default_thread_count() : num_threads;
+    return std::max<size_t>(1, std::min(threads, jobs));
+}
+
+} // namespace
+
+bool gf_kernel_supported(GfKernel kernel) {
+    switch (kernel) {
+        case GfKernel::Auto:
+        case GfKernel::Scalar:
+            return true;
+        case GfKernel::SSSE3:
+#ifdef CCC_HAVE_X86_KERNELS
+            return __builtin_cpu_supports("ssse3");
+#else
+            return false;
+#endif
+        case GfKernel::AVX2:
+#ifdef CCC_HAVE_X86_KERNELS
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+const char* gf_kernel_name(GfKernel kernel) {
+    switch (kernel) {
+        case GfKernel::Scalar: return "scalar";
+        case GfKernel::SSSE3: return "ssse3";
+        case GfKernel::AVX2: return "avx2";
+        case GfKernel::Auto: break;
+    }
+    return "auto";
+}
+
+GfKernel parse_gf_kernel(const std::string& name) {
+    if (name == "scalar") return GfKernel::Scalar;
+    if (name == "ssse3") return GfKernel::SSSE3;
+    if (name == "avx2") return GfKernel::AVX2;
+    return GfKernel::Auto;
+}
+
+uint8_t gf_mul(uint8_t a, uint8_t b) {
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    const GfTables& tables = gf_tables();
+    return tables.exp[tables.log[a] + tables.log[b]];
+}
+
+uint8_t gf_inverse(uint8_t a) {
+    if (a == 0) {
+        throw std::invalid_argument("Zero has no inverse in GF(2^8)");
+    }
+    const GfTables& tables = gf_tables();
+    return tables.exp[255 - tables.log[a]];
+}
+
+void gf_mul_region(const uint8_t* src, uint8_t* dst, size_t size, uint8_t coeff, bool accumulate, GfKernel kernel) {
+    const SplitTable table = make_split_table(coeff);
+    mul_rows(resolve_gf_kernel(kernel), accumulate, src, &dst, 0, size, &table, 1);
+}
+
+ReedSolomon::ReedSolomon(size_t data_shards, size_t parity_shards, GfKernel kernel)
+    : data_shards_(data_shards), parity_shards_(parity_shards), kernel_(resolve_gf_kernel(kernel)) {
+    if (data_shards == 0 || parity_shards == 0 || data_shards + parity_shards > kMaxShards) {
+        throw std::invalid_argument("Reed-Solomon needs 1+ data and 1+ parity shards, at most " +
+                                    std::to_string(kMaxShards) + " in total");
+    }
+    // Cauchy rows 1 / (x_i + y_j) with x_i = data_shards + i and y_j = j, all distinct
+    parity_matrix_.resize(parity_shards_ * data_shards_);
+    for (size_t i = 0; i < parity_shards_; ++i) {
+        for (size_t j = 0; j < data_shards_; ++j) {
+            parity_matrix_[i * data_shards_ + j] = gf_inverse(static_cast<uint8_t>((data_shards_ + i) ^ j));
+        }
+    }
+}
+
+void ReedSolomon::apply(const uint8_t* matrix, size_t rows, const uint8_t* const* inputs, size_t input_count,
+                        uint8_t* const* outputs, size_t shard_size) const {
+    // Tables are ordered input-major, so one input's rows sit together
+    std::vector<SplitTable> tables(rows * input_count);
+    for (size_t j = 0; j < input_count; ++j) {
+        for (size_t r = 0; r < rows; ++r) {
+            tables[j * rows + r] = make_split_table(matrix[r * input_count + j]);
+        }
+    }
+    // Each input stripe is read once and folded into every output stripe
+    for (size_t offset = 0; offset < shard_size; offset += kStripeBytes) {
+        size_t length = std::min(kStripeBytes, shard_size - offset);
+        for (size_t j = 0; j < input_count; ++j) {
+            mul_rows(kernel_, j > 0, inputs[j] + offset, outputs, offset, length, tables.data() + j * rows, rows);
+        }
+    }
+}
+
+void ReedSolomon::encode(const uint8_t* const* data, uint8_t* const* parity, size_t shard_size) const {
+    apply(parity_matrix_.data(), parity_shards_, data, data_shards_, parity, shard_size);
+}
+
+size_t ReedSolomon::reconstruct(uint8_t* const* shards, const std::vector<bool>& present, size_t shard_size,
+                                bool data_only) const {
+    const size_t total = total_shards();
+    if (present.size() != total) {
+        throw std::invalid_argument("Reed-Solomon reconstruct expects " + std::to_string(total) + " shard flags");
+    }
+    std::vector<size_t> survivors;
+    std::vector<size_t> missing_data;
+    std::vector<size_t> missing_parity;
+    for (size_t i = 0; i < total; ++i) {
+        if (present[i]) {
+            survivors.push_back(i);
+        } else if (i < data_shards_) {
+            missing_data.push_back(i);
+        } else if (!data_only) {
+            missing_parity.push_back(i);
+        }
+    }
+    if (survivors.size() < data_shards_) {
+        throw std::runtime_error("Cannot reconstruct: " + std::to_string(survivors.size()) + " of " +
+                                 std::to_string(total) + " shards present, " + std::to_string(data_shards_) +
+                                 " required");
+    }
+
+    if (!missing_data.empty()) {
+        // Rows of the generator matrix for the first data_shards survivors
+        survivors.resize(data_shards_);
+        std::vector<uint8_t> decode(data_shards_ * data_shards_, 0);
+        for (size_t r = 0; r < data_shards_; ++r) {
+            size_t shard = survivors[r];
+            if (shard < data_shards_) {
+                decode[r * data_shards_ + shard] = 1;
+            } else {
+                std::copy_n(parity_matrix_.begin() + (shard - data_shards_) * data_shards_, data_shards_,
+                            decode.begin() + r * data_shards_);
+            }
+        }
+        if (!invert_matrix(decode, data_shards_)) {
+            throw std::runtime_error("Reed-Solomon decode matrix is singular");
+        }
+        // Only the rows of the missing data shards are needed
+        std::vector<uint8_t> rows;
+        std::vector<const uint8_t*> inputs;
+        std::vector<uint8_t*> outputs;
+        for (size_t shard : missing_data) {
+            rows.insert(rows.end(), decode.begin() + shard * data_shards_, decode.begin() + (shard + 1) * data_shards_);
+            outputs.push_back(shards[shard]);
+        }
+        for (size_t shard : survivors) {
+            inputs.push_back(shards[shard]);
+        }
+        apply(rows.data(), missing_data.size(), inputs.data(), data_shards_, outputs.data(), shard_size);
+    }
+
+    if (!missing_parity.empty()) {
+        std::vector<uint8_t> rows;
+        std::vector<uint8_t*> outputs;
+        for (size_t shard : missing_parity) {
+            size_t p = shard - data_shards_;
+            rows.insert(rows.end(), parity_matrix_.begin() + p * data_shards_,
+                        parity_matrix_.begin() + (p + 1) * data_shards_);
+            outputs.push_back(shards[shard]);
+        }
+        std::vector<const uint8_t*> inputs(shards, shards + data_shards_);
+        apply(rows.data(), missing_parity.size(), inputs.data(), data_shards_, outputs.data(), shard_size);
+    }
+    return missing_data.size() + missing_parity.size();
+}
+
+std::vector<std::vector<uint8_t>> erasure_encode(const uint8_t* data, size_t size, const ErasureOptions& options) {
+    validate_options(options);
+    const size_t k = options.data_shards;
+    const size_t total = k + options.parity_shards;
+    const size_t group_bytes = k * options.shard_size;
+    const size_t groups = std::max<size_t>(1, (size + group_bytes - 1) / group_bytes);
+    const ReedSolomon codec(k, options.parity_shards, options.kernel);
+
+    ShardHeader header;
+    header.data_shards = k;
+    header.parity_shards = options.parity_shards;
+    header.shard_size = options.shard_size;
+    header.total_size = size;
+    header.stream_hash = fast_hash64(data, size);
+
+    const size_t framed = kErasureShardHeaderSize + options.shard_size + kErasureShardTrailerSize;
+    std::vector<std::vector<uint8_t>> shards(groups * total, std::vector<uint8_t>(framed, 0));
+    ThreadPool pool(worker_count(options.num_threads, groups));
+    pool.parallel_for(groups, [&](size_t g) {
+        std::vector<uint8_t*> payloads(total);
+        for (size_t i = 0; i < total; ++i) {
+            payloads[i] = shards[g * total + i].data() + kErasureShardHeaderSize;
+        }
+        // The last group is zero padded
+        for (size_t i = 0; i < k; ++i) {
+            size_t offset = g * group_bytes + i * options.shard_size;
+            if (offset < size) {
+                std::memcpy(payloads[i], data + offset, std::min(options.shard_size, size - offset));
+            }
+        }
+        codec.encode(payloads.data(), payloads.data() + k, options.shard_size);
+        for (size_t i = 0; i < total; ++i) {
+            std::vector<uint8_t>& shard = shards[g * total + i];
+            ShardHeader shard_header = header;
+            shard_header.group = g;
+            shard_header.position = i;
+            write_shard_header(shard.data(), shard_header);
+            size_t body = kErasureShardHeaderSize + options.shard_size;
+            put_u64(shard.data() + body, fast_hash64(shard.data(), body));
+        }
+    });
+    return shards;
+}
+
+std::vector<uint8_t> erasure_decode(const std::vector<std::vector<uint8_t>>& shards, ErasureRepairReport* report,
+                                    size_t num_threads, GfKernel kernel) {
+    ErasureRepairReport counts;
+    counts.shards_received = shards.size();
+
+    // The stream held by most intact shards wins (the earliest on a tie); the others are foreign
+    std::vector<ShardHeader> headers(shards.size());
+    std::vector<bool> intact(shards.size(), false);
+    std::vector<std::pair<ShardHeader, size_t>> candidates;   // stream identity, intact shard count
+    for (size_t s = 0; s < shards.size(); ++s) {
+        intact[s] = parse_shard(shards[s], headers[s]);
+        if (!intact[s]) {
+            continue;
+        }
+        auto it = std::find_if(candidates.begin(), candidates.end(), [&](const std::pair<ShardHeader, size_t>& c) {
+            return c.first.same_stream(headers[s]);
+        });
+        if (it == candidates.end()) {
+            candidates.emplace_back(headers[s], 1);
+        } else {
+            it->second++;
+        }
+    }
+    if (candidates.empty()) {
+        throw std::runtime_error("No intact erasure shard found");
+    }
+    const ShardHeader stream = std::max_element(candidates.begin(), candidates.end(),
+        [](const std::pair<ShardHeader, size_t>& a, const std::pair<ShardHeader, size_t>& b) {
+            return a.second < b.second;
+        })->first;
+
+    std::map<std::pair<size_t, size_t>, const uint8_t*> payloads;
+    for (size_t s = 0; s < shards.size(); ++s) {
+        if (!intact[s] || !headers[s].same_stream(stream)) {
+            counts.shards_rejected++;
+            continue;
+        }
+        if (!payloads.emplace(std::make_pair(headers[s].group, headers[s].position),
+                              shards[s].data() + kErasureShardHeaderSize).second) {
+            counts.shards_rejected++;
+        }
+    }
+
+    const size_t k = stream.data_shards;
+    const size_t total = k + stream.parity_shards;
+    const size_t group_bytes = k * stream.shard_size;
+    const size_t groups = std::max<size_t>(1, static_cast<size_t>((stream.total_size + group_bytes - 1) / group_bytes));
+    for (auto it = payloads.begin(); it != payloads.end();) {
+        if (it->first.first >= groups) {
+            counts.shards_rejected++;
+            it = payloads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    counts.groups = groups;
+
+    std::vector<uint8_t> output(static_cast<size_t>(stream.total_size));
+    std::vector<size_t> rebuilt(groups, 0);
+    const ReedSolomon codec(k, stream.parity_shards, kernel);
+    ThreadPool pool(worker_count(num_threads, groups));
+    pool.parallel_for(groups, [&](size_t g) {
+        std::vector<uint8_t> scratch;
+        std::vector<uint8_t*> group_shards(total, nullptr);
+        std::vector<bool> present(total, false);
+        size_t available = 0;
+        for (size_t i = 0; i < total; ++i) {
+            available += payloads.count({g, i});
+        }
+        if (available < k) {
+            throw std::runtime_error("Erasure group " + std::to_string(g) + " has " + std::to_string(available) +
+                                     " of " + std::to_string(total) + " shards, " + std::to_string(k) +
+                                     " required");
+        }
+        // Survivors are copied so the caller's shards stay untouched
+        scratch.resize(total * stream.shard_size);
+        for (size_t i = 0; i < total; ++i) {
+            group_shards[i] = scratch.data() + i * stream.shard_size;
+            auto it = payloads.find({g, i});
+            if (it != payloads.end()) {
+                std::memcpy(group_shards[i], it->second, stream.shard_size);
+                present[i] = true;
+            }
+        }
+        bool data_complete = std::all_of(present.begin(), present.begin() + k, [](bool p) { return p; });
+        if (!data_complete) {
+            rebuilt[g] = codec.reconstruct(group_shards.data(), present, stream.shard_size, true);
+        }
+        for (size_t i = 0; i < k; ++i) {
+            size_t offset = g * group_bytes + i * stream.shard_size;
+            if (offset < output.size()) {
+                std::memcpy(output.data() + offset, group_shards[i], std::min(stream.shard_size, output.size() - offset));
+            }
+        }
+    });
+    for (size_t count : rebuilt) {
+        counts.shards_rebuilt += count;
+    }
+
+    if (fast_hash64(output.data(), output.size()) != stream.stream_hash) {
+        throw std::runtime_error("Erasure-decoded stream fails its hash check");
+    }
+    if (report) {
+        *report = counts;
+    }
+    return output;
+}
+
+std::vector<std::string> write_erasure_shards(const std::string& input_path, const std::string& output_prefix,
+                                              const ErasureOptions& options) {
+    std::ifstream input(input_path, std::ios::binary);
+    if (!input.is_open()) {
+        throw std::runtime_error("Cannot read " + input_path);
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    std::vector<std::vector<uint8_t>> shards = erasure_encode(data.data(), data.size(), options);
+
+    std::vector<std::string> paths;
+    const int digits = shards.size() > 1000 ? static_cast<int>(std::to_string(shards.size() - 1).size()) : 3;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        std::ostringstream name;
+        name << output_prefix << '.' << std::setw(digits) << std::setfill('0') << i;
+        std::ofstream file(name.str(), std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(shards[i].data()), static_cast<std::streamsize>(shards[i].size()));
+        if (!file.good()) {
+            throw std::runtime_error("Cannot write erasure shard " + name.str());
+        }
+        paths.push_back(name.str());
+    }
+    return paths;
+}
+
+ErasureRepairReport repair_from_shards(const std::vector<std::string>& shard_paths, const std::string& output_path,
+                                       size_t num_threads) {
+    std::vector<std::vector<uint8_t>> shards;
+    for (const std::string& path : shard_paths) {
+        std::ifstream file(path, std::ios::binary);
+        if (file.is_open()) {
+            shards.emplace_back((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        }
+    }
+    ErasureRepairReport report;
+    std::vector<uint8_t> data = erasure_decode(shards, &report, num_threads);
+    report.shards_received = shard_paths.size();
+
+    std::string temp_path = output_path + ".tmp" + std::to_string(std::random_device()());
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file.good()) {
+            throw std::runtime_error("Cannot write repaired file " + temp_path);
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp_path, output_path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        throw std::runtime_error("Cannot install repaired file " + output_path);
+    }
+    return report;
+}
+
+} // namespace ccc
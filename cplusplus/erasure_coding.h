@@ -0,0 +1,192 @@
+/**
+ * Erasure Coding - C++ Implementation
+ *
+ * Optional outer Reed-Solomon code over GF(2^8) for archives stored on media
+ * that lose whole units (DNA oligo pools, cold-storage objects, tapes). Data
+ * is cut into groups of data shards; each group gets parity shards such that
+ * any data_shards intact shards of the group rebuild the rest.
+ *
+ * The code is systematic (data shards are stored verbatim) with a Cauchy
+ * parity matrix, so every square submatrix is invertible. Region
+ * multiplication uses the split-table method: a product is two 16-entry
+ * nibble lookups, which SSSE3/AVX2 byte shuffles do 16/32 bytes at a time.
+ */
+
+#ifndef CCC_ERASURE_CODING_H
+#define CCC_ERASURE_CODING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ccc {
+
+/**
+ * Implementations of the GF(2^8) region multiply kernel
+ */
+enum class GfKernel {
+    Auto = 0,    // best kernel supported by the running CPU
+    Scalar = 1,  // 256-entry product row per coefficient
+    SSSE3 = 2,   // nibble split tables, 16 bytes per shuffle
+    AVX2 = 3     // nibble split tables, 32 bytes per shuffle
+};
+
+/**
+ * Whether a kernel can run on this CPU (Auto and Scalar always can)
+ */
+bool gf_kernel_supported(GfKernel kernel);
+
+/**
+ * Kernel name used in logs and benchmarks ("auto", "scalar", "ssse3", "avx2")
+ */
+const char* gf_kernel_name(GfKernel kernel);
+
+/**
+ * Parse a kernel name produced by gf_kernel_name(); unknown names map to Auto
+ */
+GfKernel parse_gf_kernel(const std::string& name);
+
+/**
+ * Product in GF(2^8) with the polynomial x^8 + x^4 + x^3 + x^2 + 1 (0x11D)
+ */
+uint8_t gf_mul(uint8_t a, uint8_t b);
+
+/**
+ * Multiplicative inverse in GF(2^8)
+ *
+ * @throws std::invalid_argument for 0
+ */
+uint8_t gf_inverse(uint8_t a);
+
+/**
+ * dst = coeff * src, or dst ^= coeff * src when accumulating
+ *
+ * @param kernel Kernel to use; unsupported kernels fall back to Scalar
+ */
+void gf_mul_region(const uint8_t* src, uint8_t* dst, size_t size, uint8_t coeff, bool accumulate,
+                   GfKernel kernel = GfKernel::Auto);
+
+/**
+ * Systematic Reed-Solomon code over equally sized shards
+ */
+class ReedSolomon {
+public:
+    static constexpr size_t kMaxShards = 256;
+
+    /**
+     * @param data_shards Shards carrying data (at least 1)
+     * @param parity_shards Shards of redundancy; up to this many erasures are repaired
+     * @param kernel Region multiply kernel
+     * @throws std::invalid_argument if either count is 0 or together they exceed kMaxShards
+     */
+    ReedSolomon(size_t data_shards, size_t parity_shards, GfKernel kernel = GfKernel::Auto);
+
+    size_t data_shards() const { return data_shards_; }
+    size_t parity_shards() const { return parity_shards_; }
+    size_t total_shards() const { return data_shards_ + parity_shards_; }
+    GfKernel kernel() const { return kernel_; }
+
+    /**
+     * Compute the parity shards of one group
+     *
+     * @param data data_shards() pointers of shard_size bytes
+     * @param parity parity_shards() output pointers of shard_size bytes
+     */
+    void encode(const uint8_t* const* data, uint8_t* const* parity, size_t shard_size) const;
+
+    /**
+     * Rebuild erased shards of one group in place
+     *
+     * @param shards total_shards() pointers of shard_size bytes, data shards first
+     * @param present Which shards hold valid contents; the others are overwritten
+     * @param data_only Rebuild only missing data shards and leave missing parity alone
+     * @return Number of shards rebuilt
+     * @throws std::runtime_error if fewer than data_shards() shards are present
+     */
+    size_t reconstruct(uint8_t* const* shards, const std::vector<bool>& present, size_t shard_size,
+                       bool data_only = false) const;
+
+private:
+    /**
+     * outputs[r] = sum_j matrix[r][j] * inputs[j] for rows x inputs coefficients
+     */
+    void apply(const uint8_t* matrix, size_t rows, const uint8_t* const* inputs, size_t input_count,
+               uint8_t* const* outputs, size_t shard_size) const;
+
+    size_t data_shards_;
+    size_t parity_shards_;
+    GfKernel kernel_;
+    std::vector<uint8_t> parity_matrix_;  // parity_shards x data_shards Cauchy matrix
+};
+
+/**
+ * Layout of a protected byte stream
+ */
+struct ErasureOptions {
+    size_t data_shards = 10;
+    size_t parity_shards = 4;
+    size_t shard_size = 65536;          // payload bytes per shard
+    size_t num_threads = 0;             // groups coded concurrently; 0 uses the hardware concurrency
+    GfKernel kernel = GfKernel::Auto;
+};
+
+// Shard framing: header before the payload, XXH64 of header + payload after it
+constexpr size_t kErasureShardHeaderSize = 40;
+constexpr size_t kErasureShardTrailerSize = 8;
+
+/**
+ * Outcome of erasure_decode()
+ */
+struct ErasureRepairReport {
+    size_t groups = 0;
+    size_t shards_received = 0;
+    size_t shards_rejected = 0;         // corrupt, foreign or duplicate shards
+    size_t shards_rebuilt = 0;          // missing data shards regenerated
+};
+
+/**
+ * Split a byte stream into self-describing shards with parity
+ * Every shard records its group and position plus a hash, so shards can be
+ * stored and returned in any order (as oligos are) and corrupt ones are
+ * treated as erasures. Shards of group g are at [g * total, (g + 1) * total).
+ *
+ * @throws std::invalid_argument on invalid options
+ */
+std::vector<std::vector<uint8_t>> erasure_encode(const uint8_t* data, size_t size, const ErasureOptions& options);
+
+/**
+ * Reassemble the byte stream from any surviving shards
+ *
+ * @param shards Shards in any order; missing ones may simply be absent. If
+ *        shards of several streams are mixed, the stream with the most intact
+ *        shards is decoded and the others are rejected as foreign.
+ * @param report Optional repair counters
+ * @throws std::runtime_error if no valid shard is present, a group lost more
+ *         shards than it has parity, or the result fails its hash check
+ */
+std::vector<uint8_t> erasure_decode(const std::vector<std::vector<uint8_t>>& shards,
+                                    ErasureRepairReport* report = nullptr, size_t num_threads = 0,
+                                    GfKernel kernel = GfKernel::Auto);
+
+/**
+ * Protect a file: write its shards as prefix.000, prefix.001, ...
+ *
+ * @return Paths of the shard files written
+ * @throws std::runtime_error if a file cannot be read or written
+ */
+std::vector<std::string> write_erasure_shards(const std::string& input_path, const std::string& output_prefix,
+                                              const ErasureOptions& options);
+
+/**
+ * Rebuild a file from whichever of its shard files can still be read;
+ * unreadable paths count as erasures. The output is written atomically.
+ *
+ * @throws std::runtime_error if the file cannot be recovered
+ */
+ErasureRepairReport repair_from_shards(const std::vector<std::string>& shard_paths, const std::string& output_path,
+                                       size_t num_threads = 0);
+
+} // namespace ccc
+
+#endif // CCC_ERASURE_CODING_H
@@ -0,0 +1,34 @@
+/**
+ * Fast Non-cryptographic Hashing - C++ Implementation
+ *
+ * XXH64-compatible 64-bit hash used for content addressing, where hashing
+ * must run at memory bandwidth rather than cryptographic strength.
+ */
+
+#ifndef CCC_FAST_HASH_H
+#define CCC_FAST_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ccc {
+
+/**
+ * 64-bit XXH64 hash of a buffer
+ *
+ * @param data Input bytes
+ * @param size Number of bytes
+ * @param seed Hash seed; chaining seeds combines several buffers into one key
+ * @return Hash value (matches the reference XXH64 for the same seed)
+ */
+uint64_t fast_hash64(const void* data, size_t size, uint64_t seed = 0);
+
+/**
+ * Fixed-width lowercase hex rendering of a 64-bit hash (16 characters)
+ */
+std::string hash_to_hex(uint64_t hash);
+
+} // namespace ccc
+
+#endif // CCC_FAST_HASH_H
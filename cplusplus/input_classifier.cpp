@@ -0,0 +1,470 @@
+/**
+ * Input classification and the nucleotide-text transform
+ */
+
+#include "input_classifier.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define CCC_HAVE_SSE2 1
+#endif
+
+namespace ccc {
+
+namespace {
+
+struct ByteClasses {
+    size_t nucleotide = 0;              // A/C/G/T/N, any case
+    size_t line_breaks = 0;
+    size_t text = 0;
+};
+
+inline bool is_nucleotide_byte(uint8_t byte) {
+    uint8_t up = byte & 0xDF;
+    return up == 'A' || up == 'C' || up == 'G' || up == 'T' || up == 'N';
+}
+
+inline bool is_text_byte(uint8_t byte) {
+    return (byte >= 0x20 && byte != 0x7F) || byte == '\t' || byte == '\n' || byte == '\r';
+}
+
+/**
+ * Per-class byte counts of one sampled range
+ */
+void count_classes(const uint8_t* data, size_t size, ByteClasses& classes) {
+    size_t i = 0;
+#ifdef CCC_HAVE_SSE2
+    const __m128i case_mask = _mm_set1_epi8(static_cast<char>(0xDF));
+    const __m128i va = _mm_set1_epi8('A'), vc = _mm_set1_epi8('C'), vg = _mm_set1_epi8('G');
+    const __m128i vt = _mm_set1_epi8('T'), vn = _mm_set1_epi8('N');
+    const __m128i lf = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r'), tab = _mm_set1_epi8('\t');
+    const __m128i space_minus_one = _mm_set1_epi8(0x1F), del = _mm_set1_epi8(0x7F);
+    const __m128i zero = _mm_setzero_si128();
+    while (i + 16 <= size) {
+        // Byte counters wrap at 256, so fold them into 64-bit sums every 255 vectors
+        __m128i nucleotide = zero, breaks = zero, text = zero;
+        size_t vectors = std::min<size_t>((size - i) / 16, 255);
+        for (size_t v = 0; v < vectors; ++v, i += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            __m128i up = _mm_and_si128(bytes, case_mask);
+            __m128i is_base = _mm_or_si128(
+                _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(up, va), _mm_cmpeq_epi8(up, vc)),
+                             _mm_or_si128(_mm_cmpeq_epi8(up, vg), _mm_cmpeq_epi8(up, vt))),
+                _mm_cmpeq_epi8(up, vn));
+            __m128i is_break = _mm_or_si128(_mm_cmpeq_epi8(bytes, lf), _mm_cmpeq_epi8(bytes, cr));
+            // Signed compares: 0x20-0x7E are > 0x1F, bytes >= 0x80 are negative
+            __m128i printable = _mm_andnot_si128(_mm_cmpeq_epi8(bytes, del), _mm_cmpgt_epi8(bytes, space_minus_one));
+            __m128i is_text = _mm_or_si128(_mm_or_si128(printable, _mm_cmplt_epi8(bytes, zero)),
+                                           _mm_or_si128(is_break, _mm_cmpeq_epi8(bytes, tab)));
+            nucleotide = _mm_sub_epi8(nucleotide, is_base);
+            breaks = _mm_sub_epi8(breaks, is_break);
+            text = _mm_sub_epi8(text, is_text);
+        }
+        auto sum = [&](__m128i counts) {
+            __m128i sums = _mm_sad_epu8(counts, zero);
+            return static_cast<size_t>(_mm_cvtsi128_si32(sums)) + static_cast<size_t>(_mm_extract_epi16(sums, 4));
+        };
+        classes.nucleotide += sum(nucleotide);
+        classes.line_breaks += sum(breaks);
+        classes.text += sum(text);
+    }
+#endif
+    for (; i < size; ++i) {
+        classes.nucleotide += is_nucleotide_byte(data[i]);
+        classes.line_breaks += data[i] == '\n' || data[i] == '\r';
+        classes.text += is_text_byte(data[i]);
+    }
+}
+
+void add_histogram(const uint8_t* data, size_t size, std::array<size_t, 256>& histogram) {
+    // Four tables keep repeated bytes from serialising on one counter
+    std::array<std::array<uint32_t, 256>, 4> partial{};
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        partial[0][data[i]]++;
+        partial[1][data[i + 1]]++;
+        partial[2][data[i + 2]]++;
+        partial[3][data[i + 3]]++;
+    }
+    for (; i < size; ++i) {
+        partial[0][data[i]]++;
+    }
+    for (size_t b = 0; b < 256; ++b) {
+        histogram[b] += partial[0][b] + partial[1][b] + partial[2][b] + partial[3][b];
+    }
+}
+
+struct Magic {
+    const char* format;
+    const char* bytes;
+    size_t length;
+};
+
+const Magic kMagics[] = {
+    {"gzip", "\x1f\x8b", 2},
+    {"zstd", "\x28\xb5\x2f\xfd", 4},
+    {"xz", "\xfd" "7zXZ\x00", 6},
+    {"bzip2", "BZh", 3},
+    {"zip", "PK\x03\x04", 4},
+    {"7z", "7z\xbc\xaf\x27\x1c", 6},
+    {"lz4", "\x04\x22\x4d\x18", 4},
+    {"png", "\x89PNG", 4},
+    {"jpeg", "\xff\xd8\xff", 3},
+    {"cram", "CRAM", 4},
+    {"ccc", "CCCA", 4},
+    {"ccc", "CCCM", 4},
+};
+
+/**
+ * Whether the prefix starts with whole FASTQ records (at least one)
+ */
+bool looks_like_fastq(const uint8_t* data, size_t size) {
+    size_t pos = 0;
+    size_t records = 0;
+    auto next_line = [&](size_t& start, size_t& length) {
+        if (pos >= size) {
+            return false;
+        }
+        const void* end = std::memchr(data + pos, '\n', size - pos);
+        if (!end) {
+            return false;
+        }
+        start = pos;
+        length = static_cast<size_t>(static_cast<const uint8_t*>(end) - (data + pos));
+        pos += length + 1;
+        if (length > 0 && data[start + length - 1] == '\r') {
+            --length;
+        }
+        return true;
+    };
+    while (records < 4) {
+        size_t header, header_length, bases, bases_length, plus, plus_length, quality, quality_length;
+        if (!next_line(header, header_length)) {
+            break;
+        }
+        if (header_length == 0 || data[header] != '@') {
+            return false;
+        }
+        if (!next_line(bases, bases_length) || !next_line(plus, plus_length) ||
+            !next_line(quality, quality_length)) {
+            break;
+        }
+        if (plus_length == 0 || data[plus] != '+' || quality_length != bases_length || bases_length == 0) {
+            return false;
+        }
+        for (size_t i = 0; i < bases_length; ++i) {
+            if (!is_nucleotide_byte(data[bases + i]) && data[bases + i] != '.') {
+                return false;
+            }
+        }
+        ++records;
+    }
+    return records > 0;
+}
+
+// 0-3 for A/C/G/T in either case, 4 for any other byte
+const std::array<uint8_t, 256>& base_codes() {
+    static const std::array<uint8_t, 256> table = [] {
+        std::array<uint8_t, 256> codes;
+        codes.fill(4);
+        const char bases[] = "ACGT";
+        for (uint8_t code = 0; code < 4; ++code) {
+            codes[static_cast<uint8_t>(bases[code])] = code;
+            codes[static_cast<uint8_t>(bases[code] | 0x20)] = code;
+        }
+        return codes;
+    }();
+    return table;
+}
+
+} // namespace
+
+const char* input_kind_name(InputKind kind) {
+    switch (kind) {
+        case InputKind::Binary: return "binary";
+        case InputKind::Nucleotide: return "nucleotide";
+        case InputKind::Fastq: return "fastq";
+        case InputKind::Text: return "text";
+        case InputKind::Compressed: return "compressed";
+    }
+    return "unknown";
+}
+
+InputProfile classify_input(const uint8_t* data, size_t size, const ClassifierOptions& options) {
+    InputProfile profile;
+    if (size == 0) {
+        return profile;
+    }
+    for (const Magic& magic : kMagics) {
+        if (size >= magic.length && std::memcmp(data, magic.bytes, magic.length) == 0) {
+            profile.format = magic.format;
+            break;
+        }
+    }
+
+    ByteClasses classes;
+    std::array<size_t, 256> histogram{};
+    auto sample = [&](size_t offset, size_t length) {
+        count_classes(data + offset, length, classes);
+        add_histogram(data + offset, length, histogram);
+        profile.sampled_bytes += length;
+    };
+    const size_t prefix = std::min(size, options.prefix_bytes);
+    sample(0, prefix);
+    if (size > prefix && options.sample_blocks > 0) {
+        const size_t stride = (size - prefix) / options.sample_blocks;
+        const size_t block = std::min(options.sample_block_bytes, std::max<size_t>(stride, 1));
+        for (size_t s = 0; s < options.sample_blocks; ++s) {
+            size_t offset = prefix + s * stride;
+            if (offset >= size) {
+                break;
+            }
+            sample(offset, std::min(block, size - offset));
+        }
+    }
+
+    double entropy = 0.0;
+    for (size_t count : histogram) {
+        if (count > 0) {
+            double p = static_cast<double>(count) / static_cast<double>(profile.sampled_bytes);
+            entropy -= p * std::log2(p);
+        }
+    }
+    profile.entropy = entropy;
+    const size_t content = profile.sampled_bytes - classes.line_breaks;
+    profile.nucleotide_fraction = content ? static_cast<double>(classes.nucleotide) / static_cast<double>(content) : 0.0;
+    profile.text_fraction = static_cast<double>(classes.text) / static_cast<double>(profile.sampled_bytes);
+
+    if (!profile.format.empty()) {
+        profile.kind = InputKind::Compressed;
+    } else if (data[0] == '@' && looks_like_fastq(data, prefix)) {
+        profile.kind = InputKind::Fastq;
+    } else if (profile.nucleotide_fraction >= options.nucleotide_threshold) {
+        profile.kind = InputKind::Nucleotide;
+    } else if (profile.entropy >= options.compressed_entropy) {
+        profile.kind = InputKind::Compressed;
+    } else if (profile.text_fraction >= options.text_threshold) {
+        profile.kind = InputKind::Text;
+    }
+    return profile;
+}
+
+namespace {
+
+/**
+ * Newlines ending runs of equal-length lines (FASTA sequence lines), not counting
+ * header lines or the newline before a header, so headers stay detectable once
+ * the wrapped newlines are removed
+ */
+std::vector<LineWrap> find_line_wraps(const uint8_t* text, size_t size) {
+    std::vector<LineWrap> wraps;
+    size_t line_start = 0;
+    size_t previous = 0;                // last eligible newline + 1, 0 if none yet
+    LineWrap current;
+    auto close = [&]() {
+        if (current.count >= 2) {
+            wraps.push_back(current);
+        }
+        current = LineWrap();
+    };
+    while (line_start < size) {
+        const void* found = std::memchr(text + line_start, '\n', size - line_start);
+        if (found == nullptr) {
+            break;
+        }
+        const size_t newline = static_cast<size_t>(static_cast<const uint8_t*>(found) - text);
+        if (text[line_start] == '>' || newline + 1 >= size || text[newline + 1] == '>') {
+            close();
+            previous = 0;
+        } else {
+            const size_t width = newline - line_start;
+            if (current.count > 0 && previous == line_start && width == current.width) {
+                ++current.count;
+            } else {
+                close();
+                current = {newline, width, 1};
+            }
+            previous = newline + 1;
+        }
+        line_start = newline + 1;
+    }
+    close();
+    return wraps;
+}
+
+/**
+ * Split text without its wrapped newlines into packed bases and layout
+ */
+NucleotideLayout pack_letters(const uint8_t* text, size_t size, std::vector<uint8_t>& packed) {
+    const auto& codes = base_codes();
+    NucleotideLayout layout;
+    layout.text_size = size;
+    packed.assign(size / 4 + 1, 0);
+
+    size_t bases = 0;
+    size_t lowercase_start = 0;
+    bool in_lowercase = false;
+    // FASTA header lines stay literal even where they contain A/C/G/T letters
+    auto header_at = [&](size_t pos) { return text[pos] == '>' && (pos == 0 || text[pos - 1] == '\n'); };
+    size_t i = 0;
+    while (i < size) {
+        const uint8_t code = codes[text[i]];
+        if (code < 4 && !header_at(i)) {
+            const bool lowercase = (text[i] & 0x20) != 0;
+            if (lowercase != in_lowercase) {
+                if (in_lowercase) {
+                    layout.lowercase.emplace_back(lowercase_start, bases - lowercase_start);
+                }
+                lowercase_start = bases;
+                in_lowercase = lowercase;
+            }
+            packed[bases >> 2] |= static_cast<uint8_t>(code << (6 - 2 * (bases & 3)));
+            ++bases;
+            ++i;
+            continue;
+        }
+
+        size_t end = i;
+        while (end < size) {
+            if (header_at(end)) {
+                const void* line_end = std::memchr(text + end, '\n', size - end);
+                end = line_end ? static_cast<size_t>(static_cast<const uint8_t*>(line_end) - text) + 1 : size;
+            } else if (codes[text[end]] == 4) {
+                ++end;
+            } else {
+                break;
+            }
+        }
+        TextRun run;
+        run.position = i;
+        run.length = end - i;
+        const bool fill = std::all_of(text + i + 1, text + end, [&](uint8_t byte) { return byte == text[i]; });
+        run.bytes.assign(reinterpret_cast<const char*>(text + i), fill ? 1 : run.length);
+        layout.literals.push_back(std::move(run));
+        i = end;
+    }
+    if (in_lowercase) {
+        layout.lowercase.emplace_back(lowercase_start, bases - lowercase_start);
+    }
+    layout.bases = bases;
+    packed.resize((bases + 3) / 4);
+    return layout;
+}
+
+/**
+ * Rebuild text of size bytes without its wrapped newlines
+ */
+std::vector<uint8_t> unpack_letters(const std::vector<uint8_t>& packed, const NucleotideLayout& layout, size_t size) {
+    static const uint8_t kUpper[4] = {'A', 'C', 'G', 'T'};
+    std::vector<uint8_t> text(size);
+    size_t out = 0;
+    size_t base = 0;
+    size_t lowercase = 0;               // first lowercase run not yet passed
+    auto emit_bases = [&](size_t count) {
+        if (count > layout.bases - base || count > size - out) {
+            throw std::runtime_error("Invalid nucleotide layout: bases and literals overlap");
+        }
+        for (size_t k = 0; k < count; ++k, ++base) {
+            uint8_t letter = kUpper[(packed[base >> 2] >> (6 - 2 * (base & 3))) & 3];
+            while (lowercase < layout.lowercase.size() &&
+                   base >= layout.lowercase[lowercase].first + layout.lowercase[lowercase].second) {
+                ++lowercase;
+            }
+            if (lowercase < layout.lowercase.size() && base >= layout.lowercase[lowercase].first) {
+                letter |= 0x20;
+            }
+            text[out++] = letter;
+        }
+    };
+    for (const TextRun& run : layout.literals) {
+        if (run.position < out || run.length == 0 ||
+            (run.bytes.size() != run.length && run.bytes.size() != 1)) {
+            throw std::runtime_error("Invalid nucleotide layout: malformed literal run");
+        }
+        emit_bases(run.position - out);
+        if (run.length > size - out) {
+            throw std::runtime_error("Invalid nucleotide layout: literal run past the end of the text");
+        }
+        if (run.bytes.size() == 1) {
+            std::memset(text.data() + out, static_cast<uint8_t>(run.bytes[0]), run.length);
+        } else {
+            std::memcpy(text.data() + out, run.bytes.data(), run.length);
+        }
+        out += run.length;
+    }
+    emit_bases(size - out);
+    if (base != layout.bases) {
+        throw std::runtime_error("Invalid nucleotide layout: " + std::to_string(layout.bases - base) +
+                                 " bases left over");
+    }
+    return text;
+}
+
+} // namespace
+
+NucleotideLayout pack_nucleotide_text(const uint8_t* text, size_t size, std::vector<uint8_t>& packed) {
+    std::vector<LineWrap> wraps = find_line_wraps(text, size);
+    if (wraps.empty()) {
+        return pack_letters(text, size, packed);
+    }
+    // Pack the text as if the wrapped newlines were not there
+    std::vector<uint8_t> letters;
+    letters.reserve(size);
+    size_t from = 0;
+    for (const LineWrap& wrap : wraps) {
+        for (size_t k = 0; k < wrap.count; ++k) {
+            const size_t newline = wrap.first + k * (wrap.width + 1);
+            letters.insert(letters.end(), text + from, text + newline);
+            from = newline + 1;
+        }
+    }
+    letters.insert(letters.end(), text + from, text + size);
+    NucleotideLayout layout = pack_letters(letters.data(), letters.size(), packed);
+    layout.text_size = size;
+    layout.wraps = std::move(wraps);
+    return layout;
+}
+
+std::vector<uint8_t> unpack_nucleotide_text(const std::vector<uint8_t>& packed, const NucleotideLayout& layout) {
+    if (packed.size() < (layout.bases + 3) / 4) {
+        throw std::runtime_error("Nucleotide layout needs " + std::to_string(layout.bases) + " bases, have " +
+                                 std::to_string(packed.size() * 4));
+    }
+    // Wrapped newlines ascend and lie inside the text
+    size_t wrapped = 0;
+    size_t next_free = 0;
+    for (const LineWrap& wrap : layout.wraps) {
+        if (wrap.count == 0 || wrap.width >= layout.text_size || wrap.first < next_free ||
+            wrap.first >= layout.text_size || wrap.count - 1 > (layout.text_size - 1 - wrap.first) / (wrap.width + 1)) {
+            throw std::runtime_error("Invalid nucleotide layout: malformed line wrap");
+        }
+        next_free = wrap.first + (wrap.count - 1) * (wrap.width + 1) + 1;
+        wrapped += wrap.count;
+    }
+    if (layout.wraps.empty()) {
+        return unpack_letters(packed, layout, layout.text_size);
+    }
+
+    std::vector<uint8_t> letters = unpack_letters(packed, layout, layout.text_size - wrapped);
+    std::vector<uint8_t> text(layout.text_size);
+    size_t in = 0;
+    size_t out = 0;
+    for (const LineWrap& wrap : layout.wraps) {
+        for (size_t k = 0; k < wrap.count; ++k) {
+            const size_t newline = wrap.first + k * (wrap.width + 1);
+            std::memcpy(text.data() + out, letters.data() + in, newline - out);
+            in += newline - out;
+            text[newline] = '\n';
+            out = newline + 1;
+        }
+    }
+    std::memcpy(text.data() + out, letters.data() + in, layout.text_size - out);
+    return text;
+}
+
+} // namespace ccc
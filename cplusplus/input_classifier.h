@@ -0,0 +1,123 @@
+/**
+ * Input Classification - C++ Implementation
+ *
+ * Cheap sniffing of what a buffer holds, so compress() can route it to the
+ * path that suits it instead of expanding everything through binary_to_dna().
+ * The classifier reads a prefix and evenly spaced sample blocks, never the
+ * whole input: magic numbers of common compressed formats, a byte histogram
+ * (entropy), SIMD counts of nucleotide, line-break and printable bytes, and
+ * the four-line record structure of FASTQ.
+ *
+ * Also holds the reversible nucleotide-text transform behind the Nucleotide
+ * route: A/C/G/T letters are packed two bits each, and everything else
+ * (line breaks, FASTA header lines, N runs, lowercase soft masking) is kept
+ * as runs.
+ */
+
+#ifndef CCC_INPUT_CLASSIFIER_H
+#define CCC_INPUT_CLASSIFIER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ccc {
+
+enum class InputKind {
+    Binary,                             // anything not matched below
+    Nucleotide,                         // ASCII bases (plain or FASTA), line breaks and N allowed
+    Fastq,                              // @name / bases / + / qualities records
+    Text,                               // printable ASCII or UTF-8
+    Compressed                          // known compressed format or near-random bytes
+};
+
+/**
+ * Lowercase name of a kind ("binary", "nucleotide", "fastq", "text", "compressed")
+ */
+const char* input_kind_name(InputKind kind);
+
+/**
+ * What the classifier saw in the sampled bytes
+ */
+struct InputProfile {
+    InputKind kind = InputKind::Binary;
+    std::string format;                 // detected container, e.g. "gzip"; empty if none
+    size_t sampled_bytes = 0;
+    double entropy = 0.0;               // bits per byte over the samples
+    double nucleotide_fraction = 0.0;   // A/C/G/T/N, any case, of the bytes other than line breaks
+    double text_fraction = 0.0;         // printable ASCII, whitespace and UTF-8 continuation bytes
+};
+
+struct ClassifierOptions {
+    size_t prefix_bytes = 65536;        // always read from the start
+    size_t sample_blocks = 16;          // further blocks spread over the rest of the input
+    size_t sample_block_bytes = 4096;
+    double compressed_entropy = 7.5;    // bits per byte from which data counts as compressed
+    double nucleotide_threshold = 0.9;
+    double text_threshold = 0.95;
+};
+
+/**
+ * Classify a buffer from its prefix and sampled blocks
+ *
+ * @param data Input bytes
+ * @param size Number of bytes
+ * @return Profile; an empty input is Binary
+ */
+InputProfile classify_input(const uint8_t* data, size_t size, const ClassifierOptions& options = ClassifierOptions());
+
+inline InputProfile classify_input(const std::vector<uint8_t>& data,
+                                   const ClassifierOptions& options = ClassifierOptions()) {
+    return classify_input(data.data(), data.size(), options);
+}
+
+/**
+ * Bytes of nucleotide text kept verbatim: position in the text, then either
+ * length bytes or one byte repeated length times (N runs)
+ */
+struct TextRun {
+    size_t position = 0;
+    size_t length = 0;
+    std::string bytes;                  // length bytes, or a single fill byte
+};
+
+/**
+ * Newlines of count consecutive lines of width bytes each (FASTA sequence
+ * lines), at text positions first, first + width + 1, ...
+ */
+struct LineWrap {
+    size_t first = 0;
+    size_t width = 0;
+    size_t count = 0;
+};
+
+/**
+ * Everything about a nucleotide text except its packed bases
+ */
+struct NucleotideLayout {
+    size_t text_size = 0;               // bytes of the original text
+    size_t bases = 0;                   // A/C/G/T letters, in text order
+    std::vector<std::pair<size_t, size_t>> lowercase;  // (first base, base count) runs of a/c/g/t
+    std::vector<TextRun> literals;      // every other byte, ascending, in text without the wrapped newlines
+    std::vector<LineWrap> wraps;        // newlines of fixed-width lines, ascending
+};
+
+/**
+ * Split nucleotide text into packed bases and layout
+ *
+ * @param packed Receives (bases + 3) / 4 bytes in binary_to_dna() order
+ * @return Layout needed by unpack_nucleotide_text()
+ */
+NucleotideLayout pack_nucleotide_text(const uint8_t* text, size_t size, std::vector<uint8_t>& packed);
+
+/**
+ * Rebuild the text from packed bases and layout (inverse of pack_nucleotide_text())
+ *
+ * @throws std::runtime_error if the layout does not fit the packed bases
+ */
+std::vector<uint8_t> unpack_nucleotide_text(const std::vector<uint8_t>& packed, const NucleotideLayout& layout);
+
+} // namespace ccc
+
+#endif // CCC_INPUT_CLASSIFIER_H
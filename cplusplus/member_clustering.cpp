@@ -0,0 +1,151 @@
+/**
+ * MinHash sketches and greedy member grouping for solid archives
+ */
+
+#include "member_clustering.h"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+
+namespace ccc {
+
+namespace {
+
+// MurmurHash3 finalizer: spreads the 2-bit k-mer codes over the full 64 bits
+inline uint64_t mix64(uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdull;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ull;
+    value ^= value >> 33;
+    return value;
+}
+
+} // namespace
+
+MinHashSketch minhash_sketch(const uint8_t* packed, size_t bases, size_t kmer_length, size_t sketch_size) {
+    if (kmer_length == 0 || kmer_length > 32) {
+        throw std::invalid_argument("k-mer length must be 1..32");
+    }
+    if (sketch_size == 0) {
+        throw std::invalid_argument("Sketch size must be positive");
+    }
+    if (bases < kmer_length) {
+        return {};
+    }
+
+    const uint64_t mask = kmer_length == 32 ? ~0ull : (1ull << (2 * kmer_length)) - 1;
+    std::set<uint64_t> smallest;
+    uint64_t threshold = std::numeric_limits<uint64_t>::max();
+    uint64_t kmer = 0;
+    for (size_t i = 0; i < bases; ++i) {
+        kmer = ((kmer << 2) | ((packed[i >> 2] >> (6 - 2 * (i & 3))) & 3)) & mask;
+        if (i + 1 < kmer_length) {
+            continue;
+        }
+        // After the first few thousand k-mers almost every hash fails this test
+        const uint64_t hash = mix64(kmer);
+        if (hash >= threshold && smallest.size() == sketch_size) {
+            continue;
+        }
+        if (smallest.insert(hash).second && smallest.size() > sketch_size) {
+            smallest.erase(std::prev(smallest.end()));
+        }
+        if (smallest.size() == sketch_size) {
+            threshold = *smallest.rbegin();
+        }
+    }
+    return MinHashSketch(smallest.begin(), smallest.end());
+}
+
+double sketch_containment(const MinHashSketch& a, const MinHashSketch& b) {
+    if (a.empty() || b.empty()) {
+        return 0.0;
+    }
+    // Hashes of a above b's largest are outside b's sample, unless b holds all of its set
+    const uint64_t limit = b.back();
+    size_t compared = 0;
+    size_t shared = 0;
+    auto bi = b.begin();
+    for (uint64_t hash : a) {
+        if (hash > limit) {
+            break;
+        }
+        ++compared;
+        bi = std::lower_bound(bi, b.end(), hash);
+        if (bi != b.end() && *bi == hash) {
+            ++shared;
+        }
+    }
+    return compared ? static_cast<double>(shared) / static_cast<double>(compared) : 0.0;
+}
+
+MinHashSketch merge_sketches(const MinHashSketch& a, const MinHashSketch& b, size_t sketch_size) {
+    MinHashSketch merged;
+    merged.reserve(a.size() + b.size());
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(merged));
+    if (merged.size() > sketch_size) {
+        merged.resize(sketch_size);
+    }
+    return merged;
+}
+
+std::vector<std::vector<size_t>> cluster_members(const std::vector<MinHashSketch>& sketches,
+                                                 const std::vector<size_t>& sizes, const SolidOptions& options) {
+    if (sketches.size() != sizes.size()) {
+        throw std::invalid_argument("One sketch and one size per member required");
+    }
+
+    struct Group {
+        std::vector<size_t> members;
+        MinHashSketch sketch;
+        size_t bytes = 0;
+        bool open = true;                   // accepts further members
+    };
+    std::vector<Group> groups;
+
+    std::vector<size_t> order(sizes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+    for (size_t member : order) {
+        const bool shareable = !sketches[member].empty() && sizes[member] <= options.max_member_bytes;
+        Group* best = nullptr;
+        double best_similarity = options.min_similarity;
+        if (shareable) {
+            for (Group& group : groups) {
+                if (!group.open || group.bytes + sizes[member] > options.max_stream_bytes) {
+                    continue;
+                }
+                double similarity = sketch_containment(sketches[member], group.sketch);
+                if (similarity >= best_similarity) {
+                    best = &group;
+                    best_similarity = similarity;
+                }
+            }
+        }
+        if (!best) {
+            groups.emplace_back();
+            best = &groups.back();
+            best->open = shareable;
+        }
+        best->members.push_back(member);
+        best->bytes += sizes[member];
+        best->sketch = merge_sketches(best->sketch, sketches[member], options.sketch_size);
+    }
+
+    std::vector<std::vector<size_t>> result;
+    result.reserve(groups.size());
+    for (Group& group : groups) {
+        std::sort(group.members.begin(), group.members.end());
+        result.push_back(std::move(group.members));
+    }
+    std::sort(result.begin(), result.end(),
+              [](const std::vector<size_t>& a, const std::vector<size_t>& b) { return a.front() < b.front(); });
+    return result;
+}
+
+} // namespace ccc
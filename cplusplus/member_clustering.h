@@ -0,0 +1,78 @@
+/**
+ * Archive Member Clustering - C++ Implementation
+ *
+ * Groups the members of a multi-member archive by content similarity so
+ * that a solid archive can compress each group as one DVNP stream and let
+ * similar members share dictionary state. Similarity is estimated from
+ * bottom-k MinHash sketches of the members' k-mers: one pass over the 2-bit
+ * bases with a rolling k-mer and a hash, keeping the smallest distinct
+ * hashes.
+ */
+
+#ifndef CCC_MEMBER_CLUSTERING_H
+#define CCC_MEMBER_CLUSTERING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ccc {
+
+/**
+ * Solid archive grouping parameters
+ */
+struct SolidOptions {
+    size_t kmer_length = 16;                // bases per k-mer, 1..32
+    size_t sketch_size = 128;               // hashes kept per sketch
+    double min_similarity = 0.2;            // estimated containment needed to join a group
+    size_t max_member_bytes = 4 << 20;      // larger members keep a stream of their own
+    size_t max_stream_bytes = 32 << 20;     // packed bytes per shared stream
+};
+
+/**
+ * Bottom-k MinHash sketch: the smallest distinct k-mer hashes, ascending
+ */
+using MinHashSketch = std::vector<uint64_t>;
+
+/**
+ * Sketch 2-bit packed bases (binary_to_dna() order)
+ * A sequence shorter than kmer_length has an empty sketch.
+ *
+ * @param packed Packed bases, four per byte
+ * @param bases Number of bases
+ * @throws std::invalid_argument if kmer_length is not 1..32 or sketch_size is 0
+ */
+MinHashSketch minhash_sketch(const uint8_t* packed, size_t bases, size_t kmer_length, size_t sketch_size);
+
+/**
+ * Estimated fraction of a's k-mers that also occur in b
+ * Only hashes within the range b's sketch covers are compared, so a small
+ * member is not penalised for the size of a large group.
+ *
+ * @return 0 if either sketch is empty
+ */
+double sketch_containment(const MinHashSketch& a, const MinHashSketch& b);
+
+/**
+ * Sketch of the union of two sketched sets, at most sketch_size hashes
+ */
+MinHashSketch merge_sketches(const MinHashSketch& a, const MinHashSketch& b, size_t sketch_size);
+
+/**
+ * Group members for solid compression
+ * Members are placed largest first, each joining the group it is most
+ * contained in (at least min_similarity) that still has room, or starting
+ * a new group. Members over max_member_bytes and members without k-mers get
+ * a group of their own.
+ *
+ * @param sketches Sketch of each member
+ * @param sizes Packed bytes of each member
+ * @return Groups of member indices, each ascending, ordered by first member
+ * @throws std::invalid_argument if sketches and sizes differ in length
+ */
+std::vector<std::vector<size_t>> cluster_members(const std::vector<MinHashSketch>& sketches,
+                                                 const std::vector<size_t>& sizes, const SolidOptions& options);
+
+} // namespace ccc
+
+#endif // CCC_MEMBER_CLUSTERING_H
@@ -0,0 +1,68 @@
+/**
+ * Packed Base Access - C++ Implementation
+ *
+ * Helpers for streams of 2-bit bases packed four per byte in binary_to_dna()
+ * order (first base in the high bits), shared by the token stages that
+ * splice bases back into decoded blocks.
+ */
+
+#ifndef CCC_PACKED_BASES_H
+#define CCC_PACKED_BASES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ccc {
+
+inline uint8_t get_base(const uint8_t* packed, size_t position) {
+    return static_cast<uint8_t>((packed[position >> 2] >> (6 - 2 * (position & 3))) & 3);
+}
+
+/**
+ * OR a base into zeroed output
+ */
+inline void put_base(uint8_t* packed, size_t position, uint8_t symbol) {
+    packed[position >> 2] |= static_cast<uint8_t>(symbol << (6 - 2 * (position & 3)));
+}
+
+/**
+ * Overwrite a base that may already be set
+ */
+inline void set_base(uint8_t* packed, size_t position, uint8_t symbol) {
+    const unsigned shift = 6 - 2 * static_cast<unsigned>(position & 3);
+    packed[position >> 2] = static_cast<uint8_t>((packed[position >> 2] & ~(3u << shift)) | (symbol << shift));
+}
+
+/**
+ * OR count bases starting at base src_pos into zeroed output starting at base dst_pos
+ * Source and output may be the same buffer if the ranges do not overlap.
+ */
+inline void copy_bases(const uint8_t* src, size_t src_pos, uint8_t* dst, size_t dst_pos, size_t count) {
+    // Base by base up to an output byte boundary, then whole output bytes
+    while (count > 0 && (dst_pos & 3) != 0) {
+        put_base(dst, dst_pos++, get_base(src, src_pos++));
+        --count;
+    }
+    const unsigned shift = 2 * static_cast<unsigned>(src_pos & 3);
+    if (shift == 0) {
+        std::memmove(dst + (dst_pos >> 2), src + (src_pos >> 2), count >> 2);
+    } else {
+        // Each output byte spans two input bytes, both holding bases of the range
+        const uint8_t* in = src + (src_pos >> 2);
+        uint8_t* out = dst + (dst_pos >> 2);
+        for (size_t b = 0; b < (count >> 2); ++b) {
+            out[b] = static_cast<uint8_t>((in[b] << shift) | (in[b + 1] >> (8 - shift)));
+        }
+    }
+    size_t whole = count & ~static_cast<size_t>(3);
+    src_pos += whole;
+    dst_pos += whole;
+    for (count -= whole; count > 0; --count) {
+        put_base(dst, dst_pos++, get_base(src, src_pos++));
+    }
+}
+
+} // namespace ccc
+
+#endif // CCC_PACKED_BASES_H
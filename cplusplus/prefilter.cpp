@@ -0,0 +1,584 @@
+/**
+ * Typed pre-filters: delta, XOR-delta, byte shuffle and bit shuffle kernels
+ */
+
+#include "prefilter.h"
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define CCC_HAVE_SSE2 1
+#endif
+
+namespace ccc {
+
+namespace {
+
+template <size_t W> struct Element;
+template <> struct Element<1> { using type = uint8_t; };
+template <> struct Element<2> { using type = uint16_t; };
+template <> struct Element<4> { using type = uint32_t; };
+template <> struct Element<8> { using type = uint64_t; };
+
+// Byte-wise so the format does not depend on host byte order; compilers fold these into one load/store
+template <typename T>
+inline T load_le(const uint8_t* p) {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<T>(static_cast<T>(p[i]) << (8 * i));
+    }
+    return value;
+}
+
+template <typename T>
+inline void store_le(uint8_t* p, T value) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        p[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+/**
+ * Delta-code elements [start, count); element start - 1 of the input is the reference
+ */
+template <size_t W, bool Xor>
+void delta_encode_scalar(const uint8_t* input, uint8_t* output, size_t count, size_t start) {
+    using T = typename Element<W>::type;
+    T previous = start ? load_le<T>(input + (start - 1) * W) : 0;
+    for (size_t i = start; i < count; ++i) {
+        T value = load_le<T>(input + i * W);
+        store_le<T>(output + i * W, Xor ? static_cast<T>(value ^ previous) : static_cast<T>(value - previous));
+        previous = value;
+    }
+}
+
+/**
+ * Undo delta coding of elements [start, count); element start - 1 of the output is already decoded
+ */
+template <size_t W, bool Xor>
+void delta_decode_scalar(const uint8_t* input, uint8_t* output, size_t count, size_t start) {
+    using T = typename Element<W>::type;
+    T previous = start ? load_le<T>(output + (start - 1) * W) : 0;
+    for (size_t i = start; i < count; ++i) {
+        T delta = load_le<T>(input + i * W);
+        previous = Xor ? static_cast<T>(delta ^ previous) : static_cast<T>(delta + previous);
+        store_le<T>(output + i * W, previous);
+    }
+}
+
+/**
+ * Byte shuffle of elements [start, count): plane b holds byte b of every element
+ */
+void byte_shuffle_scalar(const uint8_t* input, uint8_t* output, size_t count, size_t width, size_t start) {
+    for (size_t i = start; i < count; ++i) {
+        for (size_t b = 0; b < width; ++b) {
+            output[b * count + i] = input[i * width + b];
+        }
+    }
+}
+
+void byte_unshuffle_scalar(const uint8_t* input, uint8_t* output, size_t count, size_t width, size_t start) {
+    for (size_t i = start; i < count; ++i) {
+        for (size_t b = 0; b < width; ++b) {
+            output[i * width + b] = input[b * count + i];
+        }
+    }
+}
+
+/**
+ * Bit planes of a byte plane, groups of 8 bytes [start, bytes): plane r holds
+ * bit 7 - r of every byte, byte k bit t from input byte 8k + t
+ */
+void bit_transpose_scalar(const uint8_t* input, uint8_t* output, size_t bytes, size_t start) {
+    const size_t stride = bytes / 8;
+    for (size_t g = start; g < bytes; g += 8) {
+        for (size_t r = 0; r < 8; ++r) {
+            uint8_t packed = 0;
+            for (size_t t = 0; t < 8; ++t) {
+                packed |= static_cast<uint8_t>(((input[g + t] >> (7 - r)) & 1) << t);
+            }
+            output[r * stride + g / 8] = packed;
+        }
+    }
+}
+
+void bit_untranspose_scalar(const uint8_t* input, uint8_t* output, size_t bytes, size_t start) {
+    const size_t stride = bytes / 8;
+    for (size_t g = start; g < bytes; g += 8) {
+        for (size_t t = 0; t < 8; ++t) {
+            uint8_t value = 0;
+            for (size_t r = 0; r < 8; ++r) {
+                value |= static_cast<uint8_t>(((input[r * stride + g / 8] >> t) & 1) << (7 - r));
+            }
+            output[g + t] = value;
+        }
+    }
+}
+
+#ifdef CCC_HAVE_SSE2
+template <size_t W>
+inline __m128i lanes_add(__m128i a, __m128i b) {
+    if constexpr (W == 1) {
+        return _mm_add_epi8(a, b);
+    } else if constexpr (W == 2) {
+        return _mm_add_epi16(a, b);
+    } else if constexpr (W == 4) {
+        return _mm_add_epi32(a, b);
+    } else {
+        return _mm_add_epi64(a, b);
+    }
+}
+
+template <size_t W>
+inline __m128i lanes_sub(__m128i a, __m128i b) {
+    if constexpr (W == 1) {
+        return _mm_sub_epi8(a, b);
+    } else if constexpr (W == 2) {
+        return _mm_sub_epi16(a, b);
+    } else if constexpr (W == 4) {
+        return _mm_sub_epi32(a, b);
+    } else {
+        return _mm_sub_epi64(a, b);
+    }
+}
+
+template <size_t W, bool Xor>
+inline __m128i forward_op(__m128i value, __m128i previous) {
+    return Xor ? _mm_xor_si128(value, previous) : lanes_sub<W>(value, previous);
+}
+
+template <size_t W, bool Xor>
+inline __m128i inverse_op(__m128i delta, __m128i previous) {
+    return Xor ? _mm_xor_si128(delta, previous) : lanes_add<W>(delta, previous);
+}
+
+/**
+ * Last element copied to every lane
+ */
+template <size_t W>
+inline __m128i broadcast_last(__m128i x) {
+    if constexpr (W == 8) {
+        return _mm_unpackhi_epi64(x, x);
+    } else if constexpr (W == 4) {
+        return _mm_shuffle_epi32(x, 0xFF);
+    } else if constexpr (W == 2) {
+        return _mm_shuffle_epi32(_mm_shufflehi_epi16(x, 0xFF), 0xFF);
+    } else {
+        x = _mm_unpackhi_epi8(x, x);
+        x = _mm_unpackhi_epi16(x, x);
+        return _mm_shuffle_epi32(x, 0xFF);
+    }
+}
+
+/**
+ * Inclusive prefix sum (XOR) across the lanes of one vector, log2(16 / W) steps
+ */
+template <size_t W, bool Xor>
+inline __m128i lanes_prefix(__m128i x) {
+    x = inverse_op<W, Xor>(x, _mm_slli_si128(x, W));
+    if constexpr (W <= 4) {
+        x = inverse_op<W, Xor>(x, _mm_slli_si128(x, 2 * W));
+    }
+    if constexpr (W <= 2) {
+        x = inverse_op<W, Xor>(x, _mm_slli_si128(x, 4 * W));
+    }
+    if constexpr (W == 1) {
+        x = inverse_op<W, Xor>(x, _mm_slli_si128(x, 8));
+    }
+    return x;
+}
+
+template <size_t W, bool Xor>
+void delta_encode_sse2(const uint8_t* input, uint8_t* output, size_t count) {
+    const size_t bytes = count * W;
+    size_t p = 0;
+    if (bytes >= 16) {
+        // The first element's predecessor is zero
+        __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), forward_op<W, Xor>(first, _mm_slli_si128(first, W)));
+        for (p = 16; p + 16 <= bytes; p += 16) {
+            __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + p));
+            __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + p - W));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + p), forward_op<W, Xor>(value, previous));
+        }
+    }
+    delta_encode_scalar<W, Xor>(input, output, count, p / W);
+}
+
+template <size_t W, bool Xor>
+void delta_decode_sse2(const uint8_t* input, uint8_t* output, size_t count) {
+    const size_t bytes = count * W;
+    __m128i carry = _mm_setzero_si128();
+    size_t p = 0;
+    for (; p + 16 <= bytes; p += 16) {
+        __m128i x = lanes_prefix<W, Xor>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + p)));
+        x = inverse_op<W, Xor>(x, carry);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + p), x);
+        carry = broadcast_last<W>(x);
+    }
+    delta_decode_scalar<W, Xor>(input, output, count, p / W);
+}
+
+/**
+ * Even and odd bytes of the 32 bytes a, b
+ */
+inline void split_bytes(__m128i a, __m128i b, __m128i& even, __m128i& odd) {
+    const __m128i low = _mm_set1_epi16(0x00FF);
+    even = _mm_packus_epi16(_mm_and_si128(a, low), _mm_and_si128(b, low));
+    odd = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+}
+
+inline void merge_bytes(__m128i even, __m128i odd, __m128i& a, __m128i& b) {
+    a = _mm_unpacklo_epi8(even, odd);
+    b = _mm_unpackhi_epi8(even, odd);
+}
+
+/**
+ * 16 elements of W bytes (W vectors) to W byte planes of 16 bytes
+ * Splitting even and odd bytes leaves elements of W / 2 bytes whose byte c is
+ * original byte 2c (even half) or 2c + 1 (odd half); recurse on each half.
+ */
+template <size_t W>
+inline void split_planes(const __m128i* v, __m128i* planes) {
+    if constexpr (W == 1) {
+        planes[0] = v[0];
+    } else {
+        __m128i even[W / 2], odd[W / 2], even_planes[W / 2], odd_planes[W / 2];
+        for (size_t j = 0; j < W / 2; ++j) {
+            split_bytes(v[2 * j], v[2 * j + 1], even[j], odd[j]);
+        }
+        split_planes<W / 2>(even, even_planes);
+        split_planes<W / 2>(odd, odd_planes);
+        for (size_t c = 0; c < W / 2; ++c) {
+            planes[2 * c] = even_planes[c];
+            planes[2 * c + 1] = odd_planes[c];
+        }
+    }
+}
+
+template <size_t W>
+inline void merge_planes(const __m128i* planes, __m128i* v) {
+    if constexpr (W == 1) {
+        v[0] = planes[0];
+    } else {
+        __m128i even_planes[W / 2], odd_planes[W / 2], even[W / 2], odd[W / 2];
+        for (size_t c = 0; c < W / 2; ++c) {
+            even_planes[c] = planes[2 * c];
+            odd_planes[c] = planes[2 * c + 1];
+        }
+        merge_planes<W / 2>(even_planes, even);
+        merge_planes<W / 2>(odd_planes, odd);
+        for (size_t j = 0; j < W / 2; ++j) {
+            merge_bytes(even[j], odd[j], v[2 * j], v[2 * j + 1]);
+        }
+    }
+}
+
+template <size_t W>
+void byte_shuffle_sse2(const uint8_t* input, uint8_t* output, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i v[W], planes[W];
+        for (size_t j = 0; j < W; ++j) {
+            v[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * W + 16 * j));
+        }
+        split_planes<W>(v, planes);
+        for (size_t b = 0; b < W; ++b) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + b * count + i), planes[b]);
+        }
+    }
+    byte_shuffle_scalar(input, output, count, W, i);
+}
+
+template <size_t W>
+void byte_unshuffle_sse2(const uint8_t* input, uint8_t* output, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i planes[W], v[W];
+        for (size_t b = 0; b < W; ++b) {
+            planes[b] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + b * count + i));
+        }
+        merge_planes<W>(planes, v);
+        for (size_t j = 0; j < W; ++j) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i * W + 16 * j), v[j]);
+        }
+    }
+    byte_unshuffle_scalar(input, output, count, W, i);
+}
+
+/**
+ * movemask collects one bit of 16 bytes; doubling each byte brings the next bit up
+ */
+void bit_transpose_sse2(const uint8_t* input, uint8_t* output, size_t bytes) {
+    const size_t stride = bytes / 8;
+    size_t g = 0;
+    for (; g + 16 <= bytes; g += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + g));
+        for (size_t r = 0; r < 8; ++r) {
+            int mask = _mm_movemask_epi8(x);
+            output[r * stride + g / 8] = static_cast<uint8_t>(mask);
+            output[r * stride + g / 8 + 1] = static_cast<uint8_t>(mask >> 8);
+            x = _mm_add_epi8(x, x);
+        }
+    }
+    bit_transpose_scalar(input, output, bytes, g);
+}
+
+void bit_untranspose_sse2(const uint8_t* input, uint8_t* output, size_t bytes) {
+    const size_t stride = bytes / 8;
+    // Byte t of a broadcast mask byte tests bit t % 8
+    const __m128i select = _mm_set_epi8(-128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+    size_t g = 0;
+    for (; g + 16 <= bytes; g += 16) {
+        __m128i x = _mm_setzero_si128();
+        for (size_t r = 0; r < 8; ++r) {
+            const uint8_t* masks = input + r * stride + g / 8;
+            __m128i spread = _mm_unpacklo_epi64(_mm_set1_epi8(static_cast<char>(masks[0])),
+                                                _mm_set1_epi8(static_cast<char>(masks[1])));
+            __m128i set = _mm_cmpeq_epi8(_mm_and_si128(spread, select), select);
+            x = _mm_or_si128(x, _mm_and_si128(set, _mm_set1_epi8(static_cast<char>(0x80 >> r))));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + g), x);
+    }
+    bit_untranspose_scalar(input, output, bytes, g);
+}
+#endif
+
+template <size_t W, bool Xor>
+void delta_encode(const uint8_t* input, uint8_t* output, size_t count, bool vectorized) {
+#ifdef CCC_HAVE_SSE2
+    if (vectorized) {
+        delta_encode_sse2<W, Xor>(input, output, count);
+        return;
+    }
+#endif
+    (void)vectorized;
+    delta_encode_scalar<W, Xor>(input, output, count, 0);
+}
+
+template <size_t W, bool Xor>
+void delta_decode(const uint8_t* input, uint8_t* output, size_t count, bool vectorized) {
+#ifdef CCC_HAVE_SSE2
+    if (vectorized) {
+        delta_decode_sse2<W, Xor>(input, output, count);
+        return;
+    }
+#endif
+    (void)vectorized;
+    delta_decode_scalar<W, Xor>(input, output, count, 0);
+}
+
+template <bool Xor>
+void delta_kernel(const uint8_t* input, uint8_t* output, size_t count, size_t width, bool inverse, bool vectorized) {
+    switch (width) {
+        case 1: return inverse ? delta_decode<1, Xor>(input, output, count, vectorized)
+                               : delta_encode<1, Xor>(input, output, count, vectorized);
+        case 2: return inverse ? delta_decode<2, Xor>(input, output, count, vectorized)
+                               : delta_encode<2, Xor>(input, output, count, vectorized);
+        case 4: return inverse ? delta_decode<4, Xor>(input, output, count, vectorized)
+                               : delta_encode<4, Xor>(input, output, count, vectorized);
+        default: return inverse ? delta_decode<8, Xor>(input, output, count, vectorized)
+                                : delta_encode<8, Xor>(input, output, count, vectorized);
+    }
+}
+
+void shuffle_kernel(const uint8_t* input, uint8_t* output, size_t count, size_t width, bool inverse,
+                    bool vectorized) {
+#ifdef CCC_HAVE_SSE2
+    if (vectorized) {
+        switch (width) {
+            case 1: std::memcpy(output, input, count); return;
+            case 2: return inverse ? byte_unshuffle_sse2<2>(input, output, count) : byte_shuffle_sse2<2>(input, output, count);
+            case 4: return inverse ? byte_unshuffle_sse2<4>(input, output, count) : byte_shuffle_sse2<4>(input, output, count);
+            default: return inverse ? byte_unshuffle_sse2<8>(input, output, count) : byte_shuffle_sse2<8>(input, output, count);
+        }
+    }
+#endif
+    (void)vectorized;
+    if (inverse) {
+        byte_unshuffle_scalar(input, output, count, width, 0);
+    } else {
+        byte_shuffle_scalar(input, output, count, width, 0);
+    }
+}
+
+void bit_transpose(const uint8_t* input, uint8_t* output, size_t bytes, bool inverse, bool vectorized) {
+#ifdef CCC_HAVE_SSE2
+    if (vectorized) {
+        if (inverse) {
+            bit_untranspose_sse2(input, output, bytes);
+        } else {
+            bit_transpose_sse2(input, output, bytes);
+        }
+        return;
+    }
+#endif
+    (void)vectorized;
+    if (inverse) {
+        bit_untranspose_scalar(input, output, bytes, 0);
+    } else {
+        bit_transpose_scalar(input, output, bytes, 0);
+    }
+}
+
+/**
+ * Bit shuffle of the first count elements, a multiple of 8: byte planes, then
+ * the bit planes of each byte plane
+ */
+void bit_shuffle_kernel(const uint8_t* input, uint8_t* output, size_t count, size_t width, bool inverse,
+                        bool vectorized) {
+    if (width == 1) {
+        bit_transpose(input, output, count, inverse, vectorized);
+        return;
+    }
+    std::vector<uint8_t> planes(count * width);
+    if (inverse) {
+        for (size_t b = 0; b < width; ++b) {
+            bit_transpose(input + b * count, planes.data() + b * count, count, true, vectorized);
+        }
+        shuffle_kernel(planes.data(), output, count, width, true, vectorized);
+    } else {
+        shuffle_kernel(input, planes.data(), count, width, false, vectorized);
+        for (size_t b = 0; b < width; ++b) {
+            bit_transpose(planes.data() + b * count, output + b * count, count, false, vectorized);
+        }
+    }
+}
+
+void run_filter(const uint8_t* input, uint8_t* output, size_t size, const FilterStage& stage, bool inverse,
+                bool vectorized) {
+    validate_filter_chain({stage});
+    const size_t width = stage.element_size;
+    size_t count = size / width;
+    if (stage.kind == FilterKind::BitShuffle) {
+        // Bit planes pack 8 elements per byte; the last count % 8 elements pass through
+        count &= ~static_cast<size_t>(7);
+    }
+    switch (stage.kind) {
+        case FilterKind::Delta:
+            delta_kernel<false>(input, output, count, width, inverse, vectorized);
+            break;
+        case FilterKind::XorDelta:
+            delta_kernel<true>(input, output, count, width, inverse, vectorized);
+            break;
+        case FilterKind::ByteShuffle:
+            shuffle_kernel(input, output, count, width, inverse, vectorized);
+            break;
+        case FilterKind::BitShuffle:
+            bit_shuffle_kernel(input, output, count, width, inverse, vectorized);
+            break;
+    }
+    const size_t filtered = count * width;
+    if (size > filtered) {
+        std::memcpy(output + filtered, input + filtered, size - filtered);
+    }
+}
+
+} // namespace
+
+const char* filter_kind_name(FilterKind kind) {
+    switch (kind) {
+        case FilterKind::Delta: return "delta";
+        case FilterKind::XorDelta: return "xor";
+        case FilterKind::ByteShuffle: return "shuffle";
+        case FilterKind::BitShuffle: return "bitshuffle";
+    }
+    return "unknown";
+}
+
+std::string filter_chain_name(const FilterChain& chain) {
+    if (chain.empty()) {
+        return "none";
+    }
+    std::string name;
+    for (const FilterStage& stage : chain) {
+        if (!name.empty()) {
+            name += ',';
+        }
+        name += filter_kind_name(stage.kind) + std::to_string(stage.element_size);
+    }
+    return name;
+}
+
+FilterChain parse_filter_chain(const std::string& text) {
+    FilterChain chain;
+    if (text.empty() || text == "none") {
+        return chain;
+    }
+    static const FilterKind kKinds[] = {FilterKind::Delta, FilterKind::XorDelta, FilterKind::ByteShuffle,
+                                        FilterKind::BitShuffle};
+    std::stringstream list(text);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        size_t digits = item.find_first_of("0123456789");
+        if (digits == std::string::npos || digits == 0 ||
+            item.find_first_not_of("0123456789", digits) != std::string::npos || item.size() - digits > 2) {
+            throw std::invalid_argument("Invalid filter '" + item + "' (expected e.g. delta4, xor8, shuffle2)");
+        }
+        const std::string kind_name = item.substr(0, digits);
+        FilterStage stage;
+        stage.element_size = std::stoul(item.substr(digits));
+        bool known = false;
+        for (FilterKind kind : kKinds) {
+            if (kind_name == filter_kind_name(kind)) {
+                stage.kind = kind;
+                known = true;
+            }
+        }
+        if (!known) {
+            throw std::invalid_argument("Unknown filter '" + kind_name + "'");
+        }
+        chain.push_back(stage);
+    }
+    validate_filter_chain(chain);
+    return chain;
+}
+
+void validate_filter_chain(const FilterChain& chain) {
+    for (const FilterStage& stage : chain) {
+        if (stage.kind < FilterKind::Delta || stage.kind > FilterKind::BitShuffle) {
+            throw std::invalid_argument("Unknown filter kind " + std::to_string(static_cast<unsigned>(stage.kind)));
+        }
+        const size_t width = stage.element_size;
+        const bool supported = stage.kind == FilterKind::ByteShuffle ? width == 2 || width == 4 || width == 8
+                                                                     : width == 1 || width == 2 || width == 4 || width == 8;
+        if (!supported) {
+            throw std::invalid_argument(std::string("Unsupported element size ") + std::to_string(width) + " for " +
+                                        filter_kind_name(stage.kind));
+        }
+    }
+}
+
+void apply_filter(const uint8_t* input, uint8_t* output, size_t size, const FilterStage& stage, bool vectorized) {
+    run_filter(input, output, size, stage, false, vectorized);
+}
+
+void invert_filter(const uint8_t* input, uint8_t* output, size_t size, const FilterStage& stage, bool vectorized) {
+    run_filter(input, output, size, stage, true, vectorized);
+}
+
+std::vector<uint8_t> apply_filters(const std::vector<uint8_t>& data, const FilterChain& chain) {
+    validate_filter_chain(chain);
+    std::vector<uint8_t> current = data;
+    std::vector<uint8_t> next(data.size());
+    for (const FilterStage& stage : chain) {
+        apply_filter(current.data(), next.data(), current.size(), stage);
+        current.swap(next);
+    }
+    return current;
+}
+
+void invert_filters(std::vector<uint8_t>& data, const FilterChain& chain) {
+    validate_filter_chain(chain);
+    if (chain.empty()) {
+        return;
+    }
+    std::vector<uint8_t> next(data.size());
+    for (auto stage = chain.rbegin(); stage != chain.rend(); ++stage) {
+        invert_filter(data.data(), next.data(), data.size(), *stage);
+        data.swap(next);
+    }
+}
+
+} // namespace ccc
@@ -0,0 +1,114 @@
+/**
+ * Typed Pre-Filters - C++ Implementation
+ *
+ * Reversible transforms for arrays of fixed-width numbers (coverage tracks,
+ * signal samples, positions), applied before core compression. Byte-wise
+ * through binary_to_dna(), such arrays offer DVNP few repeated patterns:
+ * neighbouring values differ in their low bytes, and the slowly changing high
+ * bytes are spread one per element. Delta coding turns smooth series into
+ * small repeating differences; byte-plane and bit-plane shuffles gather the
+ * near-constant high bytes (bits) into long runs.
+ *
+ * Elements are little-endian. Filters keep the size of the data; bytes after
+ * the last whole element pass through unchanged. Kernels use SSE2 where
+ * available and fall back to scalar loops.
+ */
+
+#ifndef CCC_PREFILTER_H
+#define CCC_PREFILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ccc {
+
+enum class FilterKind : uint8_t {
+    Delta = 1,                          // element minus previous element, wrapping
+    XorDelta = 2,                       // element XOR previous element (suits floats)
+    ByteShuffle = 3,                    // byte b of every element together, b = 0..width-1
+    BitShuffle = 4                      // bit planes of each byte plane, most significant bit first
+};
+
+/**
+ * One filter and the element width it works on
+ */
+struct FilterStage {
+    FilterKind kind = FilterKind::Delta;
+    size_t element_size = 1;            // bytes per element: 1, 2, 4 or 8 (2, 4 or 8 for ByteShuffle)
+
+    bool operator==(const FilterStage& other) const {
+        return kind == other.kind && element_size == other.element_size;
+    }
+    bool operator!=(const FilterStage& other) const { return !(*this == other); }
+};
+
+/**
+ * Filters in the order they are applied; inverted in reverse order
+ */
+using FilterChain = std::vector<FilterStage>;
+
+/**
+ * Lowercase name of a filter kind ("delta", "xor", "shuffle", "bitshuffle")
+ */
+const char* filter_kind_name(FilterKind kind);
+
+/**
+ * Chain as text, e.g. "delta4,shuffle4"; "none" for an empty chain
+ */
+std::string filter_chain_name(const FilterChain& chain);
+
+/**
+ * Parse filter_chain_name() text; "none" or "" is the empty chain
+ *
+ * @throws std::invalid_argument for an unknown filter or unsupported width
+ */
+FilterChain parse_filter_chain(const std::string& text);
+
+/**
+ * Check every stage's kind and element width
+ *
+ * @throws std::invalid_argument for an unknown filter or unsupported width
+ */
+void validate_filter_chain(const FilterChain& chain);
+
+/**
+ * Apply one filter
+ *
+ * @param input Source bytes
+ * @param output Destination of size bytes; must not overlap input
+ * @param size Number of bytes
+ * @param stage Filter and element width
+ * @param vectorized Use the SIMD kernels when the CPU has them (false forces scalar loops)
+ * @throws std::invalid_argument for an unsupported stage
+ */
+void apply_filter(const uint8_t* input, uint8_t* output, size_t size, const FilterStage& stage,
+                  bool vectorized = true);
+
+/**
+ * Undo apply_filter() with the same stage
+ *
+ * @throws std::invalid_argument for an unsupported stage
+ */
+void invert_filter(const uint8_t* input, uint8_t* output, size_t size, const FilterStage& stage,
+                   bool vectorized = true);
+
+/**
+ * Apply every stage of a chain
+ *
+ * @return Filtered bytes, the same size as data
+ * @throws std::invalid_argument for an unsupported stage
+ */
+std::vector<uint8_t> apply_filters(const std::vector<uint8_t>& data, const FilterChain& chain);
+
+/**
+ * Undo apply_filters() in place
+ *
+ * @throws std::invalid_argument for an unsupported stage
+ */
+void invert_filters(std::vector<uint8_t>& data, const FilterChain& chain);
+
+} // namespace ccc
+
+#endif // CCC_PREFILTER_H
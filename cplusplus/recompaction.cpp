@@ -0,0 +1,104 @@
+/**
+ * Background archive recompaction implementation
+ */
+
+#include "recompaction.h"
+#include "archive.h"
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <thread>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define CCC_HAVE_THREAD_PRIORITY 1
+#endif
+
+namespace ccc {
+
+namespace {
+
+/**
+ * Lower the calling thread to nice 19 and the idle I/O class
+ * Linux applies both per thread, and threads created afterwards inherit them.
+ */
+void lower_thread_priority() {
+#ifdef CCC_HAVE_THREAD_PRIORITY
+    pid_t tid = static_cast<pid_t>(::syscall(SYS_gettid));
+    ::setpriority(PRIO_PROCESS, static_cast<id_t>(tid), 19);
+#ifdef SYS_ioprio_set
+    const int kIoprioWhoProcess = 1;
+    const int kIoprioClassIdle = 3;
+    const int kIoprioClassShift = 13;
+    ::syscall(SYS_ioprio_set, kIoprioWhoProcess, tid, kIoprioClassIdle << kIoprioClassShift);
+#endif
+#endif
+}
+
+RecompactionResult run_recompaction(const std::string& path, const RecompactionOptions& options) {
+    auto start = std::chrono::steady_clock::now();
+
+    RecompactionResult result;
+    result.path = path;
+    result.original_bytes = std::filesystem::file_size(path);
+
+    auto [compressed_data, metadata] = read_archive(path);
+
+    CircularChromosomeCompressor compressor(metadata.encapsulation.trans_splicing.chunk_size, 4, true, false);
+    compressor.set_block_size(options.block_size);
+    compressor.set_max_dict_size(options.max_dict_size);
+    compressor.set_seed_window(options.seed_window);
+    compressor.set_num_threads(options.num_threads);
+
+    auto [recompacted_data, recompacted_metadata] = compressor.recompress(compressed_data, metadata);
+    std::vector<int>().swap(compressed_data);
+
+    // Stage beside the archive so the final rename stays on one filesystem
+    const std::string staged_path = path + ".recompact";
+    write_archive(staged_path, recompacted_data, recompacted_metadata);
+    result.recompacted_bytes = std::filesystem::file_size(staged_path);
+
+    if (result.recompacted_bytes < result.original_bytes || options.replace_if_larger) {
+        std::error_code ec;
+        std::filesystem::rename(staged_path, path, ec);
+        if (ec) {
+            std::filesystem::remove(staged_path, ec);
+            throw std::runtime_error("Cannot replace CCC archive " + path);
+        }
+        result.replaced = true;
+    } else {
+        std::error_code ec;
+        std::filesystem::remove(staged_path, ec);
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+} // namespace
+
+RecompactionResult recompact_archive(const std::string& path, const RecompactionOptions& options) {
+    if (!options.low_priority) {
+        return run_recompaction(path, options);
+    }
+
+    RecompactionResult result;
+    std::exception_ptr error;
+    std::thread worker([&]() {
+        lower_thread_priority();
+        try {
+            result = run_recompaction(path, options);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    });
+    worker.join();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return result;
+}
+
+} // namespace ccc
@@ -0,0 +1,63 @@
+/**
+ * Background Archive Recompaction - C++ Implementation
+ *
+ * Re-packs archives written with a fast ingest configuration using stronger
+ * settings (larger blocks and dictionaries, warm-start seeding) when the
+ * machine is otherwise idle. Work runs at idle CPU and I/O priority, and the
+ * archive is only replaced, atomically, when the result is smaller.
+ */
+
+#ifndef CCC_RECOMPACTION_H
+#define CCC_RECOMPACTION_H
+
+#include "circular_chromosome_compression.h"
+#include <string>
+
+namespace ccc {
+
+/**
+ * Target configuration for recompaction
+ */
+struct RecompactionOptions {
+    size_t block_size = 16 * 1048576;
+    uint32_t max_dict_size = 1u << 20;
+    size_t seed_window = 1048576;
+    size_t num_threads = 0;          // 0 uses the hardware concurrency
+    bool low_priority = true;        // run at nice 19 and idle I/O priority
+    bool replace_if_larger = false;  // keep the original unless the result is smaller
+};
+
+/**
+ * Outcome of recompacting one archive
+ */
+struct RecompactionResult {
+    std::string path;
+    uint64_t original_bytes = 0;     // archive size before
+    uint64_t recompacted_bytes = 0;  // size of the re-encoded archive
+    bool replaced = false;
+    double seconds = 0.0;
+
+    /**
+     * Bytes freed on disk (0 if the archive was kept)
+     */
+    uint64_t bytes_reclaimed() const {
+        return replaced && original_bytes > recompacted_bytes ? original_bytes - recompacted_bytes : 0;
+    }
+};
+
+/**
+ * Recompact an archive in place
+ * The work runs on a dedicated thread so lowering its priority never
+ * affects the caller; worker threads inherit the lowered priority.
+ *
+ * @param path Archive written by write_archive()
+ * @param options Target configuration
+ * @return Sizes before and after and whether the archive was replaced
+ * @throws std::runtime_error if the archive cannot be read or written
+ */
+RecompactionResult recompact_archive(const std::string& path,
+                                     const RecompactionOptions& options = RecompactionOptions());
+
+} // namespace ccc
+
+#endif // CCC_RECOMPACTION_H
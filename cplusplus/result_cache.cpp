@@ -0,0 +1,154 @@
+/**
+ * Content-addressed result cache implementation
+ */
+
+#include "result_cache.h"
+#include "archive.h"
+#include "fast_hash.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace fs = std::filesystem;
+
+namespace ccc {
+
+namespace {
+
+constexpr const char* kEntryExtension = ".ccc";
+
+struct CacheEntry {
+    fs::path path;
+    uint64_t size;
+    fs::file_time_type last_used;
+};
+
+std::vector<CacheEntry> list_entries(const std::string& directory) {
+    std::vector<CacheEntry> entries;
+    std::error_code ec;
+    for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() != kEntryExtension) {
+            continue;
+        }
+        // Entries may vanish under concurrent eviction; skip them quietly
+        std::error_code entry_ec;
+        uint64_t size = it->file_size(entry_ec);
+        fs::file_time_type last_used = it->last_write_time(entry_ec);
+        if (!entry_ec) {
+            entries.push_back({it->path(), size, last_used});
+        }
+    }
+    return entries;
+}
+
+} // namespace
+
+ResultCache::ResultCache(std::string directory, uint64_t max_bytes)
+    : directory_(std::move(directory)), max_bytes_(max_bytes), hits_(0), misses_(0) {
+}
+
+std::string ResultCache::default_directory() {
+    if (const char* explicit_dir = std::getenv("CCC_CACHE_DIR")) {
+        return explicit_dir;
+    }
+    if (const char* cache_home = std::getenv("XDG_CACHE_HOME")) {
+        return std::string(cache_home) + "/ccc/results";
+    }
+    if (const char* home = std::getenv("HOME")) {
+        return std::string(home) + "/.cache/ccc/results";
+    }
+    return "ccc_results";
+}
+
+std::string ResultCache::make_key(const uint8_t* data, size_t size, const std::string& parameters) {
+    uint64_t content_hash = fast_hash64(data, size);
+    // Archive version and input size are part of the key so format changes never collide
+    std::string tagged = parameters + ";archive=" + std::to_string(kArchiveVersion) +
+                         ";size=" + std::to_string(size);
+    uint64_t parameter_hash = fast_hash64(tagged.data(), tagged.size(), content_hash);
+    return hash_to_hex(content_hash) + hash_to_hex(parameter_hash);
+}
+
+std::string ResultCache::entry_path(const std::string& key) const {
+    return (fs::path(directory_) / (key + kEntryExtension)).string();
+}
+
+bool ResultCache::lookup(const std::string& key, std::vector<int>& codes, CompressionMetadata& metadata) {
+    const std::string path = entry_path(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        ++misses_;
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+
+    try {
+        auto result = deserialize_archive(bytes.data(), bytes.size());
+        codes = std::move(result.first);
+        metadata = std::move(result.second);
+    } catch (const std::exception&) {
+        std::error_code ec;
+        fs::remove(path, ec);
+        ++misses_;
+        return false;
+    }
+
+    // Modification time doubles as the LRU timestamp
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    ++hits_;
+    return true;
+}
+
+void ResultCache::store(const std::string& key, const std::vector<int>& codes, const CompressionMetadata& metadata) {
+    try {
+        write_archive(entry_path(key), codes, metadata);
+    } catch (const std::exception&) {
+        return;
+    }
+    evict();
+}
+
+uint64_t ResultCache::size_bytes() const {
+    uint64_t total = 0;
+    for (const CacheEntry& entry : list_entries(directory_)) {
+        total += entry.size;
+    }
+    return total;
+}
+
+void ResultCache::clear() {
+    for (const CacheEntry& entry : list_entries(directory_)) {
+        std::error_code ec;
+        fs::remove(entry.path, ec);
+    }
+}
+
+void ResultCache::evict() {
+    std::lock_guard<std::mutex> lock(evict_mutex_);
+    std::vector<CacheEntry> entries = list_entries(directory_);
+    uint64_t total = 0;
+    for (const CacheEntry& entry : entries) {
+        total += entry.size;
+    }
+    if (total <= max_bytes_) {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const CacheEntry& a, const CacheEntry& b) {
+        return a.last_used < b.last_used;
+    });
+    for (const CacheEntry& entry : entries) {
+        if (total <= max_bytes_) {
+            break;
+        }
+        std::error_code ec;
+        fs::remove(entry.path, ec);
+        total -= entry.size;
+    }
+}
+
+} // namespace ccc
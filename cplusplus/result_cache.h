@@ -0,0 +1,90 @@
+/**
+ * Content-addressed Result Cache - C++ Implementation
+ *
+ * On-disk cache of compressed archives keyed by a fast hash of the input plus
+ * every parameter that changes the compressed output. Re-compressing an input
+ * that is already cached costs one hash pass and one archive read. The cache
+ * directory is bounded in size with least-recently-used eviction, so it can
+ * be shared by concurrent jobs.
+ */
+
+#ifndef CCC_RESULT_CACHE_H
+#define CCC_RESULT_CACHE_H
+
+#include "circular_chromosome_compression.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ccc {
+
+class ResultCache {
+public:
+    static constexpr uint64_t kDefaultMaxBytes = 1024ULL * 1048576;
+
+    /**
+     * @param directory Cache directory, created on first store
+     * @param max_bytes Total size of cached archives before LRU eviction
+     */
+    explicit ResultCache(std::string directory = default_directory(), uint64_t max_bytes = kDefaultMaxBytes);
+
+    /**
+     * $CCC_CACHE_DIR if set, else $XDG_CACHE_HOME/ccc/results,
+     * else $HOME/.cache/ccc/results
+     */
+    static std::string default_directory();
+
+    /**
+     * Cache key for an input and the output-affecting compression parameters
+     *
+     * @param data Input bytes
+     * @param size Number of input bytes
+     * @param parameters Canonical description of the compression parameters
+     * @return 32 hex characters (input hash followed by parameter hash)
+     */
+    static std::string make_key(const uint8_t* data, size_t size, const std::string& parameters);
+
+    /**
+     * Load a cached result and mark it most recently used
+     *
+     * @return False on a miss; unreadable or corrupt entries count as misses and are removed
+     */
+    bool lookup(const std::string& key, std::vector<int>& codes, CompressionMetadata& metadata);
+
+    /**
+     * Store a result, then evict least recently used entries beyond max_bytes
+     * Write failures are ignored so a full or read-only cache never fails compression.
+     */
+    void store(const std::string& key, const std::vector<int>& codes, const CompressionMetadata& metadata);
+
+    /**
+     * Total bytes of cached archives currently on disk
+     */
+    uint64_t size_bytes() const;
+
+    /**
+     * Remove every cached archive
+     */
+    void clear();
+
+    const std::string& directory() const { return directory_; }
+    uint64_t max_bytes() const { return max_bytes_; }
+    size_t hits() const { return hits_; }
+    size_t misses() const { return misses_; }
+
+private:
+    std::string entry_path(const std::string& key) const;
+    void evict();
+
+    std::string directory_;
+    uint64_t max_bytes_;
+    std::atomic<size_t> hits_;
+    std::atomic<size_t> misses_;
+    std::mutex evict_mutex_;
+};
+
+} // namespace ccc
+
+#endif // CCC_RESULT_CACHE_H
@@ -0,0 +1,501 @@
+/**
+ * Vectorized Sequence Analytics - C++ Implementation
+ */
+
+#include "sequence_analytics.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define CCC_HAVE_SSE2 1
+#endif
+
+namespace ccc {
+
+namespace {
+
+constexpr size_t kChunkBases = 1048576;
+constexpr uint8_t kCaseMask = 0xDF;  // clears the ASCII lowercase bit
+
+inline char upper(char ch) {
+    return static_cast<char>(static_cast<uint8_t>(ch) & kCaseMask);
+}
+
+inline bool is_acgt(char ch) {
+    char up = upper(ch);
+    return up == 'A' || up == 'C' || up == 'G' || up == 'T';
+}
+
+inline size_t count_trailing_zeros(uint32_t mask) {
+    return static_cast<size_t>(__builtin_ctz(mask));
+}
+
+/**
+ * Early-exit validation kernel
+ */
+size_t first_invalid_kernel(const char* seq, size_t length, bool allow_n) {
+    size_t i = 0;
+#ifdef CCC_HAVE_SSE2
+    const __m128i case_mask = _mm_set1_epi8(static_cast<char>(kCaseMask));
+    const __m128i va = _mm_set1_epi8('A'), vc = _mm_set1_epi8('C');
+    const __m128i vg = _mm_set1_epi8('G'), vt = _mm_set1_epi8('T'), vn = _mm_set1_epi8('N');
+    for (; i + 16 <= length; i += 16) {
+        __m128i up = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(seq + i)), case_mask);
+        __m128i ok = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(up, va), _mm_cmpeq_epi8(up, vc)),
+                                  _mm_or_si128(_mm_cmpeq_epi8(up, vg), _mm_cmpeq_epi8(up, vt)));
+        if (allow_n) {
+            ok = _mm_or_si128(ok, _mm_cmpeq_epi8(up, vn));
+        }
+        uint32_t bad = ~static_cast<uint32_t>(_mm_movemask_epi8(ok)) & 0xFFFFu;
+        if (bad != 0) {
+            return i + count_trailing_zeros(bad);
+        }
+    }
+#endif
+    for (; i < length; ++i) {
+        if (!is_acgt(seq[i]) && !(allow_n && upper(seq[i]) == 'N')) {
+            return i;
+        }
+    }
+    return SequenceAnalyzer::npos;
+}
+
+/**
+ * Counts A/C/G/T/N and records the first non-ACGT position
+ */
+void composition_kernel(const char* seq, size_t length, size_t counts[6], size_t& first_invalid) {
+    size_t acgtn[5] = {0, 0, 0, 0, 0};
+    first_invalid = SequenceAnalyzer::npos;
+    size_t i = 0;
+
+#ifdef CCC_HAVE_SSE2
+    const __m128i case_mask = _mm_set1_epi8(static_cast<char>(kCaseMask));
+    const __m128i targets[5] = {_mm_set1_epi8('A'), _mm_set1_epi8('C'), _mm_set1_epi8('G'),
+                                _mm_set1_epi8('T'), _mm_set1_epi8('N')};
+    const __m128i zero = _mm_setzero_si128();
+
+    while (i + 16 <= length) {
+        // Byte lanes count up to 255 matches before they are flushed with SAD
+        __m128i acc[5] = {zero, zero, zero, zero, zero};
+        size_t blocks = std::min<size_t>((length - i) / 16, 255);
+        for (size_t b = 0; b < blocks; ++b, i += 16) {
+            __m128i up = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(seq + i)), case_mask);
+            __m128i valid = zero;
+            for (int k = 0; k < 4; ++k) {
+                __m128i eq = _mm_cmpeq_epi8(up, targets[k]);
+                acc[k] = _mm_sub_epi8(acc[k], eq);
+                valid = _mm_or_si128(valid, eq);
+            }
+            acc[4] = _mm_sub_epi8(acc[4], _mm_cmpeq_epi8(up, targets[4]));
+            if (first_invalid == SequenceAnalyzer::npos) {
+                uint32_t bad = ~static_cast<uint32_t>(_mm_movemask_epi8(valid)) & 0xFFFFu;
+                if (bad != 0) {
+                    first_invalid = i + count_trailing_zeros(bad);
+                }
+            }
+        }
+        for (int k = 0; k < 5; ++k) {
+            __m128i sums = _mm_sad_epu8(acc[k], zero);
+            acgtn[k] += static_cast<size_t>(_mm_cvtsi128_si32(sums)) +
+                        static_cast<size_t>(_mm_extract_epi16(sums, 4));
+        }
+    }
+#endif
+
+    for (; i < length; ++i) {
+        switch (upper(seq[i])) {
+            case 'A': acgtn[0]++; continue;
+            case 'C': acgtn[1]++; continue;
+            case 'G': acgtn[2]++; continue;
+            case 'T': acgtn[3]++; continue;
+            case 'N': acgtn[4]++; break;
+            default: break;
+        }
+        if (first_invalid == SequenceAnalyzer::npos) {
+            first_invalid = i;
+        }
+    }
+
+    size_t known = 0;
+    for (int k = 0; k < 5; ++k) {
+        counts[k] = acgtn[k];
+        known += acgtn[k];
+    }
+    counts[5] = length - known;
+}
+
+/**
+ * Appends maximal N runs (positions relative to seq)
+ */
+void n_run_kernel(const char* seq, size_t length, size_t offset, std::vector<NRun>& runs) {
+    bool in_run = false;
+    size_t run_start = 0;
+    auto step = [&](size_t pos, bool is_n) {
+        if (is_n && !in_run) {
+            in_run = true;
+            run_start = pos;
+        } else if (!is_n && in_run) {
+            in_run = false;
+            runs.push_back({offset + run_start, pos - run_start});
+        }
+    };
+
+    size_t i = 0;
+#ifdef CCC_HAVE_SSE2
+    const __m128i case_mask = _mm_set1_epi8(static_cast<char>(kCaseMask));
+    const __m128i vn = _mm_set1_epi8('N');
+    for (; i + 16 <= length; i += 16) {
+        __m128i up = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(seq + i)), case_mask);
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(up, vn)));
+        if (mask == 0) {
+            step(i, false);
+        } else if (mask == 0xFFFFu) {
+            step(i, true);
+        } else {
+            for (size_t b = 0; b < 16; ++b) {
+                step(i + b, (mask >> b) & 1u);
+            }
+        }
+    }
+#endif
+    for (; i < length; ++i) {
+        step(i, upper(seq[i]) == 'N');
+    }
+    if (in_run) {
+        runs.push_back({offset + run_start, length - run_start});
+    }
+}
+
+/**
+ * Calls on_boundary(j) for every j in [1, length) where seq[j] differs from seq[j-1]
+ */
+template <typename Callback>
+void run_boundary_kernel(const char* seq, size_t length, Callback&& on_boundary) {
+    size_t j = 1;
+#ifdef CCC_HAVE_SSE2
+    const __m128i case_mask = _mm_set1_epi8(static_cast<char>(kCaseMask));
+    for (; j + 16 <= length; j += 16) {
+        __m128i cur = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(seq + j)), case_mask);
+        __m128i prev = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(seq + j - 1)), case_mask);
+        uint32_t diff = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(cur, prev))) & 0xFFFFu;
+        while (diff != 0) {
+            on_boundary(j + count_trailing_zeros(diff));
+            diff &= diff - 1;
+        }
+    }
+#endif
+    for (; j < length; ++j) {
+        if (upper(seq[j]) != upper(seq[j - 1])) {
+            on_boundary(j);
+        }
+    }
+}
+
+std::array<uint32_t, 256> make_packed_ascii_lut() {
+    static const char bases[4] = {'A', 'C', 'G', 'T'};
+    std::array<uint32_t, 256> lut{};
+    for (uint32_t byte = 0; byte < 256; ++byte) {
+        char chars[4] = {bases[(byte >> 6) & 3u], bases[(byte >> 4) & 3u],
+                         bases[(byte >> 2) & 3u], bases[byte & 3u]};
+        std::memcpy(&lut[byte], chars, 4);
+    }
+    return lut;
+}
+
+void unpack_to_ascii(const uint8_t* packed, size_t first_base, size_t num_bases, char* out) {
+    static const std::array<uint32_t, 256> lut = make_packed_ascii_lut();
+    static const char bases[4] = {'A', 'C', 'G', 'T'};
+    size_t pos = first_base;
+    size_t end = first_base + num_bases;
+    // Unaligned head, whole bytes, unaligned tail
+    for (; pos < end && (pos & 3) != 0; ++pos) {
+        *out++ = bases[(packed[pos >> 2] >> (6 - 2 * (pos & 3))) & 3u];
+    }
+    for (; pos + 4 <= end; pos += 4, out += 4) {
+        std::memcpy(out, &lut[packed[pos >> 2]], 4);
+    }
+    for (; pos < end; ++pos) {
+        *out++ = bases[(packed[pos >> 2] >> (6 - 2 * (pos & 3))) & 3u];
+    }
+}
+
+} // namespace
+
+double BaseComposition::gc_content() const {
+    size_t length = total();
+    return length == 0 ? 0.0 : static_cast<double>(g + c) / length * 100.0;
+}
+
+size_t HomopolymerStats::runs_at_least(size_t min_length) const {
+    size_t count = 0;
+    for (size_t len = std::max<size_t>(min_length, 1); len < length_histogram.size(); ++len) {
+        count += length_histogram[len];
+    }
+    return count;
+}
+
+struct SequenceAnalyzer::ChunkStats {
+    size_t offset = 0;
+    size_t length = 0;
+    size_t counts[6] = {0, 0, 0, 0, 0, 0};
+    size_t first_invalid = npos;
+    std::vector<NRun> n_runs;
+
+    // Homopolymer runs strictly inside the chunk; the first and last run may
+    // continue into neighbouring chunks and are resolved during merge
+    std::vector<size_t> histogram;
+    size_t interior_count = 0;
+    size_t interior_bases = 0;
+    size_t max_length = 0;
+    size_t max_position = 0;
+    char max_base = 0;
+    size_t first_run_length = 0;
+    size_t last_run_start = 0;
+    bool single_run = false;
+    char first_base = 0;
+    char last_base = 0;
+};
+
+SequenceAnalyzer::SequenceAnalyzer(size_t num_threads, size_t parallel_threshold)
+    : num_threads_(num_threads), parallel_threshold_(parallel_threshold) {
+}
+
+size_t SequenceAnalyzer::thread_count(size_t num_chunks) const {
+    size_t threads = num_threads_ == 0 ? ThreadPool::default_thread_count() : num_threads_;
+    return std::max<size_t>(1, std::min(threads, num_chunks));
+}
+
+void SequenceAnalyzer::scan_chunk(const char* seq, size_t offset, size_t length, unsigned flags,
+                                  ChunkStats& stats) const {
+    stats.offset = offset;
+    stats.length = length;
+
+    if (flags & kScanComposition) {
+        size_t first_invalid = npos;
+        composition_kernel(seq, length, stats.counts, first_invalid);
+        stats.first_invalid = (first_invalid == npos) ? npos : offset + first_invalid;
+    }
+
+    if (flags & kScanNRuns) {
+        n_run_kernel(seq, length, offset, stats.n_runs);
+    }
+
+    if ((flags & kScanHomopolymers) && length > 0) {
+        stats.histogram.assign(HomopolymerStats::kMaxTrackedRun + 1, 0);
+        stats.first_base = upper(seq[0]);
+        size_t run_start = 0;
+        bool first_closed = false;
+
+        run_boundary_kernel(seq, length, [&](size_t boundary) {
+            if (!first_closed) {
+                stats.first_run_length = boundary;
+                first_closed = true;
+            } else {
+                char base = upper(seq[run_start]);
+                size_t run_length = boundary - run_start;
+                if (is_acgt(base)) {
+                    stats.interior_count++;
+                    stats.interior_bases += run_length;
+                    stats.histogram[std::min(run_length, HomopolymerStats::kMaxTrackedRun)]++;
+                    if (run_length > stats.max_length) {
+                        stats.max_length = run_length;
+                        stats.max_position = offset + run_start;
+                        stats.max_base = base;
+                    }
+                }
+            }
+            run_start = boundary;
+        });
+
+        if (!first_closed) {
+            stats.single_run = true;
+            stats.first_run_length = length;
+        }
+        stats.last_run_start = offset + run_start;
+        stats.last_base = upper(seq[run_start]);
+    }
+}
+
+SequenceReport SequenceAnalyzer::merge(std::vector<ChunkStats>& chunks, size_t length, unsigned flags) const {
+    SequenceReport report;
+    report.length = length;
+    HomopolymerStats& homo = report.homopolymers;
+    homo.length_histogram.assign(HomopolymerStats::kMaxTrackedRun + 1, 0);
+    size_t run_bases = 0;
+
+    // Open homopolymer run carried across chunk boundaries
+    bool open = false;
+    size_t open_start = 0;
+    size_t open_length = 0;
+    char open_base = 0;
+    auto close_run = [&](size_t start, size_t run_length, char base) {
+        if (!is_acgt(base)) {
+            return;
+        }
+        homo.run_count++;
+        run_bases += run_length;
+        homo.length_histogram[std::min(run_length, HomopolymerStats::kMaxTrackedRun)]++;
+        if (run_length > homo.max_run_length) {
+            homo.max_run_length = run_length;
+            homo.max_run_position = start;
+            homo.max_run_base = base;
+        }
+    };
+
+    size_t first_invalid = npos;
+    for (auto& chunk : chunks) {
+        if (flags & kScanComposition) {
+            report.composition.a += chunk.counts[0];
+            report.composition.c += chunk.counts[1];
+            report.composition.g += chunk.counts[2];
+            report.composition.t += chunk.counts[3];
+            report.composition.n += chunk.counts[4];
+            report.composition.other += chunk.counts[5];
+            if (first_invalid == npos) {
+                first_invalid = chunk.first_invalid;
+            }
+        }
+
+        if (flags & kScanNRuns) {
+            for (const NRun& run : chunk.n_runs) {
+                if (!report.n_runs.empty() &&
+                    report.n_runs.back().start + report.n_runs.back().length == run.start) {
+                    report.n_runs.back().length += run.length;
+                } else {
+                    report.n_runs.push_back(run);
+                }
+            }
+        }
+
+        if ((flags & kScanHomopolymers) && chunk.length > 0) {
+            if (open && open_base == chunk.first_base) {
+                open_length += chunk.first_run_length;
+            } else {
+                if (open) {
+                    close_run(open_start, open_length, open_base);
+                }
+                open = true;
+                open_start = chunk.offset;
+                open_length = chunk.first_run_length;
+                open_base = chunk.first_base;
+            }
+
+            if (!chunk.single_run) {
+                close_run(open_start, open_length, open_base);
+                homo.run_count += chunk.interior_count;
+                run_bases += chunk.interior_bases;
+                for (size_t len = 0; len < chunk.histogram.size(); ++len) {
+                    homo.length_histogram[len] += chunk.histogram[len];
+                }
+                if (chunk.max_length > homo.max_run_length) {
+                    homo.max_run_length = chunk.max_length;
+                    homo.max_run_position = chunk.max_position;
+                    homo.max_run_base = chunk.max_base;
+                }
+                open_start = chunk.last_run_start;
+                open_length = chunk.offset + chunk.length - chunk.last_run_start;
+                open_base = chunk.last_base;
+            }
+        }
+    }
+    if (open) {
+        close_run(open_start, open_length, open_base);
+    }
+
+    homo.mean_run_length = homo.run_count == 0 ? 0.0 : static_cast<double>(run_bases) / homo.run_count;
+    report.valid = (first_invalid == npos);
+    report.first_invalid = report.valid ? 0 : first_invalid;
+    report.gc_content = report.composition.gc_content();
+    return report;
+}
+
+SequenceReport SequenceAnalyzer::scan(const char* seq, size_t length, unsigned flags) const {
+    const size_t num_chunks = (length + kChunkBases - 1) / kChunkBases;
+    std::vector<ChunkStats> chunks(num_chunks);
+    auto scan_one = [&](size_t k) {
+        size_t offset = k * kChunkBases;
+        scan_chunk(seq + offset, offset, std::min(kChunkBases, length - offset), flags, chunks[k]);
+    };
+
+    if (length >= parallel_threshold_ && thread_count(num_chunks) > 1) {
+        ThreadPool pool(thread_count(num_chunks));
+        pool.parallel_for(num_chunks, scan_one);
+    } else {
+        for (size_t k = 0; k < num_chunks; ++k) {
+            scan_one(k);
+        }
+    }
+    return merge(chunks, length, flags);
+}
+
+size_t SequenceAnalyzer::find_first_invalid(const char* seq, size_t length, bool allow_n) const {
+    const size_t num_chunks = (length + kChunkBases - 1) / kChunkBases;
+    if (length < parallel_threshold_ || thread_count(num_chunks) <= 1) {
+        return first_invalid_kernel(seq, length, allow_n);
+    }
+
+    // Chunks past an already-found error are skipped
+    std::atomic<size_t> found{npos};
+    ThreadPool pool(thread_count(num_chunks));
+    pool.parallel_for(num_chunks, [&](size_t k) {
+        size_t offset = k * kChunkBases;
+        if (offset >= found.load(std::memory_order_relaxed)) {
+            return;
+        }
+        size_t pos = first_invalid_kernel(seq + offset, std::min(kChunkBases, length - offset), allow_n);
+        if (pos != npos) {
+            size_t absolute = offset + pos;
+            size_t current = found.load();
+            while (absolute < current && !found.compare_exchange_weak(current, absolute)) {
+            }
+        }
+    });
+    return found.load();
+}
+
+BaseComposition SequenceAnalyzer::composition(const char* seq, size_t length) const {
+    return scan(seq, length, kScanComposition).composition;
+}
+
+std::vector<NRun> SequenceAnalyzer::find_n_runs(const char* seq, size_t length) const {
+    return scan(seq, length, kScanNRuns).n_runs;
+}
+
+HomopolymerStats SequenceAnalyzer::homopolymer_stats(const char* seq, size_t length) const {
+    return scan(seq, length, kScanHomopolymers).homopolymers;
+}
+
+SequenceReport SequenceAnalyzer::analyze(const char* seq, size_t length) const {
+    return scan(seq, length, kScanAll);
+}
+
+SequenceReport SequenceAnalyzer::analyze_packed(const uint8_t* packed, size_t num_bases) const {
+    const size_t num_chunks = (num_bases + kChunkBases - 1) / kChunkBases;
+    std::vector<ChunkStats> chunks(num_chunks);
+
+    // Packed input cannot hold N or invalid bases; unpack chunk-wise into a
+    // cache-resident ASCII buffer and reuse the text kernels
+    auto scan_one = [&](size_t k) {
+        size_t offset = k * kChunkBases;
+        size_t length = std::min(kChunkBases, num_bases - offset);
+        std::vector<char> ascii(length);
+        unpack_to_ascii(packed, offset, length, ascii.data());
+        scan_chunk(ascii.data(), offset, length, kScanComposition | kScanHomopolymers, chunks[k]);
+    };
+
+    if (num_bases >= parallel_threshold_ && thread_count(num_chunks) > 1) {
+        ThreadPool pool(thread_count(num_chunks));
+        pool.parallel_for(num_chunks, scan_one);
+    } else {
+        for (size_t k = 0; k < num_chunks; ++k) {
+            scan_one(k);
+        }
+    }
+    return merge(chunks, num_bases, kScanComposition | kScanHomopolymers);
+}
+
+} // namespace ccc
@@ -0,0 +1,150 @@
+/**
+ * Vectorized Sequence Analytics - C++ Implementation
+ *
+ * SIMD kernels for the per-genome scans that previously ran as scalar
+ * per-character loops: validation, GC content, base composition, N-run
+ * detection and homopolymer statistics. Works on ASCII nucleotide text or on
+ * 2-bit packed bases (the binary_to_dna() layout) and splits large inputs
+ * across threads.
+ */
+
+#ifndef CCC_SEQUENCE_ANALYTICS_H
+#define CCC_SEQUENCE_ANALYTICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ccc {
+
+/**
+ * Per-base counts; lowercase bases are counted with their uppercase form
+ */
+struct BaseComposition {
+    size_t a = 0;
+    size_t c = 0;
+    size_t g = 0;
+    size_t t = 0;
+    size_t n = 0;
+    size_t other = 0;
+
+    size_t total() const { return a + c + g + t + n + other; }
+
+    /**
+     * GC percentage of all characters (same definition as calculate_gc_content)
+     */
+    double gc_content() const;
+};
+
+/**
+ * Maximal run of N/n characters
+ */
+struct NRun {
+    size_t start = 0;
+    size_t length = 0;
+};
+
+/**
+ * Statistics over maximal runs of one repeated A/C/G/T base (case-insensitive)
+ */
+struct HomopolymerStats {
+    static constexpr size_t kMaxTrackedRun = 64;
+
+    size_t run_count = 0;
+    size_t max_run_length = 0;
+    char max_run_base = 0;
+    size_t max_run_position = 0;
+    double mean_run_length = 0.0;
+    std::vector<size_t> length_histogram;  // index = run length; last bucket = kMaxTrackedRun or longer
+
+    /**
+     * Number of runs of at least min_length bases
+     */
+    size_t runs_at_least(size_t min_length) const;
+};
+
+/**
+ * Combined result of SequenceAnalyzer::analyze()
+ */
+struct SequenceReport {
+    size_t length = 0;
+    bool valid = true;            // only A/C/G/T (any case)
+    size_t first_invalid = 0;     // position of the first other character when !valid
+    BaseComposition composition;
+    double gc_content = 0.0;
+    std::vector<NRun> n_runs;
+    HomopolymerStats homopolymers;
+};
+
+/**
+ * SIMD sequence scanner
+ * Inputs at or above the parallel threshold are split into chunks scanned
+ * concurrently and merged in order, so results are identical to a serial scan.
+ */
+class SequenceAnalyzer {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    /**
+     * @param num_threads Worker threads for large inputs; 0 uses the hardware concurrency
+     * @param parallel_threshold Minimum input length (bases) before scanning in parallel
+     */
+    explicit SequenceAnalyzer(size_t num_threads = 0, size_t parallel_threshold = 4 * 1048576);
+
+    /**
+     * Position of the first character that is not A/C/G/T (any case)
+     *
+     * @param allow_n If true, N/n is also accepted
+     * @return Position, or npos if the whole sequence is valid
+     */
+    size_t find_first_invalid(const char* seq, size_t length, bool allow_n = false) const;
+    size_t find_first_invalid(const std::string& seq, bool allow_n = false) const {
+        return find_first_invalid(seq.data(), seq.size(), allow_n);
+    }
+
+    BaseComposition composition(const char* seq, size_t length) const;
+    double gc_content(const std::string& seq) const {
+        return composition(seq.data(), seq.size()).gc_content();
+    }
+
+    std::vector<NRun> find_n_runs(const char* seq, size_t length) const;
+    HomopolymerStats homopolymer_stats(const char* seq, size_t length) const;
+
+    /**
+     * Run every scan over ASCII nucleotide text
+     */
+    SequenceReport analyze(const char* seq, size_t length) const;
+    SequenceReport analyze(const std::string& seq) const { return analyze(seq.data(), seq.size()); }
+
+    /**
+     * Run every scan over 2-bit packed bases, four per byte, most significant
+     * pair first (A=00, C=01, G=10, T=11) - i.e. raw bytes as binary_to_dna() sees them
+     *
+     * @param packed Packed bases
+     * @param num_bases Number of bases (at most 4 * packed bytes)
+     */
+    SequenceReport analyze_packed(const uint8_t* packed, size_t num_bases) const;
+
+private:
+    struct ChunkStats;
+
+    enum ScanFlags : unsigned {
+        kScanComposition = 1u,
+        kScanNRuns = 2u,
+        kScanHomopolymers = 4u,
+        kScanAll = 7u
+    };
+
+    void scan_chunk(const char* seq, size_t offset, size_t length, unsigned flags, ChunkStats& stats) const;
+    SequenceReport scan(const char* seq, size_t length, unsigned flags) const;
+    SequenceReport merge(std::vector<ChunkStats>& chunks, size_t length, unsigned flags) const;
+    size_t thread_count(size_t num_chunks) const;
+
+    size_t num_threads_;
+    size_t parallel_threshold_;
+};
+
+} // namespace ccc
+
+#endif // CCC_SEQUENCE_ANALYTICS_H
@@ -0,0 +1,340 @@
+/**
+ * Compressed in-memory sequence store
+ */
+
+#include "sequence_store.h"
+#include "dvnp_codec.h"
+#include "thread_pool.h"
+#include "twobit.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+
+namespace ccc {
+
+namespace {
+
+constexpr char kStoreBases[4] = {'A', 'C', 'G', 'T'};
+constexpr size_t kMinSlabBytes = 65536;
+constexpr size_t kMaxSlabBytes = 4 * 1048576;
+
+unsigned bit_width(uint32_t value) {
+    unsigned width = 1;
+    while (width < 32 && (value >> width) != 0) {
+        ++width;
+    }
+    return width;
+}
+
+std::vector<uint8_t> pack_codes(const std::vector<int>& codes, unsigned width) {
+    std::vector<uint8_t> bytes((codes.size() * width + 7) / 8, 0);
+    size_t bit = 0;
+    for (int code : codes) {
+        uint64_t value = static_cast<uint32_t>(code);
+        for (unsigned written = 0; written < width;) {
+            unsigned take = std::min<unsigned>(8 - (bit & 7), width - written);
+            bytes[bit >> 3] |= static_cast<uint8_t>(((value >> written) & ((1u << take) - 1)) << (bit & 7));
+            bit += take;
+            written += take;
+        }
+    }
+    return bytes;
+}
+
+void unpack_codes(const uint8_t* bytes, size_t count, unsigned width, std::vector<int>& codes) {
+    codes.resize(count);
+    const uint64_t mask = (uint64_t(1) << width) - 1;
+    size_t bit = 0;
+    for (size_t i = 0; i < count; ++i) {
+        // A code spans at most five bytes
+        uint64_t window = 0;
+        size_t first = bit >> 3;
+        size_t last = (bit + width - 1) >> 3;
+        for (size_t b = last + 1; b-- > first;) {
+            window = (window << 8) | bytes[b];
+        }
+        codes[i] = static_cast<int>((window >> (bit & 7)) & mask);
+        bit += width;
+    }
+}
+
+/**
+ * Apply N runs and soft masking that overlap [start, start + text.size())
+ */
+void apply_runs(std::string& text, size_t start, const std::vector<BaseRun>& runs, bool mask) {
+    const size_t end = start + text.size();
+    // Runs ascend by start; skip those ending before the range
+    auto it = std::upper_bound(runs.begin(), runs.end(), start,
+                               [](size_t position, const BaseRun& run) { return position < run.start + run.length; });
+    for (; it != runs.end() && it->start < end; ++it) {
+        size_t from = std::max(it->start, start);
+        size_t to = std::min(it->start + it->length, end);
+        for (size_t i = from; i < to; ++i) {
+            char& ch = text[i - start];
+            ch = mask ? static_cast<char>(std::tolower(static_cast<unsigned char>(ch))) : 'N';
+        }
+    }
+}
+
+uint64_t cache_key(size_t id, size_t index) {
+    return (static_cast<uint64_t>(id) << 32) | static_cast<uint32_t>(index);
+}
+
+size_t runs_bytes(const std::vector<BaseRun>& runs) {
+    return runs.capacity() * sizeof(BaseRun);
+}
+
+} // namespace
+
+SequenceStore::SequenceStore(const SequenceStoreOptions& options)
+    : options_(options) {
+    if (options_.block_bases == 0 || options_.block_bases % 4 != 0 || options_.block_bases / 4 > UINT32_MAX) {
+        throw std::invalid_argument("Sequence store block size must be a positive multiple of 4 bases, got " +
+                                    std::to_string(options_.block_bases));
+    }
+    if (options_.max_dict_size < 16) {
+        throw std::invalid_argument("Dictionary size must be at least 16 codes, got " +
+                                    std::to_string(options_.max_dict_size));
+    }
+    pool_ = std::make_unique<ThreadPool>(options_.num_threads == 0 ? ThreadPool::default_thread_count()
+                                                                   : options_.num_threads);
+}
+
+SequenceStore::~SequenceStore() = default;
+
+SequenceStore::PendingSequence SequenceStore::compress(const std::string& name, const std::string& bases) const {
+    TwoBitRecord record = TwoBitRecord::from_sequence(name, bases);
+    PendingSequence pending;
+    Sequence& sequence = pending.sequence;
+    sequence.name = name;
+    sequence.length = record.length;
+    sequence.n_blocks = std::move(record.n_blocks);
+    sequence.mask_blocks = std::move(record.mask_blocks);
+
+    const size_t block_bytes = options_.block_bases / 4;
+    const size_t count = (record.packed.size() + block_bytes - 1) / block_bytes;
+    sequence.blocks.resize(count);
+    pending.payloads.resize(count);
+
+    DvnpEncoder encoder(options_.max_dict_size);
+    std::vector<uint8_t> symbols(block_bytes * 4);
+    std::vector<int> codes;
+    for (size_t b = 0; b < count; ++b) {
+        const uint8_t* packed = record.packed.data() + b * block_bytes;
+        size_t size = std::min(block_bytes, record.packed.size() - b * block_bytes);
+        bytes_to_symbols(packed, size, symbols.data());
+        codes.clear();
+        encoder.encode(symbols.data(), size * 4, codes);
+
+        Block& block = sequence.blocks[b];
+        unsigned width = bit_width(options_.max_dict_size);
+        std::vector<uint8_t> payload = pack_codes(codes, width);
+        if (payload.size() < size) {
+            block.code_count = static_cast<uint32_t>(codes.size());
+            block.code_width = static_cast<uint8_t>(width);
+            pending.payloads[b] = std::move(payload);
+        } else {
+            // Incompressible block: packed bases are already 2 bits each
+            pending.payloads[b].assign(packed, packed + size);
+        }
+        block.payload_bytes = static_cast<uint32_t>(pending.payloads[b].size());
+    }
+    return pending;
+}
+
+SequenceStore::Block SequenceStore::arena_store(const std::vector<uint8_t>& payload) {
+    if (slabs_.empty() || slab_capacity_ - slab_used_ < payload.size()) {
+        // Slabs double up to kMaxSlabBytes, so small stores reserve little.
+        // Payloads never straddle slabs; an oversized payload gets a slab of its own.
+        size_t next = slabs_.empty() ? kMinSlabBytes : std::min(kMaxSlabBytes, slab_capacity_ * 2);
+        slab_capacity_ = std::max(next, payload.size());
+        slabs_.emplace_back(new uint8_t[slab_capacity_]);
+        slab_used_ = 0;
+        arena_reserved_ += slab_capacity_;
+    }
+    Block block;
+    block.slab = static_cast<uint32_t>(slabs_.size() - 1);
+    block.slab_offset = static_cast<uint32_t>(slab_used_);
+    if (!payload.empty()) {
+        std::memcpy(slabs_.back().get() + slab_used_, payload.data(), payload.size());
+    }
+    slab_used_ += payload.size();
+    arena_used_ += payload.size();
+    return block;
+}
+
+SequenceStore::SequenceId SequenceStore::append(PendingSequence&& pending) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    Sequence& sequence = pending.sequence;
+    for (size_t b = 0; b < sequence.blocks.size(); ++b) {
+        Block placed = arena_store(pending.payloads[b]);
+        sequence.blocks[b].slab = placed.slab;
+        sequence.blocks[b].slab_offset = placed.slab_offset;
+    }
+    SequenceId id = sequences_.size();
+    names_.emplace(sequence.name, id);
+    sequences_.push_back(std::move(sequence));
+    return id;
+}
+
+SequenceStore::SequenceId SequenceStore::insert(const std::string& name, const std::string& sequence) {
+    return append(compress(name, sequence));
+}
+
+std::vector<SequenceStore::SequenceId> SequenceStore::insert_batch(
+    const std::vector<std::pair<std::string, std::string>>& sequences) {
+    std::vector<PendingSequence> pending(sequences.size());
+    pool_->parallel_for(sequences.size(), [&](size_t i) {
+        pending[i] = compress(sequences[i].first, sequences[i].second);
+    });
+    std::vector<SequenceId> ids;
+    ids.reserve(pending.size());
+    for (PendingSequence& sequence : pending) {
+        ids.push_back(append(std::move(sequence)));
+    }
+    return ids;
+}
+
+SequenceStore::PackedBlock SequenceStore::load_block(const Sequence& sequence, SequenceId id, size_t index) const {
+    const uint64_t key = cache_key(id, index);
+    if (options_.cache_bytes > 0) {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        auto it = cache_index_.find(key);
+        if (it != cache_index_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            cache_hits_++;
+            return it->second->second;
+        }
+    }
+    cache_misses_++;
+
+    const Block& block = sequence.blocks[index];
+    const uint8_t* payload;
+    {
+        // Slabs never move or shrink, so the payload stays readable after unlocking
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        payload = slabs_[block.slab].get() + block.slab_offset;
+    }
+    const size_t packed_size = (sequence.length + 3) / 4;
+    const size_t block_bytes = std::min(options_.block_bases / 4, packed_size - index * (options_.block_bases / 4));
+
+    auto packed = std::make_shared<std::vector<uint8_t>>(block_bytes, 0);
+    if (block.code_count == 0) {
+        std::memcpy(packed->data(), payload, block_bytes);
+    } else {
+        std::vector<int> codes;
+        unpack_codes(payload, block.code_count, block.code_width, codes);
+        DvnpDecoder decoder(options_.max_dict_size);
+        size_t bases = decoder.decode(codes.data(), codes.size(), packed->data(), block_bytes * 4);
+        if (bases != block_bytes * 4) {
+            throw std::runtime_error("Sequence store block decoded to " + std::to_string(bases) + " bases, expected " +
+                                     std::to_string(block_bytes * 4));
+        }
+    }
+
+    if (options_.cache_bytes > 0 && packed->size() <= options_.cache_bytes) {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        if (cache_index_.find(key) == cache_index_.end()) {
+            lru_.emplace_front(key, packed);
+            cache_index_[key] = lru_.begin();
+            cache_bytes_ += packed->size();
+            while (cache_bytes_ > options_.cache_bytes) {
+                cache_bytes_ -= lru_.back().second->size();
+                cache_index_.erase(lru_.back().first);
+                lru_.pop_back();
+            }
+        }
+    }
+    return packed;
+}
+
+std::string SequenceStore::get(SequenceId id, size_t start, size_t length) const {
+    const Sequence* sequence;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (id >= sequences_.size()) {
+            throw std::out_of_range("Unknown sequence id " + std::to_string(id));
+        }
+        sequence = &sequences_[id];
+    }
+    if (start > sequence->length) {
+        throw std::out_of_range("Start " + std::to_string(start) + " is past the end of " + sequence->name);
+    }
+    length = std::min(length, sequence->length - start);
+
+    std::string text(length, 'A');
+    const size_t first = start / options_.block_bases;
+    const size_t last = length == 0 ? first : (start + length - 1) / options_.block_bases + 1;
+    for (size_t index = first; index < last; ++index) {
+        PackedBlock packed = load_block(*sequence, id, index);
+        size_t block_start = index * options_.block_bases;
+        size_t from = std::max(start, block_start);
+        size_t to = std::min(start + length, block_start + options_.block_bases);
+        for (size_t i = from; i < to; ++i) {
+            size_t offset = i - block_start;
+            text[i - start] = kStoreBases[((*packed)[offset >> 2] >> (6 - 2 * (offset & 3))) & 3];
+        }
+    }
+    apply_runs(text, start, sequence->n_blocks, false);
+    apply_runs(text, start, sequence->mask_blocks, true);
+    return text;
+}
+
+SequenceStore::SequenceId SequenceStore::find(const std::string& name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = names_.find(name);
+    return it == names_.end() ? npos : it->second;
+}
+
+size_t SequenceStore::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return sequences_.size();
+}
+
+size_t SequenceStore::length(SequenceId id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return sequences_.at(id).length;
+}
+
+std::string SequenceStore::name(SequenceId id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return sequences_.at(id).name;
+}
+
+SequenceStoreUsage SequenceStore::usage() const {
+    SequenceStoreUsage usage;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        usage.sequences = sequences_.size();
+        usage.arena_used_bytes = arena_used_;
+        usage.arena_reserved_bytes = arena_reserved_;
+        usage.index_bytes = sequences_.size() * sizeof(Sequence) + slabs_.capacity() * sizeof(slabs_[0]);
+        for (const Sequence& sequence : sequences_) {
+            usage.bases += sequence.length;
+            usage.blocks += sequence.blocks.size();
+            usage.raw_blocks += std::count_if(sequence.blocks.begin(), sequence.blocks.end(),
+                                              [](const Block& block) { return block.code_count == 0; });
+            // Names are counted twice: once in the sequence, once as the lookup key
+            usage.index_bytes += sequence.blocks.capacity() * sizeof(Block) + runs_bytes(sequence.n_blocks) +
+                                 runs_bytes(sequence.mask_blocks) + 2 * sequence.name.capacity() +
+                                 sizeof(std::pair<std::string, SequenceId>) + sizeof(void*);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        usage.cache_bytes = cache_bytes_;
+    }
+    usage.cache_hits = cache_hits_;
+    usage.cache_misses = cache_misses_;
+    return usage;
+}
+
+void SequenceStore::clear_cache() {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    lru_.clear();
+    cache_index_.clear();
+    cache_bytes_ = 0;
+}
+
+} // namespace ccc
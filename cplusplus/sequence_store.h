@@ -0,0 +1,182 @@
+/**
+ * Compressed In-memory Sequence Store - C++ Implementation
+ *
+ * Holds nucleotide sequences in RAM as DVNP-coded blocks of 2-bit packed
+ * bases in one append-only arena, instead of one byte per base. Ranges are
+ * served by decoding only the blocks they touch; decoded blocks are kept in
+ * a byte-bounded LRU cache so hot regions are decoded once. Batched inserts
+ * are compressed on a thread pool.
+ */
+
+#ifndef CCC_SEQUENCE_STORE_H
+#define CCC_SEQUENCE_STORE_H
+
+#include "archive.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ccc {
+
+class ThreadPool;
+
+struct SequenceStoreOptions {
+    size_t block_bases = 65536;         // bases per independently decodable block (multiple of 4)
+    uint32_t max_dict_size = 4096;      // DVNP dictionary per block; small keeps decode cache resident
+    size_t cache_bytes = 64 * 1048576;  // decoded-block LRU budget (packed bytes); 0 disables caching
+    size_t num_threads = 0;             // batch compression workers; 0 uses the hardware concurrency
+};
+
+/**
+ * Memory accounting of a SequenceStore
+ */
+struct SequenceStoreUsage {
+    size_t sequences = 0;
+    uint64_t bases = 0;
+    size_t blocks = 0;
+    size_t raw_blocks = 0;              // blocks stored packed because coding did not shrink them
+    size_t arena_used_bytes = 0;        // compressed block payloads
+    size_t arena_reserved_bytes = 0;    // arena slabs allocated
+    size_t index_bytes = 0;             // names, block tables, N and mask runs
+    size_t cache_bytes = 0;             // decoded blocks currently cached
+    size_t cache_hits = 0;
+    size_t cache_misses = 0;
+
+    size_t total_bytes() const { return arena_reserved_bytes + index_bytes + cache_bytes; }
+
+    /**
+     * One byte per base (plain std::string storage) over total_bytes()
+     */
+    double bases_per_byte() const { return total_bytes() ? static_cast<double>(bases) / total_bytes() : 0.0; }
+};
+
+class SequenceStore {
+public:
+    using SequenceId = size_t;
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    /**
+     * @throws std::invalid_argument if block_bases is 0 or not a multiple of 4
+     */
+    explicit SequenceStore(const SequenceStoreOptions& options = SequenceStoreOptions());
+    ~SequenceStore();
+
+    SequenceStore(const SequenceStore&) = delete;
+    SequenceStore& operator=(const SequenceStore&) = delete;
+
+    /**
+     * Compress and add one sequence
+     * Lowercase (soft-masked) bases and non-ACGT characters (stored as N)
+     * are kept as run lists, as in .2bit files.
+     *
+     * @return Id of the new sequence
+     */
+    SequenceId insert(const std::string& name, const std::string& sequence);
+
+    /**
+     * Compress a batch of sequences on the thread pool, then add them in order
+     *
+     * @param sequences (name, sequence) pairs
+     * @return Ids of the new sequences, in batch order
+     */
+    std::vector<SequenceId> insert_batch(const std::vector<std::pair<std::string, std::string>>& sequences);
+
+    /**
+     * Bases [start, start + length) of a sequence, decoding only the blocks it touches
+     * Safe to call from several threads, also concurrently with inserts.
+     *
+     * @param length Number of bases; clipped to the end of the sequence
+     * @throws std::out_of_range for an unknown id or a start past the end
+     */
+    std::string get(SequenceId id, size_t start = 0, size_t length = npos) const;
+
+    /**
+     * Id of a sequence by name, or npos
+     */
+    SequenceId find(const std::string& name) const;
+
+    size_t size() const;
+    size_t length(SequenceId id) const;
+    std::string name(SequenceId id) const;
+
+    /**
+     * Current memory usage and cache counters
+     */
+    SequenceStoreUsage usage() const;
+
+    /**
+     * Drop every cached decoded block
+     */
+    void clear_cache();
+
+    const SequenceStoreOptions& options() const { return options_; }
+
+private:
+    struct Block {
+        uint32_t slab = 0;
+        uint32_t slab_offset = 0;
+        uint32_t payload_bytes = 0;
+        uint32_t code_count = 0;        // 0 for a block stored as packed bases
+        uint8_t code_width = 0;
+    };
+
+    struct Sequence {
+        std::string name;
+        size_t length = 0;
+        std::vector<Block> blocks;
+        std::vector<BaseRun> n_blocks;
+        std::vector<BaseRun> mask_blocks;
+    };
+
+    /**
+     * A sequence compressed but not yet placed in the arena
+     */
+    struct PendingSequence {
+        Sequence sequence;
+        std::vector<std::vector<uint8_t>> payloads;
+    };
+
+    using PackedBlock = std::shared_ptr<const std::vector<uint8_t>>;
+
+    PendingSequence compress(const std::string& name, const std::string& bases) const;
+    SequenceId append(PendingSequence&& pending);
+    PackedBlock load_block(const Sequence& sequence, SequenceId id, size_t index) const;
+    Block arena_store(const std::vector<uint8_t>& payload);
+
+    SequenceStoreOptions options_;
+    std::unique_ptr<ThreadPool> pool_;
+
+    // Arena: bump-allocated slabs, so payloads never move as it grows
+    std::vector<std::unique_ptr<uint8_t[]>> slabs_;
+    size_t slab_capacity_ = 0;          // size of the last slab
+    size_t slab_used_ = 0;              // bytes used in the last slab
+    size_t arena_used_ = 0;
+    size_t arena_reserved_ = 0;
+
+    // Guards sequences_, names_ and the arena. Inserted sequences never change
+    // and deque elements never move, so readers keep references after unlocking.
+    mutable std::shared_mutex mutex_;
+    std::deque<Sequence> sequences_;
+    std::unordered_map<std::string, SequenceId> names_;
+
+    // Decoded-block LRU, keyed by (sequence id, block index)
+    mutable std::mutex cache_mutex_;
+    mutable std::list<std::pair<uint64_t, PackedBlock>> lru_;
+    mutable std::unordered_map<uint64_t, std::list<std::pair<uint64_t, PackedBlock>>::iterator> cache_index_;
+    mutable size_t cache_bytes_ = 0;
+    mutable std::atomic<size_t> cache_hits_{0};
+    mutable std::atomic<size_t> cache_misses_{0};
+};
+
+} // namespace ccc
+
+#endif // CCC_SEQUENCE_STORE_H
@@ -0,0 +1,125 @@
+/**
+ * Tandem repeat detection and expansion
+ */
+
+#include "tandem_repeats.h"
+#include "packed_bases.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace ccc {
+
+size_t extract_tandem_repeats(const uint8_t* symbols, size_t count, size_t min_bases, uint8_t* residual,
+                              std::vector<TandemRepeat>& repeats) {
+    if (min_bases < kTandemMinBases) {
+        throw std::invalid_argument("Tandem repeats need at least " + std::to_string(kTandemMinBases) + 
+                                    " bases, got " + std::to_string(min_bases));
+    }
+
+    // A repeat of period p spans at least max(min_bases, 2p) bases, so inside it
+    // symbols[j] == symbols[j - p] holds for a run of at least max(min_bases, 2p) - p
+    // positions. Probing every step positions for kProbe matches in a row lands
+    // in every such run; the rare hits are then extended both ways.
+    constexpr size_t kProbe = 4;
+    size_t shortest_run = min_bases;
+    for (size_t p = 1; p <= kTandemMaxPeriod; ++p) {
+        shortest_run = std::min(shortest_run, std::max(min_bases, 2 * p) - p);
+    }
+    const size_t step = shortest_run - kProbe + 1;
+
+    size_t out = 0;
+    size_t cursor = 0;                  // symbols before cursor are in the residual or a repeat
+    size_t q = 0;
+    while (q + kProbe <= count) {
+        uint32_t probe;
+        std::memcpy(&probe, symbols + q, sizeof(probe));
+        uint32_t best_period = 0;
+        size_t best_start = 0;
+        size_t best_length = 0;
+        for (uint32_t p = 1; p <= kTandemMaxPeriod && q >= cursor + p; ++p) {
+            uint32_t shifted;
+            std::memcpy(&shifted, symbols + q - p, sizeof(shifted));
+            if (probe != shifted) {
+                continue;
+            }
+            size_t begin = q;
+            while (begin > cursor + p && symbols[begin - 1] == symbols[begin - 1 - p]) {
+                --begin;
+            }
+            size_t end = q + kProbe;
+            while (end < count && symbols[end] == symbols[end - p]) {
+                ++end;
+            }
+            // Ties keep the shorter period: (CA)n is not reported as (CACA)n
+            if (end - (begin - p) > best_length) {
+                best_length = end - (begin - p);
+                best_start = begin - p;
+                best_period = p;
+            }
+        }
+
+        // Only whole units are removed, so the threshold applies to them
+        const size_t copies = best_period ? best_length / best_period : 0;
+        if (copies < 2 || copies * best_period < min_bases) {
+            q += step;
+            continue;
+        }
+        TandemRepeat repeat;
+        std::memmove(residual + out, symbols + cursor, best_start - cursor);
+        out += best_start - cursor;
+        repeat.position = out;
+        repeat.period = best_period;
+        for (uint32_t k = 0; k < best_period; ++k) {
+            repeat.unit |= static_cast<uint32_t>(symbols[best_start + k]) << (2 * k);
+        }
+        repeat.count = copies;
+        repeats.push_back(repeat);
+        cursor = best_start + copies * best_period;
+        q = cursor;
+    }
+    std::memmove(residual + out, symbols + cursor, count - cursor);
+    return out + (count - cursor);
+}
+
+size_t tandem_repeat_bases(const std::vector<TandemRepeat>& repeats) {
+    size_t total = 0;
+    for (const TandemRepeat& repeat : repeats) {
+        if (repeat.period == 0 || repeat.period > kTandemMaxPeriod || (repeat.unit >> (2 * repeat.period)) != 0 ||
+            repeat.count == 0 || repeat.count > (std::numeric_limits<size_t>::max() - total) / repeat.period) {
+            throw std::invalid_argument("Malformed tandem repeat (period " + std::to_string(repeat.period) +
+                                        ", count " + std::to_string(repeat.count) + ")");
+        }
+        total += repeat.count * repeat.period;
+    }
+    return total;
+}
+
+void expand_tandem_repeats(const uint8_t* residual_packed, size_t residual_bases,
+                           const std::vector<TandemRepeat>& repeats, uint8_t* packed_out, size_t bases) {
+    if (residual_bases > bases || tandem_repeat_bases(repeats) != bases - residual_bases) {
+        throw std::invalid_argument("Tandem repeats do not add up to " + std::to_string(bases) + " bases");
+    }
+
+    size_t in = 0;
+    size_t out = 0;
+    for (const TandemRepeat& repeat : repeats) {
+        if (repeat.position < in || repeat.position > residual_bases) {
+            throw std::invalid_argument("Tandem repeat position " + std::to_string(repeat.position) +
+                                        " out of order or past the residual");
+        }
+        copy_bases(residual_packed, in, packed_out, out, repeat.position - in);
+        out += repeat.position - in;
+        in = repeat.position;
+        for (size_t c = 0; c < repeat.count; ++c) {
+            for (uint32_t k = 0; k < repeat.period; ++k) {
+                put_base(packed_out, out++, static_cast<uint8_t>((repeat.unit >> (2 * k)) & 3));
+            }
+        }
+    }
+    copy_bases(residual_packed, in, packed_out, out, residual_bases - in);
+}
+
+} // namespace ccc
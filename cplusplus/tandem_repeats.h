@@ -0,0 +1,75 @@
+/**
+ * Tandem Repeat Coding - C++ Implementation
+ *
+ * Optional pre-coding stage for microsatellites such as (CA)n or (AGAT)n.
+ * LZW learns a tandem repeat one base per phrase, so a long repeat costs many
+ * codes; here it is cut out of the base stream and kept as one
+ * (position, unit, count) token next to the DVNP codes of the remainder.
+ *
+ * Detection probes the 2-bit symbols at a stride derived from the minimum
+ * repeat length, comparing four symbols against their copies 1-6 positions
+ * back; only the few probes that match are extended into repeats, so
+ * repeat-free input is skipped at close to memory speed.
+ */
+
+#ifndef CCC_TANDEM_REPEATS_H
+#define CCC_TANDEM_REPEATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ccc {
+
+constexpr uint32_t kTandemMaxPeriod = 6;        // mono- to hexanucleotide repeats
+constexpr size_t kTandemMinBases = 8;           // shortest repeat the detector can find
+constexpr size_t kTandemDefaultMinBases = 24;   // shorter repeats cost more as tokens than as codes
+
+/**
+ * One tandem repeat removed from a base stream
+ */
+struct TandemRepeat {
+    size_t position = 0;                // residual bases preceding the repeat
+    uint32_t period = 0;                // unit length in bases, 1..kTandemMaxPeriod
+    uint32_t unit = 0;                  // unit bases, 2 bits each, first base in the low bits
+    size_t count = 0;                   // whole copies of the unit
+};
+
+/**
+ * Cut tandem repeats of at least min_bases bases out of a symbol stream
+ * Only whole units are removed; a trailing partial unit stays in the residual.
+ *
+ * @param symbols Symbols 0-3
+ * @param count Number of symbols
+ * @param min_bases Shortest repeat to remove (at least kTandemMinBases)
+ * @param residual Output of at least count symbols: the stream without the repeats;
+ *                 may be symbols itself
+ * @param repeats Receives the repeats, in stream order
+ * @return Number of residual symbols
+ * @throws std::invalid_argument if min_bases is below kTandemMinBases
+ */
+size_t extract_tandem_repeats(const uint8_t* symbols, size_t count, size_t min_bases, uint8_t* residual,
+                              std::vector<TandemRepeat>& repeats);
+
+/**
+ * Total bases covered by a repeat list
+ *
+ * @throws std::invalid_argument on a malformed repeat (bad period or overflowing count)
+ */
+size_t tandem_repeat_bases(const std::vector<TandemRepeat>& repeats);
+
+/**
+ * Rebuild a base stream from its residual and repeats (inverse of extract_tandem_repeats())
+ *
+ * @param residual_packed Residual bases, four per byte in binary_to_dna() order
+ * @param residual_bases Number of residual bases
+ * @param packed_out Zero-initialised output, four bases per byte
+ * @param bases residual_bases plus tandem_repeat_bases(repeats)
+ * @throws std::invalid_argument if the repeats do not fit the residual
+ */
+void expand_tandem_repeats(const uint8_t* residual_packed, size_t residual_bases,
+                           const std::vector<TandemRepeat>& repeats, uint8_t* packed_out, size_t bases);
+
+} // namespace ccc
+
+#endif // CCC_TANDEM_REPEATS_H
@@ -3,11 +3,38 @@
  */
 
 #include "circular_chromosome_compression.h"
+#include "constrained_coding.h"
+#include "autotune.h"
+#include "sequence_analytics.h"
+#include "archive.h"
+#include "fast_hash.h"
+#include "result_cache.h"
+#include "recompaction.h"
+#include "twobit.h"
+#include "erasure_coding.h"
+#include "sequence_store.h"
+#include "async_logger.h"
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <string>
 #include <cassert>
 #include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <csignal>
+#include <sys/resource.h>
 
 using namespace ccc;
 
@@ -183,6 +210,1960 @@ void test_large_data() {
     std::cout << "  Bits per base: " << stats.bits_per_base << std::endl;
 }
 
+/**
+ * Sparse generated input: zeros with a pseudo-random byte every 4 KiB
+ */
+uint8_t sparse_input_byte(uint64_t i) {
+    return (i & 4095) == 0 ? static_cast<uint8_t>(((i >> 12) * 0x9E3779B97F4A7C15ull) >> 56) : 0;
+}
+
+/**
+ * Whether body throws std::runtime_error while files may grow to at most bytes, as on a
+ * nearly full disk; SIGXFSZ is ignored so oversized writes fail with EFBIG instead
+ */
+bool fails_past_file_size_limit(rlim_t bytes, const std::function<void()>& body) {
+    rlimit saved{};
+    getrlimit(RLIMIT_FSIZE, &saved);
+    auto previous = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit limited = saved;
+    limited.rlim_cur = bytes;
+    setrlimit(RLIMIT_FSIZE, &limited);
+    bool failed = false;
+    try {
+        body();
+    } catch (const std::runtime_error&) {
+        failed = true;
+    }
+    setrlimit(RLIMIT_FSIZE, &saved);
+    std::signal(SIGXFSZ, previous);
+    return failed;
+}
+
+/**
+ * Whether any temporary file staged for path is still lying around
+ */
+bool staged_files_left(const std::string& path) {
+    for (const auto& entry : std::filesystem::directory_iterator(".")) {
+        if (entry.path().filename().string().rfind(path + ".tmp", 0) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void test_64bit_pipeline() {
+    std::cout << "\n=== 64-bit Pipeline Test ===" << std::endl;
+    
+    // Ring lengths past INT32_MAX and UINT32_MAX
+    bool primes = CircularChromosomeCompressor::next_prime(2147483647ull) == 2147483647ull &&
+                  CircularChromosomeCompressor::next_prime(2147483648ull) == 2147483659ull &&
+                  CircularChromosomeCompressor::next_prime(4294967296ull) == 4294967311ull &&
+                  CircularChromosomeCompressor::next_prime(1ull << 40) == 1099511627791ull &&
+                  !CircularChromosomeCompressor::is_prime(4294967297ull);   // 641 * 6700417
+    
+    // Dictionaries whose markers would not fit an int code are refused
+    CircularChromosomeCompressor compressor(1000, 4, true, false);
+    bool dict_limit = false;
+    try {
+        compressor.set_max_dict_size(UINT32_MAX);
+    } catch (const std::invalid_argument&) {
+        dict_limit = true;
+    }
+    compressor.set_max_dict_size(kDvnpDictSizeLimit);
+    compressor.set_max_dict_size(kDvnpMaxDictSize);
+    
+    // A huge dictionary on small blocks only allocates what the blocks can use
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    const long peak_before_kb = usage.ru_maxrss;
+    std::vector<uint8_t> small_input(65536);
+    for (size_t i = 0; i < small_input.size(); ++i) {
+        small_input[i] = static_cast<uint8_t>((i * 2654435761u) >> 13);
+    }
+    bool huge_dict_ok = true;
+    for (size_t lanes : {1, 4}) {
+        CircularChromosomeCompressor huge(1000, 4, true, false);
+        huge.set_max_dict_size(kDvnpDictSizeLimit);
+        huge.set_block_size(1024);
+        huge.set_lanes(lanes);
+        auto [huge_codes, huge_metadata] = huge.compress(small_input);
+        std::vector<uint8_t> archive = serialize_archive(huge_codes, huge_metadata);
+        auto [read_codes, read_metadata] = deserialize_archive(archive.data(), archive.size());
+        huge_dict_ok = huge_dict_ok && huge.decompress(read_codes, read_metadata) == small_input;
+    }
+    getrusage(RUSAGE_SELF, &usage);
+    const long peak_growth_kb = usage.ru_maxrss - peak_before_kb;
+    huge_dict_ok = huge_dict_ok && peak_growth_kb < 256 * 1024;
+    std::cout << std::dec << "Dictionary limit " << kDvnpDictSizeLimit << " on 1024-byte blocks: peak RSS grew "
+              << peak_growth_kb << " KB" << std::endl;
+    
+    if (!primes || !dict_limit || !huge_dict_ok) {
+        std::cout << "✗ 64-bit pipeline failed!" << std::endl;
+        exit(1);
+    }
+    
+    // Opt-in: CCC_LARGE_TEST_GB=5 round-trips a 5 GB input through an archive file
+    const char* large_gb = std::getenv("CCC_LARGE_TEST_GB");
+    if (large_gb == nullptr) {
+        std::cout << "Large input round trip skipped (set CCC_LARGE_TEST_GB to run it)" << std::endl;
+        std::cout << "✓ 64-bit pipeline successful!" << std::endl;
+        return;
+    }
+    const size_t size = static_cast<size_t>(std::stod(large_gb) * 1073741824.0);
+    std::vector<uint8_t> input(size);
+    for (size_t i = 0; i < size; i += 4096) {
+        input[i] = sparse_input_byte(i);
+    }
+    
+    compressor.set_block_size(16 * 1048576);
+    auto start = std::chrono::steady_clock::now();
+    auto [compressed_data, metadata] = compressor.compress(input);
+    const std::string archive_path = "test_ccc_large.ccc";
+    const std::string output_path = "test_ccc_large.out";
+    write_archive(archive_path, compressed_data, metadata);
+    std::vector<int>().swap(compressed_data);
+    auto [read_codes, read_metadata] = read_archive(archive_path);
+    size_t written = compressor.decompress_to_file(read_codes, read_metadata, output_path);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    // Compare against the input in chunks rather than reading the output back whole
+    bool identical = written == size && read_metadata.core.original_size == size &&
+                     read_metadata.core.dna_length == size * 4;
+    std::ifstream output(output_path, std::ios::binary);
+    std::vector<char> chunk(64 * 1048576);
+    for (size_t offset = 0; identical && offset < size; offset += chunk.size()) {
+        size_t length = std::min(chunk.size(), size - offset);
+        output.read(chunk.data(), static_cast<std::streamsize>(length));
+        identical = static_cast<size_t>(output.gcount()) == length &&
+                    std::memcmp(chunk.data(), input.data() + offset, length) == 0;
+    }
+    output.close();
+    std::remove(archive_path.c_str());
+    std::remove(output_path.c_str());
+    
+    std::cout << std::dec << size << " bytes (" << size * 4 << " bases) -> " << read_codes.size() << " codes, "
+              << read_metadata.core.blocks.size() << " blocks, round trip in " << seconds << " s" << std::endl;
+    
+    if (identical) {
+        std::cout << "✓ 64-bit pipeline successful!" << std::endl;
+    } else {
+        std::cout << "✗ 64-bit pipeline failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_constrained_coding() {
+    std::cout << "\n=== Constrained Coding Test ===" << std::endl;
+    
+    CircularChromosomeCompressor compressor(1000, 4, true, false);
+    ConstrainedCodec codec;
+    
+    // Worst case for homopolymers in the plain 2-bit mapping: all-zero bytes
+    std::vector<uint8_t> zeros(1000, 0);
+    std::string dna = codec.encode(zeros);
+    
+    std::cout << std::dec << "Encoded " << zeros.size() << " bytes to " << dna.length() << " bases" << std::endl;
+    std::cout << "Max homopolymer run: " << ConstrainedCodec::max_homopolymer_run(dna) << std::endl;
+    
+    if (!ConstrainedCodec::satisfies_constraints(dna) || codec.decode(dna, zeros.size()) != zeros) {
+        std::cout << "✗ Constrained coding failed!" << std::endl;
+        exit(1);
+    }
+    
+    // Transcode compressed output and decompress from the constrained DNA
+    std::string test_string = "Constrained coding runs after compression. Constrained coding runs after compression.";
+    std::vector<uint8_t> test_data(test_string.begin(), test_string.end());
+    auto [compressed_data, metadata] = compressor.compress(test_data);
+    
+    std::string synthesis_dna = codec.encode_codes(compressed_data);
+    std::vector<int> restored_codes = codec.decode_codes(synthesis_dna);
+    std::vector<uint8_t> decompressed_data = compressor.decompress(restored_codes, metadata);
+    
+    // Corrupted headers: counts past the sequence (one wrapping count * width to 0) and 32-bit codes
+    bool corrupt_rejected = true;
+    for (auto [width, count] : {std::make_pair(8, uint64_t(1) << 61), std::make_pair(31, uint64_t(1) << 40),
+                                std::make_pair(16, uint64_t(1000)), std::make_pair(32, uint64_t(4))}) {
+        std::vector<uint8_t> header(9 + 64, 0x5A);
+        header[0] = static_cast<uint8_t>(width);
+        for (size_t i = 0; i < 8; ++i) {
+            header[1 + i] = static_cast<uint8_t>(count >> (8 * i));
+        }
+        try {
+            codec.decode_codes(codec.encode(header));
+            corrupt_rejected = false;
+        } catch (const std::invalid_argument&) {
+        }
+    }
+    
+    if (restored_codes == compressed_data && decompressed_data == test_data && corrupt_rejected &&
+        ConstrainedCodec::satisfies_constraints(synthesis_dna)) {
+        std::cout << "✓ Constrained coding successful!" << std::endl;
+    } else {
+        std::cout << "✗ Constrained coding failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_block_parallel_compression() {
+    std::cout << "\n=== Block-Parallel Compression Test ===" << std::endl;
+    
+    std::string pattern = "Block-parallel DVNP coding with direct mmap decompression. ";
+    std::vector<uint8_t> test_data;
+    while (test_data.size() < 50000) {
+        test_data.insert(test_data.end(), pattern.begin(), pattern.end());
+    }
+    
+    CircularChromosomeCompressor compressor(1000, 4, true, false);
+    compressor.set_block_size(16384);
+    compressor.set_num_threads(4);
+    
+    auto [compressed_data, metadata] = compressor.compress(test_data);
+    std::cout << std::dec << "Blocks: " << metadata.core.blocks.size() << ", codes: " 
+              << compressed_data.size() << std::endl;
+    
+    // A single block must reproduce the legacy string-based DVNP stream exactly
+    CircularChromosomeCompressor legacy(1000, 4, true, false);
+    CircularChromosomeCompressor single_block(1000, 4, true, false);
+    single_block.set_block_size(test_data.size());
+    bool identical_stream = legacy.compress(test_data).first == single_block.compress(test_data).first;
+    
+    std::vector<uint8_t> decompressed_data = compressor.decompress(compressed_data, metadata);
+    
+    const std::string output_path = "test_ccc_block_output.bin";
+    size_t written = compressor.decompress_to_file(compressed_data, metadata, output_path);
+    std::ifstream infile(output_path, std::ios::binary);
+    std::vector<uint8_t> file_data((std::istreambuf_iterator<char>(infile)), std::istreambuf_iterator<char>());
+    infile.close();
+    
+    // The single-stream layout maps the output too; a truncated code stream must not pass as zero padding
+    auto [stream_data, stream_metadata] = legacy.compress(test_data);
+    size_t stream_written = legacy.decompress_to_file(stream_data, stream_metadata, output_path);
+    infile.open(output_path, std::ios::binary);
+    std::vector<uint8_t> stream_file((std::istreambuf_iterator<char>(infile)), std::istreambuf_iterator<char>());
+    infile.close();
+    CompressionMetadata truncated = stream_metadata;
+    truncated.encapsulation.trans_splicing.original_compressed_length -= 10;
+    bool truncated_rejected = false;
+    try {
+        legacy.decompress_to_file(stream_data, truncated, output_path);
+    } catch (const std::invalid_argument&) {
+        truncated_rejected = true;
+    }
+    bool single_stream = stream_metadata.core.blocks.empty() && stream_written == test_data.size() &&
+                         stream_file == test_data && truncated_rejected;
+    
+    // Failed decodes and a full disk (a file size limit) throw and leave the existing output untouched
+    bool disk_full_rejected = fails_past_file_size_limit(4096, [&]() {
+        compressor.decompress_to_file(compressed_data, metadata, output_path);
+    });
+    infile.open(output_path, std::ios::binary);
+    std::vector<uint8_t> kept_file((std::istreambuf_iterator<char>(infile)), std::istreambuf_iterator<char>());
+    infile.close();
+    bool output_kept = disk_full_rejected && kept_file == test_data && !staged_files_left(output_path);
+    std::remove(output_path.c_str());
+    
+    if (metadata.core.blocks.size() == 4 && identical_stream && single_stream && output_kept &&
+        decompressed_data == test_data && written == test_data.size() && file_data == test_data) {
+        std::cout << "✓ Block-parallel compression successful!" << std::endl;
+    } else {
+        std::cout << "✗ Block-parallel compression failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_warm_start_blocks() {
+    std::cout << "\n=== Warm-Start Block Dictionary Test ===" << std::endl;
+    
+    // Repeated pseudo-random records: each block mostly repeats the previous block's content
+    std::vector<uint8_t> record(3000);
+    uint32_t state = 7;
+    for (auto& byte : record) {
+        state = state * 1664525u + 1013904223u;
+        byte = static_cast<uint8_t>(state >> 24);
+    }
+    std::vector<uint8_t> test_data;
+    while (test_data.size() < 200000) {
+        test_data.insert(test_data.end(), record.begin(), record.end());
+        test_data.push_back(static_cast<uint8_t>(test_data.size()));
+    }
+    
+    CircularChromosomeCompressor cold(1000, 4, true, false);
+    cold.set_block_size(16384);
+    cold.set_num_threads(4);
+    auto [cold_data, cold_metadata] = cold.compress(test_data);
+    
+    CircularChromosomeCompressor warm(1000, 4, true, false);
+    warm.set_block_size(16384);
+    warm.set_num_threads(4);
+    warm.set_seed_window(8192);
+    auto [warm_data, warm_metadata] = warm.compress(test_data);
+    
+    // Small dictionary: priming fills it and resets must return to an empty dictionary
+    CircularChromosomeCompressor small_dict(1000, 4, true, false);
+    small_dict.set_block_size(16384);
+    small_dict.set_max_dict_size(4096);
+    small_dict.set_seed_window(16384);
+    auto [small_data, small_metadata] = small_dict.compress(test_data);
+    
+    const std::string output_path = "test_ccc_warm_output.bin";
+    size_t written = warm.decompress_to_file(warm_data, warm_metadata, output_path);
+    std::ifstream infile(output_path, std::ios::binary);
+    std::vector<uint8_t> file_data((std::istreambuf_iterator<char>(infile)), std::istreambuf_iterator<char>());
+    infile.close();
+    std::remove(output_path.c_str());
+    
+    std::cout << std::dec << "Cold blocks: " << cold_data.size() << " codes, warm-start blocks: " 
+              << warm_data.size() << " codes" << std::endl;
+    
+    if (warm_metadata.core.seed_window == 8192 && warm_data.size() < cold_data.size() &&
+        warm.decompress(warm_data, warm_metadata) == test_data &&
+        small_dict.decompress(small_data, small_metadata) == test_data &&
+        written == test_data.size() && file_data == test_data) {
+        std::cout << "✓ Warm-start block dictionaries successful!" << std::endl;
+    } else {
+        std::cout << "✗ Warm-start block dictionaries failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_interleaved_lanes() {
+    std::cout << "\n=== Interleaved DVNP Lanes Test ===" << std::endl;
+    
+    std::vector<uint8_t> test_data(150001);
+    uint32_t state = 11;
+    for (size_t i = 0; i < test_data.size(); ++i) {
+        state = state * 1664525u + 1013904223u;
+        // Alternate random and repetitive stretches so lanes see both
+        test_data[i] = (i / 5000) % 2 ? static_cast<uint8_t>(state >> 24) : static_cast<uint8_t>("ACGTTGCA"[i % 8]);
+    }
+    
+    // Every lane must carry exactly the codes a single-stream encoder gives its slice
+    std::vector<uint8_t> symbols(test_data.size() * 4);
+    bytes_to_symbols(test_data.data(), test_data.size(), symbols.data());
+    bool lanes_match = true;
+    for (size_t lanes : {2, 3, 8}) {
+        DvnpLaneEncoder encoder(lanes, 256);
+        std::vector<int> codes;
+        std::vector<size_t> lane_counts;
+        encoder.encode(symbols.data(), symbols.size(), codes, lane_counts);
+        size_t offset = 0;
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            size_t start = dvnp_lane_offset(test_data.size(), lanes, lane) * 4;
+            size_t end = dvnp_lane_offset(test_data.size(), lanes, lane + 1) * 4;
+            std::vector<int> reference;
+            DvnpEncoder(256).encode(symbols.data() + start, end - start, reference);
+            lanes_match = lanes_match && lane_counts[lane] == reference.size() &&
+                          std::equal(reference.begin(), reference.end(), codes.begin() + offset);
+            offset += lane_counts[lane];
+        }
+    }
+    
+    bool round_trips = true;
+    size_t total_codes[kDvnpMaxLanes + 1] = {};
+    for (size_t lanes = 1; lanes <= kDvnpMaxLanes; ++lanes) {
+        CircularChromosomeCompressor compressor(1000, 4, true, false);
+        compressor.set_block_size(lanes % 2 ? 16384 : 5);   // tiny blocks leave some lanes empty
+        compressor.set_max_dict_size(4096);
+        compressor.set_lanes(lanes);
+        auto [compressed, metadata] = compressor.compress(test_data);
+        std::vector<uint8_t> archive = serialize_archive(compressed, metadata);
+        auto [read_codes, read_metadata] = deserialize_archive(archive.data(), archive.size());
+        total_codes[lanes] = compressed.size();
+        round_trips = round_trips && metadata.core.lanes == lanes &&
+                      compressor.decompress(compressed, metadata) == test_data &&
+                      compressor.decompress(read_codes, read_metadata) == test_data;
+    }
+    
+    // A seed window keeps blocks single-lane
+    CircularChromosomeCompressor seeded(1000, 4, true, false);
+    seeded.set_block_size(16384);
+    seeded.set_seed_window(4096);
+    seeded.set_lanes(4);
+    auto [seeded_data, seeded_metadata] = seeded.compress(test_data);
+    
+    bool rejected = false;
+    try {
+        seeded.set_lanes(kDvnpMaxLanes + 1);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    
+    std::cout << std::dec << "Codes with 16KB blocks: 1 lane " << total_codes[1] << ", 3 lanes " 
+              << total_codes[3] << ", 7 lanes " << total_codes[7] << std::endl;
+    
+    if (lanes_match && round_trips && rejected && seeded_metadata.core.lanes == 1 &&
+        seeded.decompress(seeded_data, seeded_metadata) == test_data) {
+        std::cout << "✓ Interleaved DVNP lanes successful!" << std::endl;
+    } else {
+        std::cout << "✗ Interleaved DVNP lanes failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_multi_base_stepping() {
+    std::cout << "\n=== Multi-Base DVNP Stepping Test ===" << std::endl;
+    
+    std::vector<uint8_t> test_data(120000);
+    uint32_t state = 23;
+    for (size_t i = 0; i < test_data.size(); ++i) {
+        state = state * 1664525u + 1013904223u;
+        // Random, periodic and near-periodic stretches
+        switch ((i / 7000) % 3) {
+            case 0: test_data[i] = static_cast<uint8_t>(state >> 24); break;
+            case 1: test_data[i] = static_cast<uint8_t>("GATTACA"[i % 7]); break;
+            default: test_data[i] = (state >> 28) ? static_cast<uint8_t>("TTAGGG"[i % 6]) : static_cast<uint8_t>(state >> 16); break;
+        }
+    }
+    std::vector<uint8_t> symbols(test_data.size() * 4);
+    bytes_to_symbols(test_data.data(), test_data.size(), symbols.data());
+    
+    // Radix steps must reproduce the single-step parse exactly, resets included
+    bool identical = true;
+    size_t tail_lengths[] = {1, 2, 3, 4, 5, 9, symbols.size() - 4096};
+    for (uint32_t dict_size : {16u, 256u, 4096u, 65536u, 1u << 20}) {
+        for (size_t seed_count : {static_cast<size_t>(0), static_cast<size_t>(4096)}) {
+            for (size_t length : tail_lengths) {
+                const uint8_t* input = symbols.data() + 4096;
+                std::vector<int> single_codes;
+                std::vector<int> multi_codes;
+                size_t single_resets = DvnpEncoder(dict_size, false).encode(input, length, single_codes, symbols.data(), seed_count);
+                size_t multi_resets = DvnpEncoder(dict_size, true).encode(input, length, multi_codes, symbols.data(), seed_count);
+                identical = identical && single_codes == multi_codes && single_resets == multi_resets;
+            }
+        }
+    }
+    
+    // One encoder reused across inputs must not carry radix entries over
+    DvnpEncoder reused(65536, true);
+    std::vector<int> first_codes;
+    std::vector<int> second_codes;
+    std::vector<int> fresh_codes;
+    reused.encode(symbols.data(), 50000, first_codes);
+    reused.encode(symbols.data() + 200000, 50000, second_codes);
+    DvnpEncoder(65536, false).encode(symbols.data() + 200000, 50000, fresh_codes);
+    
+    // Opt-in on the compressor: same archive as the single-step default
+    CircularChromosomeCompressor plain(1000, 4, true, false);
+    CircularChromosomeCompressor stepping(1000, 4, true, false);
+    plain.set_block_size(32768);
+    stepping.set_block_size(32768);
+    stepping.set_multi_base(true);
+    auto [stepping_codes, stepping_metadata] = stepping.compress(test_data);
+    bool opt_in = !plain.multi_base() && !DvnpEncoder().multi_base() && stepping.multi_base() &&
+                  stepping_codes == plain.compress(test_data).first &&
+                  plain.decompress(stepping_codes, stepping_metadata) == test_data;
+    
+    std::cout << std::dec << "Checked " << symbols.size() << " symbols at dictionary sizes 16 to " 
+              << (1u << 20) << std::endl;
+    
+    if (identical && second_codes == fresh_codes && reused.multi_base() && opt_in) {
+        std::cout << "✓ Multi-base DVNP stepping successful!" << std::endl;
+    } else {
+        std::cout << "✗ Multi-base DVNP stepping failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_tandem_repeats() {
+    std::cout << "\n=== Tandem Repeat Coding Test ===" << std::endl;
+    
+    // Random bases interrupted by microsatellites of period 1-6, some of them imperfect
+    const char* units[] = {"A", "CA", "AAT", "AGAT", "TTAGG", "ACGTCA"};
+    std::vector<uint8_t> symbols;
+    uint32_t state = 5;
+    auto next = [&state]() { state = state * 1664525u + 1013904223u; return state >> 8; };
+    while (symbols.size() < 400000) {
+        for (int i = 0; i < 300; ++i) {
+            symbols.push_back(static_cast<uint8_t>(next() & 3));
+        }
+        const char* unit = units[next() % 6];
+        size_t copies = 5 + next() % 40;
+        for (size_t c = 0; c < copies; ++c) {
+            for (const char* base = unit; *base; ++base) {
+                symbols.push_back(static_cast<uint8_t>(std::string("ACGT").find(*base)));
+            }
+            if (c == copies / 2 && next() % 3 == 0) {
+                symbols.back() ^= 1;   // a point mutation splits the repeat
+            }
+        }
+    }
+    symbols.resize(symbols.size() / 4 * 4);
+    std::vector<uint8_t> test_data(symbols.size() / 4);
+    for (size_t i = 0; i < test_data.size(); ++i) {
+        test_data[i] = static_cast<uint8_t>(symbols[4 * i] << 6 | symbols[4 * i + 1] << 4 | 
+                                            symbols[4 * i + 2] << 2 | symbols[4 * i + 3]);
+    }
+    
+    // Extraction and expansion are exact inverses
+    std::vector<uint8_t> residual(symbols.size());
+    std::vector<TandemRepeat> repeats;
+    size_t residual_count = extract_tandem_repeats(symbols.data(), symbols.size(), kTandemDefaultMinBases,
+                                                   residual.data(), repeats);
+    std::vector<uint8_t> residual_packed((residual_count + 3) / 4, 0);
+    for (size_t i = 0; i < residual_count; ++i) {
+        residual_packed[i / 4] |= static_cast<uint8_t>(residual[i] << (6 - 2 * (i % 4)));
+    }
+    std::vector<uint8_t> expanded(test_data.size(), 0);
+    expand_tandem_repeats(residual_packed.data(), residual_count, repeats, expanded.data(), symbols.size());
+    bool periods_ok = !repeats.empty();
+    for (const TandemRepeat& repeat : repeats) {
+        periods_ok = periods_ok && repeat.count * repeat.period >= kTandemDefaultMinBases && repeat.count >= 2;
+    }
+    
+    // Through the compressor, with and without warm starts, and through an archive
+    bool round_trips = expanded == test_data;
+    size_t plain_codes = 0;
+    size_t tandem_codes = 0;
+    for (size_t seed_window : {0, 4096}) {
+        CircularChromosomeCompressor plain(1000, 4, true, false);
+        plain.set_block_size(16384);
+        plain.set_seed_window(seed_window);
+        CircularChromosomeCompressor tandem(1000, 4, true, false);
+        tandem.set_block_size(16384);
+        tandem.set_seed_window(seed_window);
+        tandem.set_lanes(4);
+        tandem.set_tandem_repeats(kTandemDefaultMinBases);
+        auto [compressed, metadata] = tandem.compress(test_data);
+        std::vector<uint8_t> archive = serialize_archive(compressed, metadata);
+        auto [read_codes, read_metadata] = deserialize_archive(archive.data(), archive.size());
+        round_trips = round_trips && metadata.core.lanes == 1 && metadata.core.tandem_min_bases == kTandemDefaultMinBases &&
+                      tandem.decompress(compressed, metadata) == test_data &&
+                      tandem.decompress(read_codes, read_metadata) == test_data;
+        if (seed_window == 0) {
+            plain_codes = plain.compress(test_data).first.size();
+            tandem_codes = compressed.size();
+        }
+    }
+    
+    // A repeat count that overruns its block is rejected
+    CircularChromosomeCompressor tandem(1000, 4, true, false);
+    tandem.set_block_size(16384);
+    tandem.set_tandem_repeats(kTandemDefaultMinBases);
+    auto [compressed, metadata] = tandem.compress(test_data);
+    metadata.core.blocks[0].tandem_repeats.at(0).count += 100000;
+    bool tamper_rejected = false;
+    try {
+        tandem.decompress(compressed, metadata);
+    } catch (const std::invalid_argument&) {
+        tamper_rejected = true;
+    }
+    
+    std::cout << std::dec << repeats.size() << " repeats covering " << symbols.size() - residual_count << " of " 
+              << symbols.size() << " bases; codes " << plain_codes << " -> " << tandem_codes << std::endl;
+    
+    if (round_trips && periods_ok && tandem_codes < plain_codes && tamper_rejected) {
+        std::cout << "✓ Tandem repeat coding successful!" << std::endl;
+    } else {
+        std::cout << "✗ Tandem repeat coding failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_approximate_repeats() {
+    std::cout << "\n=== Approximate Repeat Coding Test ===" << std::endl;
+    
+    // Random bases and diverged copies of earlier stretches (2% substitutions), plus a short-period run
+    std::vector<uint8_t> symbols;
+    uint32_t state = 17;
+    auto next = [&state]() { state = state * 1664525u + 1013904223u; return state >> 8; };
+    while (symbols.size() < 400000) {
+        for (size_t i = 0; i < (symbols.size() < 4000 ? 4000 : 400); ++i) {
+            symbols.push_back(static_cast<uint8_t>(next() >> 16 & 3));
+        }
+        if (next() % 8 == 0) {
+            for (int i = 0; i < 90; ++i) {
+                symbols.push_back(static_cast<uint8_t>(i % 5 == 0 ? 0 : i % 5 - 1));   // (AACGT)n
+            }
+        }
+        size_t length = 100 + next() % 900;
+        size_t source = next() % (symbols.size() - length);
+        for (size_t i = 0; i < length; ++i) {
+            symbols.push_back(next() % 50 == 0 ? static_cast<uint8_t>(next() >> 16 & 3) : symbols[source + i]);
+        }
+    }
+    symbols.resize(symbols.size() / 4 * 4);
+    std::vector<uint8_t> test_data(symbols.size() / 4);
+    for (size_t i = 0; i < test_data.size(); ++i) {
+        test_data[i] = static_cast<uint8_t>(symbols[4 * i] << 6 | symbols[4 * i + 1] << 4 | 
+                                            symbols[4 * i + 2] << 2 | symbols[4 * i + 3]);
+    }
+    
+    // Matching and expansion are exact inverses, overlapping sources included
+    std::vector<uint8_t> residual(symbols.size());
+    std::vector<ApproximateRepeat> copies;
+    size_t residual_count = extract_approximate_repeats(symbols.data(), symbols.size(), kApproxDefaultMinBases,
+                                                        residual.data(), copies);
+    std::vector<uint8_t> residual_packed((residual_count + 3) / 4, 0);
+    for (size_t i = 0; i < residual_count; ++i) {
+        residual_packed[i / 4] |= static_cast<uint8_t>(residual[i] << (6 - 2 * (i % 4)));
+    }
+    std::vector<uint8_t> expanded(test_data.size(), 0);
+    expand_approximate_repeats(residual_packed.data(), residual_count, copies, expanded.data(), symbols.size());
+    size_t edits = 0;
+    bool overlapping = false;
+    bool copies_ok = !copies.empty();
+    for (const ApproximateRepeat& copy : copies) {
+        copies_ok = copies_ok && copy.length >= kApproxDefaultMinBases;
+        overlapping = overlapping || copy.distance < copy.length;
+        edits += copy.edits.size();
+    }
+    bool round_trips = expanded == test_data && edits > 0 && overlapping;
+    
+    // Through the compressor, alone and after the tandem stage, with warm starts, verification and an archive
+    size_t plain_bytes = 0;
+    size_t copy_bytes = 0;
+    for (size_t variant = 0; variant < 3; ++variant) {
+        CircularChromosomeCompressor compressor(1000, 4, true, false);
+        compressor.set_block_size(65536);
+        compressor.set_lanes(4);
+        compressor.set_approximate_repeats(kApproxDefaultMinBases);
+        compressor.set_tandem_repeats(variant == 1 ? kTandemDefaultMinBases : 0);
+        compressor.set_seed_window(variant == 2 ? 4096 : 0);
+        compressor.set_verify_on_write(variant == 2);
+        auto [compressed, metadata] = compressor.compress(test_data);
+        std::vector<uint8_t> archive = serialize_archive(compressed, metadata);
+        auto [read_codes, read_metadata] = deserialize_archive(archive.data(), archive.size());
+        round_trips = round_trips && metadata.core.lanes == 1 && read_metadata.core.approx_min_bases == kApproxDefaultMinBases &&
+                      !read_metadata.core.blocks[1].approximate_repeats.empty() &&
+                      compressor.decompress(compressed, metadata) == test_data &&
+                      compressor.decompress(read_codes, read_metadata) == test_data;
+        if (variant == 0) {
+            CircularChromosomeCompressor plain(1000, 4, true, false);
+            plain.set_block_size(65536);
+            auto [plain_codes, plain_metadata] = plain.compress(test_data);
+            plain_bytes = serialize_archive(plain_codes, plain_metadata).size();
+            copy_bytes = archive.size();
+            
+            CircularChromosomeCompressor recompressor(1000, 4, true, false);
+            recompressor.set_block_size(131072);
+            auto [re_codes, re_metadata] = recompressor.recompress(read_codes, read_metadata);
+            round_trips = round_trips && re_metadata.core.approx_min_bases == 0 &&
+                          recompressor.decompress(re_codes, re_metadata) == test_data;
+        }
+    }
+    
+    // Copies reaching before the stream or edits outside a copy are rejected
+    CircularChromosomeCompressor compressor(1000, 4, true, false);
+    compressor.set_block_size(65536);
+    compressor.set_approximate_repeats(kApproxDefaultMinBases);
+    auto [compressed, metadata] = compressor.compress(test_data);
+    size_t tamper_rejected = 0;
+    for (int tamper = 0; tamper < 2; ++tamper) {
+        CompressionMetadata tampered = metadata;
+        ApproximateRepeat& copy = tampered.core.blocks[1].approximate_repeats.at(0);
+        if (tamper == 0) {
+            copy.distance += 1 << 20;
+        } else {
+            copy.edits.push_back({copy.length, 0});
+        }
+        try {
+            compressor.decompress(compressed, tampered);
+        } catch (const std::invalid_argument&) {
+            ++tamper_rejected;
+        }
+    }
+    bool setting_rejected = false;
+    try {
+        compressor.set_approximate_repeats(kApproxMinBases - 1);
+    } catch (const std::invalid_argument&) {
+        setting_rejected = true;
+    }
+    
+    std::cout << std::dec << copies.size() << " copies with " << edits << " edits covering " 
+              << symbols.size() - residual_count << " of " << symbols.size() << " bases; archive " << plain_bytes 
+              << " -> " << copy_bytes << " bytes" << std::endl;
+    
+    if (round_trips && copies_ok && copy_bytes < plain_bytes && tamper_rejected == 2 && setting_rejected) {
+        std::cout << "✓ Approximate repeat coding successful!" << std::endl;
+    } else {
+        std::cout << "✗ Approximate repeat coding failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_result_cache() {
+    std::cout << "\n=== Archive and Result Cache Test ===" << std::endl;
+    
+    // Reference XXH64 vectors (short and four-lane paths)
+    std::string spam = "Nobody inspects the spammish repetition";
+    bool hash_ok = fast_hash64("", 0) == 0xEF46DB3751D8E999ULL &&
+                   fast_hash64("abc", 3) == 0x44BC2CF5AD770999ULL &&
+                   fast_hash64(spam.data(), spam.size()) == 0xFBCEA83C8A378BF1ULL;
+    
+    std::string pattern = "Content-addressed cache entry for repeated ingestion. ";
+    std::vector<uint8_t> test_data;
+    while (test_data.size() < 60000) {
+        test_data.insert(test_data.end(), pattern.begin(), pattern.end());
+    }
+    
+    const std::string cache_dir = "test_ccc_result_cache";
+    auto cache = std::make_shared<ResultCache>(cache_dir, 1048576);
+    cache->clear();
+    
+    CircularChromosomeCompressor compressor(1000, 4, true, false);
+    compressor.set_block_size(16384);
+    compressor.set_result_cache(cache);
+    auto [first_data, first_metadata] = compressor.compress(test_data);
+    auto [second_data, second_metadata] = compressor.compress(test_data);
+    
+    // Archive bytes round-trip to the same stream and metadata
+    std::vector<uint8_t> archive = serialize_archive(first_data, first_metadata);
+    auto [archived_data, archived_metadata] = deserialize_archive(archive.data(), archive.size());
+    bool archive_ok = archived_data == first_data &&
+                      archived_metadata.core.blocks.size() == first_metadata.core.blocks.size() &&
+                      archived_metadata.encapsulation.trans_splicing.marker_positions == 
+                          first_metadata.encapsulation.trans_splicing.marker_positions &&
+                      compressor.decompress(archived_data, archived_metadata) == test_data;
+    
+    bool corrupt_rejected = false;
+    try {
+        deserialize_archive(archive.data(), archive.size() / 2);
+    } catch (const std::runtime_error&) {
+        corrupt_rejected = true;
+    }
+    
+    // A different parameter set is a different key; a tiny limit evicts the older entry
+    compressor.set_block_size(32768);
+    compressor.compress(test_data);
+    size_t entries_before = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(cache_dir)) {
+        entries_before += entry.path().extension() == ".ccc";
+    }
+    auto small_cache = std::make_shared<ResultCache>(cache_dir, cache->size_bytes() - 1);
+    compressor.set_result_cache(small_cache);
+    compressor.set_block_size(65536);
+    compressor.compress(test_data);
+    size_t entries_after = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(cache_dir)) {
+        entries_after += entry.path().extension() == ".ccc";
+    }
+    std::filesystem::remove_all(cache_dir);
+    
+    std::cout << std::dec << "Archive: " << archive.size() << " bytes for " << first_data.size() 
+              << " codes, cache hits: " << cache->hits() << ", misses: " << cache->misses() << std::endl;
+    
+    if (hash_ok && archive_ok && corrupt_rejected && second_data == first_data &&
+        cache->hits() == 1 && cache->misses() == 2 && entries_before == 2 && entries_after < 3) {
+        std::cout << "✓ Archive and result cache successful!" << std::endl;
+    } else {
+        std::cout << "✗ Archive and result cache failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_archive_stats() {
+    std::cout << "\n=== Archive Header Statistics Test ===" << std::endl;
+    
+    std::vector<uint8_t> test_data(120000);
+    for (size_t i = 0; i < test_data.size(); ++i) {
+        test_data[i] = static_cast<uint8_t>((i % 97) * (i % 13));
+    }
+    
+    CircularChromosomeCompressor compressor(1000, 4, true, false);
+    compressor.set_block_size(32768);
+    compressor.set_max_dict_size(1024);
+    auto [compressed_data, metadata] = compressor.compress(test_data);
+    CompressionStats full = compressor.get_compression_stats(test_data, compressed_data, metadata);
+    
+    const std::string archive_path = "test_ccc_stats.ccc";
+    write_archive(archive_path, compressed_data, metadata);
+    CompressionStats header = read_archive_stats(archive_path);
+    std::vector<uint8_t> archive = serialize_archive(compressed_data, metadata);
+    std::remove(archive_path.c_str());
+    
+    // The statistics section alone is enough: parse a prefix that ends before the metadata
+    size_t prefix_size = 16 + 8 * 16 + 8 * metadata.core.blocks.size();
+    CompressionStats from_prefix = parse_archive_stats(archive.data(), prefix_size);
+    
+    // A code count far beyond the remaining bytes is rejected before the codes are allocated
+    std::vector<uint8_t> hostile = serialize_archive({}, metadata);
+    hostile.pop_back();
+    for (int byte = 0; byte < 6; ++byte) {
+        hostile.push_back(0xff);
+    }
+    hostile.push_back(0x0f);
+    bool hostile_rejected = false;
+    try {
+        deserialize_archive(hostile.data(), hostile.size());
+    } catch (const std::runtime_error&) {
+        hostile_rejected = true;
+    }
+    
+    std::cout << std::dec << "Header: " << header.total_codes << " codes, " << header.reset_count 
+              << " resets, " << header.block_ratios.size() << " block ratios" << std::endl;
+    
+    if (header.original_size_bytes == test_data.size() && header.total_codes == compressed_data.size() &&
+        header.compressed_size_bytes == full.compressed_size_bytes &&
+        std::abs(header.original_entropy - full.original_entropy) < 1e-12 &&
+        std::abs(header.compressed_entropy - full.compressed_entropy) < 1e-12 &&
+        header.reset_count > 0 && header.reset_count == metadata.core.reset_count &&
+        header.block_ratios.size() == 4 && header.core_codes < header.total_codes &&
+        from_prefix.shannon_efficiency == header.shannon_efficiency && hostile_rejected) {
+        std::cout << "✓ Archive header statistics successful!" << std::endl;
+    } else {
+        std::cout << "✗ Archive header statistics failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_input_routing() {
+    std::cout << "\n=== Input Classification and Routing Test ===" << std::endl;
+    
+    uint32_t state = 99;
+    auto next = [&]() {
+        state = state * 1664525u + 1013904223u;
+        return state;
+    };
+    
+    // FASTA with a header, 60-column lines, an N block and a soft-masked run
+    std::string fasta = ">chrTest synthetic\n";
+    std::string bases;
+    for (size_t i = 0; i < 200000; ++i) {
+        bases += "ACGT"[next() >> 30];
+    }
+    std::fill_n(bases.begin() + 5000, 3000, 'N');
+    std::transform(bases.begin() + 20000, bases.begin() + 21000, bases.begin() + 20000,
+                   [](char ch) { return static_cast<char>(std::tolower(static_cast<unsigned char>(ch))); });
+    for (size_t i = 0; i < bases.size(); i += 60) {
+        fasta += bases.substr(i, 60) + "\n";
+    }
+    std::vector<uint8_t> fasta_bytes(fasta.begin(), fasta.end());
+    
+    std::string fastq;
+    for (size_t r = 0; r < 500; ++r) {
+        fastq += "@read" + std::to_string(r) + "\n" + bases.substr(r * 100, 100) + "\n+\n" + std::string(100, 'I') + "\n";
+    }
+    std::string text;
+    while (text.size() < 100000) {
+        text += "The quick brown fox jumps over the lazy dog; records " + std::to_string(next() % 1000) + ".\n";
+    }
+    std::vector<uint8_t> random(1 << 20);
+    for (uint8_t& byte : random) {
+        byte = static_cast<uint8_t>(next() >> 24);
+    }
+    std::vector<uint8_t> gzip_like(random);
+    gzip_like[0] = 0x1f;
+    gzip_like[1] = 0x8b;
+    std::vector<uint8_t> binary(200000);
+    for (size_t i = 0; i < binary.size(); ++i) {
+        binary[i] = static_cast<uint8_t>((i % 64) < 48 ? 0 : (i * 7) % 251);
+    }
+    
+    auto kind = [](const std::string& data) { return classify_input(reinterpret_cast<const uint8_t*>(data.data()), data.size()).kind; };
+    InputProfile gzip_profile = classify_input(gzip_like);
+    bool classify_ok = kind(fasta) == InputKind::Nucleotide && kind(fastq) == InputKind::Fastq &&
+                       kind(text) == InputKind::Text && classify_input(random).kind == InputKind::Compressed &&
+                       gzip_profile.kind == InputKind::Compressed && gzip_profile.format == "gzip" &&
+                       classify_input(binary).kind == InputKind::Binary && kind("") == InputKind::Binary;
+    
+    std::vector<uint8_t> packed;
+    NucleotideLayout layout = pack_nucleotide_text(fasta_bytes.data(), fasta_bytes.size(), packed);
+    bool layout_ok = layout.bases == bases.size() - 3000 && layout.lowercase.size() == 1 &&
+                     packed.size() == (layout.bases + 3) / 4 && unpack_nucleotide_text(packed, layout) == fasta_bytes;
+    // Fixed-width lines are wraps, not one literal per newline; ragged lines keep their literals
+    layout_ok = layout_ok && layout.wraps.size() == 1 && layout.literals.size() == 3;
+    const std::string ragged = ">a\nACGT\nACGTACGT\nAC\nGTAC\nGTAC\nGT\r\nA\n>b\nCCCC\nGGGG\nTT\n";
+    std::vector<uint8_t> ragged_bytes(ragged.begin(), ragged.end());
+    NucleotideLayout ragged_layout = pack_nucleotide_text(ragged_bytes.data(), ragged_bytes.size(), packed);
+    layout_ok = layout_ok && unpack_nucleotide_text(packed, ragged_layout) == ragged_bytes;
+    
+    // Sniffing cost on a large buffer stays independent of its size
+    std::vector<uint8_t> large(64 << 20);
+    std::copy(fasta_bytes.begin(), fasta_bytes.end(), large.begin());
+    auto start = std::chrono::high_resolution_clock::now();
+    InputProfile large_profile = classify_input(large);
+    double classify_us = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+    std::vector<uint8_t>().swap(large);
+    
+    // Plain and auto-routed compression of each input; every archive must round-trip
+    bool roundtrip_ok = true;
+    auto archive_size = [&](const std::vector<uint8_t>& data, bool auto_route, size_t block_size,
+                            CompressionRoute expected) {
+        CircularChromosomeCompressor compressor(1000, 4, true, false);
+        compressor.set_auto_route(auto_route);
+        compressor.set_block_size(block_size);
+        auto [codes, metadata] = compressor.compress(data);
+        std::vector<uint8_t> archive = serialize_archive(codes, metadata);
+        auto [read_codes, read_metadata] = deserialize_archive(archive.data(), archive.size());
+        roundtrip_ok = roundtrip_ok && read_metadata.core.route == expected &&
+                       compressor.decompress(read_codes, read_metadata) == data &&
+                       read_metadata.stats.original_size_bytes == data.size();
+        if (block_size > 0) {
+            CircularChromosomeCompressor recompressor(1000, 4, true, false);
+            recompressor.set_block_size(block_size * 2);
+            auto [re_codes, re_metadata] = recompressor.recompress(read_codes, read_metadata);
+            roundtrip_ok = roundtrip_ok && re_metadata.core.route == expected &&
+                           recompressor.decompress(re_codes, re_metadata) == data;
+            const std::string path = "test_ccc_routed.bin";
+            recompressor.decompress_to_file(re_codes, re_metadata, path);
+            std::ifstream file(path, std::ios::binary);
+            roundtrip_ok = roundtrip_ok && std::vector<uint8_t>((std::istreambuf_iterator<char>(file)),
+                                                                std::istreambuf_iterator<char>()) == data;
+            std::remove(path.c_str());
+        }
+        return archive.size();
+    };
+    size_t fasta_plain = archive_size(fasta_bytes, false, 0, CompressionRoute::Dvnp);
+    size_t fasta_routed = archive_size(fasta_bytes, true, 0, CompressionRoute::Nucleotide);
+    std::string unwrapped = ">chrTest synthetic\n" + bases + "\n";
+    size_t unwrapped_routed = archive_size(std::vector<uint8_t>(unwrapped.begin(), unwrapped.end()), true, 0,
+                                           CompressionRoute::Nucleotide);
+    archive_size(fasta_bytes, true, 16384, CompressionRoute::Nucleotide);
+    size_t random_plain = archive_size(random, false, 0, CompressionRoute::Dvnp);
+    size_t random_routed = archive_size(random, true, 65536, CompressionRoute::Stored);
+    archive_size(std::vector<uint8_t>(text.begin(), text.end()), true, 0, CompressionRoute::Dvnp);
+    
+    // A failed write of a routed output (here past a file size limit) is an error, not a short file
+    bool full_disk_detected = false;
+    {
+        CircularChromosomeCompressor compressor(1000, 4, true, false);
+        compressor.set_auto_route(true);
+        auto [codes, metadata] = compressor.compress(fasta_bytes);
+        const std::string path = "test_ccc_routed_full.out";
+        full_disk_detected = fails_past_file_size_limit(4096, [&]() {
+            compressor.decompress_to_file(codes, metadata, path);
+        }) && !std::filesystem::exists(path) && !staged_files_left(path);
+    }
+    
+    // Stored codes are still hash-checked
+    bool tamper_detected = false;
+    {
+        CircularChromosomeCompressor compressor(1000, 4, true, false);
+        compressor.set_auto_route(true);
+        auto [codes, metadata] = compressor.compress(gzip_like);
+        codes[1000] ^= 1;
+        try {
+            compressor.decompress(codes, metadata);
+        } catch (const std::runtime_error&) {
+            tamper_detected = true;
+        }
+    }
+    
+    std::cout << std::dec << "FASTA: " << fasta_bytes.size() << " bytes -> " << fasta_plain << " (binary path), "
+              << fasta_routed << " (nucleotide route), " << unwrapped_routed << " without line breaks" << std::endl;
+    std::cout << "Random: " << random.size() << " bytes -> " << random_plain << " (binary path), " << random_routed
+              << " (stored)" << std::endl;
+    std::cout << "Classified 64 MB in " << std::fixed << std::setprecision(1) << classify_us << " us ("
+              << large_profile.sampled_bytes << " bytes sampled)" << std::endl;
+    
+    if (classify_ok && layout_ok && roundtrip_ok && tamper_detected && full_disk_detected &&
+        fasta_routed * 10 < fasta_plain * 9 &&
+        fasta_routed * 100 < unwrapped_routed * 102 &&
+        random_routed < random.size() + 1024 && random_routed < random_plain) {
+        std::cout << "✓ Input classification and routing successful!" << std::endl;
+    } else {
+        std::cout << "✗ Input classification and routing failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_prefilters() {
+    std::cout << "\n=== Typed Pre-Filter Test ===" << std::endl;
+    
+    // Every kernel, SIMD and scalar, at sizes with and without partial vectors and elements
+    std::mt19937 rng(7);
+    bool kernels_ok = true;
+    const FilterKind kinds[] = {FilterKind::Delta, FilterKind::XorDelta, FilterKind::ByteShuffle, FilterKind::BitShuffle};
+    for (FilterKind kind : kinds) {
+        for (size_t width : {1, 2, 4, 8}) {
+            if (kind == FilterKind::ByteShuffle && width == 1) {
+                continue;
+            }
+            FilterStage stage{kind, width};
+            for (size_t size : {0, 1, 7, 15, 16, 17, 100, 1023, 4099}) {
+                std::vector<uint8_t> data(size), simd(size), scalar(size), restored(size), restored_scalar(size);
+                for (uint8_t& byte : data) {
+                    byte = static_cast<uint8_t>(rng());
+                }
+                apply_filter(data.data(), simd.data(), size, stage, true);
+                apply_filter(data.data(), scalar.data(), size, stage, false);
+                invert_filter(simd.data(), restored.data(), size, stage, true);
+                invert_filter(simd.data(), restored_scalar.data(), size, stage, false);
+                kernels_ok = kernels_ok && simd == scalar && restored == data && restored_scalar == data;
+            }
+        }
+    }
+    
+    // Known outputs: little-endian 16-bit deltas, 32-bit byte planes, bit planes of bytes
+    const uint8_t series[] = {1, 0, 3, 0, 6, 0, 5, 1};
+    const uint8_t planes_in[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    const uint8_t bits_in[] = {0x80, 0, 0, 0, 0, 0, 0, 0x81};
+    uint8_t out[8];
+    apply_filter(series, out, 8, {FilterKind::Delta, 2});
+    bool known_ok = std::vector<uint8_t>(out, out + 8) == std::vector<uint8_t>{1, 0, 2, 0, 3, 0, 0xFF, 0};
+    apply_filter(planes_in, out, 8, {FilterKind::ByteShuffle, 4});
+    known_ok = known_ok && std::vector<uint8_t>(out, out + 8) == std::vector<uint8_t>{1, 5, 2, 6, 3, 7, 4, 8};
+    apply_filter(bits_in, out, 8, {FilterKind::BitShuffle, 1});
+    known_ok = known_ok && std::vector<uint8_t>(out, out + 8) == std::vector<uint8_t>{0x81, 0, 0, 0, 0, 0, 0, 0x80};
+    
+    bool parse_ok = filter_chain_name(parse_filter_chain("delta4,shuffle4")) == "delta4,shuffle4" &&
+                    parse_filter_chain("none").empty() && filter_chain_name({}) == "none";
+    for (const char* bad : {"shuffle1", "delta3", "rotate4", "delta", "4"}) {
+        try {
+            parse_filter_chain(bad);
+            parse_ok = false;
+        } catch (const std::invalid_argument&) {
+        }
+    }
+    
+    // Coverage track: slowly varying 32-bit counts; signal: 32-bit floats of a noisy sine
+    std::vector<uint8_t> coverage(1 << 20);
+    uint32_t depth = 30;
+    for (size_t i = 0; i < coverage.size(); i += 4) {
+        depth = static_cast<uint32_t>(std::max<int64_t>(0, static_cast<int64_t>(depth) + static_cast<int>(rng() % 5) - 2));
+        std::memcpy(&coverage[i], &depth, 4);
+    }
+    std::vector<uint8_t> signal(1 << 19);
+    for (size_t i = 0; i < signal.size(); i += 4) {
+        float sample = static_cast<float>(std::sin(i * 0.001) + (rng() % 16) / 4096.0);
+        std::memcpy(&signal[i], &sample, 4);
+    }
+    
+    bool roundtrip_ok = true;
+    auto archive_size = [&](const std::vector<uint8_t>& data, const std::string& chain, size_t block_size) {
+        CircularChromosomeCompressor compressor(1000, 4, true, false);
+        compressor.set_block_size(block_size);
+        compressor.set_prefilters(parse_filter_chain(chain));
+        auto [codes, metadata] = compressor.compress(data);
+        std::vector<uint8_t> archive = serialize_archive(codes, metadata);
+        auto [read_codes, read_metadata] = deserialize_archive(archive.data(), archive.size());
+        roundtrip_ok = roundtrip_ok && filter_chain_name(read_metadata.core.filters) == chain &&
+                       compressor.decompress(read_codes, read_metadata) == data;
+        if (block_size > 0) {
+            CircularChromosomeCompressor recompressor(1000, 4, true, false);
+            recompressor.set_block_size(block_size * 2);
+            auto [re_codes, re_metadata] = recompressor.recompress(read_codes, read_metadata);
+            const std::string path = "test_ccc_prefilter.bin";
+            recompressor.decompress_to_file(re_codes, re_metadata, path);
+            std::ifstream file(path, std::ios::binary);
+            roundtrip_ok = roundtrip_ok && re_metadata.core.filters == read_metadata.core.filters &&
+                           std::vector<uint8_t>((std::istreambuf_iterator<char>(file)),
+                                                std::istreambuf_iterator<char>()) == data;
+            std::remove(path.c_str());
+        }
+        return archive.size();
+    };
+    size_t coverage_plain = archive_size(coverage, "none", 262144);
+    size_t coverage_filtered = archive_size(coverage, "delta4,shuffle4", 262144);
+    size_t signal_plain = archive_size(signal, "none", 0);
+    size_t signal_filtered = archive_size(signal, "shuffle4", 0);
+    archive_size(signal, "xor4,bitshuffle4", 131072);
+    
+    bool rejected = false;
+    try {
+        CircularChromosomeCompressor compressor;
+        compressor.set_prefilters({{FilterKind::ByteShuffle, 3}});
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    
+    std::cout << std::dec << "Coverage: " << coverage.size() << " bytes -> " << coverage_plain << " (unfiltered), "
+              << coverage_filtered << " (delta4,shuffle4)" << std::endl;
+    std::cout << "Signal: " << signal.size() << " bytes -> " << signal_plain << " (unfiltered), "
+              << signal_filtered << " (shuffle4)" << std::endl;
+    
+    if (kernels_ok && known_ok && parse_ok && roundtrip_ok && rejected && coverage_filtered * 3 < coverage_plain * 2 &&
+        signal_filtered < signal_plain) {
+        std::cout << "✓ Typed pre-filters successful!" << std::endl;
+    } else {
+        std::cout << "✗ Typed pre-filters failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_verify_on_write() {
+    std::cout << "\n=== Verify-on-Write Test ===" << std::endl;
+    
+    // Records repeating with mutations, plus microsatellite-like runs for the tandem stage
+    std::mt19937 rng(11);
+    std::vector<uint8_t> record(5000);
+    for (uint8_t& byte : record) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    std::vector<uint8_t> data;
+    while (data.size() < (2 << 20)) {
+        data.insert(data.end(), record.begin(), record.end());
+        record[rng() % record.size()] = static_cast<uint8_t>(rng());
+        data.insert(data.end(), 64, static_cast<uint8_t>(0x1B));
+    }
+    
+    // Each configuration compresses twice; verification must not change the output
+    bool identical = true;
+    bool roundtrip_ok = true;
+    auto check = [&](const std::vector<uint8_t>& input, const std::function<void(CircularChromosomeCompressor&)>& setup) {
+        CircularChromosomeCompressor plain(1000, 4, true, false);
+        CircularChromosomeCompressor verified(1000, 4, true, false);
+        setup(plain);
+        setup(verified);
+        verified.set_verify_on_write(true);
+        auto start = std::chrono::high_resolution_clock::now();
+        auto [plain_codes, plain_metadata] = plain.compress(input);
+        double plain_seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        start = std::chrono::high_resolution_clock::now();
+        auto [codes, metadata] = verified.compress(input);
+        double verified_seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        identical = identical && codes == plain_codes;
+        roundtrip_ok = roundtrip_ok && verified.decompress(codes, metadata) == input;
+        return std::make_pair(plain_seconds, verified_seconds);
+    };
+    auto blocks = check(data, [](CircularChromosomeCompressor& c) { c.set_block_size(65536); c.set_num_threads(4); });
+    check(data, [](CircularChromosomeCompressor& c) { c.set_block_size(65536); c.set_seed_window(16384); });
+    check(data, [](CircularChromosomeCompressor& c) { c.set_block_size(65536); c.set_lanes(4); });
+    check(data, [](CircularChromosomeCompressor& c) { c.set_block_size(65536); c.set_tandem_repeats(kTandemDefaultMinBases); });
+    check(data, [](CircularChromosomeCompressor& c) {
+        c.set_block_size(65536);
+        c.set_prefilters(parse_filter_chain("delta2,shuffle2"));
+    });
+    std::string fasta = ">seq\n";
+    for (size_t i = 0; i < 100000; ++i) {
+        fasta += "ACGT"[rng() & 3];
+        if (i % 60 == 59) {
+            fasta += '\n';
+        }
+    }
+    check(std::vector<uint8_t>(fasta.begin(), fasta.end()), [](CircularChromosomeCompressor& c) {
+        c.set_block_size(16384);
+        c.set_auto_route(true);
+    });
+    // Single stream: several dictionary-reset segments, each checked on a worker
+    auto single = check(std::vector<uint8_t>(data.begin(), data.begin() + 524288), [](CircularChromosomeCompressor&) {});
+    
+    // Recompression re-encodes with verification too
+    bool recompress_ok = false;
+    {
+        CircularChromosomeCompressor source(1000, 4, true, false);
+        source.set_block_size(32768);
+        auto [codes, metadata] = source.compress(data);
+        CircularChromosomeCompressor recompressor(1000, 4, true, false);
+        recompressor.set_block_size(131072);
+        recompressor.set_seed_window(32768);
+        recompressor.set_verify_on_write(true);
+        auto [re_codes, re_metadata] = recompressor.recompress(codes, metadata);
+        recompress_ok = recompressor.decompress(re_codes, re_metadata) == data;
+    }
+    
+    std::cout << std::dec << "Block mode, " << data.size() << " bytes: " << std::fixed << std::setprecision(3)
+              << blocks.first << " s plain, " << blocks.second << " s with verification" << std::endl;
+    std::cout << "Single stream, 524288 bytes: " << single.first << " s plain, " << single.second
+              << " s with verification" << std::endl;
+    
+    if (identical && roundtrip_ok && recompress_ok) {
+        std::cout << "✓ Verify-on-write successful!" << std::endl;
+    } else {
+        std::cout << "✗ Verify-on-write failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_striped_archive() {
+    std::cout << "\n=== Striped Multi-volume Archive Test ===" << std::endl;
+    
+    // Enough codes for several stripes per volume
+    std::vector<uint8_t> test_data(3 * 1048576);
+    uint32_t state = 11;
+    for (size_t i = 0; i < test_data.size(); ++i) {
+        state = state * 1664525u + 1013904223u;
+        test_data[i] = (i / 4096) % 3 ? static_cast<uint8_t>(state >> 24) : static_cast<uint8_t>(i % 251);
+    }
+    CircularChromosomeCompressor compressor(1000, 4, true, false);
+    compressor.set_block_size(65536);
+    auto [compressed_data, metadata] = compressor.compress(test_data);
+    
+    const std::filesystem::path dir = "test_ccc_striped";
+    std::filesystem::remove_all(dir);
+    const std::string index_path = (dir / "archive.ccc").string();
+    std::vector<std::string> volumes;
+    for (int v = 0; v < 3; ++v) {
+        volumes.push_back((dir / ("disk" + std::to_string(v)) / "archive.vol").string());
+    }
+    write_striped_archive(index_path, volumes, compressed_data, metadata);
+    
+    auto [read_codes, read_metadata] = read_striped_archive(index_path);
+    bool round_trip = is_striped_archive(index_path) && !is_archive(index_path) && read_codes == compressed_data &&
+                      compressor.decompress(read_codes, read_metadata) == test_data &&
+                      read_archive_stats(index_path).total_codes == compressed_data.size() &&
+                      striped_archive_volumes(index_path).size() == 3;
+    
+    // Every volume holds a share of the stripes
+    std::vector<uintmax_t> sizes;
+    for (const std::string& volume : volumes) {
+        sizes.push_back(std::filesystem::file_size(volume));
+    }
+    bool balanced = *std::min_element(sizes.begin(), sizes.end()) * 2 > *std::max_element(sizes.begin(), sizes.end());
+    
+    // A stale volume from another archive and a missing volume are both rejected
+    std::filesystem::copy_file(volumes[1], dir / "saved.vol");
+    write_striped_archive((dir / "other.ccc").string(), {volumes[1]}, compressed_data, metadata);
+    bool foreign_rejected = false;
+    try {
+        read_striped_archive(index_path);
+    } catch (const std::runtime_error&) {
+        foreign_rejected = true;
+    }
+    std::filesystem::remove(volumes[1]);
+    bool missing_rejected = false;
+    try {
+        read_striped_archive(index_path);
+    } catch (const std::runtime_error&) {
+        missing_rejected = true;
+    }
+    std::filesystem::rename(dir / "saved.vol", volumes[1]);
+    bool restored = read_striped_archive(index_path, 1).first == compressed_data;
+    std::filesystem::remove_all(dir);
+    
+    std::cout << std::dec << compressed_data.size() << " codes striped over 3 volumes of " << sizes[0] << ", " 
+              << sizes[1] << ", " << sizes[2] << " bytes" << std::endl;
+    
+    if (round_trip && balanced && foreign_rejected && missing_rejected && restored) {
+        std::cout << "✓ Striped multi-volume archive successful!" << std::endl;
+    } else {
+        std::cout << "✗ Striped multi-volume archive failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_recompaction() {
+    std::cout << "\n=== Archive Recompaction Test ===" << std::endl;
+    
+    std::vector<std::string> words;
+    uint32_t state = 99;
+    for (int w = 0; w < 64; ++w) {
+        std::string word;
+        state = state * 1664525u + 1013904223u;
+        size_t length = 20 + (state >> 24) % 200;
+        for (size_t i = 0; i < length; ++i) {
+            state = state * 1664525u + 1013904223u;
+            word += "ACGT"[state >> 30];
+        }
+        words.push_back(word);
+    }
+    std::vector<uint8_t> test_data;
+    while (test_data.size() < 400000) {
+        state = state * 1664525u + 1013904223u;
+        const std::string& word = words[(state >> 16) % words.size()];
+        test_data.insert(test_data.end(), word.begin(), word.end());
+    }
+    
+    // Fast ingest: small blocks with a small dictionary, seeded so the source decodes serially
+    CircularChromosomeCompressor fast(1000, 4, true, false);
+    fast.set_block_size(16384);
+    fast.set_max_dict_size(4096);
+    fast.set_seed_window(4096);
+    auto [fast_data, fast_metadata] = fast.compress(test_data);
+    
+    CircularChromosomeCompressor strong(1000, 4, true, false);
+    strong.set_block_size(131072);
+    strong.set_max_dict_size(1u << 18);
+    strong.set_seed_window(32768);
+    strong.set_num_threads(2);
+    auto [strong_data, strong_metadata] = strong.recompress(fast_data, fast_metadata);
+    
+    // A single-stream source is re-encoded segment by segment between its dictionary resets
+    CircularChromosomeCompressor single(1000, 4, true, false);
+    auto [single_data, single_metadata] = single.compress(test_data);
+    auto [resplit_data, resplit_metadata] = strong.recompress(single_data, single_metadata);
+    bool single_ok = single_metadata.core.blocks.empty() && single_metadata.core.reset_count > 0 &&
+                     strong.decompress(resplit_data, resplit_metadata) == test_data;
+    CompressionMetadata short_metadata = single_metadata;
+    short_metadata.core.original_size -= 1;
+    try {
+        strong.recompress(single_data, short_metadata);
+        single_ok = false;
+    } catch (const std::invalid_argument&) {
+    }
+    
+    // Through files: idle priority, atomic replace, report
+    const std::string archive_path = "test_ccc_recompact.ccc";
+    write_archive(archive_path, fast_data, fast_metadata);
+    RecompactionOptions options;
+    options.block_size = 131072;
+    options.max_dict_size = 1u << 18;
+    options.seed_window = 32768;
+    // A write that cannot complete (here past a file size limit) must neither replace nor litter
+    const std::string staged_path = archive_path + ".recompact";
+    const uintmax_t before_bytes = std::filesystem::file_size(archive_path);
+    bool failed_write_safe = fails_past_file_size_limit(65536, [&]() { recompact_archive(archive_path, options); }) &&
+                             std::filesystem::file_size(archive_path) == before_bytes &&
+                             !std::filesystem::exists(staged_path) && !staged_files_left(staged_path);
+    RecompactionResult result = recompact_archive(archive_path, options);
+    auto [file_data, file_metadata] = read_archive(archive_path);
+    CompressionStats header = read_archive_stats(archive_path);
+    std::remove(archive_path.c_str());
+    
+    std::cout << std::dec << "Archive: " << result.original_bytes << " → " << result.recompacted_bytes 
+              << " bytes, reclaimed " << result.bytes_reclaimed() << std::endl;
+    
+    if (strong_metadata.core.blocks.size() == 4 && strong_data.size() < fast_data.size() &&
+        strong.decompress(strong_data, strong_metadata) == test_data &&
+        std::abs(strong_metadata.stats.original_entropy - fast_metadata.stats.original_entropy) < 1e-9 &&
+        result.replaced && result.bytes_reclaimed() > 0 && header.original_size_bytes == test_data.size() &&
+        strong.decompress(file_data, file_metadata) == test_data && single_ok && failed_write_safe) {
+        std::cout << "✓ Archive recompaction successful!" << std::endl;
+    } else {
+        std::cout << "✗ Archive recompaction failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_twobit() {
+    std::cout << "\n=== UCSC .2bit Test ===" << std::endl;
+    
+    // Sequences with N runs, soft-masked runs and lengths not divisible by 4
+    std::vector<TwoBitRecord> records;
+    uint32_t state = 2024;
+    for (size_t s = 0; s < 3; ++s) {
+        std::string seq;
+        size_t length = 20000 + s * 7001;
+        for (size_t i = 0; i < length; ++i) {
+            state = state * 1664525u + 1013904223u;
+            seq += "ACGT"[state >> 30];
+        }
+        std::fill_n(seq.begin() + 100 * (s + 1), 250, 'N');
+        std::fill_n(seq.end() - 3, 3, 'N');
+        std::transform(seq.begin() + 5000, seq.begin() + 6500, seq.begin() + 5000,
+                       [](char ch) { return static_cast<char>(std::tolower(static_cast<unsigned char>(ch))); });
+        records.push_back(TwoBitRecord::from_sequence("chr" + std::to_string(s + 1), seq));
+    }
+    records.push_back(TwoBitRecord::from_sequence("chrEmpty", ""));
+    
+    const std::string twobit_path = "test_ccc_genome.2bit";
+    const std::string archive_path = "test_ccc_genome.ccc";
+    const std::string export_path = "test_ccc_genome_export.2bit";
+    write_twobit(twobit_path, records);
+    
+    bool reader_ok = true;
+    {
+        TwoBitReader reader(twobit_path);
+        reader_ok = reader.sequence_count() == records.size() && reader.find("chr2") == 1 &&
+                    reader.find("chrX") == TwoBitReader::npos;
+        for (size_t s = 0; s < records.size() && reader_ok; ++s) {
+            std::string expected = records[s].to_sequence();
+            reader_ok = reader.sequence(s) == expected && reader.record(s).packed == records[s].packed;
+            if (!expected.empty()) {
+                size_t n_position = 100 * (s + 1) + 10;
+                reader_ok = reader_ok && reader.base(s, 5001) == expected[5001] && reader.base(s, n_position) == 'N' &&
+                            reader.packed_base(s, n_position) == 'T' &&
+                            reader.sequence(s, 4990, 30) == expected.substr(4990, 30);
+            }
+        }
+    }
+    
+    CircularChromosomeCompressor compressor(1000, 4, true, false);
+    compressor.set_block_size(4096);
+    size_t imported = twobit_to_archive(twobit_path, archive_path, compressor, 2);
+    std::vector<MemberIndexEntry> index = read_multi_archive_index(archive_path);
+    SequenceMember member = read_multi_archive_member(archive_path, 1);
+    size_t exported = archive_to_twobit(archive_path, export_path, 2);
+    
+    auto read_bytes = [](const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    };
+    std::vector<uint8_t> original = read_bytes(twobit_path);
+    std::vector<uint8_t> regenerated = read_bytes(export_path);
+    auto archive_size = std::filesystem::file_size(archive_path);
+    
+    // A sequence count the index cannot hold and an N run past its sequence are both rejected
+    auto rejected = [&](const std::vector<uint8_t>& bytes) {
+        std::ofstream(twobit_path, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        try {
+            TwoBitReader reader(twobit_path);
+            reader.record(0);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    auto u32_at = [&](size_t at) {
+        return uint32_t(original[at]) | uint32_t(original[at + 1]) << 8 | uint32_t(original[at + 2]) << 16 |
+               uint32_t(original[at + 3]) << 24;
+    };
+    std::vector<uint8_t> huge_count = original;
+    huge_count[11] = 0x10;
+    std::vector<uint8_t> bad_run = original;
+    const size_t chr1 = u32_at(16 + 1 + 4);             // "chr1" entry: name size, name, offset
+    const uint32_t past_end = u32_at(chr1) - 100;       // start of the first N run, 250 bases long
+    std::memcpy(bad_run.data() + chr1 + 8, &past_end, 4);
+    bool malformed_rejected = rejected(huge_count) && rejected(bad_run);
+    std::remove(twobit_path.c_str());
+    std::remove(archive_path.c_str());
+    std::remove(export_path.c_str());
+    
+    std::cout << std::dec << ".2bit: " << original.size() << " bytes, archive: " << archive_size << " bytes" << std::endl;
+    
+    if (reader_ok && imported == records.size() && exported == records.size() && index.size() == records.size() &&
+        index[0].n_blocks.size() == 2 && index[0].mask_blocks.size() == 1 && member.name == "chr2" &&
+        member.length == records[1].length && regenerated == original && malformed_rejected) {
+        std::cout << "✓ UCSC .2bit import/export successful!" << std::endl;
+    } else {
+        std::cout << "✗ UCSC .2bit import/export failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_solid_archive() {
+    std::cout << "\n=== Solid Archive Test ===" << std::endl;
+    
+    // Three families of small sequences (0.2% point mutations of a shared ancestor), two unrelated
+    // sequences, one shorter than a k-mer and one empty
+    uint32_t state = 4242;
+    auto random_sequence = [&](size_t length) {
+        std::string seq;
+        for (size_t i = 0; i < length; ++i) {
+            state = state * 1664525u + 1013904223u;
+            seq += "ACGT"[state >> 30];
+        }
+        return seq;
+    };
+    std::vector<TwoBitRecord> records;
+    std::vector<int> family;
+    for (int f = 0; f < 3; ++f) {
+        std::string ancestor = random_sequence(4000 + 1000 * f);
+        for (int m = 0; m < 8; ++m) {
+            std::string seq = ancestor;
+            for (size_t i = 0; i < seq.size() / 500; ++i) {
+                state = state * 1664525u + 1013904223u;
+                seq[state % seq.size()] = "ACGT"[(state >> 7) & 3];
+            }
+            seq.resize(seq.size() - 37 * m);
+            records.push_back(TwoBitRecord::from_sequence("f" + std::to_string(f) + "_" + std::to_string(m), seq));
+            family.push_back(f);
+        }
+    }
+    records.push_back(TwoBitRecord::from_sequence("lone1", random_sequence(9001)));
+    records.push_back(TwoBitRecord::from_sequence("lone2", random_sequence(7003)));
+    records.push_back(TwoBitRecord::from_sequence("tiny", "ACGTTG"));
+    records.push_back(TwoBitRecord::from_sequence("empty", ""));
+    family.insert(family.end(), {-1, -2, -3, -4});
+    // Interleave the families so grouping, not input order, brings relatives together
+    std::vector<size_t> order(records.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937 shuffle_rng(7);
+    std::shuffle(order.begin(), order.end(), shuffle_rng);
+    std::vector<TwoBitRecord> shuffled;
+    std::vector<int> shuffled_family;
+    for (size_t i : order) {
+        shuffled.push_back(records[i]);
+        shuffled_family.push_back(family[i]);
+    }
+    
+    MinHashSketch a = minhash_sketch(shuffled[0].packed.data(), shuffled[0].length, 16, 128);
+    MinHashSketch b = minhash_sketch(shuffled[0].packed.data(), shuffled[0].length, 16, 128);
+    MinHashSketch unrelated = minhash_sketch(records[24].packed.data(), records[24].length, 16, 128);
+    bool sketch_ok = a.size() == 128 && a == b && std::is_sorted(a.begin(), a.end()) &&
+                     sketch_containment(a, b) == 1.0 && sketch_containment(a, unrelated) < 0.05 &&
+                     minhash_sketch(records[26].packed.data(), records[26].length, 16, 128).empty();
+    
+    const std::string twobit_path = "test_ccc_solid.2bit";
+    const std::string plain_path = "test_ccc_solid_plain.ccc";
+    const std::string solid_path = "test_ccc_solid.ccc";
+    const std::string export_path = "test_ccc_solid_export.2bit";
+    write_twobit(twobit_path, shuffled);
+    
+    CircularChromosomeCompressor compressor(1000, 4, true, false);
+    twobit_to_archive(twobit_path, plain_path, compressor, 2);
+    size_t imported = twobit_to_solid_archive(twobit_path, solid_path, compressor, SolidOptions(), 2);
+    std::vector<MemberIndexEntry> index = read_multi_archive_index(solid_path);
+    size_t exported = archive_to_twobit(solid_path, export_path, 2);
+    
+    // Every family in one stream of its own; members extract from their stream alone
+    bool grouping_ok = index.size() == shuffled.size();
+    std::set<size_t> streams;
+    for (size_t i = 0; i < index.size() && grouping_ok; ++i) {
+        if (index[i].length == 0) {
+            continue;
+        }
+        streams.insert(index[i].stream);
+        for (size_t j = 0; j < index.size(); ++j) {
+            if (index[j].length != 0 && j != i) {
+                bool same_stream = index[i].stream == index[j].stream;
+                grouping_ok = grouping_ok && same_stream == (shuffled_family[i] == shuffled_family[j]);
+            }
+        }
+    }
+    bool extract_ok = true;
+    for (size_t i = 0; i < index.size(); ++i) {
+        extract_ok = extract_ok && extract_multi_archive_member(solid_path, index[i]) == shuffled[i].packed;
+    }
+    
+    auto read_bytes = [](const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    };
+    bool roundtrip_ok = read_bytes(export_path) == read_bytes(twobit_path);
+    auto plain_size = std::filesystem::file_size(plain_path);
+    auto solid_size = std::filesystem::file_size(solid_path);
+    for (const std::string& path : {twobit_path, plain_path, solid_path, export_path}) {
+        std::remove(path.c_str());
+    }
+    
+    std::cout << std::dec << shuffled.size() << " members in " << streams.size() << " streams; per-member archive: "
+              << plain_size << " bytes, solid: " << solid_size << " bytes" << std::endl;
+    
+    if (sketch_ok && grouping_ok && extract_ok && roundtrip_ok && imported == shuffled.size() &&
+        exported == shuffled.size() && streams.size() == 6 && solid_size * 10 < plain_size * 9) {
+        std::cout << "✓ Solid archive successful!" << std::endl;
+    } else {
+        std::cout << "✗ Solid archive failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_erasure_coding() {
+    std::cout << "\n=== Reed-Solomon Erasure Coding Test ===" << std::endl;
+    
+    // Field sanity: every nonzero element times its inverse is 1
+    bool field_ok = gf_mul(0x53, 0xCA) == gf_mul(0xCA, 0x53) && gf_mul(7, 0) == 0;
+    for (unsigned a = 1; a < 256; ++a) {
+        field_ok = field_ok && gf_mul(static_cast<uint8_t>(a), gf_inverse(static_cast<uint8_t>(a))) == 1;
+    }
+    
+    // All kernels agree on odd lengths (SIMD bodies plus scalar tails)
+    std::vector<uint8_t> source(1000 + 37);
+    for (size_t i = 0; i < source.size(); ++i) {
+        source[i] = static_cast<uint8_t>(i * 131 + 7);
+    }
+    std::vector<uint8_t> expected(source.size(), 0x5A);
+    gf_mul_region(source.data(), expected.data(), source.size(), 0x8E, true, GfKernel::Scalar);
+    bool kernels_agree = true;
+    for (GfKernel kernel : {GfKernel::SSSE3, GfKernel::AVX2, GfKernel::Auto}) {
+        std::vector<uint8_t> product(source.size(), 0x5A);
+        gf_mul_region(source.data(), product.data(), source.size(), 0x8E, true, kernel);
+        kernels_agree = kernels_agree && product == expected;
+    }
+    
+    // Any parity_shards erasures of a group are repaired
+    const size_t k = 6, m = 3, shard_size = 333;
+    ReedSolomon codec(k, m);
+    std::vector<std::vector<uint8_t>> group(k + m, std::vector<uint8_t>(shard_size, 0));
+    uint32_t state = 5;
+    for (size_t i = 0; i < k; ++i) {
+        for (auto& byte : group[i]) {
+            state = state * 1664525u + 1013904223u;
+            byte = static_cast<uint8_t>(state >> 24);
+        }
+    }
+    std::vector<uint8_t*> pointers;
+    for (auto& shard : group) {
+        pointers.push_back(shard.data());
+    }
+    codec.encode(pointers.data(), pointers.data() + k, shard_size);
+    const std::vector<std::vector<uint8_t>> original = group;
+    bool repairs_ok = true;
+    for (size_t trial = 0; trial < 40; ++trial) {
+        std::vector<bool> present(k + m, true);
+        for (size_t lost = 0; lost < m; ++lost) {
+            state = state * 1664525u + 1013904223u;
+            size_t victim = (state >> 16) % (k + m);
+            present[victim] = false;
+            std::fill(group[victim].begin(), group[victim].end(), 0xEE);
+        }
+        codec.reconstruct(pointers.data(), present, shard_size);
+        repairs_ok = repairs_ok && group == original;
+    }
+    bool too_many_rejected = false;
+    try {
+        std::vector<bool> present(k + m, true);
+        for (size_t i = 0; i <= m; ++i) {
+            present[i] = false;
+        }
+        codec.reconstruct(pointers.data(), present, shard_size);
+    } catch (const std::runtime_error&) {
+        too_many_rejected = true;
+    }
+    
+    // Shard container around a real archive: shuffled, lost and corrupted shards
+    std::string pattern = "Cold archive of compressed blocks spread over oligo pools. ";
+    std::vector<uint8_t> test_data;
+    while (test_data.size() < 50000) {
+        test_data.insert(test_data.end(), pattern.begin(), pattern.end());
+    }
+    CircularChromosomeCompressor compressor(1000, 4, true, false);
+    compressor.set_block_size(8192);
+    auto [compressed, metadata] = compressor.compress(test_data);
+    std::vector<uint8_t> archive = serialize_archive(compressed, metadata);
+    
+    ErasureOptions options;
+    options.data_shards = 8;
+    options.parity_shards = 3;
+    options.shard_size = 512;
+    std::vector<std::vector<uint8_t>> shards = erasure_encode(archive.data(), archive.size(), options);
+    const size_t groups = shards.size() / 11;
+    std::vector<std::vector<uint8_t>> received;
+    for (size_t g = 0; g < groups; ++g) {
+        for (size_t i = 0; i < 11; ++i) {
+            // Per group: drop two data shards, corrupt one more
+            if (i == g % 8 || i == (g + 3) % 8) {
+                continue;
+            }
+            received.push_back(shards[g * 11 + i]);
+            if (i == 10) {
+                received.back()[kErasureShardHeaderSize + 5] ^= 0x40;
+            }
+        }
+    }
+    std::reverse(received.begin(), received.end());
+    ErasureRepairReport report;
+    std::vector<uint8_t> recovered = erasure_decode(received, &report);
+    auto [recovered_codes, recovered_metadata] = deserialize_archive(recovered.data(), recovered.size());
+    
+    // Foreign shards ahead of the real ones must not define the stream
+    std::vector<std::vector<uint8_t>> mixed = erasure_encode(archive.data(), archive.size() / 2, options);
+    mixed.resize(3);
+    mixed.insert(mixed.end(), received.begin(), received.end());
+    ErasureRepairReport mixed_report;
+    bool foreign_ignored = erasure_decode(mixed, &mixed_report) == archive &&
+                           mixed_report.shards_rejected == groups + 3;
+    
+    // One more loss in the first group exceeds its parity
+    received.erase(std::remove_if(received.begin(), received.end(), [&](const std::vector<uint8_t>& shard) {
+        return shard == shards[8] || shard == shards[9];
+    }), received.end());
+    bool unrecoverable_rejected = false;
+    try {
+        erasure_decode(received);
+    } catch (const std::runtime_error&) {
+        unrecoverable_rejected = true;
+    }
+    
+    std::cout << std::dec << "Archive " << archive.size() << " bytes -> " << shards.size() << " shards in " 
+              << groups << " groups; rebuilt " << report.shards_rebuilt << ", rejected " 
+              << report.shards_rejected << " (kernel " << gf_kernel_name(codec.kernel()) << ")" << std::endl;
+    
+    if (field_ok && kernels_agree && repairs_ok && too_many_rejected && recovered == archive &&
+        report.shards_rebuilt == 2 * groups && report.shards_rejected == groups &&
+        compressor.decompress(recovered_codes, recovered_metadata) == test_data && unrecoverable_rejected &&
+        foreign_ignored) {
+        std::cout << "✓ Reed-Solomon erasure coding successful!" << std::endl;
+    } else {
+        std::cout << "✗ Reed-Solomon erasure coding failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_sequence_store() {
+    std::cout << "\n=== Compressed Sequence Store Test ===" << std::endl;
+    
+    // Repetitive genomes with masked stretches and N gaps
+    std::vector<std::pair<std::string, std::string>> batch;
+    uint32_t state = 3;
+    std::string motif;
+    for (int i = 0; i < 300; ++i) {
+        state = state * 1664525u + 1013904223u;
+        motif += "ACGT"[state >> 30];
+    }
+    for (int s = 0; s < 12; ++s) {
+        std::string sequence;
+        while (sequence.size() < 50000 + 1000 * static_cast<size_t>(s)) {
+            state = state * 1664525u + 1013904223u;
+            size_t cut = (state >> 8) % motif.size();
+            sequence += motif.substr(cut) + motif.substr(0, cut);
+            sequence += "ACGT"[state >> 30];
+        }
+        sequence.resize(50000 + 1000 * static_cast<size_t>(s) + static_cast<size_t>(s));
+        std::fill_n(sequence.begin() + 700 * (s + 1), 90, 'N');
+        std::transform(sequence.begin() + 20000, sequence.begin() + 20500, sequence.begin() + 20000,
+                       [](char ch) { return static_cast<char>(std::tolower(static_cast<unsigned char>(ch))); });
+        batch.emplace_back("seq" + std::to_string(s), sequence);
+    }
+    
+    SequenceStoreOptions options;
+    options.block_bases = 8192;
+    options.cache_bytes = 4 * 2048;       // four decoded blocks
+    options.num_threads = 4;
+    SequenceStore store(options);
+    std::vector<SequenceStore::SequenceId> ids = store.insert_batch(batch);
+    SequenceStore::SequenceId extra = store.insert("random", std::string(3000, 'G') + batch[0].second.substr(0, 5000));
+    
+    bool contents_ok = ids.size() == batch.size() && store.size() == batch.size() + 1 &&
+                       store.find("seq7") == ids[7] && store.find("missing") == SequenceStore::npos &&
+                       store.get(extra) == std::string(3000, 'G') + batch[0].second.substr(0, 5000);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        contents_ok = contents_ok && store.length(ids[i]) == batch[i].second.size() && store.get(ids[i]) == batch[i].second;
+    }
+    // Ranges across block boundaries, N runs and masked runs, clipped at the end
+    const std::string& reference = batch[3].second;
+    for (size_t start : {size_t(0), size_t(2790), size_t(8190), size_t(19990), size_t(reference.size() - 10)}) {
+        contents_ok = contents_ok && store.get(ids[3], start, 600) == reference.substr(start, 600);
+    }
+    contents_ok = contents_ok && store.get(ids[3], reference.size()).empty();
+    
+    // Repeated reads of one region are served from the cache
+    store.clear_cache();
+    SequenceStoreUsage before = store.usage();
+    for (int r = 0; r < 10; ++r) {
+        store.get(ids[5], 30000, 100);
+    }
+    SequenceStoreUsage after = store.usage();
+    bool cache_ok = after.cache_misses - before.cache_misses == 1 && after.cache_hits - before.cache_hits == 9 &&
+                    after.cache_bytes <= options.cache_bytes;
+    
+    bool rejected = false;
+    try {
+        store.get(ids.back() + 10);
+    } catch (const std::out_of_range&) {
+        rejected = true;
+    }
+    
+    std::cout << std::dec << "Stored " << after.sequences << " sequences, " << after.bases << " bases in " 
+              << after.total_bytes() << " bytes (" << after.blocks << " blocks, " << after.raw_blocks 
+              << " raw); " << std::fixed << std::setprecision(2) << after.bases_per_byte() 
+              << " bases per byte" << std::endl;
+    
+    if (contents_ok && cache_ok && rejected && after.arena_used_bytes < after.bases / 4) {
+        std::cout << "✓ Compressed sequence store successful!" << std::endl;
+    } else {
+        std::cout << "✗ Compressed sequence store failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_async_logging() {
+    std::cout << "\n=== Asynchronous Logging Test ===" << std::endl;
+    
+    // Several producers wrapping small rings: nothing lost, per-thread order kept
+    std::ostringstream text_sink;
+    LoggerOptions options;
+    options.ring_records = 64;
+    const size_t kThreads = 4;
+    const size_t kRecords = 2000;
+    {
+        AsyncLogger logger(text_sink, options);
+        std::vector<std::thread> producers;
+        for (size_t t = 0; t < kThreads; ++t) {
+            producers.emplace_back([&logger, t]() {
+                for (size_t i = 0; i < kRecords; ++i) {
+                    logger.log(LogSeverity::Info, "test", "p" + std::to_string(t) + " " + std::to_string(i));
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        logger.flush();
+    }
+    std::vector<long> last(kThreads, -1);
+    size_t lines = 0;
+    bool ordered = true;
+    std::istringstream text_lines(text_sink.str());
+    for (std::string line; std::getline(text_lines, line); ++lines) {
+        size_t at = line.rfind(" p");
+        size_t space = line.find(' ', at + 2);
+        size_t t = std::stoul(line.substr(at + 2, space - at - 2));
+        long i = std::stol(line.substr(space + 1));
+        ordered = ordered && line.find("INFO  [test]") != std::string::npos && i == last[t] + 1;
+        last[t] = i;
+    }
+    bool complete = lines == kThreads * kRecords && ordered;
+    
+    // Severity threshold, JSON fields and escaping, truncation
+    std::ostringstream json_sink;
+    LoggerOptions json_options;
+    json_options.format = LogFormat::Json;
+    json_options.min_severity = LogSeverity::Info;
+    AsyncLogger json_logger(json_sink, json_options);
+    json_logger.log(LogSeverity::Debug, "compress", "filtered out");
+    json_logger.log(LogSeverity::Warning, "compress", "say \"hi\"", 123, 4567);
+    json_logger.log(LogSeverity::Info, "hash", std::string(500, 'x'));
+    json_logger.flush();
+    std::string json = json_sink.str();
+    bool structured = json.find("filtered out") == std::string::npos &&
+                      json.find("\"severity\":\"warning\"") != std::string::npos &&
+                      json.find("\"stage\":\"compress\",\"bytes\":123,\"duration_ns\":4567") != std::string::npos &&
+                      json.find("say \\\"hi\\\"") != std::string::npos &&
+                      json.find("\"truncated\":true") != std::string::npos &&
+                      json_logger.counters().written == 2 && json_logger.counters().truncated == 1;
+    
+    // Drop mode never blocks; every record is either written or counted as dropped
+    std::ostringstream drop_sink;
+    LoggerOptions drop_options;
+    drop_options.ring_records = 16;
+    drop_options.drop_when_full = true;
+    AsyncLogger drop_logger(drop_sink, drop_options);
+    for (int i = 0; i < 1000; ++i) {
+        drop_logger.log(LogSeverity::Info, "test", "burst");
+    }
+    drop_logger.flush();
+    LoggerCounters drop_counters = drop_logger.counters();
+    bool accounted = drop_counters.written + drop_counters.dropped == 1000;
+    
+    // Short-lived threads, as a rebuilt thread pool creates, reuse the rings of exited ones
+    std::ostringstream reuse_sink;
+    AsyncLogger reuse_logger(reuse_sink);
+    for (int round = 0; round < 8; ++round) {
+        std::thread([&reuse_logger]() { reuse_logger.log(LogSeverity::Info, "test", "short-lived"); }).join();
+        reuse_logger.flush();
+    }
+    LoggerCounters reuse_counters = reuse_logger.counters();
+    bool rings_reused = reuse_counters.written == 8 && reuse_counters.threads + reuse_counters.spare_rings == 1 &&
+                        reuse_sink.str().find("tid=8 short-lived") != std::string::npos;
+    
+    // A verbose compressor writes structured stage records through its logger
+    std::ostringstream pipeline_sink;
+    auto pipeline_logger = std::make_shared<AsyncLogger>(pipeline_sink);
+    CircularChromosomeCompressor compressor(1000, 4, true, true);
+    compressor.set_logger(pipeline_logger);
+    compressor.set_block_size(16384);
+    std::vector<uint8_t> test_data(100000);
+    for (size_t i = 0; i < test_data.size(); ++i) {
+        test_data[i] = static_cast<uint8_t>((i * 7) % 13);
+    }
+    auto [compressed_data, metadata] = compressor.compress(test_data);
+    bool round_trip = compressor.decompress(compressed_data, metadata) == test_data;
+    pipeline_logger->flush();
+    std::string pipeline = pipeline_sink.str();
+    bool pipeline_ok = round_trip && pipeline.find("[compress] bytes=100000 duration_us=") != std::string::npos &&
+                       pipeline.find("[decompress] bytes=100000") != std::string::npos &&
+                       pipeline.find("[block_encode]") != std::string::npos &&
+                       pipeline.find("[block_decode]") != std::string::npos;
+    
+    // Cost on the calling thread
+    std::ostringstream cost_sink;
+    LoggerOptions cost_options;
+    cost_options.ring_records = 65536;
+    AsyncLogger cost_logger(cost_sink, cost_options);
+    const int kCalls = 20000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kCalls; ++i) {
+        cost_logger.log(LogSeverity::Info, "test", "Block-parallel compression completed", 1048576, 1000);
+    }
+    double ns_per_call = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / kCalls;
+    cost_logger.flush();
+    
+    std::cout << std::dec << lines << " records from " << kThreads << " threads, " << drop_counters.dropped 
+              << " of 1000 dropped in drop mode, " << ns_per_call << " ns per log call" << std::endl;
+    
+    if (complete && structured && accounted && rings_reused && pipeline_ok &&
+        cost_logger.counters().written == kCalls) {
+        std::cout << "✓ Asynchronous logging successful!" << std::endl;
+    } else {
+        std::cout << "✗ Asynchronous logging failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_autotune_profile() {
+    std::cout << "\n=== Autotune Profile Test ===" << std::endl;
+    
+    // SIMD and scalar symbol kernels must agree
+    std::vector<uint8_t> bytes(1000);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+    std::vector<uint8_t> scalar_symbols(bytes.size() * 4), simd_symbols(bytes.size() * 4);
+    bytes_to_symbols(bytes.data(), bytes.size(), scalar_symbols.data(), SymbolKernel::Scalar);
+    bytes_to_symbols(bytes.data(), bytes.size(), simd_symbols.data(), SymbolKernel::SSSE3);
+    
+    AutotuneOptions options;
+    options.sample_size = 262144;
+    options.block_sizes = {65536, 262144};
+    options.dict_sizes = {4096, 65536};
+    options.thread_counts = {1, 2};
+    MachineProfile profile = Autotuner(options).run();
+    
+    const std::string profile_path = "test_ccc_machine_profile";
+    profile.save(profile_path);
+    MachineProfile loaded = MachineProfile::load(profile_path);
+    
+    // A failed save (past a file size limit) throws and leaves the saved profile and no temp file
+    bool failed_save_safe = fails_past_file_size_limit(64, [&]() { profile.save(profile_path); }) &&
+                            MachineProfile::load(profile_path).levels.size() == loaded.levels.size() &&
+                            !std::filesystem::exists(profile_path + ".tmp");
+    
+    // A stale profile whose dictionary size the compressor rejects is not applied (and does not throw)
+    std::string stale;
+    {
+        std::ifstream file(profile_path);
+        stale.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    size_t dict_field = stale.find("max_dict_size=");
+    stale.replace(dict_field, stale.find('\n', dict_field) - dict_field, "max_dict_size=8");
+    std::ofstream(profile_path) << stale;
+    setenv("CCC_PROFILE", profile_path.c_str(), 1);
+    CircularChromosomeCompressor untuned(1000, 4, true, false);
+    bool stale_rejected = !apply_machine_profile(untuned) && untuned.max_dict_size() == kDvnpMaxDictSize;
+    unsetenv("CCC_PROFILE");
+    std::remove(profile_path.c_str());
+    
+    // Apply the fastest level and round-trip through it
+    CircularChromosomeCompressor compressor(1000, 4, true, false);
+    apply_tuned_config(compressor, loaded.config_for(kMinCompressionLevel));
+    std::vector<uint8_t> test_data(300000);
+    for (size_t i = 0; i < test_data.size(); ++i) {
+        test_data[i] = static_cast<uint8_t>((i / 7) % 26 + 'a');
+    }
+    auto [compressed_data, metadata] = compressor.compress(test_data);
+    
+    std::cout << std::dec << "Levels tuned: " << loaded.levels.size() << ", level 1 dict size: " 
+              << loaded.config_for(1).max_dict_size << std::endl;
+    
+    if (scalar_symbols == simd_symbols && loaded.levels.size() == 3 && stale_rejected && failed_save_safe &&
+        loaded.config_for(3).max_dict_size == profile.config_for(3).max_dict_size &&
+        compressor.decompress(compressed_data, metadata) == test_data) {
+        std::cout << "✓ Autotune profile successful!" << std::endl;
+    } else {
+        std::cout << "✗ Autotune profile failed!" << std::endl;
+        exit(1);
+    }
+}
+
+void test_sequence_analytics() {
+    std::cout << "\n=== Sequence Analytics Test ===" << std::endl;
+    
+    // 3MB sequence so chunks (1MB) split runs; N block and homopolymer straddle a chunk boundary
+    std::string seq;
+    const char bases[] = "ACGTacgt";
+    uint32_t state = 12345;
+    while (seq.size() < 3 * 1048576) {
+        state = state * 1103515245u + 12345u;
+        seq += bases[(state >> 16) % 8];
+    }
+    seq.replace(1048576 - 50, 100, std::string(100, 'N'));
+    seq.replace(2 * 1048576 - 30, 70, std::string(70, 'G'));
+    seq[2500000] = '*';
+    
+    // Scalar reference
+    size_t gc = 0, n_runs = 0, max_run = 0, run = 0, run_count = 0;
+    size_t first_invalid = std::string::npos;
+    for (size_t i = 0; i < seq.size(); ++i) {
+        char up = static_cast<char>(std::toupper(seq[i]));
+        gc += (up == 'G' || up == 'C');
+        bool acgt = (up == 'A' || up == 'C' || up == 'G' || up == 'T');
+        if (!acgt && first_invalid == std::string::npos) first_invalid = i;
+        if (up == 'N' && (i == 0 || std::toupper(seq[i - 1]) != 'N')) n_runs++;
+        bool same = i > 0 && std::toupper(seq[i - 1]) == up;
+        run = same ? run + 1 : 1;
+        if (!same && acgt) run_count++;
+        if (acgt) max_run = std::max(max_run, run);
+    }
+    
+    SequenceAnalyzer analyzer(4, 0);  // force the parallel path
+    SequenceReport report = analyzer.analyze(seq);
+    
+    std::cout << std::dec << "GC: " << report.gc_content << "%, N runs: " << report.n_runs.size() 
+              << ", longest homopolymer: " << report.homopolymers.max_run_length << std::endl;
+    
+    // Packed path must agree with analysing the binary_to_dna() text
+    CircularChromosomeCompressor compressor(1000, 4, true, false);
+    std::vector<uint8_t> bytes(seq.begin(), seq.begin() + 4096);
+    std::string dna = compressor.binary_to_dna(bytes);
+    SequenceReport text_report = analyzer.analyze(dna);
+    SequenceReport packed_report = analyzer.analyze_packed(bytes.data(), bytes.size() * 4);
+    
+    if (report.composition.g + report.composition.c == gc && report.n_runs.size() == n_runs &&
+        report.n_runs[0].length == 100 && report.homopolymers.max_run_length == max_run && 
+        report.homopolymers.run_count == run_count && !report.valid && report.first_invalid == first_invalid &&
+        analyzer.find_first_invalid(seq, true) == 2500000 &&
+        packed_report.composition.a == text_report.composition.a &&
+        packed_report.homopolymers.run_count == text_report.homopolymers.run_count &&
+        packed_report.homopolymers.max_run_position == text_report.homopolymers.max_run_position) {
+        std::cout << "✓ Sequence analytics successful!" << std::endl;
+    } else {
+        std::cout << "✗ Sequence analytics failed!" << std::endl;
+        exit(1);
+    }
+}
+
 int main() {
     std::cout << "Circular Chromosome Compression (CCC) C++ Test Suite" << std::endl;
     std::cout << "===================================================" << std::endl;
@@ -192,6 +2173,28 @@ int main() {
         test_dvnp_compression();
         test_basic_compression();
         test_large_data();
+        test_64bit_pipeline();
+        test_constrained_coding();
+        test_block_parallel_compression();
+        test_warm_start_blocks();
+        test_interleaved_lanes();
+        test_multi_base_stepping();
+        test_tandem_repeats();
+        test_approximate_repeats();
+        test_result_cache();
+        test_archive_stats();
+        test_input_routing();
+        test_prefilters();
+        test_verify_on_write();
+        test_striped_archive();
+        test_recompaction();
+        test_twobit();
+        test_solid_archive();
+        test_erasure_coding();
+        test_sequence_store();
+        test_async_logging();
+        test_autotune_profile();
+        test_sequence_analytics();
         
         std::cout << "\n🎉 All tests passed successfully!" << std::endl;
         
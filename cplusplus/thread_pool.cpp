@@ -0,0 +1,86 @@
+/**
+ * Fixed-size thread pool used by the block-parallel CCC pipeline
+ */
+
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+
+namespace ccc {
+
+ThreadPool::ThreadPool(size_t num_threads) {
+    if (num_threads == 0) {
+        num_threads = default_thread_count();
+    }
+    workers_.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        workers_.emplace_back([this]() { worker_loop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    condition_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::default_thread_count() {
+    unsigned int hw = std::thread::hardware_concurrency();
+    return hw == 0 ? 1 : static_cast<size_t>(hw);
+}
+
+void ThreadPool::worker_loop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (stopping_ && tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallel_for(size_t count, const std::function<void(size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+
+    // Workers pull iterations from a shared counter so uneven blocks balance out
+    std::atomic<size_t> next_index{0};
+    size_t num_tasks = std::min(count, workers_.size());
+    std::vector<std::future<void>> futures;
+    futures.reserve(num_tasks);
+    for (size_t t = 0; t < num_tasks; ++t) {
+        futures.push_back(submit([&next_index, count, &body]() {
+            for (size_t i = next_index.fetch_add(1); i < count; i = next_index.fetch_add(1)) {
+                body(i);
+            }
+        }));
+    }
+
+    std::exception_ptr first_error;
+    for (auto& future : futures) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!first_error) {
+                first_error = std::current_exception();
+            }
+        }
+    }
+    if (first_error) {
+        std::rethrow_exception(first_error);
+    }
+}
+
+} // namespace ccc
@@ -0,0 +1,83 @@
+/**
+ * Fixed-size thread pool used by the block-parallel CCC pipeline
+ */
+
+#ifndef CCC_THREAD_POOL_H
+#define CCC_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace ccc {
+
+/**
+ * Minimal FIFO thread pool
+ * Tasks are std::function objects; exceptions thrown by a task are delivered
+ * through the future returned by submit().
+ */
+class ThreadPool {
+public:
+    /**
+     * @param num_threads Worker count; 0 selects default_thread_count()
+     */
+    explicit ThreadPool(size_t num_threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Queue a task for execution
+     *
+     * @param task Callable without arguments
+     * @return Future for the task result
+     */
+    template <typename F>
+    auto submit(F&& task) -> std::future<decltype(task())> {
+        using Result = decltype(task());
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.emplace([packaged]() { (*packaged)(); });
+        }
+        condition_.notify_one();
+        return future;
+    }
+
+    /**
+     * Run body(i) for every i in [0, count) and wait for completion
+     * The first exception thrown by any iteration is rethrown to the caller.
+     *
+     * @param count Number of iterations
+     * @param body Iteration callback, invoked concurrently
+     */
+    void parallel_for(size_t count, const std::function<void(size_t)>& body);
+
+    size_t size() const { return workers_.size(); }
+
+    /**
+     * Hardware concurrency, or 1 when it cannot be determined
+     */
+    static size_t default_thread_count();
+
+private:
+    void worker_loop();
+
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stopping_ = false;
+};
+
+} // namespace ccc
+
+#endif // CCC_THREAD_POOL_H
@@ -0,0 +1,64 @@
+/**
+ * Machine calibration tool for CCC
+ * Runs the autotuner and stores the resulting machine profile, which
+ * apply_machine_profile() picks up in later processes.
+ *
+ * Usage: ccc_autotune [profile_path] [--sample-mb N] [--quiet]
+ */
+
+#include "autotune.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+using namespace ccc;
+
+int main(int argc, char* argv[]) {
+    std::string profile_path = MachineProfile::default_path();
+    AutotuneOptions options;
+    options.verbose = true;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--sample-mb" && i + 1 < argc) {
+            options.sample_size = std::stoul(argv[++i]) * 1048576;
+        } else if (arg == "--quiet") {
+            options.verbose = false;
+        } else if (arg == "-h" || arg == "--help") {
+            std::cout << "Usage: " << argv[0] << " [profile_path] [--sample-mb N] [--quiet]" << std::endl;
+            return 0;
+        } else {
+            profile_path = arg;
+        }
+    }
+
+    try {
+        Autotuner tuner(options);
+        MachineProfile profile = tuner.run();
+        profile.save(profile_path);
+
+        std::cout << "\n=== Machine Profile ===" << std::endl;
+        std::cout << std::left << std::setw(8) << "Level"
+                  << std::setw(12) << "Block"
+                  << std::setw(10) << "Threads"
+                  << std::setw(10) << "Dict"
+                  << std::setw(10) << "Kernel"
+                  << std::setw(10) << "MB/s"
+                  << "Ratio" << std::endl;
+        std::cout << std::string(68, '-') << std::endl;
+        for (const auto& [level, config] : profile.levels) {
+            std::cout << std::left << std::setw(8) << level
+                      << std::setw(12) << config.block_size
+                      << std::setw(10) << config.num_threads
+                      << std::setw(10) << config.max_dict_size
+                      << std::setw(10) << symbol_kernel_name(config.symbol_kernel)
+                      << std::setw(10) << std::fixed << std::setprecision(1) << config.throughput_mb_s
+                      << std::setprecision(3) << config.compressed_ratio << std::endl;
+        }
+        std::cout << "\nProfile saved to: " << profile_path << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Autotune failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
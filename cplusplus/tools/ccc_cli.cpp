@@ -0,0 +1,587 @@
+/**
+ * Command Line Interface for Circular Chromosome Compression (CCC)
+ *
+ * Usage:
+ *     ccc_cli compress input_file output_file [--chunk-size N] [--min-pattern N]
+ *                      [--block-size N] [--threads N] [--cache] [--cache-dir DIR] [--cache-size MB]
+ *                      [--volumes PATH,PATH,...]
+ *     ccc_cli decompress input_file output_file [--threads N]
+ *     ccc_cli analyze input_file [--sequence] [--threads N] [--no-compress]
+ *     ccc_cli stats archive.ccc [archive.ccc ...]
+ *     ccc_cli recompact archive.ccc [archive.ccc ...] [--block-size N] [--dict-size N]
+ *                       [--seed-window N] [--threads N] [--normal-priority]
+ *     ccc_cli import-2bit genome.2bit archive.ccc [--chunk-size N] [--block-size N] [--threads N]
+ *     ccc_cli export-2bit archive.ccc genome.2bit [--threads N]
+ *     ccc_cli protect archive.ccc [--data-shards N] [--parity-shards N] [--shard-size N] [--threads N]
+ *     ccc_cli repair output.ccc shard [shard ...] [--threads N]
+ */
+
+#include "circular_chromosome_compression.h"
+#include "archive.h"
+#include "autotune.h"
+#include "erasure_coding.h"
+#include "recompaction.h"
+#include "result_cache.h"
+#include "sequence_analytics.h"
+#include "twobit.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ccc;
+
+namespace {
+
+struct CliOptions {
+    std::string command;
+    std::vector<std::string> positional;
+    bool sequence_input = false;
+    bool run_compression = true;
+    size_t num_threads = 0;
+    size_t chunk_size = 1000;
+    size_t min_pattern = 4;
+    size_t block_size = 0;              // 0 = machine profile or 4MB
+    bool use_cache = false;
+    std::string cache_dir;              // empty = ResultCache::default_directory()
+    uint64_t cache_size_mb = ResultCache::kDefaultMaxBytes / 1048576;
+    uint32_t dict_size = 0;             // 0 = command default
+    size_t seed_window = 0;
+    bool seed_window_set = false;
+    bool low_priority = true;
+    ErasureOptions erasure;
+    std::vector<std::string> volumes;   // stripe the archive across these files
+    bool solid = false;                 // import-2bit: similar sequences share code streams
+    bool auto_route = false;            // compress: classify the input and pick its path
+    std::string filters;                // compress: typed pre-filter chain, e.g. "delta4,shuffle4"
+    bool verify = false;                // compress: decode every block while compressing
+};
+
+void print_usage(const char* program) {
+    std::cout << "Circular Chromosome Compression (CCC) - Bio-inspired data compression\n\n"
+              << "Usage:\n"
+              << "  " << program << " compress input_file output_file [options]\n"
+              << "  " << program << " decompress input_file output_file [--threads N]\n"
+              << "  " << program << " analyze input_file [--sequence] [--threads N] [--no-compress]\n"
+              << "  " << program << " stats archive.ccc [archive.ccc ...]\n"
+              << "  " << program << " recompact archive.ccc [archive.ccc ...] [options]\n"
+              << "  " << program << " import-2bit genome.2bit archive.ccc [options]\n"
+              << "  " << program << " export-2bit archive.ccc genome.2bit [--threads N]\n"
+              << "  " << program << " protect archive.ccc [options]\n"
+              << "  " << program << " repair output.ccc shard [shard ...] [--threads N]\n\n"
+              << "Options:\n"
+              << "  --chunk-size N    Chunk size for trans-splicing markers (default: 1000)\n"
+              << "  --min-pattern N   Minimum pattern length for DVNP compression (default: 4)\n"
+              << "  --block-size N    Block size in bytes (default: machine profile, else 4MB)\n"
+              << "  --threads N       Worker threads (default: all hardware threads)\n"
+              << "  --cache           Reuse cached archives of identical inputs\n"
+              << "  --cache-dir DIR   Result cache directory (default: $CCC_CACHE_DIR or ~/.cache/ccc/results)\n"
+              << "  --cache-size MB   Result cache size limit (default: 1024)\n"
+              << "  --dict-size N     Recompaction dictionary size in codes (default: 1048576)\n"
+              << "  --seed-window N   Recompaction warm-start window in bytes (default: 1048576)\n"
+              << "  --normal-priority Recompact at normal instead of idle CPU/I/O priority\n"
+              << "  --data-shards N   Erasure code data shards per group (default: 10)\n"
+              << "  --parity-shards N Erasure code parity shards per group (default: 4)\n"
+              << "  --shard-size N    Erasure shard payload in bytes (default: 65536)\n"
+              << "  --volumes P,P,... Stripe the compressed blocks across volume files (e.g. one per disk);\n"
+              << "                    the output file becomes the shared index\n"
+              << "  --auto            compress: detect the input type and route it (store compressed data,\n"
+              << "                    pack nucleotide text 2-bit, else the binary path)\n"
+              << "  --filter F,F,...  compress: reversible pre-filters for numeric arrays, applied in order:\n"
+              << "                    deltaW, xorW, shuffleW, bitshuffleW with element width W in bytes\n"
+              << "                    (e.g. delta4,shuffle4 for 32-bit counts, xor4,shuffle4 for floats)\n"
+              << "  --verify          compress: decode each block on a separate worker while later blocks\n"
+              << "                    compress, and fail on any mismatch with the input\n"
+              << "  --solid           import-2bit: compress similar sequences together in shared streams\n"
+              << "  --sequence        Treat input as nucleotide text (FASTA headers and line breaks ignored)\n"
+              << "  --no-compress     Skip the test compression in analyze\n";
+}
+
+std::vector<uint8_t> read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Input file '" + path + "' not found.");
+    }
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+/**
+ * Concatenate sequence lines, dropping FASTA headers and line breaks
+ */
+std::string extract_sequence(const std::vector<uint8_t>& data) {
+    std::string seq;
+    seq.reserve(data.size());
+    bool in_header = false;
+    bool line_start = true;
+    for (uint8_t byte : data) {
+        char ch = static_cast<char>(byte);
+        if (line_start && ch == '>') {
+            in_header = true;
+        }
+        if (ch == '\n') {
+            in_header = false;
+            line_start = true;
+            continue;
+        }
+        line_start = false;
+        if (!in_header && ch != '\r') {
+            seq += ch;
+        }
+    }
+    return seq;
+}
+
+void print_report(const SequenceReport& report, bool sequence_input) {
+    const BaseComposition& comp = report.composition;
+    std::cout << "\n=== Sequence Analysis ===" << std::endl;
+    std::cout << "DNA sequence length: " << report.length << " bases" << std::endl;
+    std::cout << "GC content: " << std::fixed << std::setprecision(2) << report.gc_content << "%" << std::endl;
+    std::cout << "Composition: A=" << comp.a << " C=" << comp.c << " G=" << comp.g << " T=" << comp.t;
+    if (sequence_input) {
+        std::cout << " N=" << comp.n << " other=" << comp.other;
+    }
+    std::cout << std::endl;
+
+    if (sequence_input) {
+        if (report.valid) {
+            std::cout << "Validation: all bases are A/C/G/T" << std::endl;
+        } else {
+            std::cout << "Validation: first invalid character at position " << report.first_invalid << std::endl;
+        }
+        size_t n_bases = 0;
+        for (const NRun& run : report.n_runs) {
+            n_bases += run.length;
+        }
+        std::cout << "N runs: " << report.n_runs.size() << " (" << n_bases << " bases)" << std::endl;
+    }
+
+    const HomopolymerStats& homo = report.homopolymers;
+    std::cout << "Homopolymer runs: " << homo.run_count << ", mean length "
+              << std::fixed << std::setprecision(2) << homo.mean_run_length << std::endl;
+    if (homo.max_run_length > 0) {
+        std::cout << "Longest homopolymer: " << homo.max_run_length << "x" << homo.max_run_base
+                  << " at position " << homo.max_run_position << std::endl;
+    }
+    std::cout << "Runs >= 4 bases: " << homo.runs_at_least(4) << ", >= 8 bases: " << homo.runs_at_least(8) << std::endl;
+}
+
+CircularChromosomeCompressor make_compressor(const CliOptions& options) {
+    CircularChromosomeCompressor compressor(options.chunk_size, options.min_pattern, true, false);
+    if (!apply_machine_profile(compressor)) {
+        compressor.set_block_size(4 * 1048576);
+    }
+    if (options.block_size != 0) {
+        compressor.set_block_size(options.block_size);
+    }
+    if (options.num_threads != 0) {
+        compressor.set_num_threads(options.num_threads);
+    }
+    compressor.set_auto_route(options.auto_route);
+    compressor.set_prefilters(parse_filter_chain(options.filters));
+    compressor.set_verify_on_write(options.verify);
+    return compressor;
+}
+
+int compress_command(const CliOptions& options) {
+    if (options.positional.size() != 2) {
+        std::cerr << "Error: compress requires an input and an output file" << std::endl;
+        return 1;
+    }
+    const std::string& input_path = options.positional[0];
+    const std::string& output_path = options.positional[1];
+    std::cout << "Compressing '" << input_path << "' using Circular Chromosome Compression..." << std::endl;
+
+    std::vector<uint8_t> input_data = read_file(input_path);
+    std::cout << "Input size: " << input_data.size() << " bytes" << std::endl;
+
+    CircularChromosomeCompressor compressor = make_compressor(options);
+    if (options.use_cache) {
+        std::string cache_dir = options.cache_dir.empty() ? ResultCache::default_directory() : options.cache_dir;
+        compressor.set_result_cache(std::make_shared<ResultCache>(cache_dir, options.cache_size_mb * 1048576));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto [compressed_data, metadata] = compressor.compress(input_data);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t archive_size = 0;
+    if (options.volumes.empty()) {
+        write_archive(output_path, compressed_data, metadata);
+    } else {
+        write_striped_archive(output_path, options.volumes, compressed_data, metadata);
+        for (const std::string& volume : options.volumes) {
+            std::ifstream file(volume, std::ios::binary | std::ios::ate);
+            archive_size += static_cast<size_t>(file.tellg());
+        }
+        std::cout << "Striped across " << options.volumes.size() << " volumes" << std::endl;
+    }
+    std::ifstream archive(output_path, std::ios::binary | std::ios::ate);
+    archive_size += static_cast<size_t>(archive.tellg());
+
+    if (options.auto_route) {
+        std::cout << "Route: " << compression_route_name(metadata.core.route) << std::endl;
+    }
+    if (options.verify) {
+        std::cout << "Verified: every block decodes to the input" << std::endl;
+    }
+    if (!options.filters.empty()) {
+        std::cout << "Pre-filters: " << filter_chain_name(metadata.core.filters) << std::endl;
+    }
+    std::cout << "Compression completed in " << std::fixed << std::setprecision(2) << seconds << " seconds";
+    if (compressor.result_cache()) {
+        std::cout << (compressor.result_cache()->hits() > 0 ? " (cache hit)" : " (cache miss)");
+    }
+    std::cout << std::endl;
+    std::cout << "Compressed size: " << archive_size << " bytes" << std::endl;
+    if (!input_data.empty()) {
+        std::cout << "Compression ratio: " << std::fixed << std::setprecision(4)
+                  << static_cast<double>(archive_size) / input_data.size() << std::endl;
+        std::cout << "Space savings: " << std::fixed << std::setprecision(2)
+                  << (1.0 - static_cast<double>(archive_size) / input_data.size()) * 100 << "%" << std::endl;
+    }
+    return 0;
+}
+
+int decompress_command(const CliOptions& options) {
+    if (options.positional.size() != 2) {
+        std::cerr << "Error: decompress requires an input and an output file" << std::endl;
+        return 1;
+    }
+    const std::string& input_path = options.positional[0];
+    const std::string& output_path = options.positional[1];
+    std::cout << "Decompressing '" << input_path << "'..." << std::endl;
+
+    // Volumes of a striped archive are read concurrently
+    auto [compressed_data, metadata] = is_striped_archive(input_path) ? read_striped_archive(input_path)
+                                                                     : read_archive(input_path);
+    CircularChromosomeCompressor compressor(metadata.encapsulation.trans_splicing.chunk_size, options.min_pattern, true, false);
+    if (options.num_threads != 0) {
+        compressor.set_num_threads(options.num_threads);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t written = compressor.decompress_to_file(compressed_data, metadata, output_path);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Decompression completed in " << std::fixed << std::setprecision(2) << seconds << " seconds" << std::endl;
+    std::cout << "Output size: " << written << " bytes" << std::endl;
+    return 0;
+}
+
+/**
+ * Print statistics recorded in an archive header
+ */
+void print_archive_stats(const CompressionStats& stats) {
+    std::cout << "Original size: " << stats.original_size_bytes << " bytes" << std::endl;
+    std::cout << "Compressed size: " << stats.compressed_size_bytes << " bytes ("
+              << stats.bits_per_code << " bits/code)" << std::endl;
+    std::cout << "Compression ratio: " << std::fixed << std::setprecision(4) << stats.compression_ratio << std::endl;
+    std::cout << "Space savings: " << std::fixed << std::setprecision(2) << stats.space_savings_percent << "%" << std::endl;
+    std::cout << "Bits per base: " << std::fixed << std::setprecision(4) << stats.bits_per_base << std::endl;
+    std::cout << "Codes: " << stats.total_codes << " total, " << stats.core_codes << " DVNP, max code "
+              << stats.max_code_value << std::endl;
+    std::cout << "Dictionary resets: " << stats.reset_count << std::endl;
+    std::cout << "Entropy: " << std::fixed << std::setprecision(4) << stats.original_entropy << " -> "
+              << stats.compressed_entropy << " bits/byte" << std::endl;
+    std::cout << "Shannon efficiency: " << std::fixed << std::setprecision(2) << stats.shannon_efficiency * 100 << "%" << std::endl;
+    if (!stats.block_ratios.empty()) {
+        auto [min_it, max_it] = std::minmax_element(stats.block_ratios.begin(), stats.block_ratios.end());
+        std::cout << "Blocks: " << stats.block_ratios.size() << ", ratio min " << std::fixed << std::setprecision(4)
+                  << *min_it << " / max " << *max_it << std::endl;
+    }
+}
+
+int stats_command(const CliOptions& options) {
+    if (options.positional.empty()) {
+        std::cerr << "Error: stats requires at least one archive" << std::endl;
+        return 1;
+    }
+    int status = 0;
+    for (const std::string& path : options.positional) {
+        std::cout << "\n=== " << path << " ===" << std::endl;
+        try {
+            print_archive_stats(read_archive_stats(path));
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            status = 1;
+        }
+    }
+    return status;
+}
+
+int recompact_command(const CliOptions& options) {
+    if (options.positional.empty()) {
+        std::cerr << "Error: recompact requires at least one archive" << std::endl;
+        return 1;
+    }
+
+    RecompactionOptions recompaction;
+    if (options.block_size != 0) {
+        recompaction.block_size = options.block_size;
+    }
+    if (options.dict_size != 0) {
+        recompaction.max_dict_size = options.dict_size;
+    }
+    if (options.seed_window_set) {
+        recompaction.seed_window = options.seed_window;
+    }
+    recompaction.num_threads = options.num_threads;
+    recompaction.low_priority = options.low_priority;
+
+    int status = 0;
+    uint64_t total_reclaimed = 0;
+    for (const std::string& path : options.positional) {
+        try {
+            RecompactionResult result = recompact_archive(path, recompaction);
+            total_reclaimed += result.bytes_reclaimed();
+            std::cout << path << ": " << result.original_bytes << " -> " << result.recompacted_bytes << " bytes"
+                      << (result.replaced ? "" : " (kept original)") << ", reclaimed " << result.bytes_reclaimed()
+                      << " bytes in " << std::fixed << std::setprecision(2) << result.seconds << " s" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << path << ": " << e.what() << std::endl;
+            status = 1;
+        }
+    }
+    std::cout << "Total space reclaimed: " << total_reclaimed << " bytes" << std::endl;
+    return status;
+}
+
+int import_twobit_command(const CliOptions& options) {
+    if (options.positional.size() != 2) {
+        std::cerr << "Error: import-2bit requires a .2bit input and an output archive" << std::endl;
+        return 1;
+    }
+    const std::string& input_path = options.positional[0];
+    const std::string& output_path = options.positional[1];
+
+    auto start = std::chrono::steady_clock::now();
+    size_t count = options.solid
+        ? twobit_to_solid_archive(input_path, output_path, make_compressor(options), SolidOptions(), options.num_threads)
+        : twobit_to_archive(input_path, output_path, make_compressor(options), options.num_threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ifstream input(input_path, std::ios::binary | std::ios::ate);
+    std::ifstream archive(output_path, std::ios::binary | std::ios::ate);
+    std::cout << "Imported " << count << " sequences from '" << input_path << "' (" << input.tellg()
+              << " bytes) into '" << output_path << "' (" << archive.tellg() << " bytes) in " << std::fixed
+              << std::setprecision(2) << seconds << " s" << std::endl;
+    return 0;
+}
+
+int export_twobit_command(const CliOptions& options) {
+    if (options.positional.size() != 2) {
+        std::cerr << "Error: export-2bit requires an archive input and a .2bit output" << std::endl;
+        return 1;
+    }
+    const std::string& input_path = options.positional[0];
+    const std::string& output_path = options.positional[1];
+
+    auto start = std::chrono::steady_clock::now();
+    size_t count = archive_to_twobit(input_path, output_path, options.num_threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Exported " << count << " sequences from '" << input_path << "' to '" << output_path << "' in "
+              << std::fixed << std::setprecision(2) << seconds << " s" << std::endl;
+    return 0;
+}
+
+int protect_command(const CliOptions& options) {
+    if (options.positional.size() != 1) {
+        std::cerr << "Error: protect requires one input file" << std::endl;
+        return 1;
+    }
+    const std::string& input_path = options.positional[0];
+    ErasureOptions erasure = options.erasure;
+    erasure.num_threads = options.num_threads;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> paths = write_erasure_shards(input_path, input_path, erasure);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Wrote " << paths.size() << " shards (" << erasure.data_shards << " data + "
+              << erasure.parity_shards << " parity per group, " << erasure.shard_size << " byte payloads) as '"
+              << input_path << ".NNN' in " << std::fixed << std::setprecision(2) << seconds << " s" << std::endl;
+    std::cout << "Any " << erasure.parity_shards << " shards of each group may be lost" << std::endl;
+    return 0;
+}
+
+int repair_command(const CliOptions& options) {
+    if (options.positional.size() < 2) {
+        std::cerr << "Error: repair requires an output file and at least one shard" << std::endl;
+        return 1;
+    }
+    const std::string& output_path = options.positional[0];
+    std::vector<std::string> shard_paths(options.positional.begin() + 1, options.positional.end());
+
+    auto start = std::chrono::steady_clock::now();
+    ErasureRepairReport report = repair_from_shards(shard_paths, output_path, options.num_threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Recovered '" << output_path << "' from " << report.groups << " groups in " << std::fixed
+              << std::setprecision(2) << seconds << " s: " << report.shards_rebuilt << " shards rebuilt, "
+              << report.shards_rejected << " rejected" << std::endl;
+    return 0;
+}
+
+int analyze_command(const CliOptions& options) {
+    if (options.positional.size() != 1) {
+        std::cerr << "Error: analyze requires an input file" << std::endl;
+        return 1;
+    }
+    const std::string& input_path = options.positional[0];
+    if (is_archive(input_path) || is_striped_archive(input_path)) {
+        // Existing archives are described from their header alone
+        std::cout << "Analyzing archive '" << input_path << "' (header statistics)..." << std::endl;
+        std::cout << "\n=== Compression Analysis ===" << std::endl;
+        print_archive_stats(read_archive_stats(input_path));
+        return 0;
+    }
+    std::cout << "Analyzing '" << input_path << "' for CCC compressibility..." << std::endl;
+
+    std::vector<uint8_t> input_data = read_file(input_path);
+    std::cout << "File size: " << input_data.size() << " bytes" << std::endl;
+    InputProfile profile = classify_input(input_data);
+    std::cout << "Input type: " << input_kind_name(profile.kind)
+              << (profile.format.empty() ? std::string() : " (" + profile.format + ")") << ", "
+              << std::fixed << std::setprecision(2) << profile.entropy << " bits/byte over "
+              << profile.sampled_bytes << " sampled bytes; --auto route: "
+              << compression_route_name(CircularChromosomeCompressor::route_for(profile)) << std::endl;
+
+    SequenceAnalyzer analyzer(options.num_threads);
+    auto start = std::chrono::steady_clock::now();
+    SequenceReport report;
+    if (options.sequence_input) {
+        std::string seq = extract_sequence(input_data);
+        report = analyzer.analyze(seq);
+    } else {
+        // Raw bytes are already 2-bit packed bases in binary_to_dna() order
+        report = analyzer.analyze_packed(input_data.data(), input_data.size() * 4);
+    }
+    double scan_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    print_report(report, options.sequence_input);
+    std::cout << "Scan time: " << std::fixed << std::setprecision(2) << scan_ms << " ms" << std::endl;
+
+    if (!options.run_compression || input_data.empty()) {
+        return 0;
+    }
+
+    CircularChromosomeCompressor compressor = make_compressor(options);
+    auto [compressed_data, metadata] = compressor.compress(input_data);
+    CompressionStats stats = compressor.get_compression_stats(input_data, compressed_data, metadata);
+
+    std::cout << "\n=== Compression Analysis ===" << std::endl;
+    std::cout << "Estimated compression ratio: " << std::fixed << std::setprecision(4) << stats.compression_ratio << std::endl;
+    std::cout << "Estimated space savings: " << std::fixed << std::setprecision(2) << stats.space_savings_percent << "%" << std::endl;
+    std::cout << "Bits per base: " << std::fixed << std::setprecision(4) << stats.bits_per_base << std::endl;
+    std::cout << "Shannon efficiency: " << std::fixed << std::setprecision(2) << stats.shannon_efficiency * 100 << "%" << std::endl;
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return 0;
+    }
+
+    CliOptions options;
+    options.command = argv[1];
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--sequence") {
+            options.sequence_input = true;
+        } else if (arg == "--no-compress") {
+            options.run_compression = false;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.num_threads = std::stoul(argv[++i]);
+        } else if (arg == "--chunk-size" && i + 1 < argc) {
+            options.chunk_size = std::stoul(argv[++i]);
+        } else if (arg == "--min-pattern" && i + 1 < argc) {
+            options.min_pattern = std::stoul(argv[++i]);
+        } else if (arg == "--block-size" && i + 1 < argc) {
+            options.block_size = std::stoul(argv[++i]);
+        } else if (arg == "--dict-size" && i + 1 < argc) {
+            options.dict_size = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--seed-window" && i + 1 < argc) {
+            options.seed_window = std::stoul(argv[++i]);
+            options.seed_window_set = true;
+        } else if (arg == "--data-shards" && i + 1 < argc) {
+            options.erasure.data_shards = std::stoul(argv[++i]);
+        } else if (arg == "--parity-shards" && i + 1 < argc) {
+            options.erasure.parity_shards = std::stoul(argv[++i]);
+        } else if (arg == "--shard-size" && i + 1 < argc) {
+            options.erasure.shard_size = std::stoul(argv[++i]);
+        } else if (arg == "--volumes" && i + 1 < argc) {
+            std::stringstream list(argv[++i]);
+            std::string volume;
+            while (std::getline(list, volume, ',')) {
+                options.volumes.push_back(volume);
+            }
+        } else if (arg == "--normal-priority") {
+            options.low_priority = false;
+        } else if (arg == "--auto") {
+            options.auto_route = true;
+        } else if (arg == "--filter" && i + 1 < argc) {
+            options.filters = argv[++i];
+        } else if (arg == "--verify") {
+            options.verify = true;
+        } else if (arg == "--solid") {
+            options.solid = true;
+        } else if (arg == "--cache") {
+            options.use_cache = true;
+        } else if (arg == "--cache-dir" && i + 1 < argc) {
+            options.cache_dir = argv[++i];
+            options.use_cache = true;
+        } else if (arg == "--cache-size" && i + 1 < argc) {
+            options.cache_size_mb = std::stoull(argv[++i]);
+        } else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            options.positional.push_back(arg);
+        }
+    }
+
+    try {
+        if (options.command == "compress") {
+            return compress_command(options);
+        }
+        if (options.command == "decompress") {
+            return decompress_command(options);
+        }
+        if (options.command == "analyze") {
+            return analyze_command(options);
+        }
+        if (options.command == "stats") {
+            return stats_command(options);
+        }
+        if (options.command == "recompact") {
+            return recompact_command(options);
+        }
+        if (options.command == "import-2bit") {
+            return import_twobit_command(options);
+        }
+        if (options.command == "export-2bit") {
+            return export_twobit_command(options);
+        }
+        if (options.command == "protect") {
+            return protect_command(options);
+        }
+        if (options.command == "repair") {
+            return repair_command(options);
+        }
+        print_usage(argv[0]);
+        return 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,549 @@
+/**
+ * UCSC .2bit reader/writer and CCC archive conversion
+ */
+
+#include "twobit.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CCC_HAVE_MMAP 1
+#endif
+
+namespace ccc {
+
+namespace {
+
+constexpr uint32_t kTwoBitSignature = 0x1A412743u;
+constexpr uint32_t kTwoBitSignatureSwapped = 0x4327411Au;
+
+// .2bit codes T=0 C=1 A=2 G=3 against binary_to_dna() codes A=0 C=1 G=2 T=3
+constexpr uint8_t kTwoBitToCcc[4] = {3, 1, 0, 2};
+constexpr uint8_t kCccToTwoBit[4] = {2, 1, 3, 0};
+constexpr char kTwoBitBases[4] = {'T', 'C', 'A', 'G'};
+constexpr char kCccBases[4] = {'A', 'C', 'G', 'T'};
+
+/**
+ * Byte table applying a 2-bit code map to all four bases of a byte
+ */
+std::array<uint8_t, 256> make_translation(const uint8_t (&map)[4]) {
+    std::array<uint8_t, 256> table{};
+    for (int byte = 0; byte < 256; ++byte) {
+        uint8_t out = 0;
+        for (int shift = 0; shift < 8; shift += 2) {
+            out |= static_cast<uint8_t>(map[(byte >> shift) & 3] << shift);
+        }
+        table[byte] = out;
+    }
+    return table;
+}
+
+const std::array<uint8_t, 256>& twobit_to_ccc_table() {
+    static const std::array<uint8_t, 256> table = make_translation(kTwoBitToCcc);
+    return table;
+}
+
+const std::array<uint8_t, 256>& ccc_to_twobit_table() {
+    static const std::array<uint8_t, 256> table = make_translation(kCccToTwoBit);
+    return table;
+}
+
+/**
+ * Keep only the bits of real bases in the last packed byte
+ */
+void clear_padding(std::vector<uint8_t>& packed, size_t length) {
+    if (length % 4 != 0 && !packed.empty()) {
+        packed.back() &= static_cast<uint8_t>(0xFF << (8 - 2 * (length % 4)));
+    }
+}
+
+bool in_runs(const std::vector<BaseRun>& runs, size_t position) {
+    auto it = std::upper_bound(runs.begin(), runs.end(), position,
+                               [](size_t pos, const BaseRun& run) { return pos < run.start; });
+    return it != runs.begin() && position < std::prev(it)->start + std::prev(it)->length;
+}
+
+void put_u32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void put_u64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void put_runs(std::vector<uint8_t>& out, const std::vector<BaseRun>& runs) {
+    put_u32(out, static_cast<uint32_t>(runs.size()));
+    for (const BaseRun& run : runs) {
+        put_u32(out, static_cast<uint32_t>(run.start));
+    }
+    for (const BaseRun& run : runs) {
+        put_u32(out, static_cast<uint32_t>(run.length));
+    }
+}
+
+size_t record_header_size(const TwoBitRecord& record) {
+    return 4 + 4 + 8 * record.n_blocks.size() + 4 + 8 * record.mask_blocks.size() + 4;
+}
+
+size_t worker_count(size_t num_threads, size_t tasks) {
+    size_t threads = num_threads == 0 ? ThreadPool::default_thread_count() : num_threads;
+    return std::max<size_t>(1, std::min(threads, tasks));
+}
+
+} // namespace
+
+TwoBitRecord TwoBitRecord::from_sequence(const std::string& name, const std::string& sequence) {
+    TwoBitRecord record;
+    record.name = name;
+    record.length = sequence.size();
+    record.packed.assign((sequence.size() + 3) / 4, 0);
+
+    auto extend = [](std::vector<BaseRun>& runs, size_t position) {
+        if (!runs.empty() && runs.back().start + runs.back().length == position) {
+            ++runs.back().length;
+        } else {
+            runs.push_back({position, 1});
+        }
+    };
+
+    for (size_t i = 0; i < sequence.size(); ++i) {
+        unsigned char ch = static_cast<unsigned char>(sequence[i]);
+        if (std::islower(ch)) {
+            extend(record.mask_blocks, i);
+        }
+        uint8_t code;
+        switch (std::toupper(ch)) {
+            case 'A': code = 0; break;
+            case 'C': code = 1; break;
+            case 'G': code = 2; break;
+            case 'T': code = 3; break;
+            default:
+                // Stored as T, the .2bit convention for N positions
+                code = 3;
+                extend(record.n_blocks, i);
+                break;
+        }
+        record.packed[i >> 2] |= static_cast<uint8_t>(code << (6 - 2 * (i & 3)));
+    }
+    return record;
+}
+
+std::string TwoBitRecord::to_sequence() const {
+    std::string sequence(length, 'A');
+    for (size_t i = 0; i < length; ++i) {
+        sequence[i] = kCccBases[(packed[i >> 2] >> (6 - 2 * (i & 3))) & 3];
+    }
+    for (const BaseRun& run : n_blocks) {
+        std::fill_n(sequence.begin() + run.start, std::min(run.length, length - run.start), 'N');
+    }
+    for (const BaseRun& run : mask_blocks) {
+        for (size_t i = run.start; i < std::min(run.start + run.length, length); ++i) {
+            sequence[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(sequence[i])));
+        }
+    }
+    return sequence;
+}
+
+void write_twobit(const std::string& path, const std::vector<TwoBitRecord>& records) {
+    uint64_t index_size = 0;
+    uint64_t data_size = 0;
+    for (const TwoBitRecord& record : records) {
+        if (record.name.empty() || record.name.size() > 255) {
+            throw std::invalid_argument(".2bit sequence names must be 1-255 characters: '" + record.name + "'");
+        }
+        if (record.length > UINT32_MAX) {
+            throw std::invalid_argument(".2bit sequence " + record.name + " exceeds 4G bases");
+        }
+        if (record.packed.size() != (record.length + 3) / 4) {
+            throw std::invalid_argument(".2bit sequence " + record.name + " has inconsistent packed size");
+        }
+        index_size += 1 + record.name.size() + 4;
+        data_size += record_header_size(record) + record.packed.size();
+    }
+
+    // Version 1 widens the index offsets when the file outgrows 32 bits
+    const uint32_t version = 16 + index_size + data_size > UINT32_MAX ? 1 : 0;
+    if (version == 1) {
+        index_size += 4 * records.size();
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot write .2bit file: " + path);
+    }
+
+    std::vector<uint8_t> header;
+    put_u32(header, kTwoBitSignature);
+    put_u32(header, version);
+    put_u32(header, static_cast<uint32_t>(records.size()));
+    put_u32(header, 0);
+
+    uint64_t offset = 16 + index_size;
+    for (const TwoBitRecord& record : records) {
+        header.push_back(static_cast<uint8_t>(record.name.size()));
+        header.insert(header.end(), record.name.begin(), record.name.end());
+        if (version == 1) {
+            put_u64(header, offset);
+        } else {
+            put_u32(header, static_cast<uint32_t>(offset));
+        }
+        offset += record_header_size(record) + record.packed.size();
+    }
+    file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+
+    const auto& translate = ccc_to_twobit_table();
+    std::vector<uint8_t> buffer;
+    for (const TwoBitRecord& record : records) {
+        buffer.clear();
+        put_u32(buffer, static_cast<uint32_t>(record.length));
+        put_runs(buffer, record.n_blocks);
+        put_runs(buffer, record.mask_blocks);
+        put_u32(buffer, 0);
+        size_t start = buffer.size();
+        buffer.resize(start + record.packed.size());
+        for (size_t i = 0; i < record.packed.size(); ++i) {
+            buffer[start + i] = translate[record.packed[i]];
+        }
+        if (record.length % 4 != 0) {
+            buffer.back() &= static_cast<uint8_t>(0xFF << (8 - 2 * (record.length % 4)));
+        }
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    }
+    if (!file.good()) {
+        throw std::runtime_error("Failed writing .2bit file: " + path);
+    }
+}
+
+TwoBitReader::TwoBitReader(const std::string& path)
+    : path_(path), data_(nullptr), size_(0), swapped_(false), mapped_(false) {
+#ifdef CCC_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open .2bit file: " + path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat .2bit file: " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+        void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map .2bit file: " + path);
+        }
+        data_ = static_cast<const uint8_t*>(mapping);
+        mapped_ = true;
+    }
+    ::close(fd);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open .2bit file: " + path);
+    }
+    buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+
+    try {
+        parse();
+    } catch (...) {
+#ifdef CCC_HAVE_MMAP
+        if (mapped_) {
+            ::munmap(const_cast<uint8_t*>(data_), size_);
+        }
+#endif
+        throw;
+    }
+}
+
+TwoBitReader::~TwoBitReader() {
+#ifdef CCC_HAVE_MMAP
+    if (mapped_) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif
+}
+
+uint32_t TwoBitReader::read_u32(size_t offset) const {
+    if (offset > size_ || size_ - offset < 4) {
+        throw std::runtime_error("Invalid .2bit file: " + path_ + " is truncated");
+    }
+    uint32_t value = static_cast<uint32_t>(data_[offset]) | (static_cast<uint32_t>(data_[offset + 1]) << 8) |
+                     (static_cast<uint32_t>(data_[offset + 2]) << 16) | (static_cast<uint32_t>(data_[offset + 3]) << 24);
+    return swapped_ ? __builtin_bswap32(value) : value;
+}
+
+uint64_t TwoBitReader::read_u64(size_t offset) const {
+    uint64_t low = read_u32(offset);
+    uint64_t high = read_u32(offset + 4);
+    return swapped_ ? (low << 32) | high : (high << 32) | low;
+}
+
+void TwoBitReader::parse() {
+    uint32_t signature = read_u32(0);
+    if (signature == kTwoBitSignatureSwapped) {
+        swapped_ = true;
+    } else if (signature != kTwoBitSignature) {
+        throw std::runtime_error("Not a .2bit file: " + path_);
+    }
+    uint32_t version = read_u32(4);
+    if (version > 1) {
+        throw std::runtime_error("Unsupported .2bit version " + std::to_string(version));
+    }
+    uint32_t count = read_u32(8);
+
+    // Each index entry holds at least a name-length byte and an offset
+    size_t pos = 16;
+    const size_t min_entry = 1 + (version == 1 ? 8 : 4);
+    if (count > (size_ > pos ? (size_ - pos) / min_entry : 0)) {
+        throw std::runtime_error("Invalid .2bit file: " + path_ + " index of " + std::to_string(count) +
+                                 " sequences is truncated");
+    }
+    sequences_.resize(count);
+    for (SequenceInfo& info : sequences_) {
+        if (pos >= size_) {
+            throw std::runtime_error("Invalid .2bit file: " + path_ + " index is truncated");
+        }
+        size_t name_size = data_[pos++];
+        if (name_size > size_ - pos) {
+            throw std::runtime_error("Invalid .2bit file: " + path_ + " index is truncated");
+        }
+        info.name.assign(reinterpret_cast<const char*>(data_ + pos), name_size);
+        pos += name_size;
+
+        uint64_t offset = version == 1 ? read_u64(pos) : read_u32(pos);
+        pos += version == 1 ? 8 : 4;
+
+        size_t at = static_cast<size_t>(offset);
+        info.length = read_u32(at);
+        at += 4;
+        for (std::vector<BaseRun>* runs : {&info.n_blocks, &info.mask_blocks}) {
+            size_t blocks = read_u32(at);
+            at += 4;
+            if (blocks > (size_ - at) / 8) {
+                throw std::runtime_error("Invalid .2bit file: " + path_ + " block list is truncated");
+            }
+            runs->resize(blocks);
+            for (size_t i = 0; i < blocks; ++i) {
+                BaseRun& run = (*runs)[i];
+                run.start = read_u32(at + 4 * i);
+                run.length = read_u32(at + 4 * (blocks + i));
+                if (run.start > info.length || info.length - run.start < run.length) {
+                    throw std::runtime_error("Invalid .2bit file: " + path_ + " sequence " + info.name +
+                                             " has a run of " + std::to_string(run.length) + " at " +
+                                             std::to_string(run.start) + " past its " +
+                                             std::to_string(info.length) + " bases");
+                }
+            }
+            at += 8 * blocks;
+        }
+        at += 4;  // reserved
+
+        size_t packed_size = (info.length + 3) / 4;
+        if (at > size_ || packed_size > size_ - at) {
+            throw std::runtime_error("Invalid .2bit file: " + path_ + " sequence " + info.name + " is truncated");
+        }
+        info.packed = data_ + at;
+    }
+}
+
+size_t TwoBitReader::find(const std::string& name) const {
+    for (size_t i = 0; i < sequences_.size(); ++i) {
+        if (sequences_[i].name == name) {
+            return i;
+        }
+    }
+    return npos;
+}
+
+char TwoBitReader::packed_base(size_t seq, size_t position) const {
+    const SequenceInfo& info = sequences_.at(seq);
+    if (position >= info.length) {
+        throw std::out_of_range("Position " + std::to_string(position) + " beyond " + info.name);
+    }
+    return kTwoBitBases[(info.packed[position >> 2] >> (6 - 2 * (position & 3))) & 3];
+}
+
+char TwoBitReader::base(size_t seq, size_t position) const {
+    char ch = packed_base(seq, position);
+    const SequenceInfo& info = sequences_[seq];
+    if (in_runs(info.n_blocks, position)) {
+        ch = 'N';
+    }
+    if (in_runs(info.mask_blocks, position)) {
+        ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    }
+    return ch;
+}
+
+std::string TwoBitReader::sequence(size_t seq, size_t start, size_t length) const {
+    const SequenceInfo& info = sequences_.at(seq);
+    if (start > info.length) {
+        throw std::out_of_range("Start " + std::to_string(start) + " beyond " + info.name);
+    }
+    length = std::min(length, info.length - start);
+    const size_t end = start + length;
+
+    std::string result(length, 'N');
+    for (size_t i = start; i < end; ++i) {
+        result[i - start] = kTwoBitBases[(info.packed[i >> 2] >> (6 - 2 * (i & 3))) & 3];
+    }
+
+    // Overlay only the runs that intersect [start, end)
+    auto overlay = [&](const std::vector<BaseRun>& runs, bool mask) {
+        auto it = std::upper_bound(runs.begin(), runs.end(), start,
+                                   [](size_t pos, const BaseRun& run) { return pos < run.start; });
+        if (it != runs.begin()) {
+            --it;
+        }
+        for (; it != runs.end() && it->start < end; ++it) {
+            size_t from = std::max(it->start, start);
+            size_t to = std::min(it->start + it->length, end);
+            for (size_t i = from; i < to; ++i) {
+                char& ch = result[i - start];
+                ch = mask ? static_cast<char>(std::tolower(static_cast<unsigned char>(ch))) : 'N';
+            }
+        }
+    };
+    overlay(info.n_blocks, false);
+    overlay(info.mask_blocks, true);
+    return result;
+}
+
+TwoBitRecord TwoBitReader::record(size_t seq) const {
+    const SequenceInfo& info = sequences_.at(seq);
+    TwoBitRecord record;
+    record.name = info.name;
+    record.length = info.length;
+    record.n_blocks = info.n_blocks;
+    record.mask_blocks = info.mask_blocks;
+
+    const auto& translate = twobit_to_ccc_table();
+    record.packed.resize((info.length + 3) / 4);
+    for (size_t i = 0; i < record.packed.size(); ++i) {
+        record.packed[i] = translate[info.packed[i]];
+    }
+    clear_padding(record.packed, record.length);
+    return record;
+}
+
+size_t twobit_to_archive(const std::string& twobit_path, const std::string& archive_path,
+                         const CircularChromosomeCompressor& compressor, size_t num_threads) {
+    TwoBitReader reader(twobit_path);
+    const size_t count = reader.sequence_count();
+    std::vector<SequenceMember> members(count);
+
+    ThreadPool pool(worker_count(num_threads, count));
+    pool.parallel_for(count, [&](size_t i) {
+        TwoBitRecord record = reader.record(i);
+        SequenceMember& member = members[i];
+        member.name = record.name;
+        member.length = record.length;
+        member.n_blocks = std::move(record.n_blocks);
+        member.mask_blocks = std::move(record.mask_blocks);
+        if (record.packed.empty()) {
+            return;
+        }
+
+        // Sequences already run concurrently; keep each compression single-threaded
+        CircularChromosomeCompressor member_compressor = compressor;
+        if (pool.size() > 1) {
+            member_compressor.set_num_threads(1);
+        }
+        auto [codes, metadata] = member_compressor.compress(record.packed);
+        member.codes = std::move(codes);
+        member.metadata = std::move(metadata);
+    });
+
+    write_multi_archive(archive_path, members);
+    return count;
+}
+
+size_t twobit_to_solid_archive(const std::string& twobit_path, const std::string& archive_path,
+                               const CircularChromosomeCompressor& compressor, const SolidOptions& options,
+                               size_t num_threads) {
+    TwoBitReader reader(twobit_path);
+    const size_t count = reader.sequence_count();
+    std::vector<SequenceMember> members(count);
+    std::vector<std::vector<uint8_t>> packed(count);
+    for (size_t i = 0; i < count; ++i) {
+        TwoBitRecord record = reader.record(i);
+        members[i].name = std::move(record.name);
+        members[i].length = record.length;
+        members[i].n_blocks = std::move(record.n_blocks);
+        members[i].mask_blocks = std::move(record.mask_blocks);
+        packed[i] = std::move(record.packed);
+    }
+    write_solid_archive(archive_path, members, packed, compressor, options, num_threads);
+    return count;
+}
+
+size_t archive_to_twobit(const std::string& archive_path, const std::string& twobit_path, size_t num_threads) {
+    std::vector<MemberIndexEntry> index = read_multi_archive_index(archive_path);
+    std::vector<TwoBitRecord> records(index.size());
+
+    // Members sharing a stream are cut from a single decode of it
+    std::vector<std::vector<size_t>> streams;
+    for (size_t i = 0; i < index.size(); ++i) {
+        records[i].name = index[i].name;
+        records[i].length = index[i].length;
+        records[i].n_blocks = index[i].n_blocks;
+        records[i].mask_blocks = index[i].mask_blocks;
+        if (index[i].length == 0) {
+            continue;
+        }
+        if (index[i].stream >= streams.size()) {
+            streams.resize(index[i].stream + 1);
+        }
+        streams[index[i].stream].push_back(i);
+    }
+    streams.erase(std::remove_if(streams.begin(), streams.end(),
+                                 [](const std::vector<size_t>& members) { return members.empty(); }),
+                  streams.end());
+
+    ThreadPool pool(worker_count(num_threads, streams.size()));
+    pool.parallel_for(streams.size(), [&](size_t s) {
+        const MemberIndexEntry& first = index[streams[s].front()];
+        if (streams[s].size() == 1) {
+            records[streams[s].front()].packed = extract_multi_archive_member(archive_path, first, pool.size() > 1 ? 1 : 0);
+            return;
+        }
+
+        SequenceMember stream = read_multi_archive_member(archive_path, first);
+        CircularChromosomeCompressor decompressor(stream.metadata.encapsulation.trans_splicing.chunk_size, 4, true, false);
+        decompressor.set_num_threads(pool.size() > 1 ? 1 : 0);
+        std::vector<uint8_t> decoded = decompressor.decompress(stream.codes, stream.metadata);
+        for (size_t i : streams[s]) {
+            TwoBitRecord& record = records[i];
+            const size_t bytes = (record.length + 3) / 4;
+            if (index[i].stream_offset > decoded.size() || decoded.size() - index[i].stream_offset < bytes) {
+                throw std::runtime_error("Member " + record.name + " extends past its stream (" +
+                                         std::to_string(decoded.size()) + " bytes)");
+            }
+            auto begin = decoded.begin() + static_cast<std::ptrdiff_t>(index[i].stream_offset);
+            record.packed.assign(begin, begin + static_cast<std::ptrdiff_t>(bytes));
+        }
+    });
+
+    write_twobit(twobit_path, records);
+    return records.size();
+}
+
+} // namespace ccc
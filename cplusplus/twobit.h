@@ -0,0 +1,162 @@
+/**
+ * UCSC .2bit Import/Export - C++ Implementation
+ *
+ * Native reader and writer for the UCSC .2bit genome format (T=00, C=01,
+ * A=10, G=11; N runs and soft-mask runs stored as block lists), with an
+ * mmap-backed reader for random access and parallel per-sequence conversion
+ * to and from multi-member CCC archives. Packed bases are translated byte by
+ * byte into binary_to_dna() order, so no ASCII FASTA round trip is needed.
+ */
+
+#ifndef CCC_TWOBIT_H
+#define CCC_TWOBIT_H
+
+#include "archive.h"
+#include "circular_chromosome_compression.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ccc {
+
+/**
+ * One .2bit sequence held in memory
+ * Bases are 2-bit packed in binary_to_dna() order (A=00, C=01, G=10, T=11),
+ * four per byte, first base in the most significant bits.
+ */
+struct TwoBitRecord {
+    std::string name;
+    size_t length = 0;                  // bases
+    std::vector<BaseRun> n_blocks;
+    std::vector<BaseRun> mask_blocks;   // soft-masked (lowercase) runs
+    std::vector<uint8_t> packed;
+
+    /**
+     * Build a record from nucleotide text; lowercase becomes mask runs and
+     * any character other than A/C/G/T becomes N
+     */
+    static TwoBitRecord from_sequence(const std::string& name, const std::string& sequence);
+
+    /**
+     * Nucleotide text with N runs and lowercase masking applied
+     */
+    std::string to_sequence() const;
+};
+
+/**
+ * Write a .2bit file (version 0, or version 1 with 64-bit offsets when the
+ * file exceeds 4GB)
+ *
+ * @throws std::runtime_error if the file cannot be written
+ */
+void write_twobit(const std::string& path, const std::vector<TwoBitRecord>& records);
+
+/**
+ * Memory-mapped .2bit reader
+ * Sequences are located through the file index at open time; packed bases are
+ * then read in place, so base access never copies or scans the sequence.
+ */
+class TwoBitReader {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    /**
+     * @throws std::runtime_error if the file cannot be opened or is not a valid .2bit file
+     */
+    explicit TwoBitReader(const std::string& path);
+    ~TwoBitReader();
+
+    TwoBitReader(const TwoBitReader&) = delete;
+    TwoBitReader& operator=(const TwoBitReader&) = delete;
+
+    size_t sequence_count() const { return sequences_.size(); }
+    const std::string& name(size_t seq) const { return sequences_.at(seq).name; }
+    size_t length(size_t seq) const { return sequences_.at(seq).length; }
+
+    /**
+     * Index of a sequence by name, or npos
+     */
+    size_t find(const std::string& name) const;
+
+    /**
+     * Unmasked base at a position in O(1) (N runs read as the stored T)
+     */
+    char packed_base(size_t seq, size_t position) const;
+
+    /**
+     * Base at a position with N runs and soft masking applied
+     * (O(log blocks) lookup on top of packed_base())
+     */
+    char base(size_t seq, size_t position) const;
+
+    /**
+     * Nucleotide text of a range with N runs and soft masking applied
+     *
+     * @param length Number of bases; clipped to the end of the sequence
+     */
+    std::string sequence(size_t seq, size_t start = 0, size_t length = npos) const;
+
+    /**
+     * Copy a whole sequence into a record (packed bases translated to binary_to_dna() order)
+     */
+    TwoBitRecord record(size_t seq) const;
+
+private:
+    struct SequenceInfo {
+        std::string name;
+        size_t length = 0;
+        std::vector<BaseRun> n_blocks;
+        std::vector<BaseRun> mask_blocks;
+        const uint8_t* packed = nullptr;
+    };
+
+    uint32_t read_u32(size_t offset) const;
+    uint64_t read_u64(size_t offset) const;
+    void parse();
+
+    std::string path_;
+    const uint8_t* data_;
+    size_t size_;
+    bool swapped_;
+    bool mapped_;
+    std::vector<uint8_t> buffer_;       // used when mmap is unavailable
+    std::vector<SequenceInfo> sequences_;
+};
+
+/**
+ * Compress every sequence of a .2bit file into a multi-member CCC archive,
+ * one sequence per worker
+ *
+ * @param twobit_path Input .2bit file
+ * @param archive_path Output multi-member archive
+ * @param compressor Template whose settings every member is compressed with
+ * @param num_threads Concurrent sequences; 0 uses the hardware concurrency
+ * @return Number of sequences converted
+ */
+size_t twobit_to_archive(const std::string& twobit_path, const std::string& archive_path,
+                         const CircularChromosomeCompressor& compressor, size_t num_threads = 0);
+
+/**
+ * Compress the sequences of a .2bit file into a solid multi-member archive,
+ * similar sequences sharing a code stream (see write_solid_archive())
+ *
+ * @param options Grouping parameters
+ * @param num_threads Concurrent streams; 0 uses the hardware concurrency
+ * @return Number of sequences converted
+ */
+size_t twobit_to_solid_archive(const std::string& twobit_path, const std::string& archive_path,
+                               const CircularChromosomeCompressor& compressor,
+                               const SolidOptions& options = SolidOptions(), size_t num_threads = 0);
+
+/**
+ * Decompress every member of a multi-member CCC archive into a .2bit file,
+ * one code stream per worker; each shared stream is decoded once
+ *
+ * @return Number of sequences converted
+ */
+size_t archive_to_twobit(const std::string& archive_path, const std::string& twobit_path, size_t num_threads = 0);
+
+} // namespace ccc
+
+#endif // CCC_TWOBIT_H